@@ -0,0 +1,357 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file Bench.cpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "Bench.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <time.h>
+#include "aid/Isa.hpp"
+
+
+namespace bench {
+namespace {
+
+struct Options
+{
+	std::regex	filter{".*"};
+	double		min_time{0.5};
+	bool		json{true};
+	std::string	out{};
+};
+
+struct Result
+{
+	std::string		name;
+	std::uint64_t	iterations;
+	unsigned int	threads;
+	double			real_time;	// ns per iteration
+	double			cpu_time;	// ns per iteration and thread
+	double			bytes_per_second;
+	double			items_per_second;
+	std::string		label;
+	std::string		error;
+};
+
+bool parse_option(const char *arg, const char *name, std::string &value)
+{
+	const std::size_t length{std::strlen(name)};
+	if ( std::strncmp(arg, name, length) != 0 || arg[length] != '=' ) {
+		return false;
+	}
+	value = arg + length + 1;
+	return true;
+}
+
+Options parse_options(int argc, char *argv[])
+{
+	Options options;
+	for ( int i{1}; i < argc; ++i ) {
+		std::string value;
+		if ( parse_option(argv[i], "--benchmark_filter", value) ) {
+			try {
+				options.filter.assign(value);
+			}
+			catch (const std::regex_error &e) {
+				throw std::invalid_argument("invalid filter: " + value + ": " + e.what());
+			}
+		}
+		else if ( parse_option(argv[i], "--benchmark_min_time", value) ) {
+			options.min_time = std::strtod(value.c_str(), nullptr);
+		}
+		else if ( parse_option(argv[i], "--benchmark_format", value) ) {
+			if ( value != "json" && value != "console" ) {
+				throw std::invalid_argument("unknown format: " + value);
+			}
+			options.json = value == "json";
+		}
+		else if ( parse_option(argv[i], "--benchmark_out", value) ) {
+			options.out = value;
+		}
+		else {
+			throw std::invalid_argument(std::string("unknown option: ") + argv[i]);
+		}
+	}
+	return options;
+}
+
+std::string full_name(const Benchmark &benchmark, const std::vector<std::int64_t> &args, unsigned int threads)
+{
+	std::ostringstream name;
+	name << benchmark.name();
+	for ( std::int64_t arg : args ) {
+		name << '/' << arg;
+	}
+	if ( !benchmark.thread_counts().empty() ) {
+		name << "/threads:" << threads;
+	}
+	return name.str();
+}
+
+struct Measurement
+{
+	double			seconds;		// mean of the threads
+	double			cpu_seconds;	// all the threads
+	std::int64_t	bytes;
+	std::int64_t	items;
+	std::string		label;
+};
+
+Measurement measure(const Benchmark &benchmark, const std::vector<std::int64_t> &args,
+					unsigned int threads, std::uint64_t iterations)
+{
+	std::vector<std::unique_ptr<State>> states;
+	StartBarrier barrier(threads);
+	for ( unsigned int i{0}; i < threads; ++i ) {
+		states.emplace_back(new State(iterations, args, threads, i, threads > 1 ? &barrier : nullptr));
+	}
+
+	if ( threads == 1 ) {
+		benchmark.function()(*states.front());
+	}
+	else {
+		std::vector<std::thread> workers;
+		std::vector<std::exception_ptr> errors(threads);
+		for ( unsigned int i{0}; i < threads; ++i ) {
+			workers.emplace_back([&, i] {
+				try {
+					benchmark.function()(*states[i]);
+				}
+				catch (...) {
+					errors[i] = std::current_exception();
+				}
+			});
+		}
+		for ( std::thread &worker : workers ) {
+			worker.join();
+		}
+		for ( const std::exception_ptr &error : errors ) {
+			if ( error ) std::rethrow_exception(error);
+		}
+	}
+
+	Measurement measurement{0.0, 0.0, 0, 0, states.front()->label()};
+	for ( const std::unique_ptr<State> &state : states ) {
+		measurement.seconds += std::chrono::duration<double>(state->elapsed()).count() / threads;
+		measurement.cpu_seconds += state->cpu_seconds();
+		measurement.bytes += state->bytes_processed();
+		measurement.items += state->items_processed();
+	}
+	return measurement;
+}
+
+Result run(const Benchmark &benchmark, const std::vector<std::int64_t> &args,
+		   unsigned int threads, const Options &options)
+{
+	Result result{full_name(benchmark, args, threads), 0, threads, 0.0, 0.0, 0.0, 0.0, {}, {}};
+	try {
+		std::uint64_t iterations{1};
+		for ( ;; ) {
+			const Measurement measurement{measure(benchmark, args, threads, iterations)};
+			const bool enough{measurement.seconds >= options.min_time || iterations >= 1000000000};
+			if ( enough ) {
+				result.iterations = iterations;
+				result.real_time = measurement.seconds * 1e9 / iterations;
+				result.cpu_time = measurement.cpu_seconds * 1e9 / iterations / threads;
+				if ( measurement.seconds > 0.0 ) {
+					result.bytes_per_second = measurement.bytes / measurement.seconds;
+					result.items_per_second = measurement.items / measurement.seconds;
+				}
+				result.label = measurement.label;
+				return result;
+			}
+
+			// aim a little past min_time, but grow at most tenfold per round
+			double factor{10.0};
+			if ( measurement.seconds > 0.0 ) {
+				factor = options.min_time * 1.4 / measurement.seconds;
+				if ( factor > 10.0 ) factor = 10.0;
+				if ( factor < 2.0 ) factor = 2.0;
+			}
+			iterations = std::uint64_t(iterations * factor);
+		}
+	}
+	catch (const std::exception &e) {
+		result.error = e.what();
+	}
+	return result;
+}
+
+std::string escape(const std::string &text)
+{
+	std::string escaped;
+	for ( char c : text ) {
+		if ( c == '"' || c == '\\' ) {
+			escaped += '\\';
+		}
+		escaped += c;
+	}
+	return escaped;
+}
+
+void write_json(std::ostream &out, const std::vector<Result> &results)
+{
+	char date[32];
+	const std::time_t now{std::time(nullptr)};
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+	out << "{\n"
+		<< "  \"context\": {\n"
+		<< "    \"date\": \"" << date << "\",\n"
+		<< "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+		<< "    \"isa\": \"" << aid::isa_name(aid::active_isa()) << "\",\n"
+#ifdef NDEBUG
+		<< "    \"library_build_type\": \"release\"\n"
+#else
+		<< "    \"library_build_type\": \"debug\"\n"
+#endif
+		<< "  },\n"
+		<< "  \"benchmarks\": [";
+	const char *separator{"\n"};
+	for ( const Result &result : results ) {
+		out << separator << "    {\n"
+			<< "      \"name\": \"" << escape(result.name) << "\",\n";
+		if ( !result.error.empty() ) {
+			out << "      \"error_occurred\": true,\n"
+				<< "      \"error_message\": \"" << escape(result.error) << "\"\n"
+				<< "    }";
+			separator = ",\n";
+			continue;
+		}
+		out << "      \"iterations\": " << result.iterations << ",\n"
+			<< "      \"threads\": " << result.threads << ",\n"
+			<< "      \"real_time\": " << result.real_time << ",\n"
+			<< "      \"cpu_time\": " << result.cpu_time << ",\n"
+			<< "      \"time_unit\": \"ns\"";
+		if ( result.bytes_per_second > 0.0 ) {
+			out << ",\n      \"bytes_per_second\": " << result.bytes_per_second;
+		}
+		if ( result.items_per_second > 0.0 ) {
+			out << ",\n      \"items_per_second\": " << result.items_per_second;
+		}
+		if ( !result.label.empty() ) {
+			out << ",\n      \"label\": \"" << escape(result.label) << "\"";
+		}
+		out << "\n    }";
+		separator = ",\n";
+	}
+	out << "\n  ]\n}\n";
+}
+
+void write_console(const Result &result)
+{
+	if ( !result.error.empty() ) {
+		std::printf("%-60s ERROR: %s\n", result.name.c_str(), result.error.c_str());
+		return;
+	}
+	std::printf("%-60s %12.1f ns %12.1f ns %12llu", result.name.c_str(),
+				result.real_time, result.cpu_time, static_cast<unsigned long long>(result.iterations));
+	if ( result.bytes_per_second > 0.0 ) {
+		std::printf(" %10.1f MiB/s", result.bytes_per_second / (1024 * 1024));
+	}
+	if ( result.items_per_second > 0.0 ) {
+		std::printf(" %10.1f M items/s", result.items_per_second / 1e6);
+	}
+	if ( !result.label.empty() ) {
+		std::printf(" %s", result.label.c_str());
+	}
+	std::printf("\n");
+	std::fflush(stdout);
+}
+
+} // namespace
+
+
+double thread_cpu_seconds() noexcept
+{
+#if		defined(CLOCK_THREAD_CPUTIME_ID)
+	timespec now;
+	if ( clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) == 0 ) {
+		return now.tv_sec + now.tv_nsec * 1e-9;
+	}
+#endif
+	return double(std::clock()) / CLOCKS_PER_SEC;
+}
+
+int run_benchmarks(int argc, char *argv[])
+{
+	Options options;
+	try {
+		options = parse_options(argc, argv);
+	}
+	catch (const std::exception &e) {
+		std::fprintf(stderr, "%s\n", e.what());
+		return EXIT_FAILURE;
+	}
+	if ( !options.json ) {
+		std::printf("%-60s %15s %15s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+	}
+
+	std::vector<Result> results;
+	int status{EXIT_SUCCESS};
+	for ( const std::unique_ptr<Benchmark> &benchmark : registry() ) {
+		std::vector<std::vector<std::int64_t>> arg_lists{benchmark->arg_lists()};
+		if ( arg_lists.empty() ) arg_lists.emplace_back();
+		std::vector<unsigned int> thread_counts{benchmark->thread_counts()};
+		if ( thread_counts.empty() ) thread_counts.push_back(1);
+
+		for ( const std::vector<std::int64_t> &args : arg_lists ) {
+			for ( unsigned int threads : thread_counts ) {
+				if ( !std::regex_search(full_name(*benchmark, args, threads), options.filter) ) {
+					continue;
+				}
+				results.push_back(run(*benchmark, args, threads, options));
+				if ( !results.back().error.empty() ) status = EXIT_FAILURE;
+				if ( !options.json ) write_console(results.back());
+			}
+		}
+	}
+
+	if ( options.json ) {
+		write_json(std::cout, results);
+	}
+	if ( !options.out.empty() ) {
+		std::ofstream out(options.out);
+		write_json(out, results);
+		if ( !out ) {
+			std::fprintf(stderr, "cannot write %s\n", options.out.c_str());
+			status = EXIT_FAILURE;
+		}
+	}
+	return status;
+}
+
+} // namespace bench
+
+
+int main(int argc, char *argv[])
+{
+	return bench::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,345 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file Bench.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_bench_Bench_hpp
+#define aid_bench_Bench_hpp
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace bench {
+
+/*!
+  @brief		CPU time consumed by the calling thread
+ */
+double thread_cpu_seconds() noexcept;
+
+/*!
+  @brief		barrier which releases the threads of a benchmark together
+ */
+class StartBarrier
+{
+  private:
+	std::mutex				m_mutex;
+	std::condition_variable	m_condition;
+	unsigned int			m_waiting;
+
+  public:
+	explicit StartBarrier(unsigned int count) noexcept
+		: m_mutex{}, m_condition{}, m_waiting{count}
+	{}
+
+	void wait() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if ( --m_waiting == 0 ) {
+			m_condition.notify_all();
+			return;
+		}
+		m_condition.wait(lock, [this] { return m_waiting == 0; });
+	}
+}; // class StartBarrier
+
+/*!
+  @brief		state of a running benchmark
+  @details		A benchmark function prepares its data, then repeats the
+				measured code while keep_running() returns true. The timer
+				runs from the first to the last call of keep_running(); the
+				threads of a multi-threaded benchmark start it together.
+ */
+class State
+{
+  private:
+	using Clock	= std::chrono::steady_clock;
+
+  private:
+	std::uint64_t				m_iterations;
+	std::uint64_t				m_remaining;
+	const std::vector<std::int64_t>	&m_ranges;
+	unsigned int				m_threads;
+	unsigned int				m_thread_index;
+	StartBarrier				*m_barrier;
+	bool						m_started;
+	Clock::time_point			m_start;
+	Clock::duration				m_elapsed;
+	double						m_cpu_start;
+	double						m_cpu_seconds;
+	std::int64_t				m_bytes_processed;
+	std::int64_t				m_items_processed;
+	std::string					m_label;
+
+  public:
+	State(std::uint64_t iterations, const std::vector<std::int64_t> &ranges,
+		  unsigned int threads, unsigned int thread_index, StartBarrier *barrier = nullptr) noexcept
+		: m_iterations{iterations}, m_remaining{iterations}, m_ranges(ranges)
+		, m_threads{threads}, m_thread_index{thread_index}, m_barrier{barrier}
+		, m_started{false}, m_start{}, m_elapsed{Clock::duration::zero()}
+		, m_cpu_start{0.0}, m_cpu_seconds{0.0}
+		, m_bytes_processed{0}, m_items_processed{0}, m_label{}
+	{}
+
+	State(const State &) = delete;
+	State &operator=(const State &) = delete;
+
+  public:
+	bool keep_running() {
+		if ( !m_started ) {
+			m_started = true;
+			if ( m_barrier ) m_barrier->wait();
+			m_cpu_start = thread_cpu_seconds();
+			m_start = Clock::now();
+		}
+		if ( m_remaining > 0 ) {
+			--m_remaining;
+			return true;
+		}
+		m_elapsed = Clock::now() - m_start;
+		m_cpu_seconds = thread_cpu_seconds() - m_cpu_start;
+		return false;
+	}
+
+	/*!
+	  @brief		get an argument of the benchmark
+	 */
+	std::int64_t range(std::size_t index = 0) const {
+		return m_ranges.at(index);
+	}
+
+	std::uint64_t iterations() const noexcept {
+		return m_iterations;
+	}
+
+	unsigned int threads() const noexcept {
+		return m_threads;
+	}
+
+	unsigned int thread_index() const noexcept {
+		return m_thread_index;
+	}
+
+	Clock::duration elapsed() const noexcept {
+		return m_elapsed;
+	}
+
+	//! CPU time of the measured loop in this thread
+	double cpu_seconds() const noexcept {
+		return m_cpu_seconds;
+	}
+
+	/*!
+	  @brief		set the bytes processed by all the iterations of this thread
+	 */
+	void set_bytes_processed(std::int64_t bytes) noexcept {
+		m_bytes_processed = bytes;
+	}
+
+	std::int64_t bytes_processed() const noexcept {
+		return m_bytes_processed;
+	}
+
+	/*!
+	  @brief		set the items processed by all the iterations of this thread
+	 */
+	void set_items_processed(std::int64_t items) noexcept {
+		m_items_processed = items;
+	}
+
+	std::int64_t items_processed() const noexcept {
+		return m_items_processed;
+	}
+
+	void set_label(const std::string &label) {
+		m_label = label;
+	}
+
+	const std::string &label() const noexcept {
+		return m_label;
+	}
+}; // class State
+
+
+using Function	= std::function<void (State &)>;
+
+/*!
+  @brief		registered benchmark and its argument lists
+ */
+class Benchmark
+{
+  private:
+	std::string							m_name;
+	Function							m_function;
+	std::vector<std::vector<std::int64_t>>	m_args;
+	std::vector<unsigned int>			m_threads;
+
+  public:
+	Benchmark(const std::string &name, Function function)
+		: m_name{name}, m_function{std::move(function)}, m_args{}, m_threads{}
+	{}
+
+  public:
+	//! run the benchmark with an argument
+	Benchmark *arg(std::int64_t x) {
+		m_args.push_back({x});
+		return this;
+	}
+
+	//! run the benchmark with a pair of arguments
+	Benchmark *args(std::int64_t x, std::int64_t y) {
+		m_args.push_back({x, y});
+		return this;
+	}
+
+	//! run the benchmark with first, first * multiplier, ..., and last
+	Benchmark *range(std::int64_t first, std::int64_t last, std::int64_t multiplier = 8) {
+		for ( std::int64_t x{first}; x < last; x *= multiplier ) {
+			arg(x);
+		}
+		return arg(last);
+	}
+
+	//! run the benchmark with every argument in [first, last]
+	Benchmark *dense_range(std::int64_t first, std::int64_t last) {
+		for ( std::int64_t x{first}; x <= last; ++x ) {
+			arg(x);
+		}
+		return this;
+	}
+
+	//! run the benchmark concurrently on n threads
+	Benchmark *threads(unsigned int n) {
+		m_threads.push_back(n);
+		return this;
+	}
+
+	//! run the benchmark on 1, 2, 4, ... threads up to max_threads
+	Benchmark *thread_range(unsigned int max_threads) {
+		for ( unsigned int n{1}; n < max_threads; n *= 2 ) {
+			threads(n);
+		}
+		return threads(max_threads);
+	}
+
+	const std::string &name() const noexcept {
+		return m_name;
+	}
+
+	const Function &function() const noexcept {
+		return m_function;
+	}
+
+	const std::vector<std::vector<std::int64_t>> &arg_lists() const noexcept {
+		return m_args;
+	}
+
+	const std::vector<unsigned int> &thread_counts() const noexcept {
+		return m_threads;
+	}
+}; // class Benchmark
+
+
+/*!
+  @brief		all the registered benchmarks
+ */
+inline std::vector<std::unique_ptr<Benchmark>> &registry()
+{
+	static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+	return benchmarks;
+}
+
+inline Benchmark *register_benchmark(const std::string &name, Function function)
+{
+	registry().emplace_back(new Benchmark(name, std::move(function)));
+	return registry().back().get();
+}
+
+/*!
+  @brief		keep the compiler from optimizing away a value
+ */
+template<typename T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void *sink;
+	sink = &value;
+#endif
+}
+
+/*!
+  @brief		keep the compiler from optimizing away the stores to memory
+ */
+inline void clobber_memory()
+{
+#if defined(__GNUC__)
+	asm volatile("" : : : "memory");
+#else
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+/*!
+  @brief		run the registered benchmarks
+  @details		Options:
+				--benchmark_filter=<regex>		run only the matching benchmarks
+				--benchmark_min_time=<seconds>	minimum time of a measurement
+				--benchmark_format=<json|console>	format of the standard output
+				--benchmark_out=<path>			also write JSON to a file
+  @return		exit status of the program
+ */
+int run_benchmarks(int argc, char *argv[]);
+
+} // namespace bench
+
+
+#if defined(__GNUC__)
+#define aid_bench_UNUSED	__attribute__((unused))
+#else
+#define aid_bench_UNUSED
+#endif
+
+#define aid_bench_CONCAT2(d_x, d_y)	d_x ## d_y
+#define aid_bench_CONCAT(d_x, d_y)	aid_bench_CONCAT2(d_x, d_y)
+
+/*!
+  @brief		register a benchmark function
+  @details		AID_BENCHMARK(function)->arg(8)->threads(4);
+ */
+#define AID_BENCHMARK(d_function) \
+	static ::bench::Benchmark *aid_bench_CONCAT(aid_bench_, __COUNTER__) \
+		aid_bench_UNUSED = ::bench::register_benchmark(#d_function, d_function)
+
+/*!
+  @brief		register an instance of a benchmark function template
+  @details		AID_BENCHMARK_TEMPLATE(function, std::uint32_t)->range(8, 4096);
+ */
+#define AID_BENCHMARK_TEMPLATE(d_function, ...) \
+	static ::bench::Benchmark *aid_bench_CONCAT(aid_bench_, __COUNTER__) \
+		aid_bench_UNUSED = ::bench::register_benchmark( \
+			#d_function "<" #__VA_ARGS__ ">", d_function<__VA_ARGS__>)
+
+
+#endif // aid_bench_Bench_hpp
@@ -0,0 +1,83 @@
+// -*- tab-width: 4 -*-
+// AtomicBitVector slot allocation and section writes shared by several threads, against a mutex
+#include "Bench.hpp"
+
+#include "aid/AtomicBitVector.hpp"
+#include "aid/BitVector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t calls_per_iteration = 1024;
+
+using AtomicBVec = aid::AtomicBitVector<uint64_t>;
+using BVec = aid::BitVector<uint64_t>;
+
+// each thread writes its own 8-bit section of the shared word
+BVec::Section section_of(const bench::State &state)
+{
+	const unsigned int first = state.thread_index() % 8 * 8;
+	return BVec::create_section(first, first + 7);
+}
+
+void AtomicBitVector_acquire_release(bench::State &state)
+{
+	static AtomicBVec slots;
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < calls_per_iteration; ++i ) {
+			const auto slot = slots.acquire_first_free();
+			bench::do_not_optimize(slot);
+			if ( slot != AtomicBVec::npos ) slots.release(slot);
+		}
+	}
+	state.set_items_processed(state.iterations() * calls_per_iteration);
+}
+
+void AtomicBitVector_set(bench::State &state)
+{
+	static AtomicBVec shared;
+	const auto section = section_of(state);
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < calls_per_iteration; ++i ) {
+			shared.set(section, i & 0xFF, memory_order_relaxed);
+		}
+	}
+	state.set_items_processed(state.iterations() * calls_per_iteration);
+}
+
+void BitVector_set_mutex(bench::State &state)
+{
+	static mutex lock;
+	static BVec shared;
+	const auto section = section_of(state);
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < calls_per_iteration; ++i ) {
+			lock_guard<mutex> guard(lock);
+			shared.set(section, i & 0xFF);
+		}
+	}
+	state.set_items_processed(state.iterations() * calls_per_iteration);
+}
+
+unsigned int max_threads()
+{
+	const unsigned int n = thread::hardware_concurrency();
+	return n < 2 ? 2 : n * 2;
+}
+
+} // namespace
+
+
+AID_BENCHMARK(AtomicBitVector_acquire_release)->thread_range(max_threads());
+AID_BENCHMARK(AtomicBitVector_set)->thread_range(max_threads());
+AID_BENCHMARK(BitVector_set_mutex)->thread_range(max_threads());
@@ -0,0 +1,118 @@
+// -*- tab-width: 4 -*-
+// BitReader/BitWriter fields of mixed widths and Exp-Golomb codes, MSB-first and LSB-first
+#include "Bench.hpp"
+
+#include "aid/BitStream.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t field_count = 1 << 16;
+
+// widths of 1 to 24 bits and values which fill them
+struct Fields
+{
+	vector<unsigned int>	widths;
+	vector<uint64_t>		values;
+	size_t					bits;
+};
+
+Fields make_fields()
+{
+	mt19937_64 engine(field_count);
+	Fields fields{{}, {}, 0};
+	for ( size_t i = 0; i < field_count; ++i ) {
+		const unsigned int width = static_cast<unsigned int>(engine() % 24 + 1);
+		fields.widths.push_back(width);
+		fields.values.push_back(engine() & ((uint64_t{1} << width) - 1));
+		fields.bits += width;
+	}
+	return fields;
+}
+
+template<aid::BitOrder t_order>
+vector<unsigned char> encode(const Fields &fields)
+{
+	vector<unsigned char> bytes((fields.bits + 7) / 8);
+	aid::BitWriter<t_order> writer(bytes.data(), bytes.size());
+	for ( size_t i = 0; i < field_count; ++i ) {
+		writer.write(fields.values[i], fields.widths[i]);
+	}
+	return bytes;
+}
+
+template<aid::BitOrder t_order>
+void BitReader_read(bench::State &state)
+{
+	const Fields fields = make_fields();
+	const vector<unsigned char> bytes = encode<t_order>(fields);
+
+	while ( state.keep_running() ) {
+		aid::BitReader<t_order> reader(bytes.data(), bytes.size());
+		uint64_t sum = 0;
+		for ( unsigned int width : fields.widths ) {
+			sum += reader.read(width);
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * field_count);
+	state.set_bytes_processed(state.iterations() * bytes.size());
+}
+
+template<aid::BitOrder t_order>
+void BitWriter_write(bench::State &state)
+{
+	const Fields fields = make_fields();
+	vector<unsigned char> bytes((fields.bits + 7) / 8);
+
+	while ( state.keep_running() ) {
+		aid::BitWriter<t_order> writer(bytes.data(), bytes.size());
+		for ( size_t i = 0; i < field_count; ++i ) {
+			writer.write(fields.values[i], fields.widths[i]);
+		}
+		writer.flush();
+		bench::clobber_memory();
+	}
+	state.set_items_processed(state.iterations() * field_count);
+	state.set_bytes_processed(state.iterations() * bytes.size());
+}
+
+// small values, as the syntax elements of a video stream
+void BitReader_read_ue(bench::State &state)
+{
+	mt19937_64 engine(field_count);
+	geometric_distribution<uint64_t> distribution(0.1);
+	vector<unsigned char> bytes(field_count * 8);
+	aid::BitWriter<> writer(bytes.data(), bytes.size());
+	for ( size_t i = 0; i < field_count; ++i ) {
+		writer.write_ue(distribution(engine));
+	}
+	writer.flush();
+
+	while ( state.keep_running() ) {
+		aid::BitReader<> reader(bytes.data(), writer.size());
+		uint64_t sum = 0;
+		for ( size_t i = 0; i < field_count; ++i ) {
+			sum += reader.read_ue();
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * field_count);
+	state.set_bytes_processed(state.iterations() * writer.size());
+}
+
+} // namespace
+
+
+AID_BENCHMARK_TEMPLATE(BitReader_read, aid::BitOrder::msb_first);
+AID_BENCHMARK_TEMPLATE(BitReader_read, aid::BitOrder::lsb_first);
+AID_BENCHMARK_TEMPLATE(BitWriter_write, aid::BitOrder::msb_first);
+AID_BENCHMARK_TEMPLATE(BitWriter_write, aid::BitOrder::lsb_first);
+AID_BENCHMARK(BitReader_read_ue);
@@ -0,0 +1,324 @@
+// -*- tab-width: 4 -*-
+// BitVector::get() and BitVector::set() with sections and BitFields, and the bulk operations of DynamicBitVector
+#include "Bench.hpp"
+
+#include "aid/BitField.hpp"
+#include "aid/BitVector.hpp"
+#include "aid/DynamicBitVector.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t vectors_per_iteration = 1024;
+
+template<typename DataType>
+vector<aid::BitVector<DataType>> make_vectors()
+{
+	mt19937_64 engine(vectors_per_iteration);
+	vector<aid::BitVector<DataType>> bvecs;
+	for ( size_t i = 0; i < vectors_per_iteration; ++i ) {
+		bvecs.emplace_back(static_cast<DataType>(engine()));
+	}
+	return bvecs;
+}
+
+// sections of 1 bit, a few bits in the middle and the upper half
+template<typename DataType>
+vector<typename aid::BitVector<DataType>::Section> make_sections()
+{
+	using BVec = aid::BitVector<DataType>;
+	constexpr unsigned int bits = sizeof(DataType) * CHAR_BIT;
+	return {BVec::create_section(0), BVec::create_section(1, 3), BVec::create_section(bits / 2, bits - 1)};
+}
+
+template<typename DataType>
+void BitVector_get(bench::State &state)
+{
+	const auto bvecs = make_vectors<DataType>();
+	const auto sections = make_sections<DataType>();
+
+	while ( state.keep_running() ) {
+		DataType sum = 0;
+		for ( const auto &bvec : bvecs ) {
+			for ( const auto &section : sections ) {
+				sum += bvec.get(section);
+			}
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * bvecs.size() * sections.size());
+}
+
+template<typename DataType>
+void BitVector_set(bench::State &state)
+{
+	auto bvecs = make_vectors<DataType>();
+	const auto sections = make_sections<DataType>();
+
+	while ( state.keep_running() ) {
+		DataType value = static_cast<DataType>(state.iterations());
+		for ( auto &bvec : bvecs ) {
+			for ( const auto &section : sections ) {
+				bvec.set(section, value & (section.mask >> section.offset));
+				++value;
+			}
+		}
+		bench::clobber_memory();
+	}
+	state.set_items_processed(state.iterations() * bvecs.size() * sections.size());
+}
+
+// the fields of make_sections() fixed at compile time
+template<typename DataType>
+using Layout = aid::BitLayout<DataType, aid::TypeList<aid::BitField<0>, aid::BitField<1, 3>,
+													   aid::BitField<sizeof(DataType) * CHAR_BIT / 2, sizeof(DataType) * CHAR_BIT - 1>>>;
+
+template<typename DataType>
+void BitVector_get_field(bench::State &state)
+{
+	using Fields = typename Layout<DataType>::fields;
+	const auto bvecs = make_vectors<DataType>();
+
+	while ( state.keep_running() ) {
+		DataType sum = 0;
+		for ( const auto &bvec : bvecs ) {
+			sum += bvec.template get<typename Fields::head>();
+			sum += bvec.template get<typename Fields::tail::head>();
+			sum += bvec.template get<typename Fields::tail::tail::head>();
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * bvecs.size() * Fields::size);
+}
+
+template<typename DataType>
+void BitVector_pack(bench::State &state)
+{
+	auto bvecs = make_vectors<DataType>();
+
+	while ( state.keep_running() ) {
+		DataType value = static_cast<DataType>(state.iterations());
+		for ( auto &bvec : bvecs ) {
+			bvec = Layout<DataType>::pack(value & 1, value & 7, value & 3);
+			++value;
+		}
+		bench::clobber_memory();
+	}
+	state.set_items_processed(state.iterations() * bvecs.size());
+}
+
+// a control word of 8 fields, decoded into a byte per field
+using Control = aid::BitLayout<uint64_t, aid::TypeList<aid::BitField<0, 2>, aid::BitField<5, 9>, aid::BitField<12, 19>,
+														aid::BitField<22, 23>, aid::BitField<28, 33>, aid::BitField<36, 42>,
+														aid::BitField<48, 51>, aid::BitField<56, 63>>>;
+using ControlBytes = aid::BitLayout<uint64_t, aid::TypeList<aid::BitField<0, 2>, aid::BitField<8, 12>,
+															 aid::BitField<16, 23>, aid::BitField<24, 25>,
+															 aid::BitField<32, 37>, aid::BitField<40, 46>,
+															 aid::BitField<48, 51>, aid::BitField<56, 63>>>;
+
+void BitVector_decode_fields(bench::State &state)
+{
+	using Fields = Control::fields;
+	const auto bvecs = make_vectors<uint64_t>();
+
+	while ( state.keep_running() ) {
+		uint64_t sum = 0;
+		for ( const auto &bvec : bvecs ) {
+			sum += bvec.get<Fields::head>()
+				| bvec.get<Fields::tail::head>() << 8
+				| bvec.get<Fields::tail::tail::head>() << 16
+				| bvec.get<Fields::tail::tail::tail::head>() << 24
+				| bvec.get<Fields::tail::tail::tail::tail::head>() << 32
+				| bvec.get<Fields::tail::tail::tail::tail::tail::head>() << 40
+				| bvec.get<Fields::tail::tail::tail::tail::tail::tail::head>() << 48
+				| bvec.get<Fields::tail::tail::tail::tail::tail::tail::tail::head>() << 56;
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * bvecs.size() * Fields::size);
+}
+
+void BitVector_extract(bench::State &state)
+{
+	const auto bvecs = make_vectors<uint64_t>();
+
+	while ( state.keep_running() ) {
+		uint64_t sum = 0;
+		for ( const auto &bvec : bvecs ) {
+			sum += bvec.extract<Control>();
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * bvecs.size() * Control::fields::size);
+}
+
+void BitVector_transcode(bench::State &state)
+{
+	const auto bvecs = make_vectors<uint64_t>();
+
+	while ( state.keep_running() ) {
+		uint64_t sum = 0;
+		for ( const auto &bvec : bvecs ) {
+			sum += Control::transcode<ControlBytes>(bvec.get());
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * bvecs.size() * Control::fields::size);
+}
+
+aid::DynamicBitVector make_dynamic(size_t size, unsigned int seed)
+{
+	mt19937_64 engine(seed);
+	aid::DynamicBitVector bvec(size);
+	for ( size_t i = 0; i < size; ++i ) {
+		if ( engine() % 4 == 0 ) bvec.set(i);
+	}
+	return bvec;
+}
+
+vector<bool> make_bools(const aid::DynamicBitVector &bvec)
+{
+	vector<bool> bools(bvec.size());
+	for ( size_t i = 0; i < bvec.size(); ++i ) {
+		bools[i] = bvec[i];
+	}
+	return bools;
+}
+
+void set_processed(bench::State &state, size_t bits)
+{
+	state.set_items_processed(state.iterations() * bits);
+	state.set_bytes_processed(state.iterations() * bits / CHAR_BIT);
+}
+
+// a &= b
+void DynamicBitVector_and(bench::State &state)
+{
+	aid::DynamicBitVector a = make_dynamic(state.range(0), 1);
+	const aid::DynamicBitVector b = make_dynamic(state.range(0), 2);
+
+	while ( state.keep_running() ) {
+		a &= b;
+		bench::clobber_memory();
+	}
+	set_processed(state, a.size());
+}
+
+// a &= b | c in one pass
+void DynamicBitVector_and_or(bench::State &state)
+{
+	aid::DynamicBitVector a = make_dynamic(state.range(0), 1);
+	const aid::DynamicBitVector b = make_dynamic(state.range(0), 2);
+	const aid::DynamicBitVector c = make_dynamic(state.range(0), 3);
+
+	while ( state.keep_running() ) {
+		a.apply(aid::BitOp::and_, b, aid::BitOp::or_, c);
+		bench::clobber_memory();
+	}
+	set_processed(state, a.size());
+}
+
+// a &= b | c with a temporary
+void DynamicBitVector_and_or_temporary(bench::State &state)
+{
+	aid::DynamicBitVector a = make_dynamic(state.range(0), 1);
+	const aid::DynamicBitVector b = make_dynamic(state.range(0), 2);
+	const aid::DynamicBitVector c = make_dynamic(state.range(0), 3);
+
+	while ( state.keep_running() ) {
+		a &= b | c;
+		bench::clobber_memory();
+	}
+	set_processed(state, a.size());
+}
+
+void DynamicBitVector_count(bench::State &state)
+{
+	const aid::DynamicBitVector a = make_dynamic(state.range(0), 1);
+
+	while ( state.keep_running() ) {
+		bench::do_not_optimize(a.count());
+	}
+	set_processed(state, a.size());
+}
+
+void DynamicBitVector_for_each_set(bench::State &state)
+{
+	const aid::DynamicBitVector a = make_dynamic(state.range(0), 1);
+
+	while ( state.keep_running() ) {
+		size_t sum = 0;
+		a.for_each_set([&sum](size_t i) { sum += i; });
+		bench::do_not_optimize(sum);
+	}
+	set_processed(state, a.size());
+}
+
+// the same as DynamicBitVector_and with std::vector<bool>
+void vector_bool_and(bench::State &state)
+{
+	vector<bool> a = make_bools(make_dynamic(state.range(0), 1));
+	const vector<bool> b = make_bools(make_dynamic(state.range(0), 2));
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < a.size(); ++i ) {
+			a[i] = a[i] && b[i];
+		}
+		bench::clobber_memory();
+	}
+	set_processed(state, a.size());
+}
+
+// the same as DynamicBitVector_count with std::vector<bool>
+void vector_bool_count(bench::State &state)
+{
+	const vector<bool> a = make_bools(make_dynamic(state.range(0), 1));
+
+	while ( state.keep_running() ) {
+		size_t count = 0;
+		for ( bool bit : a ) {
+			count += bit ? 1 : 0;
+		}
+		bench::do_not_optimize(count);
+	}
+	set_processed(state, a.size());
+}
+
+} // namespace
+
+
+AID_BENCHMARK_TEMPLATE(BitVector_get, uint8_t);
+AID_BENCHMARK_TEMPLATE(BitVector_get, uint16_t);
+AID_BENCHMARK_TEMPLATE(BitVector_get, uint32_t);
+AID_BENCHMARK_TEMPLATE(BitVector_get, uint64_t);
+AID_BENCHMARK_TEMPLATE(BitVector_set, uint8_t);
+AID_BENCHMARK_TEMPLATE(BitVector_set, uint16_t);
+AID_BENCHMARK_TEMPLATE(BitVector_set, uint32_t);
+AID_BENCHMARK_TEMPLATE(BitVector_set, uint64_t);
+AID_BENCHMARK_TEMPLATE(BitVector_get_field, uint8_t);
+AID_BENCHMARK_TEMPLATE(BitVector_get_field, uint16_t);
+AID_BENCHMARK_TEMPLATE(BitVector_get_field, uint32_t);
+AID_BENCHMARK_TEMPLATE(BitVector_get_field, uint64_t);
+AID_BENCHMARK_TEMPLATE(BitVector_pack, uint8_t);
+AID_BENCHMARK_TEMPLATE(BitVector_pack, uint16_t);
+AID_BENCHMARK_TEMPLATE(BitVector_pack, uint32_t);
+AID_BENCHMARK_TEMPLATE(BitVector_pack, uint64_t);
+AID_BENCHMARK(BitVector_decode_fields);
+AID_BENCHMARK(BitVector_extract);
+AID_BENCHMARK(BitVector_transcode);
+
+AID_BENCHMARK(DynamicBitVector_and)->range(1 << 12, 1 << 24, 16);
+AID_BENCHMARK(DynamicBitVector_and_or)->range(1 << 12, 1 << 24, 16);
+AID_BENCHMARK(DynamicBitVector_and_or_temporary)->range(1 << 12, 1 << 24, 16);
+AID_BENCHMARK(DynamicBitVector_count)->range(1 << 12, 1 << 24, 16);
+AID_BENCHMARK(DynamicBitVector_for_each_set)->range(1 << 12, 1 << 24, 16);
+AID_BENCHMARK(vector_bool_and)->range(1 << 12, 1 << 24, 16);
+AID_BENCHMARK(vector_bool_count)->range(1 << 12, 1 << 24, 16);
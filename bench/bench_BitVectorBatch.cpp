@@ -0,0 +1,126 @@
+// -*- tab-width: 4 -*-
+// get/select/set of a section over a column of BitVectors, against the loops of BitVector::get() and set()
+#include "Bench.hpp"
+
+#include "aid/BitVectorBatch.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t column_size = 1 << 16;
+
+template<typename DataType>
+vector<aid::BitVector<DataType>> make_column()
+{
+	mt19937_64 engine(column_size);
+	vector<aid::BitVector<DataType>> bvecs;
+	for ( size_t i = 0; i < column_size; ++i ) {
+		bvecs.emplace_back(static_cast<DataType>(engine()));
+	}
+	return bvecs;
+}
+
+template<typename DataType>
+typename aid::BitVector<DataType>::Section section() noexcept
+{
+	return aid::BitVector<DataType>::create_section(4, 7);
+}
+
+template<typename DataType>
+void set_throughput(bench::State &state)
+{
+	state.set_items_processed(state.iterations() * column_size);
+	state.set_bytes_processed(state.iterations() * column_size * sizeof(DataType));
+}
+
+template<typename DataType>
+void BitVector_get_loop(bench::State &state)
+{
+	const auto bvecs = make_column<DataType>();
+	vector<DataType> values(column_size);
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < column_size; ++i ) {
+			values[i] = bvecs[i].get(section<DataType>());
+		}
+		bench::clobber_memory();
+	}
+	set_throughput<DataType>(state);
+}
+
+template<typename DataType>
+void BitVector_get_sections(bench::State &state)
+{
+	const auto bvecs = make_column<DataType>();
+	vector<DataType> values(column_size);
+
+	while ( state.keep_running() ) {
+		aid::get_sections(bvecs.data(), column_size, section<DataType>(), values.data());
+		bench::clobber_memory();
+	}
+	set_throughput<DataType>(state);
+}
+
+// the predicate as it is written without the batch operations
+template<typename DataType>
+void BitVector_select_loop(bench::State &state)
+{
+	const auto bvecs = make_column<DataType>();
+	aid::DynamicBitVector selection(column_size);
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < column_size; ++i ) {
+			selection.set(i, bvecs[i].get(section<DataType>()) == 5);
+		}
+		bench::do_not_optimize(selection.data()[0]);
+	}
+	set_throughput<DataType>(state);
+}
+
+template<typename DataType>
+void BitVector_select_sections(bench::State &state)
+{
+	const auto bvecs = make_column<DataType>();
+	aid::DynamicBitVector selection;
+
+	while ( state.keep_running() ) {
+		bench::do_not_optimize(aid::select_sections(bvecs.data(), column_size, section<DataType>(),
+													DataType{5}, selection));
+	}
+	set_throughput<DataType>(state);
+}
+
+// one sixteenth of the column is selected
+template<typename DataType>
+void BitVector_set_sections(bench::State &state)
+{
+	auto bvecs = make_column<DataType>();
+	aid::DynamicBitVector selection;
+	aid::select_sections(bvecs.data(), column_size, section<DataType>(), DataType{5}, selection);
+	const auto target = aid::BitVector<DataType>::create_section(0, 1);
+
+	while ( state.keep_running() ) {
+		aid::set_sections(bvecs.data(), column_size, target, DataType{2}, selection);
+		bench::clobber_memory();
+	}
+	set_throughput<DataType>(state);
+}
+
+} // namespace
+
+
+AID_BENCHMARK_TEMPLATE(BitVector_get_loop, uint32_t);
+AID_BENCHMARK_TEMPLATE(BitVector_get_sections, uint32_t);
+AID_BENCHMARK_TEMPLATE(BitVector_get_sections, uint64_t);
+AID_BENCHMARK_TEMPLATE(BitVector_select_loop, uint32_t);
+AID_BENCHMARK_TEMPLATE(BitVector_select_sections, uint32_t);
+AID_BENCHMARK_TEMPLATE(BitVector_select_sections, uint64_t);
+AID_BENCHMARK_TEMPLATE(BitVector_set_sections, uint32_t);
+AID_BENCHMARK_TEMPLATE(BitVector_set_sections, uint64_t);
@@ -0,0 +1,91 @@
+// -*- tab-width: 4 -*-
+// BloomFilter insert and lookup, one by one and in bulk, in cache and out of it
+#include "Bench.hpp"
+
+#include "aid/BloomFilter.hpp"
+#include "aid/Hash.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t bits_per_key = 12;
+constexpr size_t queries_per_iteration = 1 << 16;
+
+vector<uint64_t> make_hashes(uint64_t first, size_t count)
+{
+	vector<uint64_t> hashes;
+	for ( uint64_t key = first; key < first + count; ++key ) {
+		hashes.push_back(aid::hash_word(key));
+	}
+	return hashes;
+}
+
+// half of the queries are inserted keys
+aid::BloomFilter make_filter(size_t key_count)
+{
+	aid::BloomFilter filter(key_count * bits_per_key);
+	for ( size_t first = 0; first < key_count; first += queries_per_iteration ) {
+		const vector<uint64_t> hashes = make_hashes(first * 2, queries_per_iteration);
+		filter.insert(hashes.data(), hashes.size());
+	}
+	return filter;
+}
+
+template<size_t t_key_count>
+void BloomFilter_insert(bench::State &state)
+{
+	aid::BloomFilter filter(t_key_count * bits_per_key);
+	const vector<uint64_t> hashes = make_hashes(0, queries_per_iteration);
+
+	while ( state.keep_running() ) {
+		filter.insert(hashes.data(), hashes.size());
+		bench::clobber_memory();
+	}
+	state.set_items_processed(state.iterations() * queries_per_iteration);
+}
+
+template<size_t t_key_count>
+void BloomFilter_contains_loop(bench::State &state)
+{
+	const aid::BloomFilter filter = make_filter(t_key_count);
+	const vector<uint64_t> hashes = make_hashes(t_key_count, queries_per_iteration);
+
+	while ( state.keep_running() ) {
+		size_t found = 0;
+		for ( uint64_t hash : hashes ) {
+			found += filter.contains(hash);
+		}
+		bench::do_not_optimize(found);
+	}
+	state.set_items_processed(state.iterations() * queries_per_iteration);
+}
+
+template<size_t t_key_count>
+void BloomFilter_contains_bulk(bench::State &state)
+{
+	const aid::BloomFilter filter = make_filter(t_key_count);
+	const vector<uint64_t> hashes = make_hashes(t_key_count, queries_per_iteration);
+	aid::DynamicBitVector result;
+
+	while ( state.keep_running() ) {
+		bench::do_not_optimize(filter.contains(hashes.data(), hashes.size(), result));
+	}
+	state.set_items_processed(state.iterations() * queries_per_iteration);
+}
+
+} // namespace
+
+
+// 96 KiB and 96 MiB of bits
+AID_BENCHMARK_TEMPLATE(BloomFilter_insert, 1 << 16);
+AID_BENCHMARK_TEMPLATE(BloomFilter_insert, 1 << 26);
+AID_BENCHMARK_TEMPLATE(BloomFilter_contains_loop, 1 << 16);
+AID_BENCHMARK_TEMPLATE(BloomFilter_contains_loop, 1 << 26);
+AID_BENCHMARK_TEMPLATE(BloomFilter_contains_bulk, 1 << 16);
+AID_BENCHMARK_TEMPLATE(BloomFilter_contains_bulk, 1 << 26);
@@ -0,0 +1,128 @@
+// -*- tab-width: 4 -*-
+// CompressedBitmap set operations and lookups against DynamicBitVector
+#include "Bench.hpp"
+
+#include "aid/CompressedBitmap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+constexpr uint32_t universe = 1u << 26;
+constexpr size_t queries_per_iteration = 256;
+
+// one value in every `one_in` on average
+vector<uint32_t> make_values(size_t one_in, unsigned int seed)
+{
+	mt19937 engine(seed);
+	vector<uint32_t> values;
+	for ( uint32_t value = 0; value < universe; value += 1 + engine() % (2 * one_in - 1) ) {
+		values.push_back(value);
+	}
+	return values;
+}
+
+aid::CompressedBitmap make_bitmap(size_t one_in, unsigned int seed)
+{
+	aid::CompressedBitmap bitmap;
+	for ( uint32_t value : make_values(one_in, seed) ) {
+		bitmap.add(value);
+	}
+	return bitmap;
+}
+
+aid::DynamicBitVector make_bits(size_t one_in, unsigned int seed)
+{
+	aid::DynamicBitVector bits(universe);
+	for ( uint32_t value : make_values(one_in, seed) ) {
+		bits.set(value);
+	}
+	return bits;
+}
+
+vector<uint32_t> make_queries()
+{
+	mt19937 engine(universe);
+	vector<uint32_t> queries(queries_per_iteration);
+	for ( uint32_t &query : queries ) {
+		query = engine() % universe;
+	}
+	return queries;
+}
+
+void CompressedBitmap_and(bench::State &state)
+{
+	const aid::CompressedBitmap x = make_bitmap(state.range(0), 1);
+	const aid::CompressedBitmap y = make_bitmap(state.range(0), 2);
+
+	while ( state.keep_running() ) {
+		bench::do_not_optimize((x & y).cardinality());
+	}
+	state.set_bytes_processed(state.iterations() * (x.serialized_size() + y.serialized_size()));
+	state.set_label(to_string(x.serialized_size()) + " bytes");
+}
+
+void CompressedBitmap_or(bench::State &state)
+{
+	const aid::CompressedBitmap x = make_bitmap(state.range(0), 1);
+	const aid::CompressedBitmap y = make_bitmap(state.range(0), 2);
+
+	while ( state.keep_running() ) {
+		bench::do_not_optimize((x | y).cardinality());
+	}
+	state.set_bytes_processed(state.iterations() * (x.serialized_size() + y.serialized_size()));
+}
+
+void CompressedBitmap_contains(bench::State &state)
+{
+	const aid::CompressedBitmap bitmap = make_bitmap(state.range(0), 1);
+	const vector<uint32_t> queries = make_queries();
+
+	while ( state.keep_running() ) {
+		for ( uint32_t query : queries ) {
+			bench::do_not_optimize(bitmap.contains(query));
+		}
+	}
+	state.set_items_processed(state.iterations() * queries.size());
+}
+
+void CompressedBitmap_view_contains(bench::State &state)
+{
+	const vector<unsigned char> external = make_bitmap(state.range(0), 1).serialize();
+	const aid::CompressedBitmapView view(external.data(), external.size());
+	const vector<uint32_t> queries = make_queries();
+
+	while ( state.keep_running() ) {
+		for ( uint32_t query : queries ) {
+			bench::do_not_optimize(view.contains(query));
+		}
+	}
+	state.set_items_processed(state.iterations() * queries.size());
+}
+
+void DynamicBitVector_and_count(bench::State &state)
+{
+	const aid::DynamicBitVector x = make_bits(state.range(0), 1);
+	const aid::DynamicBitVector y = make_bits(state.range(0), 2);
+
+	while ( state.keep_running() ) {
+		bench::do_not_optimize(x.count(aid::BitOp::and_, y));
+	}
+	state.set_bytes_processed(state.iterations() * 2 * x.word_size() * sizeof(uint64_t));
+}
+
+} // namespace
+
+
+AID_BENCHMARK(CompressedBitmap_and)->arg(16)->arg(128)->arg(1024);
+AID_BENCHMARK(CompressedBitmap_or)->arg(16)->arg(128)->arg(1024);
+AID_BENCHMARK(CompressedBitmap_contains)->arg(16)->arg(1024);
+AID_BENCHMARK(CompressedBitmap_view_contains)->arg(16)->arg(1024);
+AID_BENCHMARK(DynamicBitVector_and_count)->arg(16)->arg(128)->arg(1024);
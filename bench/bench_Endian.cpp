@@ -0,0 +1,228 @@
+// -*- tab-width: 4 -*-
+// per-value and bulk conversions of EndianConverter and DynamicEndianConverter
+#include "Bench.hpp"
+
+#include "aid/DynamicEndianConverter.hpp"
+#include "aid/Endian.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+using aid::EndianType;
+
+
+namespace {
+
+constexpr size_t values_per_iteration = 1024;
+
+template<typename Integer>
+typename enable_if<is_integral<Integer>::value, vector<Integer>>::type
+make_values(size_t count)
+{
+	mt19937_64 engine(count);
+	vector<Integer> values(count);
+	for ( Integer &value : values ) {
+		value = static_cast<Integer>(engine());
+	}
+	return values;
+}
+
+template<typename Real>
+typename enable_if<is_floating_point<Real>::value, vector<Real>>::type
+make_values(size_t count)
+{
+	mt19937_64 engine(count);
+	uniform_real_distribution<Real> distribution(-1e6, 1e6);
+	vector<Real> values(count);
+	for ( Real &value : values ) {
+		value = distribution(engine);
+	}
+	return values;
+}
+
+void set_processed(bench::State &state, size_t count, size_t size)
+{
+	state.set_items_processed(state.iterations() * count);
+	state.set_bytes_processed(state.iterations() * count * size);
+}
+
+// EndianConverter::to_external(native, external, size) for each value
+template<EndianType t_external_type, typename Integer>
+void Endian_to_external(bench::State &state)
+{
+	using converter = aid::EndianConverter<t_external_type>;
+	const size_t size = state.range(0);
+	const vector<Integer> native = make_values<Integer>(values_per_iteration);
+	vector<unsigned char> external(native.size() * size);
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < native.size(); ++i ) {
+			converter::to_external(native[i], external.data() + i * size, size);
+		}
+		bench::clobber_memory();
+	}
+	set_processed(state, native.size(), size);
+}
+
+// EndianConverter::from_external(external, size, native) for each value
+template<EndianType t_external_type, typename Integer>
+void Endian_from_external(bench::State &state)
+{
+	using converter = aid::EndianConverter<t_external_type>;
+	const size_t size = state.range(0);
+	const vector<unsigned char> external = make_values<unsigned char>(values_per_iteration * size);
+	vector<Integer> native(values_per_iteration);
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < native.size(); ++i ) {
+			converter::from_external(external.data() + i * size, size, native[i]);
+		}
+		bench::clobber_memory();
+	}
+	set_processed(state, native.size(), size);
+}
+
+// EndianConverter::to_external<size>(native, external) for each value
+template<EndianType t_external_type, typename Integer, size_t t_size>
+void Endian_to_external_fixed(bench::State &state)
+{
+	using converter = aid::EndianConverter<t_external_type>;
+	const vector<Integer> native = make_values<Integer>(values_per_iteration);
+	vector<unsigned char> external(native.size() * t_size);
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < native.size(); ++i ) {
+			converter::template to_external<t_size>(native[i], external.data() + i * t_size);
+		}
+		bench::clobber_memory();
+	}
+	set_processed(state, native.size(), t_size);
+}
+
+// EndianConverter::from_external<size>(external, native) for each value
+template<EndianType t_external_type, typename Integer, size_t t_size>
+void Endian_from_external_fixed(bench::State &state)
+{
+	using converter = aid::EndianConverter<t_external_type>;
+	const vector<unsigned char> external = make_values<unsigned char>(values_per_iteration * t_size);
+	vector<Integer> native(values_per_iteration);
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < native.size(); ++i ) {
+			converter::template from_external<t_size>(external.data() + i * t_size, native[i]);
+		}
+		bench::clobber_memory();
+	}
+	set_processed(state, native.size(), t_size);
+}
+
+// EndianConverter::to_external_n(native, count, external)
+template<EndianType t_external_type, typename Integer>
+void Endian_to_external_n(bench::State &state)
+{
+	using converter = aid::EndianConverter<t_external_type>;
+	const vector<Integer> native = make_values<Integer>(state.range(0));
+	vector<unsigned char> external(native.size() * sizeof(Integer));
+
+	while ( state.keep_running() ) {
+		converter::to_external_n(native.data(), native.size(), external.data());
+		bench::clobber_memory();
+	}
+	set_processed(state, native.size(), sizeof(Integer));
+}
+
+// EndianConverter::from_external_n(external, count, native)
+template<EndianType t_external_type, typename Integer>
+void Endian_from_external_n(bench::State &state)
+{
+	using converter = aid::EndianConverter<t_external_type>;
+	const vector<unsigned char> external = make_values<unsigned char>(state.range(0) * sizeof(Integer));
+	vector<Integer> native(state.range(0));
+
+	while ( state.keep_running() ) {
+		converter::from_external_n(external.data(), native.size(), native.data());
+		bench::clobber_memory();
+	}
+	set_processed(state, native.size(), sizeof(Integer));
+}
+
+// DynamicEndianConverter::from_external(external, size, native) for each value
+template<EndianType t_external_type, typename Integer>
+void Endian_dynamic_from_external(bench::State &state)
+{
+	const aid::DynamicEndianConverter converter(t_external_type);
+	const size_t size = state.range(0);
+	const vector<unsigned char> external = make_values<unsigned char>(values_per_iteration * size);
+	vector<Integer> native(values_per_iteration);
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < native.size(); ++i ) {
+			converter.from_external(external.data() + i * size, size, native[i]);
+		}
+		bench::clobber_memory();
+	}
+	set_processed(state, native.size(), size);
+}
+
+// DynamicEndianConverter::Resolved::from_external(external, native) for each value
+template<EndianType t_external_type, typename Integer>
+void Endian_resolved_from_external(bench::State &state)
+{
+	const aid::DynamicEndianConverter converter(t_external_type);
+	const auto resolved = converter.resolve<Integer>(state.range(0));
+	const size_t size = state.range(0);
+	const vector<unsigned char> external = make_values<unsigned char>(values_per_iteration * size);
+	vector<Integer> native(values_per_iteration);
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < native.size(); ++i ) {
+			resolved.from_external(external.data() + i * size, native[i]);
+		}
+		bench::clobber_memory();
+	}
+	set_processed(state, native.size(), size);
+}
+
+} // namespace
+
+
+#define BENCH_ENDIAN_VALUE(d_external_type, DInteger, d_last_size) \
+	AID_BENCHMARK_TEMPLATE(Endian_to_external, d_external_type, DInteger)->dense_range(1, d_last_size); \
+	AID_BENCHMARK_TEMPLATE(Endian_from_external, d_external_type, DInteger)->dense_range(1, d_last_size)
+
+#define BENCH_ENDIAN_BULK(d_external_type, DInteger) \
+	AID_BENCHMARK_TEMPLATE(Endian_to_external_n, d_external_type, DInteger)->range(64, 64 * 1024, 32); \
+	AID_BENCHMARK_TEMPLATE(Endian_from_external_n, d_external_type, DInteger)->range(64, 64 * 1024, 32)
+
+#define BENCH_ENDIAN(d_external_type) \
+	BENCH_ENDIAN_VALUE(d_external_type, uint16_t, 2); \
+	BENCH_ENDIAN_VALUE(d_external_type, int16_t, 2); \
+	BENCH_ENDIAN_VALUE(d_external_type, uint32_t, 4); \
+	BENCH_ENDIAN_VALUE(d_external_type, int32_t, 4); \
+	BENCH_ENDIAN_VALUE(d_external_type, uint64_t, 8); \
+	BENCH_ENDIAN_VALUE(d_external_type, int64_t, 8); \
+	AID_BENCHMARK_TEMPLATE(Endian_to_external, d_external_type, float)->arg(sizeof(float)); \
+	AID_BENCHMARK_TEMPLATE(Endian_from_external, d_external_type, float)->arg(sizeof(float)); \
+	AID_BENCHMARK_TEMPLATE(Endian_to_external, d_external_type, double)->arg(sizeof(double)); \
+	AID_BENCHMARK_TEMPLATE(Endian_from_external, d_external_type, double)->arg(sizeof(double)); \
+	AID_BENCHMARK_TEMPLATE(Endian_to_external_fixed, d_external_type, uint32_t, 3); \
+	AID_BENCHMARK_TEMPLATE(Endian_from_external_fixed, d_external_type, uint32_t, 3); \
+	AID_BENCHMARK_TEMPLATE(Endian_to_external_fixed, d_external_type, int64_t, 6); \
+	AID_BENCHMARK_TEMPLATE(Endian_from_external_fixed, d_external_type, int64_t, 6); \
+	AID_BENCHMARK_TEMPLATE(Endian_dynamic_from_external, d_external_type, uint32_t)->dense_range(1, 4); \
+	AID_BENCHMARK_TEMPLATE(Endian_resolved_from_external, d_external_type, uint32_t)->dense_range(1, 4); \
+	BENCH_ENDIAN_BULK(d_external_type, uint16_t); \
+	BENCH_ENDIAN_BULK(d_external_type, int16_t); \
+	BENCH_ENDIAN_BULK(d_external_type, uint32_t); \
+	BENCH_ENDIAN_BULK(d_external_type, int32_t); \
+	BENCH_ENDIAN_BULK(d_external_type, uint64_t); \
+	BENCH_ENDIAN_BULK(d_external_type, int64_t); \
+	BENCH_ENDIAN_BULK(d_external_type, float); \
+	BENCH_ENDIAN_BULK(d_external_type, double)
+
+BENCH_ENDIAN(EndianType::big);
+BENCH_ENDIAN(EndianType::little);
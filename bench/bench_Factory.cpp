@@ -0,0 +1,269 @@
+// -*- tab-width: 4 -*-
+// Factory::create() versus the number of registered identifiers
+#include "Bench.hpp"
+
+#include "aid/ConcurrentFactory.hpp"
+#include "aid/Factory.hpp"
+#include "aid/InplaceCreator.hpp"
+#include "aid/PooledFactory.hpp"
+#include "aid/StaticFactory.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t creates_per_iteration = 1024;
+
+struct Product
+{
+	virtual ~Product() = default;
+};
+
+struct ConcreteProduct: Product {};
+
+unique_ptr<Product> create_product()
+{
+	return unique_ptr<Product>(new ConcreteProduct);
+}
+
+int create_value()
+{
+	return 1;
+}
+
+template<typename Identifier>
+Identifier make_id(size_t i);
+
+template<>
+int make_id<int>(size_t i)
+{
+	return static_cast<int>(i * 7919);
+}
+
+// common prefixes make the comparisons of a map realistic
+template<>
+string make_id<string>(size_t i)
+{
+	return "aid::Product" + to_string(i * 7919);
+}
+
+template<class Factory>
+vector<typename Factory::identifier_type> register_ids(Factory &factory, size_t count,
+													   typename Factory::product_creator_type creator)
+{
+	using Identifier = typename Factory::identifier_type;
+	vector<Identifier> ids;
+	for ( size_t i = 0; i < count; ++i ) {
+		ids.push_back(make_id<Identifier>(i));
+		factory.register_creator(ids.back(), creator);
+	}
+
+	vector<Identifier> lookups;
+	mt19937 engine(count);
+	uniform_int_distribution<size_t> distribution(0, count - 1);
+	for ( size_t i = 0; i < creates_per_iteration; ++i ) {
+		lookups.push_back(ids[distribution(engine)]);
+	}
+	return lookups;
+}
+
+// create() of heap allocated products
+template<typename Identifier>
+void Factory_create(bench::State &state)
+{
+	aid::Factory<unique_ptr<Product>, Identifier> factory;
+	const auto lookups = register_ids(factory, state.range(0), &create_product);
+
+	while ( state.keep_running() ) {
+		for ( const auto &id : lookups ) {
+			bench::do_not_optimize(factory.create(id));
+		}
+	}
+	state.set_items_processed(state.iterations() * lookups.size());
+}
+
+// create() and release of pooled products, against Factory_create
+template<typename Identifier>
+void PooledFactory_create(bench::State &state)
+{
+	aid::PooledFactory<Product, Identifier> factory;
+	const auto lookups = register_ids(factory, state.range(0), &create_product);
+
+	while ( state.keep_running() ) {
+		for ( const auto &id : lookups ) {
+			bench::do_not_optimize(factory.create(id));
+		}
+	}
+	state.set_items_processed(state.iterations() * lookups.size());
+}
+
+template<int t_number>
+struct NumberedProduct: Product {};
+
+using NumberedProducts = aid::TypeList<NumberedProduct<0>, NumberedProduct<1>, NumberedProduct<2>, NumberedProduct<3>,
+									   NumberedProduct<4>, NumberedProduct<5>, NumberedProduct<6>, NumberedProduct<7>>;
+
+// create() of heap allocated products from a TypeList, against Factory_create<int>/8
+void StaticFactory_create(bench::State &state)
+{
+	const aid::StaticFactory<unique_ptr<Product>, NumberedProducts> factory;
+	vector<size_t> lookups;
+	mt19937 engine(NumberedProducts::size);
+	uniform_int_distribution<size_t> distribution(0, NumberedProducts::size - 1);
+	for ( size_t i = 0; i < creates_per_iteration; ++i ) {
+		lookups.push_back(distribution(engine));
+	}
+
+	while ( state.keep_running() ) {
+		for ( const auto id : lookups ) {
+			bench::do_not_optimize(factory.create(id));
+		}
+	}
+	state.set_items_processed(state.iterations() * lookups.size());
+}
+
+template<class Factory>
+void freeze(Factory &) {}
+
+template<typename Identifier, typename ProductCreator, template<typename, class> class FactoryErrorPolicy>
+void freeze(aid::Factory<int, Identifier, ProductCreator, FactoryErrorPolicy, aid::FrozenFactoryLookup> &factory)
+{
+	factory.freeze();
+}
+
+// create() of values, which leaves the cost of the lookup only
+template<typename Identifier, template<typename, typename> class FactoryLookupPolicy>
+void Factory_create_lookup(bench::State &state)
+{
+	aid::Factory<int, Identifier, int (*)(), aid::DefaultFactoryError, FactoryLookupPolicy> factory;
+	const auto lookups = register_ids(factory, state.range(0), &create_value);
+	freeze(factory);
+
+	while ( state.keep_running() ) {
+		int sum = 0;
+		for ( const auto &id : lookups ) {
+			sum += factory.create(id);
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * lookups.size());
+}
+
+// the configuration of a tenant, larger than the local buffer of std::function
+struct TenantConfig
+{
+	long	weights[3];
+};
+
+using ValueCreator = int (*)();
+
+// a creator which captures config
+template<class Creator>
+Creator make_tenant_creator(const TenantConfig &config)
+{
+	return [config]() { return static_cast<int>(config.weights[0]); };
+}
+
+// a function pointer, which cannot capture config
+template<>
+ValueCreator make_tenant_creator<ValueCreator>(const TenantConfig &)
+{
+	return &create_value;
+}
+
+// create() by creators which capture a TenantConfig, against function pointers
+template<class Creator>
+void Factory_create_context(bench::State &state)
+{
+	aid::Factory<int, int, Creator, aid::DefaultFactoryError, aid::HashFactoryLookup> factory;
+	const size_t count = state.range(0);
+	for ( size_t i = 0; i < count; ++i ) {
+		const TenantConfig config{{static_cast<long>(i), 1, 2}};
+		factory.register_creator(make_id<int>(i), make_tenant_creator<Creator>(config));
+	}
+	vector<int> lookups;
+	mt19937 engine(count);
+	uniform_int_distribution<size_t> distribution(0, count - 1);
+	for ( size_t i = 0; i < creates_per_iteration; ++i ) {
+		lookups.push_back(make_id<int>(distribution(engine)));
+	}
+
+	while ( state.keep_running() ) {
+		int sum = 0;
+		for ( const auto id : lookups ) {
+			sum += factory.create(id);
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * lookups.size());
+}
+
+// create() shared by several threads: a Factory behind a mutex, against ConcurrentFactory
+void Factory_create_mutex(bench::State &state)
+{
+	static mutex lock;
+	static aid::Factory<int, int> factory;
+	static const auto lookups = register_ids(factory, 64, &create_value);
+
+	while ( state.keep_running() ) {
+		int sum = 0;
+		for ( const auto id : lookups ) {
+			lock_guard<mutex> guard(lock);
+			sum += factory.create(id);
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * lookups.size());
+}
+
+void ConcurrentFactory_create(bench::State &state)
+{
+	static aid::ConcurrentFactory<int, int> factory;
+	static const auto lookups = register_ids(factory, 64, &create_value);
+
+	while ( state.keep_running() ) {
+		int sum = 0;
+		for ( const auto id : lookups ) {
+			sum += factory.create(id);
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * lookups.size());
+}
+
+unsigned int max_threads()
+{
+	const unsigned int n = thread::hardware_concurrency();
+	return n < 2 ? 2 : n * 2;
+}
+
+} // namespace
+
+
+AID_BENCHMARK_TEMPLATE(Factory_create, int)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(Factory_create, string)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(PooledFactory_create, int)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(PooledFactory_create, string)->range(8, 4096);
+AID_BENCHMARK(StaticFactory_create);
+AID_BENCHMARK_TEMPLATE(Factory_create_lookup, int, aid::MapFactoryLookup)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(Factory_create_lookup, int, aid::HashFactoryLookup)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(Factory_create_lookup, int, aid::FrozenFactoryLookup)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(Factory_create_context, ValueCreator)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(Factory_create_context, function<int ()>)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(Factory_create_context, aid::InplaceCreator<int ()>)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(Factory_create_lookup, string, aid::MapFactoryLookup)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(Factory_create_lookup, string, aid::HashFactoryLookup)->range(8, 4096);
+AID_BENCHMARK_TEMPLATE(Factory_create_lookup, string, aid::FrozenFactoryLookup)->range(8, 4096);
+AID_BENCHMARK(Factory_create_mutex)->thread_range(max_threads());
+AID_BENCHMARK(ConcurrentFactory_create)->thread_range(max_threads());
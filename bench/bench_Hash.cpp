@@ -0,0 +1,82 @@
+// -*- tab-width: 4 -*-
+// hash_word() and hash_bytes() against std::hash, and the buckets of std::hash<BitVector>
+#include "Bench.hpp"
+
+#include "aid/BitVector.hpp"
+#include "aid/Hash.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t keys_per_iteration = 1024;
+
+void Hash_word(bench::State &state)
+{
+	while ( state.keep_running() ) {
+		uint64_t sum = 0;
+		for ( uint64_t key = 0; key < keys_per_iteration; ++key ) {
+			sum += aid::hash_word(key);
+		}
+		bench::do_not_optimize(sum);
+	}
+	state.set_items_processed(state.iterations() * keys_per_iteration);
+}
+
+template<size_t t_size>
+void Hash_bytes(bench::State &state)
+{
+	const string text(t_size, 'x');
+	while ( state.keep_running() ) {
+		bench::do_not_optimize(aid::hash_bytes(text.data(), text.size()));
+	}
+	state.set_bytes_processed(state.iterations() * t_size);
+}
+
+template<size_t t_size>
+void Hash_std_string(bench::State &state)
+{
+	const string text(t_size, 'x');
+	while ( state.keep_running() ) {
+		bench::do_not_optimize(hash<string>{}(text));
+	}
+	state.set_bytes_processed(state.iterations() * t_size);
+}
+
+// keys whose low bits are zero, as the packed fields above bit 8
+void Hash_unordered_set_BitVector(bench::State &state)
+{
+	using BVec = aid::BitVector<uint32_t>;
+	while ( state.keep_running() ) {
+		unordered_set<BVec> set;
+		for ( uint32_t i = 0; i < keys_per_iteration; ++i ) {
+			set.insert(BVec{i << 8});
+		}
+		size_t found = 0;
+		for ( uint32_t i = 0; i < 2 * keys_per_iteration; ++i ) {
+			found += set.count(BVec{i << 8});
+		}
+		bench::do_not_optimize(found);
+	}
+	state.set_items_processed(state.iterations() * keys_per_iteration * 3);
+}
+
+} // namespace
+
+
+AID_BENCHMARK(Hash_word);
+AID_BENCHMARK_TEMPLATE(Hash_bytes, 8);
+AID_BENCHMARK_TEMPLATE(Hash_bytes, 64);
+AID_BENCHMARK_TEMPLATE(Hash_bytes, 4096);
+AID_BENCHMARK_TEMPLATE(Hash_std_string, 8);
+AID_BENCHMARK_TEMPLATE(Hash_std_string, 64);
+AID_BENCHMARK_TEMPLATE(Hash_std_string, 4096);
+AID_BENCHMARK(Hash_unordered_set_BitVector);
@@ -0,0 +1,120 @@
+// -*- tab-width: 4 -*-
+// PackedIntVector bulk unpack/pack with a compile-time and a run-time width, against get/set per element
+#include "Bench.hpp"
+
+#include "aid/PackedIntVector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t element_count = 1 << 16;
+
+template<typename PackedInts>
+void fill(PackedInts &pvec)
+{
+	mt19937 engine(pvec.width());
+	uniform_int_distribution<uint32_t> distribution(0, pvec.max_value());
+	for ( size_t i = 0; i < pvec.size(); ++i ) {
+		pvec.set(i, distribution(engine));
+	}
+}
+
+template<typename PackedInts>
+void set_counters(bench::State &state, const PackedInts &pvec)
+{
+	state.set_items_processed(state.iterations() * pvec.size());
+	state.set_bytes_processed(state.iterations() * pvec.size() * sizeof(uint32_t));
+}
+
+void PackedIntVector_unpack(bench::State &state)
+{
+	aid::DynamicPackedIntVector pvec(static_cast<unsigned int>(state.range(0)), element_count);
+	fill(pvec);
+	vector<uint32_t> values(pvec.size());
+
+	while ( state.keep_running() ) {
+		pvec.unpack(0, values.size(), values.data());
+		bench::clobber_memory();
+	}
+	set_counters(state, pvec);
+}
+
+void PackedIntVector_pack(bench::State &state)
+{
+	aid::DynamicPackedIntVector pvec(static_cast<unsigned int>(state.range(0)), element_count);
+	fill(pvec);
+	vector<uint32_t> values(pvec.size());
+	pvec.unpack(0, values.size(), values.data());
+
+	while ( state.keep_running() ) {
+		pvec.pack(0, values.data(), values.size());
+		bench::clobber_memory();
+	}
+	set_counters(state, pvec);
+}
+
+void PackedIntVector_get(bench::State &state)
+{
+	aid::DynamicPackedIntVector pvec(static_cast<unsigned int>(state.range(0)), element_count);
+	fill(pvec);
+	vector<uint32_t> values(pvec.size());
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < values.size(); ++i ) {
+			values[i] = pvec[i];
+		}
+		bench::clobber_memory();
+	}
+	set_counters(state, pvec);
+}
+
+template<unsigned int t_width>
+void PackedIntVector_unpack_fixed(bench::State &state)
+{
+	aid::PackedIntVector<t_width> pvec(element_count);
+	fill(pvec);
+	vector<uint32_t> values(pvec.size());
+
+	while ( state.keep_running() ) {
+		pvec.unpack(0, values.size(), values.data());
+		bench::clobber_memory();
+	}
+	set_counters(state, pvec);
+}
+
+template<unsigned int t_width>
+void PackedIntVector_pack_fixed(bench::State &state)
+{
+	aid::PackedIntVector<t_width> pvec(element_count);
+	fill(pvec);
+	vector<uint32_t> values(pvec.size());
+	pvec.unpack(0, values.size(), values.data());
+
+	while ( state.keep_running() ) {
+		pvec.pack(0, values.data(), values.size());
+		bench::clobber_memory();
+	}
+	set_counters(state, pvec);
+}
+
+} // namespace
+
+
+AID_BENCHMARK(PackedIntVector_unpack)->arg(3)->arg(13)->arg(25)->arg(31);
+AID_BENCHMARK(PackedIntVector_pack)->arg(3)->arg(13)->arg(25)->arg(31);
+AID_BENCHMARK(PackedIntVector_get)->arg(3)->arg(13)->arg(25)->arg(31);
+AID_BENCHMARK_TEMPLATE(PackedIntVector_unpack_fixed, 3);
+AID_BENCHMARK_TEMPLATE(PackedIntVector_unpack_fixed, 13);
+AID_BENCHMARK_TEMPLATE(PackedIntVector_unpack_fixed, 25);
+AID_BENCHMARK_TEMPLATE(PackedIntVector_unpack_fixed, 31);
+AID_BENCHMARK_TEMPLATE(PackedIntVector_pack_fixed, 3);
+AID_BENCHMARK_TEMPLATE(PackedIntVector_pack_fixed, 13);
+AID_BENCHMARK_TEMPLATE(PackedIntVector_pack_fixed, 25);
+AID_BENCHMARK_TEMPLATE(PackedIntVector_pack_fixed, 31);
@@ -0,0 +1,43 @@
+// -*- tab-width: 4 -*-
+// scaling of parallel_from_external_n() from 1 to hardware_concurrency() threads
+#include "Bench.hpp"
+
+#include "aid/ParallelEndian.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t megabytes = 64;
+
+void ParallelEndian_from_external_n(bench::State &state)
+{
+	const size_t count = megabytes * 1024 * 1024 / sizeof(uint32_t);
+	vector<unsigned char> big(count * sizeof(uint32_t), 0x5A);
+	vector<uint32_t> native(count);
+	const aid::EndianConverter<aid::EndianType::big> converter{};
+	aid::WorkerPool pool(state.range(0));
+
+	while ( state.keep_running() ) {
+		aid::parallel_from_external_n(pool, converter, big.data(), count, native.data());
+		bench::clobber_memory();
+	}
+	state.set_bytes_processed(state.iterations() * big.size());
+}
+
+unsigned int max_threads()
+{
+	const unsigned int n = thread::hardware_concurrency();
+	return n == 0 ? 1 : n;
+}
+
+} // namespace
+
+
+AID_BENCHMARK(ParallelEndian_from_external_n)->range(1, max_threads(), 2);
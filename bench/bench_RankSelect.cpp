@@ -0,0 +1,123 @@
+// -*- tab-width: 4 -*-
+// RankSelect::rank1() and select1() against a linear popcount scan
+#include "Bench.hpp"
+
+#include "aid/RankSelect.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t queries_per_iteration = 256;
+
+aid::DynamicBitVector make_bits(size_t size)
+{
+	mt19937_64 engine(size);
+	aid::DynamicBitVector bits(size);
+	for ( size_t i = 0; i < size; ++i ) {
+		if ( engine() % 2 == 0 ) bits.set(i);
+	}
+	return bits;
+}
+
+vector<size_t> make_queries(size_t limit)
+{
+	mt19937_64 engine(limit);
+	uniform_int_distribution<size_t> distribution(0, limit - 1);
+	vector<size_t> queries(queries_per_iteration);
+	for ( size_t &query : queries ) {
+		query = distribution(engine);
+	}
+	return queries;
+}
+
+size_t linear_rank1(const aid::DynamicBitVector &bits, size_t index)
+{
+	const uint64_t * const words = bits.data();
+	size_t rank = 0;
+	for ( size_t i = 0; i < index / 64; ++i ) {
+		rank += aid::BitVector_impl::popcount(words[i]);
+	}
+	if ( index % 64 != 0 ) {
+		rank += aid::BitVector_impl::popcount(words[index / 64] << (64 - index % 64));
+	}
+	return rank;
+}
+
+size_t linear_select1(const aid::DynamicBitVector &bits, size_t rank)
+{
+	const uint64_t * const words = bits.data();
+	for ( size_t i = 0; ; ++i ) {
+		const size_t n = aid::BitVector_impl::popcount(words[i]);
+		if ( rank < n ) {
+			return i * 64 + aid::RankSelect_impl::select_in_word(words[i], static_cast<unsigned int>(rank));
+		}
+		rank -= n;
+	}
+}
+
+void RankSelect_rank1(bench::State &state)
+{
+	const aid::RankSelect index(make_bits(state.range(0)));
+	const vector<size_t> queries = make_queries(index.size());
+
+	while ( state.keep_running() ) {
+		for ( size_t query : queries ) {
+			bench::do_not_optimize(index.rank1(query));
+		}
+	}
+	state.set_items_processed(state.iterations() * queries.size());
+}
+
+void RankSelect_select1(bench::State &state)
+{
+	const aid::RankSelect index(make_bits(state.range(0)));
+	const vector<size_t> queries = make_queries(index.count());
+
+	while ( state.keep_running() ) {
+		for ( size_t query : queries ) {
+			bench::do_not_optimize(index.select1(query));
+		}
+	}
+	state.set_items_processed(state.iterations() * queries.size());
+}
+
+void RankSelect_linear_rank1(bench::State &state)
+{
+	const aid::DynamicBitVector bits = make_bits(state.range(0));
+	const vector<size_t> queries = make_queries(bits.size());
+
+	while ( state.keep_running() ) {
+		for ( size_t query : queries ) {
+			bench::do_not_optimize(linear_rank1(bits, query));
+		}
+	}
+	state.set_items_processed(state.iterations() * queries.size());
+}
+
+void RankSelect_linear_select1(bench::State &state)
+{
+	const aid::DynamicBitVector bits = make_bits(state.range(0));
+	const vector<size_t> queries = make_queries(bits.count());
+
+	while ( state.keep_running() ) {
+		for ( size_t query : queries ) {
+			bench::do_not_optimize(linear_select1(bits, query));
+		}
+	}
+	state.set_items_processed(state.iterations() * queries.size());
+}
+
+} // namespace
+
+
+AID_BENCHMARK(RankSelect_rank1)->range(1 << 16, 1 << 26, 32);
+AID_BENCHMARK(RankSelect_select1)->range(1 << 16, 1 << 26, 32);
+AID_BENCHMARK(RankSelect_linear_rank1)->range(1 << 16, 1 << 26, 32);
+AID_BENCHMARK(RankSelect_linear_select1)->range(1 << 16, 1 << 26, 32);
@@ -0,0 +1,45 @@
+// -*- tab-width: 4 -*-
+// Singleton::instance() called concurrently from several threads
+#include "Bench.hpp"
+
+#include "aid/Singleton.hpp"
+
+#include <cstddef>
+#include <thread>
+
+using namespace std;
+
+
+namespace {
+
+constexpr size_t calls_per_iteration = 1024;
+
+struct Object
+{
+	int value = 1;
+};
+
+using ObjectHolder = aid::Singleton<Object>;
+
+void Singleton_instance(bench::State &state)
+{
+	ObjectHolder::instance();
+
+	while ( state.keep_running() ) {
+		for ( size_t i = 0; i < calls_per_iteration; ++i ) {
+			bench::do_not_optimize(&ObjectHolder::instance());
+		}
+	}
+	state.set_items_processed(state.iterations() * calls_per_iteration);
+}
+
+unsigned int max_threads()
+{
+	const unsigned int n = thread::hardware_concurrency();
+	return n < 2 ? 2 : n * 2;
+}
+
+} // namespace
+
+
+AID_BENCHMARK(Singleton_instance)->thread_range(max_threads());
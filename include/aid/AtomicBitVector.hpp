@@ -0,0 +1,234 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file AtomicBitVector.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_AtomicBitVector_hpp
+#define aid_AtomicBitVector_hpp
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include "aid/BitVector.hpp"
+#include "aid/DynamicBitVector.hpp"
+#include "aid/NonCopyable.hpp"
+
+
+namespace aid {
+
+/*!
+  @brief		BitVector whose sections are updated atomically
+  @details		fetch_or() and fetch_and() are single atomic instructions.
+				set(), exchange(), compare_exchange() and acquire_first_free()
+				retry a compare-and-swap until no other thread has changed the
+				word in between, so threads may update different sections of
+				the same word concurrently.
+ */
+template<typename DataType>
+class AtomicBitVector
+	: private NonCopyable
+{
+  public:
+	using data_type		= DataType;
+	using offset_type	= typename BitVector<DataType>::offset_type;
+	using Section		= typename BitVector<DataType>::Section;
+
+	//! acquire_first_free() found no clear bit
+	static constexpr offset_type npos{static_cast<offset_type>(-1)};
+
+  private:
+	using mask_type	= typename Section::mask_type;
+
+	static constexpr offset_type data_bits{sizeof(data_type) * CHAR_BIT};
+
+  public:
+	static constexpr Section create_section(offset_type first, offset_type last) {
+		return BitVector<DataType>::create_section(first, last);
+	}
+
+	static constexpr Section create_section(offset_type first) {
+		return BitVector<DataType>::create_section(first);
+	}
+
+  private:
+	std::atomic<data_type>	m_data;
+
+  public:
+	AtomicBitVector() noexcept
+		: m_data{0}
+	{}
+
+	explicit AtomicBitVector(data_type data) noexcept
+		: m_data{data}
+	{}
+
+	explicit AtomicBitVector(BitVector<DataType> bvec) noexcept
+		: m_data{bvec.get()}
+	{}
+
+  public:
+	bool is_lock_free() const noexcept {
+		return m_data.is_lock_free();
+	}
+
+	data_type get(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+		return m_data.load(order);
+	}
+
+	data_type get(const Section &section, std::memory_order order = std::memory_order_seq_cst) const noexcept {
+		return (m_data.load(order) & section.mask) >> section.offset;
+	}
+
+	//! a snapshot of all the sections
+	BitVector<DataType> load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+		return BitVector<DataType>(m_data.load(order));
+	}
+
+	void store(BitVector<DataType> bvec, std::memory_order order = std::memory_order_seq_cst) noexcept {
+		m_data.store(bvec.get(), order);
+	}
+
+	/*!
+	  @brief		replace the bits of a section, leaving the other sections intact
+	  @exception	std::overflow_error	value does not fit in the section (only without NDEBUG)
+	 */
+	void set(const Section &section, data_type value, std::memory_order order = std::memory_order_seq_cst) {
+		exchange(section, value, order);
+	}
+
+	/*!
+	  @brief		set() which returns the previous value of the section
+	  @exception	std::overflow_error	value does not fit in the section (only without NDEBUG)
+	 */
+	data_type exchange(const Section &section, data_type value, std::memory_order order = std::memory_order_seq_cst) {
+		const data_type shifted_value{shift(section, value)};
+		data_type expected{m_data.load(std::memory_order_relaxed)};
+		while ( !m_data.compare_exchange_weak(expected, static_cast<data_type>((expected & ~section.mask) | shifted_value),
+											  order, failure_order(order)) ) {
+		}
+		return (expected & section.mask) >> section.offset;
+	}
+
+	/*!
+	  @brief		set the section to desired if it is expected
+	  @param[in,out]	expected	expected value of the section; the actual value on failure
+	  @return		the section was expected and has been replaced
+	  @exception	std::overflow_error	expected or desired does not fit in the section (only without NDEBUG)
+	 */
+	bool compare_exchange(const Section &section, data_type &expected, data_type desired,
+						  std::memory_order order = std::memory_order_seq_cst) {
+		const data_type shifted_expected{shift(section, expected)};
+		const data_type shifted_desired{shift(section, desired)};
+		data_type current{m_data.load(std::memory_order_relaxed)};
+		do {
+			if ( (current & section.mask) != shifted_expected ) {
+				std::atomic_thread_fence(failure_order(order));
+				expected = (current & section.mask) >> section.offset;
+				return false;
+			}
+		} while ( !m_data.compare_exchange_weak(current, static_cast<data_type>((current & ~section.mask) | shifted_desired),
+												order, failure_order(order)) );
+		return true;
+	}
+
+	/*!
+	  @brief		OR bits into a section
+	  @return		previous value of the section
+	  @exception	std::overflow_error	bits does not fit in the section (only without NDEBUG)
+	 */
+	data_type fetch_or(const Section &section, data_type bits, std::memory_order order = std::memory_order_seq_cst) {
+		return (m_data.fetch_or(shift(section, bits), order) & section.mask) >> section.offset;
+	}
+
+	/*!
+	  @brief		AND bits into a section, leaving the other sections intact
+	  @return		previous value of the section
+	  @exception	std::overflow_error	bits does not fit in the section (only without NDEBUG)
+	 */
+	data_type fetch_and(const Section &section, data_type bits, std::memory_order order = std::memory_order_seq_cst) {
+		return (m_data.fetch_and(static_cast<data_type>(shift(section, bits) | ~section.mask), order)
+				& section.mask) >> section.offset;
+	}
+
+	/*!
+	  @brief		set the lowest clear bit of a section
+	  @details		Typical for a slot allocation bitmap: the returned bit is owned
+					by the caller until release() clears it. The default order
+					is acquire, which pairs with the release order of release().
+	  @return		offset of the acquired bit in the word, or npos if every bit of the section is set
+	 */
+	offset_type acquire_first_free(const Section &section, std::memory_order order = std::memory_order_acquire) noexcept {
+		data_type expected{m_data.load(std::memory_order_relaxed)};
+		for ( ;; ) {
+			const data_type free{static_cast<data_type>(~expected & section.mask)};
+			if ( free == 0 ) {
+				std::atomic_thread_fence(failure_order(order));
+				return npos;
+			}
+			const data_type lowest{static_cast<data_type>(free & (~free + 1))};
+			if ( m_data.compare_exchange_weak(expected, static_cast<data_type>(expected | lowest),
+											  order, failure_order(order)) ) {
+				return static_cast<offset_type>(BitVector_impl::count_trailing_zeros(lowest));
+			}
+		}
+	}
+
+	//! acquire_first_free() of the whole word
+	offset_type acquire_first_free(std::memory_order order = std::memory_order_acquire) noexcept {
+		return acquire_first_free(Section(static_cast<mask_type>(~mask_type{0})), order);
+	}
+
+	/*!
+	  @brief		clear a bit set by acquire_first_free()
+	  @exception	std::out_of_range	offset >= sizeof(data_type) * CHAR_BIT
+	 */
+	void release(offset_type offset, std::memory_order order = std::memory_order_release) {
+		if ( offset >= data_bits ) throw std::out_of_range("offset >= sizeof(data_type) * CHAR_BIT");
+		m_data.fetch_and(static_cast<data_type>(~(data_type{1} << offset)), order);
+	}
+
+  private:
+	static data_type shift(const Section &section, data_type value) {
+		data_type shifted_value = value << section.offset;
+#ifdef NDEBUG
+		shifted_value &= section.mask;
+#else
+		if ( value != (value & (section.mask >> section.offset)) ) {
+			throw std::overflow_error("data_type value");
+		}
+#endif
+		return shifted_value;
+	}
+
+	//! the strongest order allowed for a failed compare-and-swap
+	static constexpr std::memory_order failure_order(std::memory_order order) noexcept {
+		return order == std::memory_order_acq_rel ? std::memory_order_acquire
+			: order == std::memory_order_release ? std::memory_order_relaxed
+			: order;
+	}
+}; // class AtomicBitVector
+
+template<typename DataType>
+constexpr typename AtomicBitVector<DataType>::offset_type AtomicBitVector<DataType>::npos;
+
+template<typename DataType>
+constexpr typename AtomicBitVector<DataType>::offset_type AtomicBitVector<DataType>::data_bits;
+
+} // namespace aid
+
+
+#endif // aid_AtomicBitVector_hpp
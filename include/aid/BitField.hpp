@@ -0,0 +1,314 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file BitField.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_BitField_hpp
+#define aid_BitField_hpp
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include "aid/TypeList.hpp"
+
+#if		defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+
+namespace aid {
+
+/*!
+  @brief		bits [t_first, t_last] of a word, fixed at compile time
+  @details		The mask is a closed form, so get and set fold to a shift and a mask.
+ */
+template<unsigned int t_first, unsigned int t_last = t_first>
+struct BitField
+{
+	static_assert(t_first <= t_last, "t_first > t_last");
+	static_assert(t_last < 64, "t_last >= 64");
+
+	static constexpr unsigned int first{t_first};
+	static constexpr unsigned int last{t_last};
+	static constexpr unsigned int width{t_last - t_first + 1};
+
+	template<typename DataType>
+	static constexpr DataType mask() noexcept {
+		static_assert(t_last < sizeof(DataType) * CHAR_BIT, "t_last >= sizeof(DataType) * CHAR_BIT");
+		return static_cast<DataType>((~0ull >> (64 - width)) << first);
+	}
+}; // struct BitField
+
+template<unsigned int t_first, unsigned int t_last>
+constexpr unsigned int BitField<t_first, t_last>::first;
+
+template<unsigned int t_first, unsigned int t_last>
+constexpr unsigned int BitField<t_first, t_last>::last;
+
+template<unsigned int t_first, unsigned int t_last>
+constexpr unsigned int BitField<t_first, t_last>::width;
+
+namespace BitField_impl {
+
+/*!
+  @brief		value shifted into a field
+  @exception	std::overflow_error	value does not fit in the field (only without NDEBUG)
+ */
+template<typename TField, typename DataType>
+constexpr DataType shift(DataType value)
+{
+#ifdef NDEBUG
+	return static_cast<DataType>((value << TField::first) & TField::template mask<DataType>());
+#else
+	return value != (value & (TField::template mask<DataType>() >> TField::first))
+		? throw std::overflow_error("data_type value")
+		: static_cast<DataType>(value << TField::first);
+#endif
+}
+
+//! union of the masks of the fields, and whether two of them overlap
+template<typename DataType, typename TFields>
+struct LayoutMask;
+
+template<typename DataType>
+struct LayoutMask<DataType, TypeList<>>
+{
+	static constexpr DataType value{0};
+	static constexpr bool overlaps{false};
+};
+
+template<typename DataType, typename THead, typename... TTail>
+struct LayoutMask<DataType, TypeList<THead, TTail...>>
+{
+	using Tail	= LayoutMask<DataType, TypeList<TTail...>>;
+
+	static constexpr DataType value{static_cast<DataType>(THead::template mask<DataType>() | Tail::value)};
+	static constexpr bool overlaps{Tail::overlaps || (THead::template mask<DataType>() & Tail::value) != 0};
+};
+
+template<typename DataType>
+constexpr DataType bit_or() noexcept
+{
+	return 0;
+}
+
+template<typename DataType, typename... TRest>
+constexpr DataType bit_or(DataType head, TRest... rest) noexcept
+{
+	return static_cast<DataType>(head | bit_or<DataType>(rest...));
+}
+
+constexpr unsigned int sum() noexcept
+{
+	return 0;
+}
+
+template<typename... TRest>
+constexpr unsigned int sum(unsigned int head, TRest... rest) noexcept
+{
+	return head + sum(rest...);
+}
+
+constexpr bool all() noexcept
+{
+	return true;
+}
+
+template<typename... TRest>
+constexpr bool all(bool head, TRest... rest) noexcept
+{
+	return head && all(rest...);
+}
+
+//! value shifted from bit from to bit to
+template<typename DataType, typename TValue>
+constexpr DataType move(TValue value, unsigned int from, unsigned int to) noexcept
+{
+	return from >= to
+		? static_cast<DataType>(value >> (from - to))
+		: static_cast<DataType>(static_cast<DataType>(value) << (to - from));
+}
+
+#if		defined(__BMI2__)
+
+//! the bits of data under mask, packed from bit 0
+template<typename DataType>
+inline DataType pext(DataType data, DataType mask) noexcept
+{
+	return static_cast<DataType>(sizeof(DataType) > sizeof(std::uint32_t)
+								 ? _pext_u64(data, mask)
+								 : _pext_u32(static_cast<std::uint32_t>(data), static_cast<std::uint32_t>(mask)));
+}
+
+//! the low bits of bits spread to the bits of mask
+template<typename DataType>
+inline DataType pdep(DataType bits, DataType mask) noexcept
+{
+	return static_cast<DataType>(sizeof(DataType) > sizeof(std::uint32_t)
+								 ? _pdep_u64(bits, mask)
+								 : _pdep_u32(static_cast<std::uint32_t>(bits), static_cast<std::uint32_t>(mask)));
+}
+
+#endif	// __BMI2__
+
+} // namespace BitField_impl
+
+template<typename DataType, typename TFields>
+class BitLayout;
+
+/*!
+  @brief		record of non-overlapping BitFields packed in a DataType
+  @details		For example
+				@code
+				using Header = BitLayout<std::uint16_t, TypeList<BitField<0, 3>, BitField<4, 11>, BitField<12, 15>>>;
+				constexpr std::uint16_t word{Header::pack(1, 0x23, 4)};
+				@endcode
+  @tparam		DataType	unsigned integral type
+  @tparam		TFields		TypeList of BitFields
+ */
+template<typename DataType, typename... TFields>
+class BitLayout<DataType, TypeList<TFields...>>
+{
+	static_assert(std::is_integral<DataType>::value
+				  && std::is_unsigned<DataType>::value,
+				  "DataType is not unsigned integral type");
+	static_assert(!BitField_impl::LayoutMask<DataType, TypeList<TFields...>>::overlaps, "fields overlap");
+
+  public:
+	using data_type	= DataType;
+	using fields	= TypeList<TFields...>;
+
+	//! the bits of all the fields
+	static constexpr data_type mask{BitField_impl::LayoutMask<DataType, fields>::value};
+
+	//! the bits of all the fields, counted
+	static constexpr unsigned int width{BitField_impl::sum(TFields::width...)};
+
+	//! number of the fields below TField
+	template<typename TField>
+	static constexpr unsigned int rank() noexcept {
+		return BitField_impl::sum((TFields::first < TField::first ? 1u : 0u)...);
+	}
+
+	//! bit of TField in extract()
+	template<typename TField>
+	static constexpr unsigned int offset() noexcept {
+		return BitField_impl::sum((TFields::first < TField::first ? TFields::width : 0u)...);
+	}
+
+	//! width of the field of rank() r
+	static constexpr unsigned int width_at(unsigned int r) noexcept {
+		return BitField_impl::sum((rank<TFields>() == r ? TFields::width : 0u)...);
+	}
+
+	//! first bit of the field of rank() r
+	static constexpr unsigned int first_at(unsigned int r) noexcept {
+		return BitField_impl::sum((rank<TFields>() == r ? TFields::first : 0u)...);
+	}
+
+	template<typename TField>
+	static constexpr data_type get(data_type data) noexcept {
+		return static_cast<data_type>((data & TField::template mask<data_type>()) >> TField::first);
+	}
+
+	/*!
+	  @brief		data with a field replaced
+	  @exception	std::overflow_error	value does not fit in the field (only without NDEBUG)
+	 */
+	template<typename TField>
+	static constexpr data_type set(data_type data, data_type value) {
+		return static_cast<data_type>((data & ~TField::template mask<data_type>())
+									  | BitField_impl::shift<TField>(value));
+	}
+
+	/*!
+	  @brief		a word from a value per field, in the order of the fields
+	  @exception	std::overflow_error	a value does not fit in its field (only without NDEBUG)
+	 */
+	template<typename... TValues>
+	static constexpr data_type pack(TValues... values) {
+		static_assert(sizeof...(TValues) == sizeof...(TFields), "a value per field");
+		return BitField_impl::bit_or<data_type>(BitField_impl::shift<TFields>(static_cast<data_type>(values))...);
+	}
+
+	/*!
+	  @brief		the values of the fields, in the order of the fields
+	 */
+	template<typename... TValues>
+	static void unpack(data_type data, TValues &... values) noexcept {
+		static_assert(sizeof...(TValues) == sizeof...(TFields), "a value per field");
+		const int expand[]{0, (values = static_cast<TValues>(get<TFields>(data)), 0)...};
+		static_cast<void>(expand);
+	}
+
+	/*!
+	  @brief		all the fields of data packed back to back from bit 0, the lowest field first
+	  @details		A single pext with BMI2, otherwise a mask and a shift per field.
+	 */
+	static data_type extract(data_type data) noexcept {
+#if		defined(__BMI2__)
+		return BitField_impl::pext(data, mask);
+#else
+		return BitField_impl::bit_or<data_type>(
+			static_cast<data_type>((data & TFields::template mask<data_type>()) >> (TFields::first - offset<TFields>()))...);
+#endif
+	}
+
+	/*!
+	  @brief		the inverse of extract(): bits spread to the fields, other bits zero
+	  @details		A single pdep with BMI2, otherwise a shift and a mask per field.
+	 */
+	static data_type deposit(data_type bits) noexcept {
+#if		defined(__BMI2__)
+		return BitField_impl::pdep(bits, mask);
+#else
+		return BitField_impl::bit_or<data_type>(
+			static_cast<data_type>((bits << (TFields::first - offset<TFields>())) & TFields::template mask<data_type>())...);
+#endif
+	}
+
+	/*!
+	  @brief		the fields of data moved to the fields of TLayout
+	  @details		The n-th lowest field goes to the n-th lowest field of
+					TLayout, which must be as wide. For example a control word
+					is decoded into a byte per field. Each field is a mask and
+					a shift by a constant, which the compiler merges for the
+					fields moving by the same distance; this measured faster
+					than a pext and a pdep.
+	 */
+	template<typename TLayout>
+	static constexpr typename TLayout::data_type transcode(data_type data) noexcept {
+		static_assert(width == TLayout::width
+					  && BitField_impl::all((TFields::width == TLayout::width_at(rank<TFields>()))...),
+					  "the fields of TLayout differ in width");
+		return BitField_impl::bit_or<typename TLayout::data_type>(
+			BitField_impl::move<typename TLayout::data_type>(data & TFields::template mask<data_type>(),
+															 TFields::first, TLayout::first_at(rank<TFields>()))...);
+	}
+}; // class BitLayout
+
+template<typename DataType, typename... TFields>
+constexpr DataType BitLayout<DataType, TypeList<TFields...>>::mask;
+
+template<typename DataType, typename... TFields>
+constexpr unsigned int BitLayout<DataType, TypeList<TFields...>>::width;
+
+} // namespace aid
+
+
+#endif // aid_BitField_hpp
@@ -0,0 +1,610 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file BitStream.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_BitStream_hpp
+#define aid_BitStream_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "aid/Endian.hpp"
+
+
+namespace aid {
+
+/*!
+  @brief		order of the bits of a field in a byte sequence
+  @details		msb_first fills each byte from bit 7 and puts the most
+				significant bit of a field first (H.264, ASN.1 PER);
+				lsb_first fills each byte from bit 0 and puts the least
+				significant bit first (Deflate).
+ */
+enum class BitOrder: unsigned char
+{
+	msb_first
+	, lsb_first
+};
+
+namespace BitStream_impl {
+
+using cache_type	= std::uint64_t;
+
+//! bits of a field read or written in one step; longer fields are split
+constexpr unsigned int step_bits{56};
+
+constexpr cache_type low_mask(unsigned int bits) noexcept
+{
+	return bits == 0 ? 0 : ~cache_type{0} >> (64 - bits);
+}
+
+//! @pre	bits != 0
+inline unsigned int count_leading_zeros(cache_type bits) noexcept
+{
+#if		defined(__GNUC__)
+	return static_cast<unsigned int>(__builtin_clzll(bits));
+#else
+	unsigned int n{0};
+	for ( ; (bits >> 63) == 0; bits <<= 1 ) ++n;
+	return n;
+#endif
+}
+
+//! @pre	bits != 0
+inline unsigned int count_trailing_zeros(cache_type bits) noexcept
+{
+#if		defined(__GNUC__)
+	return static_cast<unsigned int>(__builtin_ctzll(bits));
+#else
+	unsigned int n{0};
+	for ( ; (bits & 1) == 0; bits >>= 1 ) ++n;
+	return n;
+#endif
+}
+
+/*!
+  @brief		the cache as seen by an order
+  @details		The next bit of the stream is bit 63 of the cache for
+				msb_first and bit 0 for lsb_first.
+ */
+template<BitOrder t_order>
+struct Cache;
+
+//! 8 bytes in the native byte order or swapped (a memcpy is a single load or store)
+template<EndianType t_external_type>
+struct Bytes
+{
+	static cache_type load(const unsigned char *external) noexcept {
+		cache_type bytes;
+		std::memcpy(&bytes, external, sizeof(bytes));
+		return t_external_type == Endian_impl::native_type() ? bytes : Endian_impl::byte_swap(bytes);
+	}
+
+	static void store(cache_type bytes, unsigned char *external) noexcept {
+		bytes = t_external_type == Endian_impl::native_type() ? bytes : Endian_impl::byte_swap(bytes);
+		std::memcpy(external, &bytes, sizeof(bytes));
+	}
+};
+
+template<>
+struct Cache<BitOrder::msb_first>
+{
+	using Bytes = BitStream_impl::Bytes<EndianType::big>;
+
+	//! bytes at the bit offset (from the next bit) of the cache
+	static cache_type place(cache_type bytes, unsigned int offset) noexcept {
+		return bytes >> offset;
+	}
+
+	//! @pre	bits <= 56
+	static cache_type first(cache_type cache, unsigned int bits) noexcept {
+		return (cache >> 1) >> (63 - bits);
+	}
+
+	//! the field of bits at the bit offset of loaded bytes
+	//! @pre	0 < bits <= 56, offset < 8
+	static cache_type field(cache_type bytes, unsigned int offset, unsigned int bits) noexcept {
+		return (bytes << offset) >> (64 - bits);
+	}
+
+	static cache_type drop(cache_type cache, unsigned int bits) noexcept {
+		return cache << bits;
+	}
+
+	//! the first bits of the cache set
+	//! @pre	bits < 64
+	static cache_type head(unsigned int bits) noexcept {
+		return ~(~cache_type{0} >> bits);
+	}
+
+	//! @pre	offset + bits <= 64, 0 < bits
+	static cache_type put(cache_type value, unsigned int offset, unsigned int bits) noexcept {
+		return value << (64 - offset - bits);
+	}
+
+	//! @pre	cache != 0
+	static unsigned int zeros(cache_type cache) noexcept {
+		return count_leading_zeros(cache);
+	}
+
+	//! the first byte of the cache
+	static unsigned char byte(cache_type cache) noexcept {
+		return static_cast<unsigned char>(cache >> 56);
+	}
+
+	//! a byte as the first byte of a cache
+	static cache_type front(unsigned char byte) noexcept {
+		return cache_type{byte} << 56;
+	}
+};
+
+template<>
+struct Cache<BitOrder::lsb_first>
+{
+	using Bytes = BitStream_impl::Bytes<EndianType::little>;
+
+	static cache_type place(cache_type bytes, unsigned int offset) noexcept {
+		return bytes << offset;
+	}
+
+	static cache_type first(cache_type cache, unsigned int bits) noexcept {
+		return cache & ((cache_type{1} << bits) - 1);
+	}
+
+	static cache_type field(cache_type bytes, unsigned int offset, unsigned int bits) noexcept {
+		return (bytes << (64 - offset - bits)) >> (64 - bits);
+	}
+
+	static cache_type drop(cache_type cache, unsigned int bits) noexcept {
+		return cache >> bits;
+	}
+
+	static cache_type head(unsigned int bits) noexcept {
+		return ~(~cache_type{0} << bits);
+	}
+
+	static cache_type put(cache_type value, unsigned int offset, unsigned int) noexcept {
+		return value << offset;
+	}
+
+	static unsigned int zeros(cache_type cache) noexcept {
+		return count_trailing_zeros(cache);
+	}
+
+	static unsigned char byte(cache_type cache) noexcept {
+		return static_cast<unsigned char>(cache);
+	}
+
+	static cache_type front(unsigned char byte) noexcept {
+		return cache_type{byte};
+	}
+};
+
+} // namespace BitStream_impl
+
+/*!
+  @brief		cursor which reads fields of any number of bits from a memory block
+  @details		A read of 1 to 56 bits while 8 bytes are left from the position
+				is one check, a load of the 8 bytes around the position and two
+				shifts. The loads depend only on the position, not on a cache
+				refilled by the previous read, so the reads of mixed widths
+				overlap. The other reads (0 or more than 56 bits, the last 7
+				bytes) take a slower path, which is inlined as well so that the
+				position stays in a register.
+  @tparam		t_order	order of the bits
+ */
+template<BitOrder t_order = BitOrder::msb_first>
+class BitReader
+{
+	using Cache	= BitStream_impl::Cache<t_order>;
+
+  public:
+	using cache_type	= BitStream_impl::cache_type;
+
+  private:
+	const unsigned char	*m_begin;
+	std::size_t			m_size;			// in bytes
+	std::size_t			m_fast_end;		// bits before which 8 bytes can be loaded
+	std::size_t			m_position;		// in bits
+
+  public:
+	/*!
+	  @brief		construct a reader of a memory block
+	  @param[in]	data	pointer to the beginning of the block
+	  @param[in]	size	size of the block in bytes
+	  @exception	std::invalid_argument	data == nullptr && size > 0
+	 */
+	BitReader(const unsigned char *data, std::size_t size)
+		: m_begin{data}, m_size{size}, m_fast_end{size >= 8 ? (size - 7) * 8 : 0}, m_position{0}
+	{
+		if ( data == nullptr && size > 0 ) throw std::invalid_argument("data == nullptr");
+	}
+
+  public:
+	/*!
+	  @brief		get the number of the bits read so far
+	 */
+	std::size_t position() const noexcept {
+		return m_position;
+	}
+
+	/*!
+	  @brief		get the number of the bits left
+	 */
+	std::size_t available() const noexcept {
+		return m_size * 8 - m_position;
+	}
+
+	bool eof() const noexcept {
+		return available() == 0;
+	}
+
+	/*!
+	  @brief		the next bits without reading them
+	  @exception	std::invalid_argument	bits > 56
+	  @exception	std::out_of_range		the stream ends before bits
+	 */
+	cache_type peek(unsigned int bits) const {
+		if ( bits > BitStream_impl::step_bits ) throw std::invalid_argument("bits > 56");
+		require(bits);
+		return Cache::first(cache(), bits);
+	}
+
+	/*!
+	  @brief		read a field
+	  @param[in]	bits	width of the field (0 to 64)
+	  @exception	std::invalid_argument	bits > 64
+	  @exception	std::out_of_range		the stream ends before bits
+	 */
+	cache_type read(unsigned int bits) {
+		// (bits - 1 wraps for 0, so that only 1 to 56 bits are read here)
+		if ( bits - 1 < BitStream_impl::step_bits && m_position < m_fast_end ) {
+			const cache_type value{Cache::field(Cache::Bytes::load(m_begin + m_position / 8),
+				static_cast<unsigned int>(m_position % 8), bits)};
+			m_position += bits;
+			return value;
+		}
+		if ( bits > BitStream_impl::step_bits ) {
+			return read_long(bits);
+		}
+		return read_short(bits);
+	}
+
+	/*!
+	  @exception	std::out_of_range	the stream ends
+	 */
+	bool read_bit() {
+		return read(1) != 0;
+	}
+
+	/*!
+	  @brief		read zeros terminated by a one
+	  @return		number of the zeros
+	  @exception	std::out_of_range	the stream ends before a one
+	 */
+	std::size_t read_unary() {
+		std::size_t zeros{0};
+		for ( ; ; ) {
+			require(1);
+			// a cache holds at least 57 bits of the stream, the rest may be zero padding
+			const std::size_t valid{available() < 57 ? available() : 57};
+			const cache_type bits{cache()};
+			const unsigned int n{bits == 0 ? 64 : Cache::zeros(bits)};
+			if ( n < valid ) {
+				m_position += n + 1;
+				return zeros + n;
+			}
+			zeros += valid;
+			m_position += valid;
+		}
+	}
+
+	/*!
+	  @brief		read an unsigned Exp-Golomb code (ue(v) of H.264)
+	  @exception	std::overflow_error	the code has more than 63 leading zeros
+	  @exception	std::out_of_range	the stream ends in the code
+	 */
+	std::uint64_t read_ue() {
+		if ( m_position < m_fast_end ) {
+			// the cache holds at least 57 bits of the stream, so a code of up to 57 bits is in it
+			const cache_type bits{cache()};
+			const unsigned int n{bits == 0 ? 64 : Cache::zeros(bits)};
+			if ( n <= 28 ) {
+				m_position += 2 * n + 1;
+				return ((cache_type{1} << n) | Cache::first(Cache::drop(bits, n + 1), n)) - 1;
+			}
+		}
+		const std::size_t zeros{read_unary()};
+		if ( zeros > 63 ) throw std::overflow_error("Exp-Golomb code > 64 bits");
+		const unsigned int bits{static_cast<unsigned int>(zeros)};
+		return ((cache_type{1} << bits) | read(bits)) - 1;
+	}
+
+	/*!
+	  @brief		read a signed Exp-Golomb code (se(v) of H.264): 0, 1, -1, 2, -2, ...
+	  @exception	std::overflow_error	the code has more than 63 leading zeros
+	  @exception	std::out_of_range	the stream ends in the code
+	 */
+	std::int64_t read_se() {
+		const std::uint64_t k{read_ue()};
+		const std::int64_t magnitude{static_cast<std::int64_t>(k / 2 + (k & 1))};
+		return (k & 1) != 0 ? magnitude : -magnitude;
+	}
+
+	/*!
+	  @brief		skip bits
+	  @exception	std::out_of_range	the stream ends before bits
+	 */
+	BitReader &skip(std::size_t bits) {
+		if ( bits > available() ) throw std::out_of_range("end of stream");
+		m_position += bits;
+		return *this;
+	}
+
+	/*!
+	  @brief		skip to the next byte boundary
+	 */
+	BitReader &align() noexcept {
+		m_position = (m_position + 7) & ~std::size_t{7};
+		return *this;
+	}
+
+  private:
+	void require(std::size_t bits) const {
+		if ( bits > available() ) end_of_stream();
+	}
+
+	// kept out of read() so that read() is inlined
+	[[noreturn]] static void end_of_stream() {
+		throw std::out_of_range("end of stream");
+	}
+
+	//! @pre	bits <= 56
+	cache_type read_short(unsigned int bits) {
+		require(bits);
+		const cache_type value{Cache::first(cache(), bits)};
+		m_position += bits;
+		return value;
+	}
+
+	cache_type read_long(unsigned int bits) {
+		if ( bits > 64 ) throw std::invalid_argument("bits > 64");
+		require(bits);
+		// the first part is the upper bits - 32 bits for msb_first and the lower 32 bits for lsb_first
+		const unsigned int head_bits{t_order == BitOrder::msb_first ? bits - 32 : 32};
+		const cache_type head{read_short(head_bits)};
+		const cache_type tail{read_short(bits - head_bits)};
+		return t_order == BitOrder::msb_first ? head << 32 | tail : tail << 32 | head;
+	}
+
+	// the stream from the position: at least 57 bits, zeros after the end
+	cache_type cache() const noexcept {
+		const std::size_t byte{m_position / 8};
+		const unsigned int offset{static_cast<unsigned int>(m_position % 8)};
+		if ( m_position < m_fast_end ) {
+			return Cache::drop(Cache::Bytes::load(m_begin + byte), offset);
+		}
+		cache_type bytes{0};
+		for ( std::size_t i{byte}; i < m_size; ++i ) {
+			bytes |= Cache::place(Cache::front(m_begin[i]), static_cast<unsigned int>(i - byte) * 8);
+		}
+		return Cache::drop(bytes, offset);
+	}
+}; // class BitReader
+
+/*!
+  @brief		cursor which writes fields of any number of bits to a memory block
+  @details		The bits are gathered in a 64-bit cache, whose whole bytes are
+				stored as one word while 8 bytes are left: the word is merged
+				with the bytes after them, so the bytes of the block past
+				size() are kept. Only the last 7 bytes are stored one by one.
+				flush() stores the pending bits, so the destructor does.
+  @tparam		t_order	order of the bits
+ */
+template<BitOrder t_order = BitOrder::msb_first>
+class BitWriter
+{
+	using Cache	= BitStream_impl::Cache<t_order>;
+
+  public:
+	using cache_type	= BitStream_impl::cache_type;
+
+  private:
+	unsigned char	*m_begin;
+	unsigned char	*m_cur;
+	unsigned char	*m_end;
+	cache_type		m_cache;
+	unsigned int	m_count;	// pending bits in m_cache, less than 64
+
+  public:
+	/*!
+	  @brief		construct a writer to a memory block
+	  @param[out]	data	pointer to the beginning of the block
+	  @param[in]	size	size of the block in bytes
+	  @exception	std::invalid_argument	data == nullptr && size > 0
+	 */
+	BitWriter(unsigned char *data, std::size_t size)
+		: m_begin{data}, m_cur{data}, m_end{data + size}, m_cache{0}, m_count{0}
+	{
+		if ( data == nullptr && size > 0 ) throw std::invalid_argument("data == nullptr");
+	}
+
+	BitWriter(const BitWriter &) = delete;
+	BitWriter &operator=(const BitWriter &) = delete;
+
+	~BitWriter() {
+		flush();
+	}
+
+  public:
+	/*!
+	  @brief		get the number of the bits written so far
+	 */
+	std::size_t position() const noexcept {
+		return static_cast<std::size_t>(m_cur - m_begin) * 8 + m_count;
+	}
+
+	/*!
+	  @brief		get the number of the bits writable
+	 */
+	std::size_t available() const noexcept {
+		return static_cast<std::size_t>(m_end - m_begin) * 8 - position();
+	}
+
+	/*!
+	  @brief		get the number of the bytes touched so far, the last one maybe in part
+	 */
+	std::size_t size() const noexcept {
+		return (position() + 7) / 8;
+	}
+
+	/*!
+	  @brief		store the pending bits, the last byte padded with zeros
+	  @details		The position does not move; the next field overwrites the padding.
+	 */
+	void flush() noexcept {
+		drain();
+		if ( m_count > 0 ) {
+			*m_cur = Cache::byte(m_cache);
+		}
+	}
+
+	/*!
+	  @brief		write a field
+	  @param[in]	value	value of the field
+	  @param[in]	bits	width of the field (0 to 64)
+	  @exception	std::invalid_argument	bits > 64
+	  @exception	std::overflow_error		value has bits above the field (only without NDEBUG)
+	  @exception	std::out_of_range		the memory block ends before bits
+	 */
+	BitWriter &write(cache_type value, unsigned int bits) {
+		if ( bits > 64 ) throw std::invalid_argument("bits > 64");
+		value = checked(value, bits);
+		if ( bits > available() ) throw std::out_of_range("end of buffer");
+		if ( bits <= BitStream_impl::step_bits ) {
+			put(value, bits);
+		}
+		else if ( t_order == BitOrder::msb_first ) {
+			put(value >> 32, bits - 32);
+			put(value & BitStream_impl::low_mask(32), 32);
+		}
+		else {
+			put(value & BitStream_impl::low_mask(32), 32);
+			put(value >> 32, bits - 32);
+		}
+		return *this;
+	}
+
+	/*!
+	  @exception	std::out_of_range	the memory block ends
+	 */
+	BitWriter &write_bit(bool bit) {
+		return write(bit ? 1 : 0, 1);
+	}
+
+	/*!
+	  @brief		write zeros terminated by a one
+	  @exception	std::out_of_range	the memory block ends before zeros + 1 bits
+	 */
+	BitWriter &write_unary(std::size_t zeros) {
+		if ( zeros >= available() ) throw std::out_of_range("end of buffer");
+		for ( ; zeros > BitStream_impl::step_bits; zeros -= BitStream_impl::step_bits ) {
+			put(0, BitStream_impl::step_bits);
+		}
+		put(0, static_cast<unsigned int>(zeros));
+		put(1, 1);
+		return *this;
+	}
+
+	/*!
+	  @brief		write an unsigned Exp-Golomb code (ue(v) of H.264)
+	  @exception	std::overflow_error	value == 2^64 - 1
+	  @exception	std::out_of_range	the memory block ends in the code
+	 */
+	BitWriter &write_ue(std::uint64_t value) {
+		if ( value == ~std::uint64_t{0} ) throw std::overflow_error("value == 2^64 - 1");
+		const std::uint64_t code{value + 1};
+		const unsigned int bits{63 - BitStream_impl::count_leading_zeros(code)};
+		if ( 2 * std::size_t{bits} + 1 > available() ) throw std::out_of_range("end of buffer");
+		write_unary(bits);
+		return write(code & BitStream_impl::low_mask(bits), bits);
+	}
+
+	/*!
+	  @brief		write a signed Exp-Golomb code (se(v) of H.264)
+	  @exception	std::overflow_error	value == INT64_MIN
+	  @exception	std::out_of_range	the memory block ends in the code
+	 */
+	BitWriter &write_se(std::int64_t value) {
+		if ( value == INT64_MIN ) throw std::overflow_error("value == INT64_MIN");
+		const std::uint64_t magnitude{static_cast<std::uint64_t>(value < 0 ? -value : value)};
+		return write_ue(value > 0 ? magnitude * 2 - 1 : magnitude * 2);
+	}
+
+	/*!
+	  @brief		write zeros up to the next byte boundary
+	  @exception	std::out_of_range	the memory block ends
+	 */
+	BitWriter &align() {
+		return write(0, static_cast<unsigned int>((8 - position() % 8) % 8));
+	}
+
+  private:
+	cache_type checked(cache_type value, unsigned int bits) const {
+#ifdef NDEBUG
+		return bits == 64 ? value : value & BitStream_impl::low_mask(bits);
+#else
+		if ( bits < 64 && (value >> bits) != 0 ) throw std::overflow_error("value >= 2^bits");
+		return value;
+#endif
+	}
+
+	//! @pre	bits <= 56 && bits <= available()
+	void put(cache_type value, unsigned int bits) noexcept {
+		if ( bits == 0 ) {
+			return;
+		}
+		if ( bits > 63 - m_count ) {
+			drain();
+		}
+		m_cache |= Cache::put(value, m_count, bits);
+		m_count += bits;
+	}
+
+	// store the whole bytes of the cache
+	void drain() noexcept {
+		const unsigned int whole{m_count & ~7u};
+		if ( m_end - m_cur >= 8 ) {
+			const cache_type mask{Cache::head(whole)};
+			Cache::Bytes::store((m_cache & mask) | (Cache::Bytes::load(m_cur) & ~mask), m_cur);
+			m_cur += whole / 8;
+			m_cache = Cache::drop(m_cache, whole);
+			m_count -= whole;
+			return;
+		}
+		for ( ; m_count >= 8; ++m_cur, m_count -= 8 ) {
+			*m_cur = Cache::byte(m_cache);
+			m_cache = Cache::drop(m_cache, 8);
+		}
+	}
+}; // class BitWriter
+
+} // namespace aid
+
+
+#endif // aid_BitStream_hpp
@@ -24,6 +24,8 @@
 #include <functional>
 #include <stdexcept>
 #include <type_traits>
+#include "aid/BitField.hpp"
+#include "aid/Hash.hpp"
 
 
 namespace aid {
@@ -56,8 +58,7 @@ class BitVector
 
   private:
 	static constexpr mask_type create_mask(offset_type first, offset_type last) {
-		return (mask_type{1u} << first)
-			| (first < last ? create_mask(first + 1, last) : 0);
+		return static_cast<mask_type>((~0ull >> (63 - (last - first))) << first);
 	}
 
   public:
@@ -98,6 +99,16 @@ class BitVector
 		m_data |= shifted_value;
 	}
 
+	/*!
+	  @brief		set() of a field fixed at compile time
+	  @tparam		TField	BitField
+	 */
+	template<typename TField>
+	void set(data_type value) {
+		m_data = static_cast<data_type>((m_data & ~TField::template mask<data_type>())
+										| BitField_impl::shift<TField>(value));
+	}
+
 	constexpr data_type get() const noexcept {
 		return m_data;
 	}
@@ -106,6 +117,34 @@ class BitVector
 		return (m_data & section.mask) >> section.offset;
 	}
 
+	/*!
+	  @brief		get() of a field fixed at compile time
+	  @tparam		TField	BitField
+	 */
+	template<typename TField>
+	constexpr data_type get() const noexcept {
+		return static_cast<data_type>((m_data & TField::template mask<data_type>()) >> TField::first);
+	}
+
+	/*!
+	  @brief		all the fields of TLayout at once, packed from bit 0 (see BitLayout::extract)
+	 */
+	template<typename TLayout>
+	data_type extract() const noexcept {
+		static_assert(std::is_same<typename TLayout::data_type, data_type>::value, "TLayout::data_type != data_type");
+		return TLayout::extract(m_data);
+	}
+
+	/*!
+	  @brief		replace all the fields of TLayout at once (see BitLayout::deposit)
+	  @details		bits above TLayout::width are ignored.
+	 */
+	template<typename TLayout>
+	void deposit(data_type bits) noexcept {
+		static_assert(std::is_same<typename TLayout::data_type, data_type>::value, "TLayout::data_type != data_type");
+		m_data = static_cast<data_type>((m_data & ~TLayout::mask) | TLayout::deposit(bits));
+	}
+
 #define aid_BitVector_DEFINE_BINARY_OPERATOR(d_op) \
 	constexpr bool operator d_op(BitVector rhs) const noexcept { \
 		return m_data d_op rhs.m_data; \
@@ -121,8 +160,9 @@ aid_BitVector_DEFINE_BINARY_OPERATOR(>=)
 #undef aid_BitVector_DEFINE_BINARY_OPERATOR
 
   private:
+	// std::hash of an integer is the identity on some libraries, which clusters packed fields
 	constexpr std::size_t hash_code() const noexcept {
-		return std::hash<data_type>{}(m_data);
+		return static_cast<std::size_t>(hash_word(m_data));
 	}
 
 	friend struct std::hash<BitVector>;
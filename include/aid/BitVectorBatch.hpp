@@ -0,0 +1,184 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file BitVectorBatch.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_BitVectorBatch_hpp
+#define aid_BitVectorBatch_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include "aid/BitVector.hpp"
+#include "aid/DynamicBitVector.hpp"
+
+
+namespace aid {
+
+namespace BitVectorBatch_impl {
+
+using BitVector_impl::word_type;
+using BitVector_impl::word_bits;
+
+/*!
+  @brief		values[i] = (data[i] & mask) >> offset, for i in [0, count)
+ */
+template<typename DataType>
+void get_n(const DataType *data, std::size_t count, DataType mask, unsigned int offset, DataType *values) noexcept
+{
+	for ( std::size_t i{0}; i < count; ++i ) {
+		values[i] = static_cast<DataType>((data[i] & mask) >> offset);
+	}
+}
+
+/*!
+  @brief		bit i of selection = (data[i] & mask) == bits, for i in [0, count)
+  @details		The bits of the last word past count are cleared.
+  @return		number of the selected elements
+ */
+template<typename DataType>
+std::size_t select_n(const DataType *data, std::size_t count, DataType mask, DataType bits,
+					 word_type *selection) noexcept
+{
+	std::size_t selected{0};
+	for ( std::size_t i{0}; i < count; i += word_bits ) {
+		const std::size_t n{count - i < word_bits ? count - i : word_bits};
+		word_type word{0};
+		for ( std::size_t k{0}; k < n; ++k ) {
+			word |= word_type{(data[i + k] & mask) == bits} << k;
+		}
+		selection[i / word_bits] = word;
+		selected += BitVector_impl::popcount(word);
+	}
+	return selected;
+}
+
+/*!
+  @brief		data[i] = (data[i] & ~mask) | bits, for i in [0, count) selected by selection
+ */
+template<typename DataType>
+void set_n(DataType *data, std::size_t count, DataType mask, DataType bits, const word_type *selection) noexcept
+{
+	for ( std::size_t i{0}; i < count; ++i ) {
+		if ( (selection[i / word_bits] >> (i % word_bits)) & 1 ) {
+			data[i] = static_cast<DataType>((data[i] & ~mask) | bits);
+		}
+	}
+}
+
+// The overloads for 32-bit and 64-bit data run AVX2/AVX-512 kernels if available.
+void get_n(const std::uint32_t *data, std::size_t count, std::uint32_t mask, unsigned int offset,
+		   std::uint32_t *values) noexcept;
+void get_n(const std::uint64_t *data, std::size_t count, std::uint64_t mask, unsigned int offset,
+		   std::uint64_t *values) noexcept;
+std::size_t select_n(const std::uint32_t *data, std::size_t count, std::uint32_t mask, std::uint32_t bits,
+					 word_type *selection) noexcept;
+std::size_t select_n(const std::uint64_t *data, std::size_t count, std::uint64_t mask, std::uint64_t bits,
+					 word_type *selection) noexcept;
+void set_n(std::uint32_t *data, std::size_t count, std::uint32_t mask, std::uint32_t bits,
+		   const word_type *selection) noexcept;
+void set_n(std::uint64_t *data, std::size_t count, std::uint64_t mask, std::uint64_t bits,
+		   const word_type *selection) noexcept;
+
+// A BitVector is its data_type, so an array of them is an array of data_type.
+template<typename DataType>
+const DataType *data(const BitVector<DataType> *bvecs) noexcept
+{
+	static_assert(sizeof(BitVector<DataType>) == sizeof(DataType)
+				  && std::is_standard_layout<BitVector<DataType>>::value,
+				  "BitVector<DataType> is not laid out as DataType");
+	return reinterpret_cast<const DataType *>(bvecs);
+}
+
+template<typename DataType>
+DataType *data(BitVector<DataType> *bvecs) noexcept
+{
+	return const_cast<DataType *>(data(static_cast<const BitVector<DataType> *>(bvecs)));
+}
+
+inline void check_pointer(const void *pointer, std::size_t count)
+{
+	if ( pointer == nullptr && count > 0 ) throw std::invalid_argument("nullptr");
+}
+
+} // namespace BitVectorBatch_impl
+
+/*!
+  @brief		values[i] = bvecs[i].get(section), for i in [0, count)
+  @exception	std::invalid_argument	bvecs or values is nullptr and count > 0
+ */
+template<typename DataType>
+void get_sections(const BitVector<DataType> *bvecs, std::size_t count,
+				  const typename BitVector<DataType>::Section &section, DataType *values)
+{
+	BitVectorBatch_impl::check_pointer(bvecs, count);
+	BitVectorBatch_impl::check_pointer(values, count);
+	BitVectorBatch_impl::get_n(BitVectorBatch_impl::data(bvecs), count, section.mask, section.offset, values);
+}
+
+/*!
+  @brief		select the elements whose section is value
+  @details		selection is resized to count, and bit i is bvecs[i].get(section) == value.
+				A value which does not fit in section selects nothing.
+				The selections of several sections combine with the bulk operations
+				of DynamicBitVector.
+  @return		number of the selected elements
+  @exception	std::invalid_argument	bvecs is nullptr and count > 0
+ */
+template<typename DataType>
+std::size_t select_sections(const BitVector<DataType> *bvecs, std::size_t count,
+							const typename BitVector<DataType>::Section &section, DataType value,
+							DynamicBitVector &selection)
+{
+	BitVectorBatch_impl::check_pointer(bvecs, count);
+	selection.resize(count);
+	if ( value != (value & (section.mask >> section.offset)) ) {
+		selection.reset();
+		return 0;
+	}
+	return BitVectorBatch_impl::select_n(BitVectorBatch_impl::data(bvecs), count, section.mask,
+										 static_cast<DataType>(value << section.offset), selection.data());
+}
+
+/*!
+  @brief		bvecs[i].set(section, value), for the elements selected by selection
+  @param[in]	count	number of bvecs, which is selection.size()
+  @exception	std::invalid_argument	bvecs is nullptr and count > 0, or count != selection.size()
+  @exception	std::overflow_error		value does not fit in section (masked under NDEBUG)
+ */
+template<typename DataType>
+void set_sections(BitVector<DataType> *bvecs, std::size_t count,
+				  const typename BitVector<DataType>::Section &section, DataType value,
+				  const DynamicBitVector &selection)
+{
+	BitVectorBatch_impl::check_pointer(bvecs, count);
+	if ( count != selection.size() ) throw std::invalid_argument("count != selection.size()");
+	DataType bits{static_cast<DataType>(value << section.offset)};
+#ifdef NDEBUG
+	bits &= section.mask;
+#else
+	if ( value != (value & (section.mask >> section.offset)) ) {
+		throw std::overflow_error("data_type value");
+	}
+#endif
+	BitVectorBatch_impl::set_n(BitVectorBatch_impl::data(bvecs), count, section.mask, bits, selection.data());
+}
+
+} // namespace aid
+
+
+#endif // aid_BitVectorBatch_hpp
@@ -0,0 +1,221 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file BloomFilter.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_BloomFilter_hpp
+#define aid_BloomFilter_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "aid/DynamicBitVector.hpp"
+
+
+namespace aid {
+
+namespace BloomFilter_impl {
+
+using BitVector_impl::word_type;
+using BitVector_impl::word_bits;
+using hash_type	= std::uint64_t;
+
+constexpr unsigned int block_bits{256};
+constexpr unsigned int block_words{block_bits / word_bits};
+constexpr unsigned int lane_count{8};	// 32-bit lanes of a block; a key sets one bit in each
+constexpr std::size_t max_block_count{std::size_t{1} << 32};
+
+// odd multipliers which spread the lower half of a hash over the lanes (those of the Parquet filter)
+constexpr std::uint32_t salt[lane_count]{
+	0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du, 0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u,
+};
+
+/*!
+  @brief		the block of hash, from its upper half
+ */
+inline std::size_t block(hash_type hash, std::size_t block_count) noexcept
+{
+	return static_cast<std::size_t>(((hash >> 32) * block_count) >> 32);
+}
+
+/*!
+  @brief		the bits of hash in a block
+  @details		Lane i is word i / 2, upper half if i is odd, as the lanes of
+				a 256-bit vector on a little-endian CPU.
+ */
+inline void make_mask(hash_type hash, word_type mask[block_words]) noexcept
+{
+	for ( unsigned int i{0}; i < block_words; ++i ) {
+		mask[i] = 0;
+	}
+	for ( unsigned int lane{0}; lane < lane_count; ++lane ) {
+		const unsigned int bit{static_cast<std::uint32_t>(static_cast<std::uint32_t>(hash) * salt[lane]) >> 27};
+		mask[lane / 2] |= word_type{1} << (lane % 2 * 32 + bit);
+	}
+}
+
+inline void insert(word_type *words, std::size_t block_count, hash_type hash) noexcept
+{
+	word_type mask[block_words];
+	make_mask(hash, mask);
+	word_type * const target = words + block(hash, block_count) * block_words;
+	for ( unsigned int i{0}; i < block_words; ++i ) {
+		target[i] |= mask[i];
+	}
+}
+
+inline bool contains(const word_type *words, std::size_t block_count, hash_type hash) noexcept
+{
+	word_type mask[block_words];
+	make_mask(hash, mask);
+	const word_type * const target = words + block(hash, block_count) * block_words;
+	word_type missing{0};
+	for ( unsigned int i{0}; i < block_words; ++i ) {
+		missing |= mask[i] & ~target[i];
+	}
+	return missing == 0;
+}
+
+/*!
+  @brief		insert hashes[i], for i in [0, count)
+  @details		The masks are made and merged with AVX2 if available.
+ */
+void insert_n(word_type *words, std::size_t block_count, const hash_type *hashes, std::size_t count) noexcept;
+
+/*!
+  @brief		bit i of result = contains(hashes[i]), for i in [0, count)
+  @details		The bits of the last word of result past count are cleared.
+				The blocks are tested with AVX2 if available.
+  @return		number of the hashes found
+ */
+std::size_t contains_n(const word_type *words, std::size_t block_count, const hash_type *hashes,
+					   std::size_t count, word_type *result) noexcept;
+
+} // namespace BloomFilter_impl
+
+/*!
+  @brief		Bloom filter whose keys are tested in one cache line
+  @details		A key sets one bit in each 32-bit lane of a 256-bit block, which
+				the upper half of its hash selects (a split block Bloom filter).
+				So a lookup reads one cache line, and the bits of a block are
+				set and tested with a few vector instructions.
+				The false positive rate is about 1.3% with 10 bits per key,
+				0.55% with 12 and 0.14% with 16.
+
+				The keys are given as 64-bit hashes, whose every bit must depend on
+				the key: hash_word(), hash_bytes() or std::hash<BitVector>, but not
+				the std::hash of an integer, which is the identity on some libraries.
+ */
+class BloomFilter
+{
+  public:
+	using size_type	= std::size_t;
+	using hash_type	= BloomFilter_impl::hash_type;
+
+  private:
+	DynamicBitVector	m_bits;
+	size_type			m_block_count;
+
+  private:
+	static size_type block_count(size_type bits) {
+		const size_type count{(bits + BloomFilter_impl::block_bits - 1) / BloomFilter_impl::block_bits};
+		if ( count > BloomFilter_impl::max_block_count ) throw std::length_error("bits > 2^40");
+		return count > 0 ? count : 1;
+	}
+
+  public:
+	/*!
+	  @brief		construct an empty filter
+	  @param[in]	bits	size of the filter, rounded up to whole 256-bit blocks
+	  @exception	std::length_error	bits > 2^40
+	 */
+	explicit BloomFilter(size_type bits)
+		: m_bits{}, m_block_count{block_count(bits)}
+	{
+		m_bits.resize(m_block_count * BloomFilter_impl::block_bits);
+	}
+
+  public:
+	//! get the number of the bits
+	size_type size() const noexcept {
+		return m_bits.size();
+	}
+
+	//! get the bits, to count them or to store them
+	const DynamicBitVector &bits() const noexcept {
+		return m_bits;
+	}
+
+	void insert(hash_type hash) noexcept {
+		BloomFilter_impl::insert(m_bits.data(), m_block_count, hash);
+	}
+
+	/*!
+	  @brief		insert many keys
+	  @exception	std::invalid_argument	hashes is nullptr and count > 0
+	 */
+	void insert(const hash_type *hashes, size_type count) {
+		if ( hashes == nullptr && count > 0 ) throw std::invalid_argument("hashes == nullptr");
+		BloomFilter_impl::insert_n(m_bits.data(), m_block_count, hashes, count);
+	}
+
+	/*!
+	  @retval		false	the key is not inserted
+	  @retval		true	the key may be inserted
+	 */
+	bool contains(hash_type hash) const noexcept {
+		return BloomFilter_impl::contains(m_bits.data(), m_block_count, hash);
+	}
+
+	/*!
+	  @brief		test many keys, to filter the rows of a join for example
+	  @details		result is resized to count, and bit i is contains(hashes[i]).
+	  @return		number of the keys which may be inserted
+	  @exception	std::invalid_argument	hashes is nullptr and count > 0
+	 */
+	size_type contains(const hash_type *hashes, size_type count, DynamicBitVector &result) const {
+		if ( hashes == nullptr && count > 0 ) throw std::invalid_argument("hashes == nullptr");
+		result.resize(count);
+		return BloomFilter_impl::contains_n(m_bits.data(), m_block_count, hashes, count, result.data());
+	}
+
+	//! remove all the keys
+	void clear() noexcept {
+		m_bits.reset();
+	}
+
+	/*!
+	  @brief		insert the keys of other
+	  @exception	std::invalid_argument	size() != other.size()
+	 */
+	BloomFilter &operator|=(const BloomFilter &other) {
+		m_bits |= other.m_bits;
+		return *this;
+	}
+
+	bool operator==(const BloomFilter &rhs) const noexcept {
+		return m_bits == rhs.m_bits;
+	}
+
+	bool operator!=(const BloomFilter &rhs) const noexcept {
+		return !(*this == rhs);
+	}
+}; // class BloomFilter
+
+} // namespace aid
+
+
+#endif // aid_BloomFilter_hpp
@@ -0,0 +1,678 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file ByteStream.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_ByteStream_hpp
+#define aid_ByteStream_hpp
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "aid/DynamicEndianConverter.hpp"
+#include "aid/Endian.hpp"
+
+#if		defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>
+#define AID_BYTESTREAM_FD	1
+#endif
+
+
+namespace aid {
+
+/*!
+  @brief		source of a ByteReader
+  @details		It reads at most size bytes into buffer and returns the number of
+				the read bytes. It returns 0 only at the end of the source.
+ */
+using ByteSource	= std::function<std::size_t (unsigned char *buffer, std::size_t size)>;
+
+/*!
+  @brief		sink of a ByteWriter
+  @details		It writes all of size bytes from buffer.
+ */
+using ByteSink		= std::function<void (const unsigned char *buffer, std::size_t size)>;
+
+/*!
+  @brief		make a source which reads a stdio stream
+  @exception	std::system_error	(at reading) std::ferror(file)
+ */
+inline ByteSource make_file_source(std::FILE *file)
+{
+	return [file](unsigned char *buffer, std::size_t size) -> std::size_t {
+		const std::size_t read = std::fread(buffer, 1, size, file);
+		if ( read == 0 && std::ferror(file) ) {
+			throw std::system_error(std::make_error_code(std::errc::io_error), "fread");
+		}
+		return read;
+	};
+}
+
+/*!
+  @brief		make a sink which writes a stdio stream
+  @exception	std::system_error	(at writing) fwrite failed
+ */
+inline ByteSink make_file_sink(std::FILE *file)
+{
+	return [file](const unsigned char *buffer, std::size_t size) {
+		if ( std::fwrite(buffer, 1, size, file) != size ) {
+			throw std::system_error(std::make_error_code(std::errc::io_error), "fwrite");
+		}
+	};
+}
+
+/*!
+  @brief		make a sink which appends to a vector
+ */
+inline ByteSink make_vector_sink(std::vector<unsigned char> &bytes)
+{
+	return [&bytes](const unsigned char *buffer, std::size_t size) {
+		bytes.insert(bytes.end(), buffer, buffer + size);
+	};
+}
+
+#if		defined(AID_BYTESTREAM_FD)
+/*!
+  @brief		make a source which reads a file descriptor
+  @exception	std::system_error	(at reading) read(2) failed
+ */
+inline ByteSource make_fd_source(int fd)
+{
+	return [fd](unsigned char *buffer, std::size_t size) -> std::size_t {
+		for ( ; ; ) {
+			const ssize_t read = ::read(fd, buffer, size);
+			if ( read >= 0 ) {
+				return static_cast<std::size_t>(read);
+			}
+			if ( errno != EINTR ) {
+				throw std::system_error(errno, std::generic_category(), "read");
+			}
+		}
+	};
+}
+
+/*!
+  @brief		make a sink which writes a file descriptor
+  @exception	std::system_error	(at writing) write(2) failed
+ */
+inline ByteSink make_fd_sink(int fd)
+{
+	return [fd](const unsigned char *buffer, std::size_t size) {
+		while ( size > 0 ) {
+			const ssize_t written = ::write(fd, buffer, size);
+			if ( written < 0 ) {
+				if ( errno == EINTR ) continue;
+				throw std::system_error(errno, std::generic_category(), "write");
+			}
+			buffer += written;
+			size -= static_cast<std::size_t>(written);
+		}
+	};
+}
+#endif
+
+namespace ByteStream_impl {
+
+/*!
+  @brief		codec for a external endian type fixed at compile time
+ */
+template<EndianType t_external_type>
+struct StaticCodec
+{
+	using Native = Endian_impl::Converter<t_external_type, Endian_impl::native_type()>;
+
+	template<typename Integer>
+	void decode(const unsigned char *external, std::size_t size, Integer &native) const {
+		Native::from_external(external, size, native);
+	}
+
+	template<typename Integer>
+	void decode_n(const unsigned char *external, std::size_t count, Integer *native) const {
+		Native::from_external_n(external, count, native);
+	}
+
+	template<typename Integer>
+	void encode(Integer native, unsigned char *external, std::size_t size) const {
+		Native::to_external(native, external, size);
+	}
+
+	template<typename Integer>
+	void encode_n(const Integer *native, std::size_t count, unsigned char *external) const {
+		Native::to_external_n(native, count, external);
+	}
+}; // struct StaticCodec
+
+/*!
+  @brief		codec for a external endian type given at run time
+ */
+class DynamicCodec
+{
+	template<EndianType t_external_type>
+	using Native = Endian_impl::Converter<t_external_type, Endian_impl::native_type()>;
+
+  private:
+	DynamicEndianConverter	m_converter;
+
+  public:
+	/*!
+	  @exception	std::logic_error	external_type is unknown
+	 */
+	DynamicCodec(EndianType external_type)
+		: m_converter{external_type}
+	{
+		if ( external_type != EndianType::little && external_type != EndianType::big ) {
+			throw std::logic_error("external_type is unknown");
+		}
+	}
+
+	DynamicCodec(const DynamicEndianConverter &converter)
+		: DynamicCodec(converter.get_external_type())
+	{}
+
+	template<typename Integer>
+	void decode(const unsigned char *external, std::size_t size, Integer &native) const {
+		if ( m_converter.get_external_type() == EndianType::big ) {
+			Native<EndianType::big>::from_external(external, size, native);
+		}
+		else {
+			Native<EndianType::little>::from_external(external, size, native);
+		}
+	}
+
+	template<typename Integer>
+	void decode_n(const unsigned char *external, std::size_t count, Integer *native) const {
+		m_converter.from_external_n(external, count, native);
+	}
+
+	template<typename Integer>
+	void encode(Integer native, unsigned char *external, std::size_t size) const {
+		if ( m_converter.get_external_type() == EndianType::big ) {
+			Native<EndianType::big>::to_external(native, external, size);
+		}
+		else {
+			Native<EndianType::little>::to_external(native, external, size);
+		}
+	}
+
+	template<typename Integer>
+	void encode_n(const Integer *native, std::size_t count, unsigned char *external) const {
+		m_converter.to_external_n(native, count, external);
+	}
+}; // class DynamicCodec
+
+template<typename Integer>
+inline void check_size(std::size_t size)
+{
+	if ( size == 0 ) throw std::length_error("size == 0");
+	if ( size > sizeof(Integer) ) throw std::invalid_argument("size > sizeof(native)");
+	Endian_impl::check_floating_point_size<Integer>(size);
+}
+
+} // namespace ByteStream_impl
+
+/*!
+  @brief		cursor which reads external endian values from a byte sequence
+  @details		The bytes come from a memory block, or from a ByteSource through an
+				internal buffer. Every read checks the bounds with one comparison and
+				refills the buffer only when it runs short. ensure() checks the bounds
+				for a batch of fields, which then can be read by read_unchecked().
+  @tparam		Codec	ByteStream_impl::StaticCodec or ByteStream_impl::DynamicCodec
+ */
+template<class Codec>
+class BasicByteReader
+{
+  public:
+	using codec_type	= Codec;
+
+	static constexpr std::size_t default_buffer_size{64 * 1024};
+
+  private:
+	Codec						m_codec;
+	ByteSource					m_source;
+	std::vector<unsigned char>	m_buffer;
+	const unsigned char			*m_begin;
+	const unsigned char			*m_cur;
+	const unsigned char			*m_end;
+	std::size_t					m_offset;
+
+  public:
+	/*!
+	  @brief		construct a reader of a memory block
+	  @param[in]	data	pointer to the beginning of the block
+	  @param[in]	size	size of the block
+	  @param[in]	codec	codec (or external endian type for DynamicCodec)
+	  @exception	std::invalid_argument	data == nullptr && size > 0
+	 */
+	BasicByteReader(const unsigned char *data, std::size_t size, Codec codec = Codec())
+		: m_codec(std::move(codec))
+		, m_begin{data}, m_cur{data}, m_end{data + size}, m_offset{0}
+	{
+		if ( data == nullptr && size > 0 ) throw std::invalid_argument("data == nullptr");
+	}
+
+	/*!
+	  @brief		construct a reader of a source
+	  @param[in]	source		source of the bytes
+	  @param[in]	buffer_size	size of the internal buffer
+	  @param[in]	codec		codec (or external endian type for DynamicCodec)
+	  @exception	std::invalid_argument	!source
+	  @exception	std::length_error		buffer_size == 0
+	 */
+	explicit BasicByteReader(ByteSource source, std::size_t buffer_size = default_buffer_size,
+							 Codec codec = Codec())
+		: m_codec(std::move(codec)), m_source(std::move(source)), m_buffer(buffer_size)
+		, m_begin{m_buffer.data()}, m_cur{m_begin}, m_end{m_begin}, m_offset{0}
+	{
+		if ( !m_source ) throw std::invalid_argument("!source");
+		if ( buffer_size == 0 ) throw std::length_error("buffer_size == 0");
+	}
+
+	BasicByteReader(const BasicByteReader &) = delete;
+	BasicByteReader &operator=(const BasicByteReader &) = delete;
+
+  public:
+	/*!
+	  @brief		get the number of the bytes read so far
+	 */
+	std::size_t position() const noexcept {
+		return m_offset + static_cast<std::size_t>(m_cur - m_begin);
+	}
+
+	/*!
+	  @brief		get the number of the bytes readable without a refill
+	 */
+	std::size_t available() const noexcept {
+		return static_cast<std::size_t>(m_end - m_cur);
+	}
+
+	/*!
+	  @brief		make size bytes readable without a refill
+	  @retval		false	the source ends before size bytes
+	 */
+	bool ensure(std::size_t size) {
+		return available() >= size || refill(size);
+	}
+
+	/*!
+	  @brief		check whether all the bytes have been read
+	 */
+	bool eof() {
+		return !ensure(1);
+	}
+
+	/*!
+	  @brief		read a external endian value
+	  @tparam		Integer	integer type
+	  @return		native endian value
+	  @exception	std::out_of_range	the stream ends before sizeof(Integer) bytes
+	 */
+	template<typename Integer>
+	Integer read() {
+		Integer native;
+		read(native);
+		return native;
+	}
+
+	/*!
+	  @brief		read a external endian value of size bytes
+	  @exception	std::length_error		size == 0
+	  @exception	std::invalid_argument	size > sizeof(Integer)
+	  @exception	std::out_of_range		the stream ends before size bytes
+	 */
+	template<typename Integer>
+	Integer read(std::size_t size) {
+		ByteStream_impl::check_size<Integer>(size);
+		require(size);
+		Integer native;
+		m_codec.decode(m_cur, size, native);
+		m_cur += size;
+		return native;
+	}
+
+	/*!
+	  @brief		read a external endian value
+	  @return		*this, so that calls can be chained
+	  @exception	std::out_of_range	the stream ends before sizeof(Integer) bytes
+	 */
+	template<typename Integer>
+	BasicByteReader &read(Integer &native) {
+		require(sizeof(native));
+		return read_unchecked(native);
+	}
+
+	/*!
+	  @brief		read a external endian value without the bounds check
+	  @pre			ensure(sizeof(Integer)) has returned true for this value
+	  @attention	This function does not check the pre-conditions.
+	 */
+	template<typename Integer>
+	BasicByteReader &read_unchecked(Integer &native) {
+		m_codec.decode(m_cur, sizeof(native), native);
+		m_cur += sizeof(native);
+		return *this;
+	}
+
+	/*!
+	  @brief		read count external endian values
+	  @exception	std::out_of_range	the stream ends before count values
+	 */
+	template<typename Integer>
+	BasicByteReader &read_n(Integer *native, std::size_t count) {
+		while ( count > 0 ) {
+			require(sizeof(Integer));
+			std::size_t chunk{available() / sizeof(Integer)};
+			if ( chunk > count ) chunk = count;
+			m_codec.decode_n(m_cur, chunk, native);
+			m_cur += chunk * sizeof(Integer);
+			native += chunk;
+			count -= chunk;
+		}
+		return *this;
+	}
+
+	/*!
+	  @brief		read raw bytes
+	  @exception	std::out_of_range	the stream ends before size bytes
+	 */
+	BasicByteReader &read_bytes(unsigned char *bytes, std::size_t size) {
+		while ( size > 0 ) {
+			require(1);
+			const std::size_t chunk{available() < size ? available() : size};
+			std::memcpy(bytes, m_cur, chunk);
+			m_cur += chunk;
+			bytes += chunk;
+			size -= chunk;
+		}
+		return *this;
+	}
+
+	/*!
+	  @brief		skip bytes
+	  @exception	std::out_of_range	the stream ends before size bytes
+	 */
+	BasicByteReader &skip(std::size_t size) {
+		while ( size > 0 ) {
+			require(1);
+			const std::size_t chunk{available() < size ? available() : size};
+			m_cur += chunk;
+			size -= chunk;
+		}
+		return *this;
+	}
+
+  private:
+	void require(std::size_t size) {
+		if ( !ensure(size) ) throw std::out_of_range("end of stream");
+	}
+
+	bool refill(std::size_t size) {
+		if ( !m_source ) {
+			return false;
+		}
+
+		const std::size_t rest{available()};
+		const std::size_t consumed{static_cast<std::size_t>(m_cur - m_begin)};
+		if ( m_buffer.size() < size ) {
+			std::vector<unsigned char> buffer(size);
+			std::memcpy(buffer.data(), m_cur, rest);
+			m_buffer.swap(buffer);
+		}
+		else {
+			std::memmove(m_buffer.data(), m_cur, rest);
+		}
+		m_offset += consumed;
+		m_begin = m_buffer.data();
+		m_cur = m_begin;
+		m_end = m_begin + rest;
+
+		while ( available() < size ) {
+			unsigned char * const end = m_buffer.data() + (m_end - m_begin);
+			const std::size_t read = m_source(end, m_buffer.size() - available());
+			if ( read == 0 ) {
+				return false;
+			}
+			m_end += read;
+		}
+		return true;
+	}
+}; // class BasicByteReader
+
+/*!
+  @brief		cursor which writes external endian values to a byte sequence
+  @details		The bytes go to a memory block, or to a ByteSink through an internal
+				buffer. Every write checks the bounds with one comparison and flushes
+				the buffer only when it runs short. ensure() checks the bounds for
+				a batch of fields, which then can be written by write_unchecked().
+  @tparam		Codec	ByteStream_impl::StaticCodec or ByteStream_impl::DynamicCodec
+ */
+template<class Codec>
+class BasicByteWriter
+{
+  public:
+	using codec_type	= Codec;
+
+	static constexpr std::size_t default_buffer_size{64 * 1024};
+
+  private:
+	Codec						m_codec;
+	ByteSink					m_sink;
+	std::vector<unsigned char>	m_buffer;
+	unsigned char				*m_begin;
+	unsigned char				*m_cur;
+	unsigned char				*m_end;
+	std::size_t					m_offset;
+
+  public:
+	/*!
+	  @brief		construct a writer to a memory block
+	  @param[out]	data	pointer to the beginning of the block
+	  @param[in]	size	size of the block
+	  @param[in]	codec	codec (or external endian type for DynamicCodec)
+	  @exception	std::invalid_argument	data == nullptr && size > 0
+	 */
+	BasicByteWriter(unsigned char *data, std::size_t size, Codec codec = Codec())
+		: m_codec(std::move(codec))
+		, m_begin{data}, m_cur{data}, m_end{data + size}, m_offset{0}
+	{
+		if ( data == nullptr && size > 0 ) throw std::invalid_argument("data == nullptr");
+	}
+
+	/*!
+	  @brief		construct a writer to a sink
+	  @param[in]	sink		sink of the bytes
+	  @param[in]	buffer_size	size of the internal buffer
+	  @param[in]	codec		codec (or external endian type for DynamicCodec)
+	  @exception	std::invalid_argument	!sink
+	  @exception	std::length_error		buffer_size == 0
+	 */
+	explicit BasicByteWriter(ByteSink sink, std::size_t buffer_size = default_buffer_size,
+							 Codec codec = Codec())
+		: m_codec(std::move(codec)), m_sink(std::move(sink)), m_buffer(buffer_size)
+		, m_begin{m_buffer.data()}, m_cur{m_begin}, m_end{m_begin + buffer_size}, m_offset{0}
+	{
+		if ( !m_sink ) throw std::invalid_argument("!sink");
+		if ( buffer_size == 0 ) throw std::length_error("buffer_size == 0");
+	}
+
+	BasicByteWriter(const BasicByteWriter &) = delete;
+	BasicByteWriter &operator=(const BasicByteWriter &) = delete;
+
+	/*!
+	  @brief		flush the buffer
+	  @details		Errors of the sink are ignored here; call flush() to get them.
+	 */
+	~BasicByteWriter() {
+		try {
+			flush();
+		}
+		catch (...) {
+		}
+	}
+
+  public:
+	/*!
+	  @brief		get the number of the bytes written so far
+	 */
+	std::size_t position() const noexcept {
+		return m_offset + static_cast<std::size_t>(m_cur - m_begin);
+	}
+
+	/*!
+	  @brief		get the number of the bytes writable without a flush
+	 */
+	std::size_t available() const noexcept {
+		return static_cast<std::size_t>(m_end - m_cur);
+	}
+
+	/*!
+	  @brief		make size bytes writable without a flush
+	  @retval		false	the memory block has less than size bytes left
+	 */
+	bool ensure(std::size_t size) {
+		return available() >= size || drain(size);
+	}
+
+	/*!
+	  @brief		pass the buffered bytes to the sink
+	 */
+	void flush() {
+		if ( !m_sink || m_cur == m_begin ) {
+			return;
+		}
+		const std::size_t size{static_cast<std::size_t>(m_cur - m_begin)};
+		m_sink(m_begin, size);
+		m_offset += size;
+		m_cur = m_begin;
+	}
+
+	/*!
+	  @brief		write a native endian value as a external endian value
+	  @return		*this, so that calls can be chained
+	  @exception	std::out_of_range	the memory block ends before sizeof(Integer) bytes
+	 */
+	template<typename Integer>
+	BasicByteWriter &write(Integer native) {
+		require(sizeof(native));
+		return write_unchecked(native);
+	}
+
+	/*!
+	  @brief		write a native endian value as a external endian value of size bytes
+	  @exception	std::length_error		size == 0
+	  @exception	std::invalid_argument	size > sizeof(Integer)
+	  @exception	std::out_of_range		the memory block ends before size bytes
+	 */
+	template<typename Integer>
+	BasicByteWriter &write(Integer native, std::size_t size) {
+		ByteStream_impl::check_size<Integer>(size);
+		require(size);
+		m_codec.encode(native, m_cur, size);
+		m_cur += size;
+		return *this;
+	}
+
+	/*!
+	  @brief		write a value without the bounds check
+	  @pre			ensure(sizeof(Integer)) has returned true for this value
+	  @attention	This function does not check the pre-conditions.
+	 */
+	template<typename Integer>
+	BasicByteWriter &write_unchecked(Integer native) {
+		m_codec.encode(native, m_cur, sizeof(native));
+		m_cur += sizeof(native);
+		return *this;
+	}
+
+	/*!
+	  @brief		write count native endian values as external endian values
+	  @exception	std::out_of_range	the memory block ends before count values
+	 */
+	template<typename Integer>
+	BasicByteWriter &write_n(const Integer *native, std::size_t count) {
+		while ( count > 0 ) {
+			require(sizeof(Integer));
+			std::size_t chunk{available() / sizeof(Integer)};
+			if ( chunk > count ) chunk = count;
+			m_codec.encode_n(native, chunk, m_cur);
+			m_cur += chunk * sizeof(Integer);
+			native += chunk;
+			count -= chunk;
+		}
+		return *this;
+	}
+
+	/*!
+	  @brief		write raw bytes
+	  @exception	std::out_of_range	the memory block ends before size bytes
+	 */
+	BasicByteWriter &write_bytes(const unsigned char *bytes, std::size_t size) {
+		while ( size > 0 ) {
+			require(1);
+			const std::size_t chunk{available() < size ? available() : size};
+			std::memcpy(m_cur, bytes, chunk);
+			m_cur += chunk;
+			bytes += chunk;
+			size -= chunk;
+		}
+		return *this;
+	}
+
+  private:
+	void require(std::size_t size) {
+		if ( !ensure(size) ) throw std::out_of_range("end of buffer");
+	}
+
+	bool drain(std::size_t size) {
+		if ( !m_sink ) {
+			return false;
+		}
+
+		flush();
+		if ( m_buffer.size() < size ) {
+			m_buffer.resize(size);
+			m_begin = m_buffer.data();
+			m_cur = m_begin;
+			m_end = m_begin + size;
+		}
+		return true;
+	}
+}; // class BasicByteWriter
+
+template<class Codec>
+constexpr std::size_t BasicByteReader<Codec>::default_buffer_size;
+
+template<class Codec>
+constexpr std::size_t BasicByteWriter<Codec>::default_buffer_size;
+
+template<EndianType t_external_type>
+using ByteReader		= BasicByteReader<ByteStream_impl::StaticCodec<t_external_type>>;
+
+template<EndianType t_external_type>
+using ByteWriter		= BasicByteWriter<ByteStream_impl::StaticCodec<t_external_type>>;
+
+using DynamicByteReader	= BasicByteReader<ByteStream_impl::DynamicCodec>;
+using DynamicByteWriter	= BasicByteWriter<ByteStream_impl::DynamicCodec>;
+
+} // namespace aid
+
+
+#endif // aid_ByteStream_hpp
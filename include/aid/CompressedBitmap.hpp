@@ -0,0 +1,339 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file CompressedBitmap.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_CompressedBitmap_hpp
+#define aid_CompressedBitmap_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "aid/DynamicBitVector.hpp"
+#include "aid/Endian.hpp"
+
+
+namespace aid {
+
+class CompressedBitmapView;
+
+namespace CompressedBitmap_impl {
+
+using Converter	= EndianConverter<EndianType::little>;
+
+constexpr std::size_t chunk_bits{65536};	// values sharing the upper 16 bits
+constexpr std::size_t array_limit{4096};	// a larger array is larger than a bitmap
+constexpr std::size_t bitmap_words{chunk_bits / BitVector_impl::word_bits};
+constexpr std::size_t header_bytes{8};
+constexpr std::size_t entry_bytes{16};
+
+enum class Kind: unsigned char
+{
+	array		//!< sorted lower 16 bits
+	, bitmap	//!< bitmap_words words
+	, run		//!< sorted (start, length - 1) pairs
+};
+
+struct Container
+{
+	std::uint16_t							key;			// upper 16 bits of the values
+	Kind									kind;
+	std::uint32_t							cardinality;
+	std::vector<std::uint16_t>				values;			// array and run
+	std::vector<BitVector_impl::word_type>	words;			// bitmap
+};
+
+} // namespace CompressedBitmap_impl
+
+/*!
+  @brief		compressed set of 32-bit values (Roaring bitmap)
+  @details		The values are split into 64K chunks by their upper 16 bits.
+				A chunk holds a sorted array of up to 4096 values, a 8 KiB
+				bitmap, or runs after run_optimize(), whichever is smaller.
+				Bitmap containers are combined with the dispatched
+				BitVector_impl kernels.
+
+				serialize() writes the little endian form which
+				CompressedBitmapView queries in place:
+				- header: "aidR", the number of the containers (uint32)
+				- a 16-byte entry per container, sorted by key:
+				  key (uint16), kind (uint8), 0 (uint8), cardinality (uint32),
+				  offset of the payload from the beginning (uint32),
+				  number of the uint16 values or uint64 words (uint32)
+				- the payloads in the order of the entries
+ */
+class CompressedBitmap
+{
+  public:
+	using value_type	= std::uint32_t;
+	using size_type		= std::uint64_t;
+
+  private:
+	std::vector<CompressedBitmap_impl::Container>	m_containers;
+
+  public:
+	CompressedBitmap() noexcept
+		: m_containers{}
+	{}
+
+	/*!
+	  @brief		deserialize a view
+	  @details		The payloads of the containers are checked, as the other
+					members trust them: the arrays ascend, and the bitmaps and
+					the runs hold the cardinalities of their entries.
+	  @exception	std::invalid_argument	a payload does not match its entry
+	 */
+	explicit CompressedBitmap(const CompressedBitmapView &view);
+
+  public:
+	bool empty() const noexcept {
+		return m_containers.empty();
+	}
+
+	/*!
+	  @brief		number of the values
+	 */
+	size_type cardinality() const noexcept;
+
+	/*!
+	  @brief		number of the 64K chunks which have values
+	 */
+	std::size_t container_count() const noexcept {
+		return m_containers.size();
+	}
+
+	/*!
+	  @brief		size of the heap storage of the containers
+	 */
+	std::size_t memory_bytes() const noexcept;
+
+	void clear() noexcept {
+		m_containers.clear();
+	}
+
+	CompressedBitmap &add(value_type value);
+
+	CompressedBitmap &remove(value_type value);
+
+	bool contains(value_type value) const noexcept;
+
+	/*!
+	  @brief		convert the containers to runs where it is smaller
+	  @return		some container is a run container
+	 */
+	bool run_optimize();
+
+	//! union
+	CompressedBitmap &operator|=(const CompressedBitmap &rhs);
+
+	//! intersection
+	CompressedBitmap &operator&=(const CompressedBitmap &rhs);
+
+	//! difference
+	CompressedBitmap &operator-=(const CompressedBitmap &rhs);
+
+	/*!
+	  @brief		call function(value) for each value in ascending order
+	 */
+	template<typename Function>
+	void for_each(Function function) const {
+		using namespace CompressedBitmap_impl;
+		for ( const Container &container : m_containers ) {
+			const value_type high{static_cast<value_type>(container.key) << 16};
+			switch ( container.kind ) {
+			case Kind::array:
+				for ( std::uint16_t low : container.values ) {
+					function(high | low);
+				}
+				break;
+			case Kind::bitmap:
+				for ( std::size_t i{0}; i < bitmap_words; ++i ) {
+					for ( BitVector_impl::word_type word{container.words[i]}; word != 0; word &= word - 1 ) {
+						function(high | static_cast<value_type>(i * BitVector_impl::word_bits
+																 + BitVector_impl::count_trailing_zeros(word)));
+					}
+				}
+				break;
+			case Kind::run:
+				for ( std::size_t i{0}; i < container.values.size(); i += 2 ) {
+					const size_type first{high | container.values[i]};
+					for ( size_type value{first}; value <= first + container.values[i + 1]; ++value ) {
+						function(static_cast<value_type>(value));
+					}
+				}
+				break;
+			}
+		}
+	}
+
+	/*!
+	  @brief		size of the serialized form
+	 */
+	std::size_t serialized_size() const noexcept;
+
+	/*!
+	  @brief		write the serialized form
+	  @param[out]	external	serialized_size() bytes
+	  @exception	std::invalid_argument	external == nullptr
+	 */
+	void serialize(unsigned char *external) const;
+
+	std::vector<unsigned char> serialize() const {
+		std::vector<unsigned char> external(serialized_size());
+		serialize(external.data());
+		return external;
+	}
+
+	bool operator==(const CompressedBitmap &rhs) const;
+
+	bool operator!=(const CompressedBitmap &rhs) const {
+		return !(*this == rhs);
+	}
+}; // class CompressedBitmap
+
+inline CompressedBitmap operator|(CompressedBitmap lhs, const CompressedBitmap &rhs)
+{
+	return lhs |= rhs;
+}
+
+inline CompressedBitmap operator&(CompressedBitmap lhs, const CompressedBitmap &rhs)
+{
+	return lhs &= rhs;
+}
+
+inline CompressedBitmap operator-(CompressedBitmap lhs, const CompressedBitmap &rhs)
+{
+	return lhs -= rhs;
+}
+
+/*!
+  @brief		read-only CompressedBitmap over its serialized form
+  @details		Nothing is copied, so the bytes can be a mapped file.
+				The bytes must outlive the view.
+ */
+class CompressedBitmapView
+{
+  public:
+	using value_type	= CompressedBitmap::value_type;
+	using size_type		= CompressedBitmap::size_type;
+
+  private:
+	const unsigned char	*m_data;
+	std::size_t			m_container_count;
+	size_type			m_cardinality;
+
+  public:
+	CompressedBitmapView() noexcept
+		: m_data{nullptr}, m_container_count{0}, m_cardinality{0}
+	{}
+
+	/*!
+	  @brief		check the header and the entries
+	  @details		The payloads are not read, so that a view of a mapped file
+					touches only its header and entries. A malformed payload
+					gives wrong answers but no access out of the bytes; the
+					constructor of CompressedBitmap checks it.
+	  @param[in]	external	serialized form
+	  @param[in]	size		size of external
+	  @exception	std::invalid_argument	external is not a serialized CompressedBitmap
+	 */
+	CompressedBitmapView(const void *external, std::size_t size);
+
+  public:
+	bool empty() const noexcept {
+		return m_container_count == 0;
+	}
+
+	size_type cardinality() const noexcept {
+		return m_cardinality;
+	}
+
+	std::size_t container_count() const noexcept {
+		return m_container_count;
+	}
+
+	bool contains(value_type value) const noexcept;
+
+	/*!
+	  @brief		call function(value) for each value in ascending order
+	 */
+	template<typename Function>
+	void for_each(Function function) const {
+		using namespace CompressedBitmap_impl;
+		for ( std::size_t i{0}; i < m_container_count; ++i ) {
+			const Entry entry{read_entry(i)};
+			const value_type high{static_cast<value_type>(entry.key) << 16};
+			const unsigned char * const payload = m_data + entry.offset;
+			switch ( entry.kind ) {
+			case Kind::array:
+				for ( std::size_t j{0}; j < entry.size; ++j ) {
+					function(high | read16(payload, j));
+				}
+				break;
+			case Kind::bitmap:
+				for ( std::size_t j{0}; j < bitmap_words; ++j ) {
+					for ( BitVector_impl::word_type word{read64(payload, j)}; word != 0; word &= word - 1 ) {
+						function(high | static_cast<value_type>(j * BitVector_impl::word_bits
+																 + BitVector_impl::count_trailing_zeros(word)));
+					}
+				}
+				break;
+			case Kind::run:
+				for ( std::size_t j{0}; j < entry.size; j += 2 ) {
+					const size_type first{high | read16(payload, j)};
+					for ( size_type value{first}; value <= first + read16(payload, j + 1); ++value ) {
+						function(static_cast<value_type>(value));
+					}
+				}
+				break;
+			}
+		}
+	}
+
+  private:
+	friend class CompressedBitmap;
+
+	struct Entry
+	{
+		std::uint16_t				key;
+		CompressedBitmap_impl::Kind	kind;
+		std::uint32_t				cardinality;
+		std::uint32_t				offset;
+		std::uint32_t				size;
+	};
+
+	Entry read_entry(std::size_t index) const noexcept;
+
+	//! @exception	std::invalid_argument	the values of the container do not match its entry
+	void validate_payload(const Entry &entry) const;
+
+	static std::uint16_t read16(const unsigned char *payload, std::size_t index) noexcept {
+		std::uint16_t value;
+		CompressedBitmap_impl::Converter::from_external<2>(payload + index * 2, value);
+		return value;
+	}
+
+	static BitVector_impl::word_type read64(const unsigned char *payload, std::size_t index) noexcept {
+		BitVector_impl::word_type word;
+		CompressedBitmap_impl::Converter::from_external<8>(payload + index * 8, word);
+		return word;
+	}
+}; // class CompressedBitmapView
+
+} // namespace aid
+
+
+#endif // aid_CompressedBitmap_hpp
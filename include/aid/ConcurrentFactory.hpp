@@ -0,0 +1,244 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file ConcurrentFactory.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_ConcurrentFactory_hpp
+#define aid_ConcurrentFactory_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "aid/Factory.hpp"
+#include "aid/Memory.hpp"
+#include "aid/NonCopyable.hpp"
+#include "aid/NonMovable.hpp"
+
+
+namespace aid {
+
+namespace ConcurrentFactory_impl {
+
+constexpr std::size_t reader_shard_count{64};
+
+//! the readers of the two epoch parities, in a cache line of its own
+struct alignas(64) ReaderShard
+{
+	std::atomic<unsigned long>	readers[2];
+
+	ReaderShard() noexcept
+		: readers{{0}, {0}}
+	{}
+};
+
+//! the shard of the calling thread; the threads are spread over the shards in the order of their first call
+inline std::size_t reader_shard() noexcept
+{
+	static std::atomic<std::size_t> next{0};
+	// (constant initialized, so that no TLS init function is called)
+	static thread_local std::size_t shard{reader_shard_count};
+	if ( shard == reader_shard_count ) {
+		shard = next.fetch_add(1, std::memory_order_relaxed) % reader_shard_count;
+	}
+	return shard;
+}
+
+} // namespace ConcurrentFactory_impl
+
+/*!
+  @brief		Factory whose create() runs concurrently with the registrations
+  @details		The creators are in an immutable snapshot which an atomic pointer
+				publishes. create() reads it with no lock and no wait: it counts
+				itself in the reader shard of its thread for the current epoch,
+				loads the pointer, and calls the creator.
+				register_creator() and the other updates copy the snapshot, change
+				the copy and publish it, then wait for the readers of the old one
+				to leave (two epoch flips, as the user-space RCU) before deleting
+				it. So the updates are serialized and O(n), fit for plugin loading
+				rather than for a changing set of products.
+
+				A creator must not update the factory which calls it: the update
+				would wait for the call to finish.
+ */
+template<
+	class AbstractProductPtr
+	, typename Identifier
+	, typename ProductCreator = AbstractProductPtr (*)()
+	, template<typename, class> class FactoryErrorPolicy = DefaultFactoryError
+	, template<typename, typename> class FactoryLookupPolicy = MapFactoryLookup
+	>
+class ConcurrentFactory
+	: public FactoryErrorPolicy<Identifier, AbstractProductPtr>
+	, private NonCopyable
+	, private NonMovable
+{
+  private:
+	using IdToProductMap	= FactoryLookupPolicy<Identifier, ProductCreator>;
+	using ReaderShard		= ConcurrentFactory_impl::ReaderShard;
+	using ReaderShards		= std::vector<ReaderShard, AlignedAllocator<ReaderShard, alignof(ReaderShard)>>;
+
+  public:
+	using abstract_product_ptr_type	= AbstractProductPtr;
+	using identifier_type			= Identifier;
+	using product_creator_type		= ProductCreator;
+	using error_policy_type			= FactoryErrorPolicy<Identifier, AbstractProductPtr>;
+	using lookup_policy_type		= IdToProductMap;
+
+  private:
+	//! counts a reader from the load of the snapshot to the end of its use
+	class ReadGuard
+		: private NonCopyable
+		, private NonMovable
+	{
+	  private:
+		std::atomic<unsigned long>	&m_readers;
+		const IdToProductMap		&m_snapshot;
+
+	  public:
+		explicit ReadGuard(const ConcurrentFactory &factory) noexcept
+			: m_readers(factory.enter())
+			, m_snapshot(*factory.m_snapshot.load())
+		{}
+
+		~ReadGuard() {
+			m_readers.fetch_sub(1, std::memory_order_release);
+		}
+
+		const IdToProductMap &snapshot() const noexcept {
+			return m_snapshot;
+		}
+	}; // class ReadGuard
+
+  private:
+	std::atomic<IdToProductMap *>	m_snapshot;
+	std::atomic<unsigned long>		m_epoch;
+	mutable ReaderShards			m_shards;
+	std::mutex						m_update_mutex;
+
+  private:
+	std::atomic<unsigned long> &enter() const noexcept {
+		const unsigned long parity{m_epoch.load(std::memory_order_acquire) & 1};
+		std::atomic<unsigned long> &readers = m_shards[ConcurrentFactory_impl::reader_shard()].readers[parity];
+		// (sequentially consistent, so that the following load of the snapshot is not done before)
+		readers.fetch_add(1);
+		return readers;
+	}
+
+	void wait_for_readers(unsigned long parity) const noexcept {
+		for ( const auto &shard : m_shards ) {
+			while ( shard.readers[parity].load() != 0 ) {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	//! wait for the readers which may have loaded a snapshot before the last exchange
+	void synchronize() noexcept {
+		// A reader may have read the epoch before the previous flip, so both parities are waited for.
+		for ( int flip{0}; flip < 2; ++flip ) {
+			const unsigned long epoch{m_epoch.load(std::memory_order_relaxed)};
+			m_epoch.store(epoch + 1);
+			wait_for_readers(epoch & 1);
+		}
+	}
+
+	/*!
+	  @brief		publish a copy of the snapshot changed by change, if change returns true
+	  @return		the result of change
+	 */
+	template<typename Update>
+	bool update(Update &&change) {
+		std::lock_guard<std::mutex> guard(m_update_mutex);
+		std::unique_ptr<IdToProductMap> next{new IdToProductMap(*m_snapshot.load(std::memory_order_relaxed))};
+		if ( !change(*next) ) {
+			return false;
+		}
+		const std::unique_ptr<IdToProductMap> retired{m_snapshot.exchange(next.release())};
+		synchronize();
+		return true;
+	}
+
+  public:
+	ConcurrentFactory()
+		: m_snapshot{nullptr}, m_epoch{0}, m_shards(ConcurrentFactory_impl::reader_shard_count), m_update_mutex{}
+	{
+		m_snapshot.store(new IdToProductMap);
+	}
+
+	~ConcurrentFactory() {
+		delete m_snapshot.load();
+	}
+
+  public:
+	bool register_creator(const identifier_type &id, product_creator_type creator) {
+		return update([&id, &creator](IdToProductMap &associations) {
+			return associations.insert(id, std::move(creator));
+		});
+	}
+
+	bool unregister_creator(const identifier_type &id) {
+		return update([&id](IdToProductMap &associations) {
+			return associations.erase(id);
+		});
+	}
+
+	//! the identifiers of the current snapshot
+	std::vector<identifier_type> registered_ids() const {
+		const ReadGuard guard(*this);
+		return guard.snapshot().ids();
+	}
+
+	void clear_creator() {
+		update([](IdToProductMap &associations) {
+			associations.clear();
+			return true;
+		});
+	}
+
+	/*!
+	  @brief		create a product with the creator of id in the current snapshot
+	  @details		The creator is called while the snapshot is counted, so the
+					updates wait for it.
+	 */
+	template<typename... Args>
+	abstract_product_ptr_type create(const identifier_type &id, Args &&... args) const {
+		const ReadGuard guard(*this);
+		const product_creator_type * const creator = guard.snapshot().find(id);
+		if ( creator == nullptr ) {
+			return this->on_unknown_type(id);
+		}
+		return (*creator)(std::forward<Args>(args)...);
+	}
+
+	/*!
+	  @brief		publish a perfect hash of the registered identifiers (FrozenFactoryLookup only)
+	  @return		whether the lookups are frozen
+	 */
+	bool freeze() {
+		return update([](IdToProductMap &associations) {
+			return associations.freeze();
+		});
+	}
+}; // class ConcurrentFactory
+
+} // namespace aid
+
+
+#endif // aid_ConcurrentFactory_hpp
@@ -0,0 +1,166 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file CountMinSketch.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_CountMinSketch_hpp
+#define aid_CountMinSketch_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+
+namespace aid {
+
+namespace CountMinSketch_impl {
+
+using hash_type		= std::uint64_t;
+using count_type	= std::uint64_t;
+
+constexpr unsigned int max_depth{16};
+constexpr std::size_t max_width{std::size_t{1} << 32};
+
+/*!
+  @brief		the counter of hash in row, from [0, width)
+  @details		The rows take h1 + row * h2 of the two halves of hash (double
+				hashing), so that one 64-bit hash serves all the rows.
+ */
+inline std::size_t column(hash_type hash, unsigned int row, std::size_t width) noexcept
+{
+	const std::uint32_t h1{static_cast<std::uint32_t>(hash)};
+	const std::uint32_t h2{static_cast<std::uint32_t>(hash >> 32) | 1};
+	return static_cast<std::size_t>((std::uint64_t{static_cast<std::uint32_t>(h1 + row * h2)} * width) >> 32);
+}
+
+} // namespace CountMinSketch_impl
+
+/*!
+  @brief		count-min sketch, which estimates the counts of the keys in fixed space
+  @details		A key adds its count to one counter in each of depth rows of
+				width counters, and its estimate is the least of them. An
+				estimate is never less than the true count, and exceeds it by
+				more than e / width of total() with a probability of at most
+				exp(-depth): width = 2719 and depth = 5 are within 0.1% of the
+				total with 99.3%.
+
+				The keys are given as 64-bit hashes, whose every bit must depend on
+				the key: hash_word(), hash_bytes() or std::hash<BitVector>, as for
+				BloomFilter.
+ */
+class CountMinSketch
+{
+  public:
+	using size_type		= std::size_t;
+	using hash_type		= CountMinSketch_impl::hash_type;
+	using count_type	= CountMinSketch_impl::count_type;
+
+  private:
+	std::vector<count_type>	m_counters;	// row major
+	size_type				m_width;
+	unsigned int			m_depth;
+	count_type				m_total;
+
+  private:
+	static size_type checked_size(size_type width, unsigned int depth) {
+		if ( width == 0 ) throw std::invalid_argument("width == 0");
+		if ( depth == 0 || depth > CountMinSketch_impl::max_depth ) throw std::invalid_argument("depth not in [1, 16]");
+		if ( width > CountMinSketch_impl::max_width ) throw std::length_error("width > 2^32");
+		return width * depth;
+	}
+
+  public:
+	/*!
+	  @brief		construct a sketch of zero counts
+	  @param[in]	width	counters of a row
+	  @param[in]	depth	rows
+	  @exception	std::invalid_argument	width == 0, depth == 0 or depth > 16
+	  @exception	std::length_error		width > 2^32
+	 */
+	CountMinSketch(size_type width, unsigned int depth)
+		: m_counters(checked_size(width, depth), 0), m_width{width}, m_depth{depth}, m_total{0}
+	{}
+
+  public:
+	size_type width() const noexcept {
+		return m_width;
+	}
+
+	unsigned int depth() const noexcept {
+		return m_depth;
+	}
+
+	//! get the sum of the counts added
+	count_type total() const noexcept {
+		return m_total;
+	}
+
+	void add(hash_type hash, count_type count = 1) noexcept {
+		count_type *row = m_counters.data();
+		for ( unsigned int i{0}; i < m_depth; ++i, row += m_width ) {
+			row[CountMinSketch_impl::column(hash, i, m_width)] += count;
+		}
+		m_total += count;
+	}
+
+	/*!
+	  @brief		estimate the count of a key
+	  @return		at least the sum of the counts added with hash
+	 */
+	count_type estimate(hash_type hash) const noexcept {
+		const count_type *row = m_counters.data();
+		count_type least{row[CountMinSketch_impl::column(hash, 0, m_width)]};
+		for ( unsigned int i{1}; i < m_depth; ++i ) {
+			row += m_width;
+			const count_type count{row[CountMinSketch_impl::column(hash, i, m_width)]};
+			least = count < least ? count : least;
+		}
+		return least;
+	}
+
+	//! set all the counts to zero
+	void clear() noexcept {
+		m_counters.assign(m_counters.size(), 0);
+		m_total = 0;
+	}
+
+	/*!
+	  @brief		add the counts of other, of another partition of a stream for example
+	  @exception	std::invalid_argument	width() != other.width() || depth() != other.depth()
+	 */
+	CountMinSketch &operator+=(const CountMinSketch &other) {
+		if ( m_width != other.m_width || m_depth != other.m_depth ) throw std::invalid_argument("different shapes");
+		for ( size_type i{0}; i < m_counters.size(); ++i ) {
+			m_counters[i] += other.m_counters[i];
+		}
+		m_total += other.m_total;
+		return *this;
+	}
+
+	bool operator==(const CountMinSketch &rhs) const noexcept {
+		return m_width == rhs.m_width && m_total == rhs.m_total && m_counters == rhs.m_counters;
+	}
+
+	bool operator!=(const CountMinSketch &rhs) const noexcept {
+		return !(*this == rhs);
+	}
+}; // class CountMinSketch
+
+} // namespace aid
+
+
+#endif // aid_CountMinSketch_hpp
@@ -0,0 +1,458 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file DynamicBitVector.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_DynamicBitVector_hpp
+#define aid_DynamicBitVector_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "aid/Memory.hpp"
+
+
+namespace aid {
+
+/*!
+  @brief		word-parallel bit operation
+ */
+enum class BitOp: unsigned char
+{
+	and_		//!< x & y
+	, or_		//!< x | y
+	, xor_		//!< x ^ y
+	, and_not	//!< x & ~y
+};
+
+namespace BitVector_impl {
+
+using word_type	= std::uint64_t;
+
+constexpr std::size_t word_bits{64};
+constexpr std::size_t line_words{8};	// words of a 64-byte cache line
+
+inline unsigned int popcount(word_type word) noexcept
+{
+#if		defined(__GNUC__)
+	return static_cast<unsigned int>(__builtin_popcountll(word));
+#else
+	word = word - ((word >> 1) & 0x5555555555555555u);
+	word = (word & 0x3333333333333333u) + ((word >> 2) & 0x3333333333333333u);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Fu;
+	return static_cast<unsigned int>((word * 0x0101010101010101u) >> 56);
+#endif
+}
+
+/*!
+  @brief		index of the lowest set bit (tzcnt)
+  @pre			word != 0
+ */
+inline unsigned int count_trailing_zeros(word_type word) noexcept
+{
+#if		defined(__GNUC__)
+	return static_cast<unsigned int>(__builtin_ctzll(word));
+#else
+	unsigned int n{0};
+	for ( ; (word & 1) == 0; word >>= 1 ) ++n;
+	return n;
+#endif
+}
+
+inline word_type apply(BitOp op, word_type x, word_type y) noexcept
+{
+	switch ( op ) {
+	case BitOp::and_:		return x & y;
+	case BitOp::or_:		return x | y;
+	case BitOp::xor_:		return x ^ y;
+	case BitOp::and_not:	return x & ~y;
+	}
+	return x;
+}
+
+/*!
+  @brief		dst[i] = dst[i] op src[i]
+ */
+void apply_n(word_type *dst, const word_type *src, std::size_t count, BitOp op) noexcept;
+
+/*!
+  @brief		dst[i] = dst[i] outer (a[i] inner b[i])
+ */
+void apply_n(word_type *dst, const word_type *a, const word_type *b, std::size_t count,
+			 BitOp outer, BitOp inner) noexcept;
+
+/*!
+  @brief		dst[i] = ~dst[i]
+ */
+void flip_n(word_type *dst, std::size_t count) noexcept;
+
+/*!
+  @brief		number of the set bits of src[0, count)
+ */
+std::size_t count_n(const word_type *src, std::size_t count) noexcept;
+
+/*!
+  @brief		number of the set bits of (a[i] op b[i]) for i in [0, count)
+ */
+std::size_t count_n(const word_type *a, const word_type *b, std::size_t count, BitOp op) noexcept;
+
+} // namespace BitVector_impl
+
+/*!
+  @brief		dynamically sized bit vector
+  @details		The words are aligned to and padded to cache lines, so the
+				bulk operations run whole AVX2/AVX-512 vectors without a
+				tail. The bits past size() are always zero.
+ */
+class DynamicBitVector
+{
+  public:
+	using word_type	= BitVector_impl::word_type;
+	using size_type	= std::size_t;
+
+	static constexpr size_type npos{static_cast<size_type>(-1)};
+
+  private:
+	using Words	= std::vector<word_type, AlignedAllocator<word_type, 64>>;
+
+  private:
+	Words		m_words;
+	size_type	m_size;
+
+  private:
+	static constexpr size_type word_count(size_type size) noexcept {
+		return (size + BitVector_impl::word_bits - 1) / BitVector_impl::word_bits;
+	}
+
+	static constexpr size_type padded_word_count(size_type size) noexcept {
+		return (word_count(size) + BitVector_impl::line_words - 1)
+			/ BitVector_impl::line_words * BitVector_impl::line_words;
+	}
+
+	static constexpr word_type bit(size_type index) noexcept {
+		return word_type{1} << (index % BitVector_impl::word_bits);
+	}
+
+	// clear the bits past size() in the last word
+	void clear_tail() noexcept {
+		const size_type used{m_size % BitVector_impl::word_bits};
+		if ( used != 0 ) {
+			m_words[m_size / BitVector_impl::word_bits] &= (word_type{1} << used) - 1;
+		}
+	}
+
+	void check_index(size_type index) const {
+		if ( index >= m_size ) throw std::out_of_range("index >= size()");
+	}
+
+	void check_size(const DynamicBitVector &other) const {
+		if ( other.m_size != m_size ) throw std::invalid_argument("size() != other.size()");
+	}
+
+  public:
+	DynamicBitVector() noexcept
+		: m_words{}, m_size{0}
+	{}
+
+	/*!
+	  @brief		construct a bit vector of size bits
+	  @param[in]	size	number of the bits
+	  @param[in]	value	value of all the bits
+	 */
+	explicit DynamicBitVector(size_type size, bool value = false)
+		: m_words(padded_word_count(size), value ? ~word_type{0} : 0), m_size{size}
+	{
+		if ( value ) {
+			for ( size_type i{word_count(size)}; i < m_words.size(); ++i ) {
+				m_words[i] = 0;
+			}
+			clear_tail();
+		}
+	}
+
+  public:
+	size_type size() const noexcept {
+		return m_size;
+	}
+
+	bool empty() const noexcept {
+		return m_size == 0;
+	}
+
+	/*!
+	  @brief		get the words, including the zero padding to a cache line
+	 */
+	const word_type *data() const noexcept {
+		return m_words.data();
+	}
+
+	/*!
+	  @brief		get the words to write them in bulk
+	  @attention	The bits past size() must be left zero.
+	 */
+	word_type *data() noexcept {
+		return m_words.data();
+	}
+
+	/*!
+	  @brief		get the number of the words returned by data()
+	 */
+	size_type word_size() const noexcept {
+		return m_words.size();
+	}
+
+	/*!
+	  @brief		change the number of the bits
+	  @param[in]	size	new number of the bits
+	  @param[in]	value	value of the added bits
+	 */
+	void resize(size_type size, bool value = false) {
+		const size_type old_size{m_size};
+		m_words.resize(padded_word_count(size), 0);
+		m_size = size;
+		for ( size_type i{word_count(size)}; i < word_count(old_size) && i < m_words.size(); ++i ) {
+			m_words[i] = 0;
+		}
+		if ( value && size > old_size ) {
+			for ( size_type i{old_size}; i < size && i % BitVector_impl::word_bits != 0; ++i ) {
+				m_words[i / BitVector_impl::word_bits] |= bit(i);
+			}
+			for ( size_type i{word_count(old_size)}; i < word_count(size); ++i ) {
+				m_words[i] = ~word_type{0};
+			}
+		}
+		clear_tail();
+	}
+
+	void clear() noexcept {
+		m_words.clear();
+		m_size = 0;
+	}
+
+	/*!
+	  @brief		get a bit without a range check
+	 */
+	bool operator[](size_type index) const noexcept {
+		return (m_words[index / BitVector_impl::word_bits] & bit(index)) != 0;
+	}
+
+	/*!
+	  @brief		get a bit
+	  @exception	std::out_of_range	index >= size()
+	 */
+	bool test(size_type index) const {
+		check_index(index);
+		return (*this)[index];
+	}
+
+	/*!
+	  @brief		set a bit
+	  @exception	std::out_of_range	index >= size()
+	 */
+	DynamicBitVector &set(size_type index, bool value = true) {
+		check_index(index);
+		word_type &word = m_words[index / BitVector_impl::word_bits];
+		word = value ? word | bit(index) : word & ~bit(index);
+		return *this;
+	}
+
+	/*!
+	  @brief		clear a bit
+	  @exception	std::out_of_range	index >= size()
+	 */
+	DynamicBitVector &reset(size_type index) {
+		return set(index, false);
+	}
+
+	/*!
+	  @brief		invert a bit
+	  @exception	std::out_of_range	index >= size()
+	 */
+	DynamicBitVector &flip(size_type index) {
+		check_index(index);
+		m_words[index / BitVector_impl::word_bits] ^= bit(index);
+		return *this;
+	}
+
+	//! set all the bits
+	DynamicBitVector &set() noexcept {
+		for ( size_type i{0}; i < word_count(m_size); ++i ) {
+			m_words[i] = ~word_type{0};
+		}
+		clear_tail();
+		return *this;
+	}
+
+	//! clear all the bits
+	DynamicBitVector &reset() noexcept {
+		for ( word_type &word : m_words ) {
+			word = 0;
+		}
+		return *this;
+	}
+
+	//! invert all the bits
+	DynamicBitVector &flip() noexcept {
+		BitVector_impl::flip_n(m_words.data(), word_count(m_size));
+		clear_tail();
+		return *this;
+	}
+
+	/*!
+	  @brief		number of the set bits
+	 */
+	size_type count() const noexcept {
+		return BitVector_impl::count_n(m_words.data(), m_words.size());
+	}
+
+	/*!
+	  @brief		number of the set bits of (*this op other), without making it
+	  @exception	std::invalid_argument	other.size() != size()
+	 */
+	size_type count(BitOp op, const DynamicBitVector &other) const {
+		check_size(other);
+		return BitVector_impl::count_n(m_words.data(), other.m_words.data(), m_words.size(), op);
+	}
+
+	bool any() const noexcept {
+		return find_first() != npos;
+	}
+
+	bool none() const noexcept {
+		return !any();
+	}
+
+	bool all() const noexcept {
+		return count() == m_size;
+	}
+
+	/*!
+	  @brief		*this = *this op other
+	  @exception	std::invalid_argument	other.size() != size()
+	 */
+	DynamicBitVector &apply(BitOp op, const DynamicBitVector &other) {
+		check_size(other);
+		BitVector_impl::apply_n(m_words.data(), other.m_words.data(), m_words.size(), op);
+		return *this;
+	}
+
+	/*!
+	  @brief		*this = *this outer (a inner b) in one pass
+	  @details		a.apply(BitOp::and_, b, BitOp::or_, c) is a &= b | c
+					without a temporary bit vector.
+	  @exception	std::invalid_argument	a.size() != size() || b.size() != size()
+	 */
+	DynamicBitVector &apply(BitOp outer, const DynamicBitVector &a, BitOp inner, const DynamicBitVector &b) {
+		check_size(a);
+		check_size(b);
+		BitVector_impl::apply_n(m_words.data(), a.m_words.data(), b.m_words.data(), m_words.size(),
+								outer, inner);
+		return *this;
+	}
+
+	DynamicBitVector &operator&=(const DynamicBitVector &other) {
+		return apply(BitOp::and_, other);
+	}
+
+	DynamicBitVector &operator|=(const DynamicBitVector &other) {
+		return apply(BitOp::or_, other);
+	}
+
+	DynamicBitVector &operator^=(const DynamicBitVector &other) {
+		return apply(BitOp::xor_, other);
+	}
+
+	DynamicBitVector operator~() const {
+		DynamicBitVector result(*this);
+		return result.flip();
+	}
+
+	/*!
+	  @brief		index of the first set bit
+	  @return		npos if no bit is set
+	 */
+	size_type find_first() const noexcept {
+		return find_from_word(0);
+	}
+
+	/*!
+	  @brief		index of the first set bit after index
+	  @return		npos if no bit is set after index
+	 */
+	size_type find_next(size_type index) const noexcept {
+		if ( index == npos || ++index >= m_size ) {
+			return npos;
+		}
+		const size_type i{index / BitVector_impl::word_bits};
+		const word_type word{m_words[i] & (~word_type{0} << (index % BitVector_impl::word_bits))};
+		if ( word != 0 ) {
+			return i * BitVector_impl::word_bits + BitVector_impl::count_trailing_zeros(word);
+		}
+		return find_from_word(i + 1);
+	}
+
+	/*!
+	  @brief		call a function with the index of each set bit in ascending order
+	  @param[in]	function	called as function(size_type index)
+	 */
+	template<typename Function>
+	void for_each_set(Function function) const {
+		for ( size_type i{0}; i < word_count(m_size); ++i ) {
+			for ( word_type word{m_words[i]}; word != 0; word &= word - 1 ) {
+				function(i * BitVector_impl::word_bits + BitVector_impl::count_trailing_zeros(word));
+			}
+		}
+	}
+
+	bool operator==(const DynamicBitVector &rhs) const noexcept {
+		return m_size == rhs.m_size && m_words == rhs.m_words;
+	}
+
+	bool operator!=(const DynamicBitVector &rhs) const noexcept {
+		return !(*this == rhs);
+	}
+
+  private:
+	size_type find_from_word(size_type first) const noexcept {
+		for ( size_type i{first}; i < word_count(m_size); ++i ) {
+			if ( m_words[i] != 0 ) {
+				return i * BitVector_impl::word_bits + BitVector_impl::count_trailing_zeros(m_words[i]);
+			}
+		}
+		return npos;
+	}
+}; // class DynamicBitVector
+
+inline DynamicBitVector operator&(DynamicBitVector lhs, const DynamicBitVector &rhs)
+{
+	return lhs &= rhs;
+}
+
+inline DynamicBitVector operator|(DynamicBitVector lhs, const DynamicBitVector &rhs)
+{
+	return lhs |= rhs;
+}
+
+inline DynamicBitVector operator^(DynamicBitVector lhs, const DynamicBitVector &rhs)
+{
+	return lhs ^= rhs;
+}
+
+} // namespace aid
+
+
+#endif // aid_DynamicBitVector_hpp
@@ -29,6 +29,148 @@ class DynamicEndianConverter
 	template<EndianType t_external_type>
 	using Native = Endian_impl::Converter<t_external_type, Endian_impl::native_type()>;
 
+  public:
+	/*!
+	  @brief		converter resolved for an external endian type, an integer type and a size
+	  @details		DynamicEndianConverter::resolve() validates all the arguments,
+					so the conversions neither check them nor switch on the endian type.
+	  @tparam		Integer	integer type
+	 */
+	template<typename Integer>
+	class Resolved
+	{
+		friend class DynamicEndianConverter;
+
+	  private:
+		using ToExternal		= void (*)(Integer, unsigned char *, std::size_t);
+		using FromExternal		= void (*)(const unsigned char *, std::size_t, Integer &);
+		using ToExternalN		= void (*)(const Integer *, std::size_t, unsigned char *, std::size_t);
+		using FromExternalN		= void (*)(const unsigned char *, std::size_t, Integer *, std::size_t);
+
+	  private:
+		ToExternal		m_to_external;
+		FromExternal	m_from_external;
+		ToExternalN		m_to_external_n;
+		FromExternalN	m_from_external_n;
+		std::size_t		m_size;
+
+	  private:
+		Resolved(ToExternal to, FromExternal from,
+				 ToExternalN to_n, FromExternalN from_n, std::size_t size) noexcept
+			: m_to_external{to}, m_from_external{from}
+			, m_to_external_n{to_n}, m_from_external_n{from_n}, m_size{size}
+		{}
+
+	  public:
+		/*!
+		  @brief		get the size of the external endian value
+		 */
+		std::size_t size() const noexcept {
+			return m_size;
+		}
+
+		/*!
+		  @brief		convert a native endian value to a external endian value
+		  @param[in]	native		native endian value
+		  @param[out]	external	pointer to the beginning of the external endian value
+		  @pre			external != nullptr
+		  @attention	This function does not check the pre-conditions.
+		 */
+		void to_external(Integer native, unsigned char *external) const {
+			m_to_external(native, external, m_size);
+		}
+
+		/*!
+		  @brief		convert a external endian value to a native endian value
+		  @param[in]	external	pointer to the beginning of the external endian value
+		  @param[out]	native		native endian value
+		  @pre			external != nullptr
+		  @attention	This function does not check the pre-conditions.
+		 */
+		void from_external(const unsigned char *external, Integer &native) const {
+			m_from_external(external, m_size, native);
+		}
+
+		/*!
+		  @brief		convert a external endian value to a native endian value
+		  @param[in]	external	pointer to the beginning of the external endian value
+		  @return		native endian value
+		  @pre			external != nullptr
+		  @attention	This function does not check the pre-conditions.
+		 */
+		Integer from_external(const unsigned char *external) const {
+			Integer native;
+			m_from_external(external, m_size, native);
+			return native;
+		}
+
+		/*!
+		  @brief		convert native endian values to packed external endian values
+		  @param[in]	native		pointer to the beginning of the native endian values
+		  @param[in]	count		number of the values
+		  @param[out]	external	pointer to the beginning of the external endian values
+								(count * size() bytes)
+		  @pre			native != nullptr && external != nullptr
+		  @attention	This function does not check the pre-conditions.
+		 */
+		void to_external_n(const Integer *native, std::size_t count, unsigned char *external) const {
+			m_to_external_n(native, count, external, m_size);
+		}
+
+		/*!
+		  @brief		convert packed external endian values to native endian values
+		  @param[in]	external	pointer to the beginning of the external endian values
+								(count * size() bytes)
+		  @param[in]	count		number of the values
+		  @param[out]	native		pointer to the beginning of the native endian values
+		  @pre			native != nullptr && external != nullptr
+		  @attention	This function does not check the pre-conditions.
+		 */
+		void from_external_n(const unsigned char *external, std::size_t count, Integer *native) const {
+			m_from_external_n(external, count, native, m_size);
+		}
+	}; // class Resolved
+
+  private:
+	template<EndianType t_external_type, typename Integer>
+	static void to_external_packed(const Integer *native, std::size_t count,
+								   unsigned char *external, std::size_t) {
+		Native<t_external_type>::to_external_n(native, count, external);
+	}
+
+	template<EndianType t_external_type, typename Integer>
+	static void to_external_sized(const Integer *native, std::size_t count,
+								  unsigned char *external, std::size_t size) {
+		for ( std::size_t i{0}; i < count; ++i ) {
+			Native<t_external_type>::to_external(native[i], external + i * size, size);
+		}
+	}
+
+	template<EndianType t_external_type, typename Integer>
+	static void from_external_packed(const unsigned char *external, std::size_t count,
+									 Integer *native, std::size_t) {
+		Native<t_external_type>::from_external_n(external, count, native);
+	}
+
+	template<EndianType t_external_type, typename Integer>
+	static void from_external_sized(const unsigned char *external, std::size_t count,
+									Integer *native, std::size_t size) {
+		for ( std::size_t i{0}; i < count; ++i ) {
+			Native<t_external_type>::from_external(external + i * size, size, native[i]);
+		}
+	}
+
+	template<EndianType t_external_type, typename Integer>
+	static Resolved<Integer> make_resolved(std::size_t size) noexcept {
+		const bool packed{size == sizeof(Integer)};
+		return Resolved<Integer>(
+			&Native<t_external_type>::template to_external<Integer>,
+			&Native<t_external_type>::template from_external<Integer>,
+			packed ? &to_external_packed<t_external_type, Integer> : &to_external_sized<t_external_type, Integer>,
+			packed ? &from_external_packed<t_external_type, Integer> : &from_external_sized<t_external_type, Integer>,
+			size);
+	}
+
   private:
 	EndianType	m_external_type;
 
@@ -71,12 +213,14 @@ class DynamicEndianConverter
 	  @exception	std::invalid_argument	external == nullptr
 	  @exception	std::length_error		size == 0
 	  @exception	std::invalid_argument	size > sizeof(native)
+	  @exception	std::invalid_argument	size != sizeof(native) for a floating point type
 	 */
 	template<typename Integer>
 	void to_external(Integer native, unsigned char *external, std::size_t size) const {
 		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
 		if ( size == 0 ) throw std::length_error("size == 0");
 		if ( size > sizeof(native) ) throw std::invalid_argument("size > sizeof(native)");
+		Endian_impl::check_floating_point_size<Integer>(size);
 
 		switch ( m_external_type ) {
 		case EndianType::little:
@@ -126,12 +270,14 @@ class DynamicEndianConverter
 	  @exception	std::invalid_argument	external == nullptr
 	  @exception	std::length_error		size == 0
 	  @exception	std::invalid_argument	size > sizeof(native)
+	  @exception	std::invalid_argument	size != sizeof(native) for a floating point type
 	 */
 	template<typename Integer>
 	void from_external(const unsigned char *external, std::size_t size, Integer &native) const {
 		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
 		if ( size == 0 ) throw std::length_error("size == 0");
 		if ( size > sizeof(native) ) throw std::invalid_argument("size > sizeof(native)");
+		Endian_impl::check_floating_point_size<Integer>(size);
 
 		switch ( m_external_type ) {
 		case EndianType::little:
@@ -171,11 +317,112 @@ class DynamicEndianConverter
 	void from_external(const char (&external)[t_size], Integer &native) const {
 		from_external(external, t_size, native);
 	}
+
+	/*!
+	  @brief		resolve the converter for the current external endian type
+	  @tparam		Integer	integer type
+	  @param[in]	size	size of the external endian value
+	  @return		resolved converter, which stays valid after set_external_type()
+	  @exception	std::length_error		size == 0
+	  @exception	std::invalid_argument	size > sizeof(Integer)
+	  @exception	std::invalid_argument	size != sizeof(Integer) for a floating point type
+	  @exception	std::logic_error		m_external_type is unknown
+	 */
+	template<typename Integer>
+	Resolved<Integer> resolve(std::size_t size = sizeof(Integer)) const {
+		if ( size == 0 ) throw std::length_error("size == 0");
+		if ( size > sizeof(Integer) ) throw std::invalid_argument("size > sizeof(native)");
+		Endian_impl::check_floating_point_size<Integer>(size);
+
+		switch ( m_external_type ) {
+		case EndianType::little:
+			return make_resolved<EndianType::little, Integer>(size);
+		case EndianType::big:
+			return make_resolved<EndianType::big, Integer>(size);
+		default:
+			throw std::logic_error("m_external_type is unknown");
+		}
+	}
+
+	/*!
+	  @brief		convert native endian values to external endian values
+	  @tparam		Integer		integer type
+	  @param[in]	native		pointer to the beginning of the native endian values
+	  @param[in]	count		number of the values
+	  @param[out]	external	pointer to the beginning of the external endian values
+							(count * sizeof(Integer) bytes)
+	  @exception	std::invalid_argument	native == nullptr && count > 0
+	  @exception	std::invalid_argument	external == nullptr && count > 0
+	  @exception	std::logic_error		m_external_type is unknown
+	  @pre			native and external are the same or do not overlap
+	 */
+	template<typename Integer>
+	void to_external_n(const Integer *native, std::size_t count, unsigned char *external) const {
+		if ( count == 0 ) return;
+		if ( native == nullptr ) throw std::invalid_argument("native == nullptr");
+		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
+
+		switch ( m_external_type ) {
+		case EndianType::little:
+			return Native<EndianType::little>::to_external_n(native, count, external);
+		case EndianType::big:
+			return Native<EndianType::big>::to_external_n(native, count, external);
+		default:
+			throw std::logic_error("m_external_type is unknown");
+		}
+	}
+
+	/*!
+	  @copydoc		to_external_n(const Integer *,std::size_t,unsigned char *)
+	 */
+	template<typename Integer>
+	void to_external_n(const Integer *native, std::size_t count, char *external) const {
+		to_external_n(native, count, reinterpret_cast<unsigned char *>(external));
+	}
+
+	/*!
+	  @brief		convert external endian values to native endian values
+	  @tparam		Integer		integer type
+	  @param[in]	external	pointer to the beginning of the external endian values
+							(count * sizeof(Integer) bytes)
+	  @param[in]	count		number of the values
+	  @param[out]	native		pointer to the beginning of the native endian values
+	  @exception	std::invalid_argument	external == nullptr && count > 0
+	  @exception	std::invalid_argument	native == nullptr && count > 0
+	  @exception	std::logic_error		m_external_type is unknown
+	  @pre			native and external are the same or do not overlap
+	 */
+	template<typename Integer>
+	void from_external_n(const unsigned char *external, std::size_t count, Integer *native) const {
+		if ( count == 0 ) return;
+		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
+		if ( native == nullptr ) throw std::invalid_argument("native == nullptr");
+
+		switch ( m_external_type ) {
+		case EndianType::little:
+			return Native<EndianType::little>::from_external_n(external, count, native);
+		case EndianType::big:
+			return Native<EndianType::big>::from_external_n(external, count, native);
+		default:
+			throw std::logic_error("m_external_type is unknown");
+		}
+	}
+
+	/*!
+	  @copydoc		from_external_n(const unsigned char *,std::size_t,Integer *)
+	 */
+	template<typename Integer>
+	void from_external_n(const char *external, std::size_t count, Integer *native) const {
+		from_external_n(reinterpret_cast<const unsigned char *>(external), count, native);
+	}
 }; // class DynamicEndianConverter
 
 #define aid_DEFINE_DynamicEndianConverter_external(DModifier, DInteger) \
 	DModifier template void DynamicEndianConverter::to_external(DInteger, unsigned char *, std::size_t) const; \
-	DModifier template void DynamicEndianConverter::from_external(const unsigned char *, std::size_t, DInteger &) const
+	DModifier template void DynamicEndianConverter::from_external(const unsigned char *, std::size_t, DInteger &) const; \
+	DModifier template void DynamicEndianConverter::to_external_n(const DInteger *, std::size_t, unsigned char *) const; \
+	DModifier template void DynamicEndianConverter::from_external_n(const unsigned char *, std::size_t, DInteger *) const; \
+	DModifier template DynamicEndianConverter::Resolved<DInteger> DynamicEndianConverter::resolve(std::size_t) const
 #define aid_DEFINE_DynamicEndianConverter(DModifier) \
 	aid_DEFINE_DynamicEndianConverter_external(DModifier, char); \
 	aid_DEFINE_DynamicEndianConverter_external(DModifier, wchar_t); \
@@ -190,7 +437,18 @@ class DynamicEndianConverter
 	aid_DEFINE_DynamicEndianConverter_external(DModifier, unsigned long); \
 	aid_DEFINE_DynamicEndianConverter_external(DModifier, long); \
 	aid_DEFINE_DynamicEndianConverter_external(DModifier, unsigned long long); \
-	aid_DEFINE_DynamicEndianConverter_external(DModifier, long long)
+	aid_DEFINE_DynamicEndianConverter_external(DModifier, long long); \
+	aid_DEFINE_DynamicEndianConverter_external(DModifier, float); \
+	aid_DEFINE_DynamicEndianConverter_external(DModifier, double) \
+	aid_DEFINE_DynamicEndianConverter_int128(DModifier)
+#if		defined(AID_HAS_INT128)
+#define aid_DEFINE_DynamicEndianConverter_int128(DModifier) \
+	; \
+	aid_DEFINE_DynamicEndianConverter_external(DModifier, int128_t); \
+	aid_DEFINE_DynamicEndianConverter_external(DModifier, uint128_t)
+#else
+#define aid_DEFINE_DynamicEndianConverter_int128(DModifier)
+#endif
 
 aid_DEFINE_DynamicEndianConverter(extern);
 
@@ -20,11 +20,16 @@
 #define aid_Endian_hpp
 
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <stdexcept>
 #include <type_traits>
 #include "aid/Config.hpp"
 
+#if		defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
 
 namespace aid {
 
@@ -35,6 +40,12 @@ enum class EndianType: unsigned char
 	, big
 };
 
+#if		defined(__SIZEOF_INT128__)
+#define AID_HAS_INT128	1
+__extension__ typedef __int128				int128_t;
+__extension__ typedef unsigned __int128		uint128_t;
+#endif
+
 namespace Endian_impl {
 
 /*!
@@ -51,6 +62,133 @@ constexpr EndianType native_type() noexcept
 #endif
 }
 
+/*!
+  @brief		unsigned integer type which has t_size bytes
+ */
+template<std::size_t t_size>
+struct UnsignedOf;
+
+template<> struct UnsignedOf<1> { using type = std::uint8_t; };
+template<> struct UnsignedOf<2> { using type = std::uint16_t; };
+template<> struct UnsignedOf<4> { using type = std::uint32_t; };
+template<> struct UnsignedOf<8> { using type = std::uint64_t; };
+#if		defined(AID_HAS_INT128)
+template<> struct UnsignedOf<16> { using type = uint128_t; };
+#endif
+
+/*!
+  @brief		signed integer type which has t_size bytes
+ */
+template<std::size_t t_size>
+struct SignedOf;
+
+template<> struct SignedOf<1> { using type = std::int8_t; };
+template<> struct SignedOf<2> { using type = std::int16_t; };
+template<> struct SignedOf<4> { using type = std::int32_t; };
+template<> struct SignedOf<8> { using type = std::int64_t; };
+#if		defined(AID_HAS_INT128)
+template<> struct SignedOf<16> { using type = int128_t; };
+#endif
+
+/*!
+  @brief		std::is_signed which also knows int128_t
+  @details		std::is_signed<__int128> is false in the strict ISO modes.
+ */
+template<typename Integer>
+struct IsSigned: std::is_signed<Integer> {};
+
+#if		defined(AID_HAS_INT128)
+template<> struct IsSigned<int128_t>: std::true_type {};
+#endif
+
+/*!
+  @brief		check that a floating point value is converted at its full size
+ */
+template<typename Integer>
+inline void check_floating_point_size(std::size_t size)
+{
+	if ( std::is_floating_point<Integer>::value && size != sizeof(Integer) ) {
+		throw std::invalid_argument("size != sizeof(native)");
+	}
+}
+
+/*!
+  @brief		reverse the byte order of a value
+ */
+inline std::uint8_t byte_swap(std::uint8_t value) noexcept
+{
+	return value;
+}
+
+inline std::uint16_t byte_swap(std::uint16_t value) noexcept
+{
+#if		defined(__GNUC__)
+	return __builtin_bswap16(value);
+#elif	defined(_MSC_VER)
+	return _byteswap_ushort(value);
+#else
+	return static_cast<std::uint16_t>((value << 8) | (value >> 8));
+#endif
+}
+
+inline std::uint32_t byte_swap(std::uint32_t value) noexcept
+{
+#if		defined(__GNUC__)
+	return __builtin_bswap32(value);
+#elif	defined(_MSC_VER)
+	return _byteswap_ulong(value);
+#else
+	return (value << 24) | ((value << 8) & 0x00FF0000u)
+		| ((value >> 8) & 0x0000FF00u) | (value >> 24);
+#endif
+}
+
+inline std::uint64_t byte_swap(std::uint64_t value) noexcept
+{
+#if		defined(__GNUC__)
+	return __builtin_bswap64(value);
+#elif	defined(_MSC_VER)
+	return _byteswap_uint64(value);
+#else
+	return (std::uint64_t{byte_swap(static_cast<std::uint32_t>(value))} << 32)
+		| byte_swap(static_cast<std::uint32_t>(value >> 32));
+#endif
+}
+
+#if		defined(AID_HAS_INT128)
+inline uint128_t byte_swap(uint128_t value) noexcept
+{
+	return (uint128_t{byte_swap(static_cast<std::uint64_t>(value))} << 64)
+		| byte_swap(static_cast<std::uint64_t>(value >> 64));
+}
+#endif
+
+/*!
+  @brief		reverse the byte order of a value of any type
+  @details		The value is copied through the unsigned integer type of the same size,
+				so that this function is free from the strict aliasing problem.
+ */
+template<typename Integer>
+inline Integer byte_swap_value(Integer value) noexcept
+{
+	typename UnsignedOf<sizeof(Integer)>::type bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	bits = byte_swap(bits);
+	std::memcpy(&value, &bits, sizeof(bits));
+	return value;
+}
+
+/*!
+  @brief		reverse the byte order of each element of an array
+  @param[in]	src		pointer to the beginning of the source elements
+  @param[out]	dst		pointer to the beginning of the destination elements
+  @param[in]	count	number of elements
+  @param[in]	width	size of an element (1, 2, 4, 8 or 16)
+  @pre			src and dst are the same or do not overlap
+  @attention	This function does not check the pre-conditions.
+ */
+void byte_swap_n(const void *src, void *dst, std::size_t count, std::size_t width) noexcept;
+
 /*!
   @tparam		t_external_type	external endian type
   @tparam		t_native_type	native endian type
@@ -63,10 +201,77 @@ struct Converter
 
 	template<typename Integer>
 	static void from_external(const unsigned char *external, std::size_t size, Integer &native);
+
+	template<typename Integer>
+	static void to_external_n(const Integer *native, std::size_t count, unsigned char *external);
+
+	template<typename Integer>
+	static void from_external_n(const unsigned char *external, std::size_t count, Integer *native);
 }; // struct Converter
 
+/*!
+  @brief		array conversion between the same endian types
+ */
+struct SameOrderArrayConverter
+{
+	/*!
+	  @brief		native endian values to external endian values
+	  @pre			native != nullptr && external != nullptr
+	  @pre			native and external are the same or do not overlap
+	  @attention	This function does not check the pre-conditions.
+	 */
+	template<typename Integer>
+	static void to_external_n(const Integer *native, std::size_t count, unsigned char *external) {
+		if ( static_cast<const void *>(native) != external ) {
+			std::memcpy(external, native, count * sizeof(Integer));
+		}
+	}
+
+	/*!
+	  @brief		external endian values to native endian values
+	  @pre			native != nullptr && external != nullptr
+	  @pre			native and external are the same or do not overlap
+	  @attention	This function does not check the pre-conditions.
+	 */
+	template<typename Integer>
+	static void from_external_n(const unsigned char *external, std::size_t count, Integer *native) {
+		if ( external != static_cast<const void *>(native) ) {
+			std::memcpy(native, external, count * sizeof(Integer));
+		}
+	}
+}; // struct SameOrderArrayConverter
+
+/*!
+  @brief		array conversion between the opposite endian types
+ */
+struct ReverseOrderArrayConverter
+{
+	/*!
+	  @brief		native endian values to external endian values
+	  @pre			native != nullptr && external != nullptr
+	  @pre			native and external are the same or do not overlap
+	  @attention	This function does not check the pre-conditions.
+	 */
+	template<typename Integer>
+	static void to_external_n(const Integer *native, std::size_t count, unsigned char *external) {
+		byte_swap_n(native, external, count, sizeof(Integer));
+	}
+
+	/*!
+	  @brief		external endian values to native endian values
+	  @pre			native != nullptr && external != nullptr
+	  @pre			native and external are the same or do not overlap
+	  @attention	This function does not check the pre-conditions.
+	 */
+	template<typename Integer>
+	static void from_external_n(const unsigned char *external, std::size_t count, Integer *native) {
+		byte_swap_n(external, native, count, sizeof(Integer));
+	}
+}; // struct ReverseOrderArrayConverter
+
 template<>
 struct Converter<EndianType::big, EndianType::little>
+	: ReverseOrderArrayConverter
 {
 	/*!
 	  @brief		a native(little) endian value to a big endian value
@@ -78,6 +283,12 @@ struct Converter<EndianType::big, EndianType::little>
 	 */
 	template<typename Integer>
 	static void to_external(Integer native, unsigned char *external, std::size_t size) {
+		if ( size == sizeof(native) ) {
+			const Integer swapped = byte_swap_value(native);
+			std::memcpy(external, &swapped, sizeof(swapped));
+			return;
+		}
+
 		const unsigned char * const msbyte = reinterpret_cast<const unsigned char *>(&native) + size - 1;
 		for ( std::size_t i{0}; i < size; ++i ) {
 			*(external + i) = *(msbyte - i);
@@ -94,13 +305,19 @@ struct Converter<EndianType::big, EndianType::little>
 	 */
 	template<typename Integer>
 	static void from_external(const unsigned char *external, std::size_t size, Integer &native) {
+		if ( size == sizeof(native) ) {
+			std::memcpy(&native, external, sizeof(native));
+			native = byte_swap_value(native);
+			return;
+		}
+
 		native = 0;
 		unsigned char * const msbyte = reinterpret_cast<unsigned char *>(&native) + size - 1;
 		for ( std::size_t i{0}; i < size; ++i ) {
 			*(msbyte - i) = *(external + i);
 		}
 
-		if ( std::is_signed<Integer>::value
+		if ( IsSigned<Integer>::value
 			 && *reinterpret_cast<const signed char *>(external) < 0 )
 		{
 			const std::size_t offset{sizeof(native) - size};
@@ -115,6 +332,7 @@ struct Converter<EndianType::big, EndianType::little>
 
 template<>
 struct Converter<EndianType::little, EndianType::little>
+	: SameOrderArrayConverter
 {
 	/*!
 	  @brief		a native(little) endian value to a little endian value
@@ -142,7 +360,7 @@ struct Converter<EndianType::little, EndianType::little>
 		native = 0;
 		std::memcpy(&native, external, size);
 
-		if ( std::is_signed<Integer>::value
+		if ( IsSigned<Integer>::value
 			 && *reinterpret_cast<const signed char *>(external + size - 1) < 0 )
 		{
 			const std::size_t offset{sizeof(native) - size};
@@ -158,6 +376,7 @@ struct Converter<EndianType::little, EndianType::little>
 
 template<>
 struct Converter<EndianType::big, EndianType::big>
+	: SameOrderArrayConverter
 {
 	/*!
 	  @brief		a native(big) endian value to a big endian value
@@ -189,7 +408,7 @@ struct Converter<EndianType::big, EndianType::big>
 		unsigned char * const msbyte = reinterpret_cast<unsigned char *>(&native) + offset;
 		std::memcpy(msbyte, external, size);
 
-		if ( std::is_signed<Integer>::value
+		if ( IsSigned<Integer>::value
 			 && offset > 0 && *reinterpret_cast<const signed char *>(external) < 0 )
 		{
 			// big   :      MSByte -> LSByte
@@ -201,6 +420,7 @@ struct Converter<EndianType::big, EndianType::big>
 
 template<>
 struct Converter<EndianType::little, EndianType::big>
+	: ReverseOrderArrayConverter
 {
 	/*!
 	  @brief		a native(big) endian value to a little endian value
@@ -212,6 +432,12 @@ struct Converter<EndianType::little, EndianType::big>
 	 */
 	template<typename Integer>
 	static void to_external(Integer native, unsigned char *external, std::size_t size) {
+		if ( size == sizeof(native) ) {
+			const Integer swapped = byte_swap_value(native);
+			std::memcpy(external, &swapped, sizeof(swapped));
+			return;
+		}
+
 		const unsigned char * const lsbyte = reinterpret_cast<unsigned char *>(&native) + sizeof(native) - 1;
 		for ( std::size_t i{0}; i < size; ++i ) {
 			*(external + i) = *(lsbyte - i);
@@ -228,13 +454,19 @@ struct Converter<EndianType::little, EndianType::big>
 	 */
 	template<typename Integer>
 	static void from_external(const unsigned char *external, std::size_t size, Integer &native) {
+		if ( size == sizeof(native) ) {
+			std::memcpy(&native, external, sizeof(native));
+			native = byte_swap_value(native);
+			return;
+		}
+
 		native = 0;
 		unsigned char * const lsbyte = reinterpret_cast<unsigned char *>(&native) + size - 1;
 		for ( std::size_t i{0}; i < size; ++i ) {
 			*(lsbyte - i) = *(external + i);
 		}
 
-		if ( std::is_signed<Integer>::value
+		if ( IsSigned<Integer>::value
 			 && *reinterpret_cast<const signed char *>(external + size - 1) < 0 )
 		{
 			const std::size_t offset{sizeof(native) - size};
@@ -247,6 +479,155 @@ struct Converter<EndianType::little, EndianType::big>
 	}
 }; // struct Converter<EndianType::little, EndianType::big>
 
+/*!
+  @brief		unpack 3-byte external endian values to 4-byte native endian values
+  @param[in]	external		pointer to the beginning of the external endian values
+  @param[in]	count			number of the values
+  @param[out]	native			pointer to the beginning of the native endian values
+  @param[in]	external_type	external endian type (little or big)
+  @param[in]	sign			whether the values are sign extended
+  @pre			external != nullptr && native != nullptr
+  @attention	This function does not check the pre-conditions.
+ */
+void unpack24_n(const unsigned char *external, std::size_t count, std::uint32_t *native,
+				EndianType external_type, bool sign) noexcept;
+
+/*!
+  @brief		unpack 6-byte external endian values to 8-byte native endian values
+  @copydetails	unpack24_n()
+ */
+void unpack48_n(const unsigned char *external, std::size_t count, std::uint64_t *native,
+				EndianType external_type, bool sign) noexcept;
+
+/*!
+  @brief		conversion of a t_size-byte external endian value fixed at compile time
+  @details		The bytes are assembled by shifts, which compilers fold into
+				a load and a byte swap, and the sign is extended without a branch.
+  @tparam		t_external_type	external endian type
+  @tparam		t_size			size of the external endian value
+ */
+template<EndianType t_external_type, std::size_t t_size>
+struct FixedSizeConverter
+{
+	static_assert(t_size > 0, "t_size == 0");
+	static_assert(t_size <= 8, "t_size > 8");
+
+	using Bits	= typename UnsignedOf<(t_size <= 1 ? 1 : t_size <= 2 ? 2 : t_size <= 4 ? 4 : 8)>::type;
+
+	/*!
+	  @brief		load the external endian value without sign extension
+	 */
+	static Bits load(const unsigned char *external) noexcept {
+		Bits bits{0};
+		for ( std::size_t i{0}; i < t_size; ++i ) {
+			const std::size_t shift{t_external_type == EndianType::big ? t_size - 1 - i : i};
+			bits |= static_cast<Bits>(static_cast<Bits>(external[i]) << (shift * 8));
+		}
+		return bits;
+	}
+
+	/*!
+	  @brief		store the lower t_size bytes of a value as a external endian value
+	 */
+	static void store(Bits bits, unsigned char *external) noexcept {
+		for ( std::size_t i{0}; i < t_size; ++i ) {
+			const std::size_t shift{t_external_type == EndianType::big ? t_size - 1 - i : i};
+			external[i] = static_cast<unsigned char>(bits >> (shift * 8));
+		}
+	}
+
+	/*!
+	  @brief		a native endian value to a external endian value
+	  @pre			external != nullptr
+	  @attention	This function does not check the pre-conditions.
+	 */
+	template<typename Integer>
+	static void to_external(Integer native, unsigned char *external) noexcept {
+		static_assert(t_size <= sizeof(Integer), "t_size > sizeof(Integer)");
+		static_assert(!std::is_floating_point<Integer>::value || t_size == sizeof(Integer),
+					  "t_size != sizeof(Integer)");
+		using UInteger = typename UnsignedOf<sizeof(Integer)>::type;
+
+		UInteger unative;
+		std::memcpy(&unative, &native, sizeof(unative));
+		store(static_cast<Bits>(unative), external);
+	}
+
+	/*!
+	  @brief		a external endian value to a native endian value
+	  @pre			external != nullptr
+	  @attention	This function does not check the pre-conditions.
+	 */
+	template<typename Integer>
+	static void from_external(const unsigned char *external, Integer &native) noexcept {
+		static_assert(t_size <= sizeof(Integer), "t_size > sizeof(Integer)");
+		static_assert(!std::is_floating_point<Integer>::value || t_size == sizeof(Integer),
+					  "t_size != sizeof(Integer)");
+		using UInteger = typename UnsignedOf<sizeof(Integer)>::type;
+		constexpr std::size_t sign_bit{t_size * 8 - 1};
+
+		UInteger unative{load(external)};
+		if ( IsSigned<Integer>::value && t_size < sizeof(Integer) ) {
+			// (x ^ m) - m extends the bit m to the upper bits
+			const UInteger m{static_cast<UInteger>(UInteger{1} << sign_bit)};
+			unative = static_cast<UInteger>((unative ^ m) - m);
+		}
+		std::memcpy(&native, &unative, sizeof(native));
+	}
+
+	/*!
+	  @brief		native endian values to packed external endian values
+	  @pre			native != nullptr && external != nullptr
+	  @attention	This function does not check the pre-conditions.
+	 */
+	template<typename Integer>
+	static void to_external_n(const Integer *native, std::size_t count, unsigned char *external) noexcept {
+		for ( std::size_t i{0}; i < count; ++i ) {
+			to_external(native[i], external + i * t_size);
+		}
+	}
+
+	/*!
+	  @brief		packed external endian values to native endian values
+	  @details		The 3-byte to 32-bit and 6-byte to 64-bit cases use vector kernels.
+	  @pre			native != nullptr && external != nullptr
+	  @attention	This function does not check the pre-conditions.
+	 */
+	template<typename Integer>
+	static void from_external_n(const unsigned char *external, std::size_t count, Integer *native) noexcept {
+		using UInteger = typename UnsignedOf<sizeof(Integer)>::type;
+		using Unpacked = std::integral_constant<bool,
+			((t_size == 3 && sizeof(Integer) == 4) || (t_size == 6 && sizeof(Integer) == 8))
+			&& (std::is_same<Integer, UInteger>::value
+				|| std::is_same<Integer, typename SignedOf<sizeof(Integer)>::type>::value)>;
+		from_external_n(external, count, native, Unpacked());
+	}
+
+  private:
+	template<typename Integer>
+	static void from_external_n(const unsigned char *external, std::size_t count, Integer *native,
+								std::false_type) noexcept {
+		for ( std::size_t i{0}; i < count; ++i ) {
+			from_external(external + i * t_size, native[i]);
+		}
+	}
+
+	template<typename Integer>
+	static void from_external_n(const unsigned char *external, std::size_t count, Integer *native,
+								std::true_type) noexcept {
+		unpack(external, count, reinterpret_cast<typename UnsignedOf<sizeof(Integer)>::type *>(native),
+			   std::is_signed<Integer>::value);
+	}
+
+	static void unpack(const unsigned char *external, std::size_t count, std::uint32_t *native, bool sign) noexcept {
+		unpack24_n(external, count, native, t_external_type, sign);
+	}
+
+	static void unpack(const unsigned char *external, std::size_t count, std::uint64_t *native, bool sign) noexcept {
+		unpack48_n(external, count, native, t_external_type, sign);
+	}
+}; // struct FixedSizeConverter
+
 } // namespace Endian_impl
 
 /*!
@@ -267,12 +648,14 @@ class EndianConverter
 	  @exception	std::invalid_argument	external == nullptr
 	  @exception	std::length_error		size == 0
 	  @exception	std::invalid_argument	size > sizeof(native)
+	  @exception	std::invalid_argument	size != sizeof(native) for a floating point type
 	 */
 	template<typename Integer>
 	static void to_external(Integer native, unsigned char *external, std::size_t size) {
 		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
 		if ( size == 0 ) throw std::length_error("size == 0");
 		if ( size > sizeof(native) ) throw std::invalid_argument("size > sizeof(native)");
+		Endian_impl::check_floating_point_size<Integer>(size);
 
 		Native::to_external(native, external, size);
 	}
@@ -315,12 +698,14 @@ class EndianConverter
 	  @exception	std::invalid_argument	external == nullptr
 	  @exception	std::length_error		size == 0
 	  @exception	std::invalid_argument	size > sizeof(native)
+	  @exception	std::invalid_argument	size != sizeof(native) for a floating point type
 	 */
 	template<typename Integer>
 	static void from_external(const unsigned char *external, std::size_t size, Integer &native) {
 		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
 		if ( size == 0 ) throw std::length_error("size == 0");
 		if ( size > sizeof(native) ) throw std::invalid_argument("size > sizeof(native)");
+		Endian_impl::check_floating_point_size<Integer>(size);
 
 		Native::from_external(external, size, native);
 	}
@@ -353,11 +738,259 @@ class EndianConverter
 	static void from_external(const char (&external)[t_size], Integer &native) {
 		from_external(external, t_size, native);
 	}
+
+	/*!
+	  @brief		convert a native endian value to a t_size-byte external endian value
+	  @details		The size is fixed at compile time, so the conversion is
+					a few shifts and masks.
+	  @tparam		t_size		size of the external endian value (0 < t_size <= sizeof(Integer))
+	  @tparam		Integer		integer type
+	  @param[in]	native		native endian value
+	  @param[out]	external	pointer to the beginning of the external endian value
+	  @exception	std::invalid_argument	external == nullptr
+	 */
+	template<std::size_t t_size, typename Integer>
+	static void to_external(Integer native, unsigned char *external) {
+		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
+
+		Endian_impl::FixedSizeConverter<t_external_type, t_size>::to_external(native, external);
+	}
+
+	/*!
+	  @copydoc		to_external(Integer,unsigned char *)
+	 */
+	template<std::size_t t_size, typename Integer>
+	static void to_external(Integer native, char *external) {
+		to_external<t_size>(native, reinterpret_cast<unsigned char *>(external));
+	}
+
+	/*!
+	  @brief		convert a t_size-byte external endian value to a native endian value
+	  @details		The size is fixed at compile time, so the conversion is
+					a few shifts and masks, and the sign is extended without a branch.
+	  @tparam		t_size		size of the external endian value (0 < t_size <= sizeof(Integer))
+	  @tparam		Integer		integer type
+	  @param[in]	external	pointer to the beginning of the external endian value
+	  @param[out]	native		native endian value
+	  @exception	std::invalid_argument	external == nullptr
+	 */
+	template<std::size_t t_size, typename Integer>
+	static void from_external(const unsigned char *external, Integer &native) {
+		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
+
+		Endian_impl::FixedSizeConverter<t_external_type, t_size>::from_external(external, native);
+	}
+
+	/*!
+	  @copydoc		from_external(const unsigned char *,Integer &)
+	 */
+	template<std::size_t t_size, typename Integer>
+	static void from_external(const char *external, Integer &native) {
+		from_external<t_size>(reinterpret_cast<const unsigned char *>(external), native);
+	}
+
+	/*!
+	  @brief		convert native endian values to external endian values
+	  @tparam		Integer		integer type
+	  @param[in]	native		pointer to the beginning of the native endian values
+	  @param[in]	count		number of the values
+	  @param[out]	external	pointer to the beginning of the external endian values
+							(count * sizeof(Integer) bytes)
+	  @exception	std::invalid_argument	native == nullptr && count > 0
+	  @exception	std::invalid_argument	external == nullptr && count > 0
+	  @pre			native and external are the same or do not overlap
+	 */
+	template<typename Integer>
+	static void to_external_n(const Integer *native, std::size_t count, unsigned char *external) {
+		if ( count == 0 ) return;
+		if ( native == nullptr ) throw std::invalid_argument("native == nullptr");
+		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
+
+		Native::to_external_n(native, count, external);
+	}
+
+	/*!
+	  @copydoc		to_external_n(const Integer *,std::size_t,unsigned char *)
+	 */
+	template<typename Integer>
+	static void to_external_n(const Integer *native, std::size_t count, char *external) {
+		to_external_n(native, count, reinterpret_cast<unsigned char *>(external));
+	}
+
+	/*!
+	  @brief		convert external endian values to native endian values
+	  @tparam		Integer		integer type
+	  @param[in]	external	pointer to the beginning of the external endian values
+							(count * sizeof(Integer) bytes)
+	  @param[in]	count		number of the values
+	  @param[out]	native		pointer to the beginning of the native endian values
+	  @exception	std::invalid_argument	external == nullptr && count > 0
+	  @exception	std::invalid_argument	native == nullptr && count > 0
+	  @pre			native and external are the same or do not overlap
+	 */
+	template<typename Integer>
+	static void from_external_n(const unsigned char *external, std::size_t count, Integer *native) {
+		if ( count == 0 ) return;
+		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
+		if ( native == nullptr ) throw std::invalid_argument("native == nullptr");
+
+		Native::from_external_n(external, count, native);
+	}
+
+	/*!
+	  @copydoc		from_external_n(const unsigned char *,std::size_t,Integer *)
+	 */
+	template<typename Integer>
+	static void from_external_n(const char *external, std::size_t count, Integer *native) {
+		from_external_n(reinterpret_cast<const unsigned char *>(external), count, native);
+	}
+
+	/*!
+	  @brief		convert native endian values to packed t_size-byte external endian values
+	  @tparam		t_size		size of a external endian value (0 < t_size <= sizeof(Integer))
+	  @tparam		Integer		integer type
+	  @param[in]	native		pointer to the beginning of the native endian values
+	  @param[in]	count		number of the values
+	  @param[out]	external	pointer to the beginning of the external endian values
+							(count * t_size bytes)
+	  @exception	std::invalid_argument	native == nullptr && count > 0
+	  @exception	std::invalid_argument	external == nullptr && count > 0
+	 */
+	template<std::size_t t_size, typename Integer>
+	static void to_external_n(const Integer *native, std::size_t count, unsigned char *external) {
+		if ( count == 0 ) return;
+		if ( native == nullptr ) throw std::invalid_argument("native == nullptr");
+		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
+
+		Endian_impl::FixedSizeConverter<t_external_type, t_size>::to_external_n(native, count, external);
+	}
+
+	/*!
+	  @brief		convert packed t_size-byte external endian values to native endian values
+	  @details		24-bit values to (u)int32_t and 48-bit values to (u)int64_t
+					are unpacked by vector shuffles.
+	  @tparam		t_size		size of a external endian value (0 < t_size <= sizeof(Integer))
+	  @tparam		Integer		integer type
+	  @param[in]	external	pointer to the beginning of the external endian values
+							(count * t_size bytes)
+	  @param[in]	count		number of the values
+	  @param[out]	native		pointer to the beginning of the native endian values
+	  @exception	std::invalid_argument	external == nullptr && count > 0
+	  @exception	std::invalid_argument	native == nullptr && count > 0
+	  @pre			native and external do not overlap
+	 */
+	template<std::size_t t_size, typename Integer>
+	static void from_external_n(const unsigned char *external, std::size_t count, Integer *native) {
+		if ( count == 0 ) return;
+		if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
+		if ( native == nullptr ) throw std::invalid_argument("native == nullptr");
+
+		Endian_impl::FixedSizeConverter<t_external_type, t_size>::from_external_n(external, count, native);
+	}
 }; // class EndianConverter
 
+/*!
+  @brief		integer stored as a external endian byte array
+  @details		The object is trivially copyable and has no alignment requirement,
+				so a structure of these objects can be laid over a received or mapped
+				buffer to read and write its fields in place. A value is converted
+				only when it is read or written.
+  @tparam		t_external_type	external endian type
+  @tparam		Integer			integer type of the value
+  @tparam		t_size			size of the external endian value
+*/
+template<EndianType t_external_type, typename Integer, std::size_t t_size = sizeof(Integer)>
+class EndianInteger
+{
+	static_assert(t_size > 0, "t_size == 0");
+	static_assert(t_size <= sizeof(Integer), "t_size > sizeof(Integer)");
+
+	using Native = Endian_impl::FixedSizeConverter<t_external_type, t_size>;
+
+  public:
+	using value_type	= Integer;
+
+  private:
+	unsigned char	m_external[t_size];
+
+  public:
+	EndianInteger() noexcept = default;
+
+	EndianInteger(value_type native) noexcept {
+		set(native);
+	}
+
+	EndianInteger &operator=(value_type native) noexcept {
+		set(native);
+		return *this;
+	}
+
+	/*!
+	  @brief		get the size of the external endian value
+	 */
+	static constexpr std::size_t size() noexcept {
+		return t_size;
+	}
+
+	/*!
+	  @brief		get the value converted to the native endian
+	 */
+	value_type get() const noexcept {
+		value_type native;
+		Native::from_external(m_external, native);
+		return native;
+	}
+
+	/*!
+	  @brief		set a native endian value
+	 */
+	void set(value_type native) noexcept {
+		Native::to_external(native, m_external);
+	}
+
+	operator value_type() const noexcept {
+		return get();
+	}
+
+	/*!
+	  @brief		get the external endian value (byte array)
+	 */
+	const unsigned char *data() const noexcept {
+		return m_external;
+	}
+
+	unsigned char *data() noexcept {
+		return m_external;
+	}
+}; // class EndianInteger
+
+using big_int16_t		= EndianInteger<EndianType::big, std::int16_t>;
+using big_uint16_t		= EndianInteger<EndianType::big, std::uint16_t>;
+using big_int24_t		= EndianInteger<EndianType::big, std::int32_t, 3>;
+using big_uint24_t		= EndianInteger<EndianType::big, std::uint32_t, 3>;
+using big_int32_t		= EndianInteger<EndianType::big, std::int32_t>;
+using big_uint32_t		= EndianInteger<EndianType::big, std::uint32_t>;
+using big_int48_t		= EndianInteger<EndianType::big, std::int64_t, 6>;
+using big_uint48_t		= EndianInteger<EndianType::big, std::uint64_t, 6>;
+using big_int64_t		= EndianInteger<EndianType::big, std::int64_t>;
+using big_uint64_t		= EndianInteger<EndianType::big, std::uint64_t>;
+
+using little_int16_t	= EndianInteger<EndianType::little, std::int16_t>;
+using little_uint16_t	= EndianInteger<EndianType::little, std::uint16_t>;
+using little_int24_t	= EndianInteger<EndianType::little, std::int32_t, 3>;
+using little_uint24_t	= EndianInteger<EndianType::little, std::uint32_t, 3>;
+using little_int32_t	= EndianInteger<EndianType::little, std::int32_t>;
+using little_uint32_t	= EndianInteger<EndianType::little, std::uint32_t>;
+using little_int48_t	= EndianInteger<EndianType::little, std::int64_t, 6>;
+using little_uint48_t	= EndianInteger<EndianType::little, std::uint64_t, 6>;
+using little_int64_t	= EndianInteger<EndianType::little, std::int64_t>;
+using little_uint64_t	= EndianInteger<EndianType::little, std::uint64_t>;
+
 #define aid_DEFINE_EndianConverter_external(DModifier, d_external_type, DInteger) \
 	DModifier template void EndianConverter<d_external_type>::to_external(DInteger, unsigned char *, std::size_t); \
-	DModifier template void EndianConverter<d_external_type>::from_external(const unsigned char *, std::size_t, DInteger &)
+	DModifier template void EndianConverter<d_external_type>::from_external(const unsigned char *, std::size_t, DInteger &); \
+	DModifier template void EndianConverter<d_external_type>::to_external_n(const DInteger *, std::size_t, unsigned char *); \
+	DModifier template void EndianConverter<d_external_type>::from_external_n(const unsigned char *, std::size_t, DInteger *)
 #define aid_DEFINE_EndianConverter(DModifier, d_external_type) \
 	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, char); \
 	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, wchar_t); \
@@ -372,7 +1005,18 @@ class EndianConverter
 	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, unsigned long); \
 	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, long); \
 	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, unsigned long long); \
-	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, long long)
+	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, long long); \
+	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, float); \
+	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, double) \
+	aid_DEFINE_EndianConverter_int128(DModifier, d_external_type)
+#if		defined(AID_HAS_INT128)
+#define aid_DEFINE_EndianConverter_int128(DModifier, d_external_type) \
+	; \
+	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, int128_t); \
+	aid_DEFINE_EndianConverter_external(DModifier, d_external_type, uint128_t)
+#else
+#define aid_DEFINE_EndianConverter_int128(DModifier, d_external_type)
+#endif
 
 aid_DEFINE_EndianConverter(extern, EndianType::little);
 aid_DEFINE_EndianConverter(extern, EndianType::big);
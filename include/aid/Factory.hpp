@@ -20,10 +20,10 @@
 #define aid_Factory_hpp
 
 #include <exception>
-#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
+#include "aid/FactoryLookup.hpp"
 
 
 namespace aid {
@@ -52,38 +52,36 @@ template<
 	, typename Identifier
 	, typename ProductCreator = AbstractProductPtr (*)()
 	, template<typename, class> class FactoryErrorPolicy = DefaultFactoryError
+	, template<typename, typename> class FactoryLookupPolicy = MapFactoryLookup
 	>
 class Factory
 	: public FactoryErrorPolicy<Identifier, AbstractProductPtr>
 {
   private:
-	using IdToProductMap		= std::map<Identifier, ProductCreator>;
+	using IdToProductMap		= FactoryLookupPolicy<Identifier, ProductCreator>;
 
   public:
 	using abstract_product_ptr_type	= AbstractProductPtr;
 	using identifier_type			= Identifier;
 	using product_creator_type		= ProductCreator;
 	using error_policy_type			= FactoryErrorPolicy<Identifier, AbstractProductPtr>;
+	using lookup_policy_type		= IdToProductMap;
 
   private:
 	IdToProductMap	m_associations;
 
   public:
 	bool register_creator(const identifier_type &id, product_creator_type creator) {
-		return m_associations.insert(std::make_pair(id, creator)).second;
+		return m_associations.insert(id, std::move(creator));
 	}
 
 	bool unregister_creator(const identifier_type &id) {
-		return m_associations.erase(id) != 0;
+		return m_associations.erase(id);
 	}
 
+	//! the identifiers in order with MapFactoryLookup, in no particular order with the others
 	std::vector<identifier_type> registered_ids() const {
-		std::vector<identifier_type> ids;
-		ids.reserve(m_associations.size());
-		for ( const auto &association : m_associations ) {
-			ids.push_back(association.first);
-		}
-		return ids;
+		return m_associations.ids();
 	}
 
 	void clear_creator() {
@@ -92,11 +90,20 @@ class Factory
 
 	template<typename... Args>
 	abstract_product_ptr_type create(const identifier_type &id, Args &&... args) const {
-		typename IdToProductMap::const_iterator i = m_associations.find(id);
-		if ( i == m_associations.end() ) {
+		const product_creator_type * const creator = m_associations.find(id);
+		if ( creator == nullptr ) {
 			return this->on_unknown_type(id);
 		}
-		return (i->second)(std::forward<Args>(args)...);
+		return (*creator)(std::forward<Args>(args)...);
+	}
+
+	/*!
+	  @brief		build a perfect hash of the registered identifiers (FrozenFactoryLookup only)
+	  @details		register_creator() and unregister_creator() undo it.
+	  @return		whether the lookups are frozen
+	 */
+	bool freeze() {
+		return m_associations.freeze();
 	}
 }; // class Factory
 
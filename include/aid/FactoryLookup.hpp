@@ -0,0 +1,385 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file FactoryLookup.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_FactoryLookup_hpp
+#define aid_FactoryLookup_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "aid/Hash.hpp"
+
+
+namespace aid {
+
+/*
+  The lookup policies of Factory store the creators by identifier. A policy has
+	bool insert(const Identifier &id, ProductCreator creator);	// false if id is registered
+	bool erase(const Identifier &id);							// false if id is not registered
+	void clear();
+	const ProductCreator *find(const Identifier &id) const;	// nullptr if id is not registered
+	std::vector<Identifier> ids() const;
+*/
+
+/*!
+  @brief		lookup in a std::map: O(log n) comparisons, the identifiers in order
+ */
+template<typename Identifier, typename ProductCreator>
+class MapFactoryLookup
+{
+  private:
+	std::map<Identifier, ProductCreator>	m_map;
+
+  public:
+	bool insert(const Identifier &id, ProductCreator creator) {
+		return m_map.insert(std::make_pair(id, std::move(creator))).second;
+	}
+
+	bool erase(const Identifier &id) {
+		return m_map.erase(id) != 0;
+	}
+
+	void clear() noexcept {
+		m_map.clear();
+	}
+
+	const ProductCreator *find(const Identifier &id) const {
+		const auto i = m_map.find(id);
+		return i != m_map.end() ? &i->second : nullptr;
+	}
+
+	//! the identifiers in order
+	std::vector<Identifier> ids() const {
+		std::vector<Identifier> ids;
+		ids.reserve(m_map.size());
+		for ( const auto &association : m_map ) {
+			ids.push_back(association.first);
+		}
+		return ids;
+	}
+}; // class MapFactoryLookup
+
+/*!
+  @brief		lookup in an open-addressing hash table: about one hash and one comparison
+  @details		The creators are stored densely, and a table of indices at most
+				half full is probed linearly. The hash of an identifier is
+				std::hash<Identifier> mixed by hash_word(), so that the std::hash
+				of an integer, which is the identity on some libraries, spreads
+				over the table too.
+ */
+template<typename Identifier, typename ProductCreator>
+class HashFactoryLookup
+{
+  protected:
+	using hash_type	= std::uint64_t;
+	using index_type	= std::uint32_t;	// entry index + 1, or 0 for an empty slot
+
+	struct Entry
+	{
+		Identifier		id;
+		ProductCreator	creator;
+		hash_type		hash;
+	};
+
+  protected:
+	std::vector<Entry>		m_entries;
+	std::vector<index_type>	m_slots;	// a power of 2 in size
+
+  protected:
+	static hash_type hash(const Identifier &id) {
+		return hash_word(std::hash<Identifier>{}(id));
+	}
+
+	std::size_t slot_mask() const noexcept {
+		return m_slots.size() - 1;
+	}
+
+	//! the slot of the entry of id, or of the empty slot where it would be
+	std::size_t probe(const Identifier &id, hash_type id_hash) const {
+		std::size_t slot{static_cast<std::size_t>(id_hash) & slot_mask()};
+		for ( ; m_slots[slot] != 0; slot = (slot + 1) & slot_mask() ) {
+			const Entry &entry = m_entries[m_slots[slot] - 1];
+			if ( entry.hash == id_hash && entry.id == id ) {
+				break;
+			}
+		}
+		return slot;
+	}
+
+	//! the slot whose index is index
+	std::size_t slot_of(index_type index) const noexcept {
+		std::size_t slot{static_cast<std::size_t>(m_entries[index - 1].hash) & slot_mask()};
+		for ( ; m_slots[slot] != index; slot = (slot + 1) & slot_mask() ) {}
+		return slot;
+	}
+
+	//! index all the entries again in slots of size
+	void rehash(std::size_t size) {
+		m_slots.assign(size, 0);
+		for ( std::size_t i{0}; i < m_entries.size(); ++i ) {
+			std::size_t slot{static_cast<std::size_t>(m_entries[i].hash) & slot_mask()};
+			for ( ; m_slots[slot] != 0; slot = (slot + 1) & slot_mask() ) {}
+			m_slots[slot] = static_cast<index_type>(i + 1);
+		}
+	}
+
+	const ProductCreator *find(const Identifier &id, hash_type id_hash) const {
+		if ( m_slots.empty() ) {
+			return nullptr;
+		}
+		const index_type index{m_slots[probe(id, id_hash)]};
+		return index != 0 ? &m_entries[index - 1].creator : nullptr;
+	}
+
+  public:
+	HashFactoryLookup() noexcept
+		: m_entries{}, m_slots{}
+	{}
+
+	/*!
+	  @exception	std::length_error	2^31 identifiers are registered
+	 */
+	bool insert(const Identifier &id, ProductCreator creator) {
+		const hash_type id_hash{hash(id)};
+		if ( find(id, id_hash) != nullptr ) {
+			return false;
+		}
+		if ( m_entries.size() >= std::size_t{1} << 31 ) throw std::length_error("too many identifiers");
+		m_entries.push_back(Entry{id, std::move(creator), id_hash});
+		if ( m_entries.size() * 2 > m_slots.size() ) {
+			rehash(std::max<std::size_t>(m_slots.size() * 2, 16));
+		}
+		else {
+			m_slots[probe(id, id_hash)] = static_cast<index_type>(m_entries.size());
+		}
+		return true;
+	}
+
+	bool erase(const Identifier &id) {
+		if ( m_slots.empty() ) {
+			return false;
+		}
+		std::size_t slot{probe(id, hash(id))};
+		const index_type index{m_slots[slot]};
+		if ( index == 0 ) {
+			return false;
+		}
+
+		// shift back the entries after the slot which would no longer be found
+		for ( std::size_t next{(slot + 1) & slot_mask()}; m_slots[next] != 0; next = (next + 1) & slot_mask() ) {
+			const std::size_t home{static_cast<std::size_t>(m_entries[m_slots[next] - 1].hash) & slot_mask()};
+			if ( ((next - home) & slot_mask()) >= ((next - slot) & slot_mask()) ) {
+				m_slots[slot] = m_slots[next];
+				slot = next;
+			}
+		}
+		m_slots[slot] = 0;
+
+		// the last entry fills the hole
+		const index_type last{static_cast<index_type>(m_entries.size())};
+		if ( index != last ) {
+			m_slots[slot_of(last)] = index;
+			m_entries[index - 1] = std::move(m_entries.back());
+		}
+		m_entries.pop_back();
+		return true;
+	}
+
+	void clear() noexcept {
+		m_entries.clear();
+		m_slots.clear();
+	}
+
+	const ProductCreator *find(const Identifier &id) const {
+		return find(id, hash(id));
+	}
+
+	//! the identifiers in no particular order
+	std::vector<Identifier> ids() const {
+		std::vector<Identifier> ids;
+		ids.reserve(m_entries.size());
+		for ( const auto &entry : m_entries ) {
+			ids.push_back(entry.id);
+		}
+		return ids;
+	}
+}; // class HashFactoryLookup
+
+/*!
+  @brief		HashFactoryLookup which freeze() turns into a minimal perfect hash
+  @details		freeze() orders the entries so that each identifier has its own
+				slot, selected by a seed of the bucket of its hash ("hash and
+				displace"). A frozen lookup is one hash, a comparison and the
+				call, with no probing. insert() and erase() thaw the table, which
+				is a HashFactoryLookup until the next freeze().
+ */
+template<typename Identifier, typename ProductCreator>
+class FrozenFactoryLookup
+	: public HashFactoryLookup<Identifier, ProductCreator>
+{
+  private:
+	using Base			= HashFactoryLookup<Identifier, ProductCreator>;
+	using hash_type		= typename Base::hash_type;
+	using Entry			= typename Base::Entry;
+	using seed_type		= std::uint32_t;
+
+	static constexpr std::size_t bucket_size{4};			// identifiers per bucket on average
+	static constexpr seed_type max_seed{seed_type{1} << 24};	// tries of a bucket before freeze() gives up
+
+  private:
+	std::vector<seed_type>	m_seeds;	// of each bucket; empty if not frozen
+
+  private:
+	//! [0, size) from the upper or the lower half of x
+	static std::size_t reduce(std::uint32_t x, std::size_t size) noexcept {
+		return static_cast<std::size_t>((std::uint64_t{x} * size) >> 32);
+	}
+
+	static std::size_t bucket(hash_type id_hash, std::size_t bucket_count) noexcept {
+		return reduce(static_cast<std::uint32_t>(id_hash >> 32), bucket_count);
+	}
+
+	static std::size_t slot(hash_type id_hash, seed_type seed, std::size_t size) noexcept {
+		return reduce(static_cast<std::uint32_t>(Hash_impl::mix(id_hash ^ Hash_impl::secret[0],
+																 Hash_impl::secret[1] + seed)),
+					  size);
+	}
+
+  public:
+	FrozenFactoryLookup() noexcept
+		: Base{}, m_seeds{}
+	{}
+
+	bool frozen() const noexcept {
+		return !m_seeds.empty();
+	}
+
+	/*!
+	  @brief		build the perfect hash of the registered identifiers
+	  @retval		true	the lookups are frozen
+	  @retval		false	no identifier is registered, or two of them have the same 64-bit hash;
+							the table is left a hash table
+	 */
+	bool freeze() {
+		std::vector<Entry> &entries = this->m_entries;
+		const std::size_t size{entries.size()};
+		if ( size == 0 ) {
+			return false;
+		}
+		// no seed separates two identifiers of the same hash
+		std::vector<hash_type> hashes;
+		hashes.reserve(size);
+		for ( const auto &entry : entries ) {
+			hashes.push_back(entry.hash);
+		}
+		std::sort(hashes.begin(), hashes.end());
+		if ( std::adjacent_find(hashes.begin(), hashes.end()) != hashes.end() ) {
+			return false;
+		}
+		const std::size_t bucket_count{(size + bucket_size - 1) / bucket_size};
+
+		// the entries of each bucket, the largest buckets first
+		std::vector<std::vector<std::size_t>> buckets(bucket_count);
+		for ( std::size_t i{0}; i < size; ++i ) {
+			buckets[bucket(entries[i].hash, bucket_count)].push_back(i);
+		}
+		std::vector<std::size_t> order(bucket_count);
+		for ( std::size_t i{0}; i < bucket_count; ++i ) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&buckets](std::size_t x, std::size_t y) {
+			return buckets[x].size() > buckets[y].size();
+		});
+
+		// the first seed which puts all the entries of a bucket into free slots
+		std::vector<seed_type> seeds(bucket_count, 0);
+		std::vector<std::size_t> slot_entries(size, size);
+		std::vector<std::size_t> taken;
+		for ( std::size_t b : order ) {
+			seed_type seed{0};
+			for ( ; ; ++seed ) {
+				if ( seed == max_seed ) {
+					return false;
+				}
+				taken.clear();
+				bool fits{true};
+				for ( std::size_t i : buckets[b] ) {
+					const std::size_t s{slot(entries[i].hash, seed, size)};
+					if ( slot_entries[s] != size || std::find(taken.begin(), taken.end(), s) != taken.end() ) {
+						fits = false;
+						break;
+					}
+					taken.push_back(s);
+				}
+				if ( fits ) {
+					break;
+				}
+			}
+			for ( std::size_t k{0}; k < buckets[b].size(); ++k ) {
+				slot_entries[taken[k]] = buckets[b][k];
+			}
+			seeds[b] = seed;
+		}
+
+		// the entries in the order of their slots
+		std::vector<Entry> ordered;
+		ordered.reserve(size);
+		for ( std::size_t i : slot_entries ) {
+			ordered.push_back(std::move(entries[i]));
+		}
+		entries.swap(ordered);
+		this->rehash(this->m_slots.size());
+		m_seeds.swap(seeds);
+		return true;
+	}
+
+	bool insert(const Identifier &id, ProductCreator creator) {
+		m_seeds.clear();
+		return Base::insert(id, std::move(creator));
+	}
+
+	bool erase(const Identifier &id) {
+		m_seeds.clear();
+		return Base::erase(id);
+	}
+
+	void clear() noexcept {
+		m_seeds.clear();
+		Base::clear();
+	}
+
+	const ProductCreator *find(const Identifier &id) const {
+		const hash_type id_hash{Base::hash(id)};
+		if ( m_seeds.empty() ) {
+			return Base::find(id, id_hash);
+		}
+		const Entry &entry = this->m_entries[slot(id_hash, m_seeds[bucket(id_hash, m_seeds.size())],
+												  this->m_entries.size())];
+		return entry.hash == id_hash && entry.id == id ? &entry.creator : nullptr;
+	}
+}; // class FrozenFactoryLookup
+
+} // namespace aid
+
+
+#endif // aid_FactoryLookup_hpp
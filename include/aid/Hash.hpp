@@ -0,0 +1,181 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file Hash.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_Hash_hpp
+#define aid_Hash_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+
+namespace aid {
+
+/*!
+  @brief		the multiply-and-fold hash of wyhash (final version 4, public domain, by Wang Yi)
+  @details		Not cryptographic. The values depend on the byte order of the platform,
+				so they are not to be stored.
+ */
+namespace Hash_impl {
+
+constexpr std::uint64_t secret[4]{
+	0x2d358dccaa6c78a5u, 0x8bb84b93962eacc9u, 0x4b33a62ed433d4a3u, 0x4d5a2da51de1aa47u,
+};
+
+// (single return statements, so that hash_word() is constexpr in C++11)
+
+//! the lower and the upper halves of a product
+struct Product
+{
+	std::uint64_t	low;
+	std::uint64_t	high;
+};
+
+#if		defined(__SIZEOF_INT128__)
+constexpr Product halves(unsigned __int128 product) noexcept
+{
+	return Product{static_cast<std::uint64_t>(product), static_cast<std::uint64_t>(product >> 64)};
+}
+
+constexpr Product multiply(std::uint64_t a, std::uint64_t b) noexcept
+{
+	return halves(static_cast<unsigned __int128>(a) * b);
+}
+#else
+//! a * b from the products of the 32-bit halves
+constexpr Product halves(std::uint64_t hh, std::uint64_t hl, std::uint64_t lh, std::uint64_t ll) noexcept
+{
+	return Product{
+		(((ll >> 32) + (hl & 0xFFFFFFFFu) + (lh & 0xFFFFFFFFu)) << 32) | (ll & 0xFFFFFFFFu),
+		hh + (hl >> 32) + (lh >> 32) + (((ll >> 32) + (hl & 0xFFFFFFFFu) + (lh & 0xFFFFFFFFu)) >> 32),
+	};
+}
+
+constexpr Product multiply(std::uint64_t a, std::uint64_t b) noexcept
+{
+	return halves((a >> 32) * (b >> 32), (a >> 32) * (b & 0xFFFFFFFFu), (a & 0xFFFFFFFFu) * (b >> 32),
+				  (a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu));
+}
+#endif
+
+constexpr std::uint64_t fold(Product product) noexcept
+{
+	return product.low ^ product.high;
+}
+
+//! the lower and the upper halves of a * b, xored
+constexpr std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept
+{
+	return fold(multiply(a, b));
+}
+
+constexpr std::uint64_t finish(Product product, std::size_t size) noexcept
+{
+	return mix(product.low ^ secret[0] ^ size, product.high ^ secret[1]);
+}
+
+//! the last step of the hash of size bytes, whose last 16 bytes (or fewer) are a and b
+constexpr std::uint64_t finish(std::uint64_t a, std::uint64_t b, std::uint64_t seed, std::size_t size) noexcept
+{
+	return finish(multiply(a ^ secret[1], b ^ seed), size);
+}
+
+inline std::uint64_t read8(const unsigned char *p) noexcept
+{
+	std::uint64_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+inline std::uint64_t read4(const unsigned char *p) noexcept
+{
+	std::uint32_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+// 1 to 3 bytes
+inline std::uint64_t read3(const unsigned char *p, std::size_t size) noexcept
+{
+	return (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[size >> 1]} << 8) | p[size - 1];
+}
+
+} // namespace Hash_impl
+
+/*!
+  @brief		hash a 64-bit value
+  @details		Every bit of value changes about half of the bits of the hash,
+				so the hash can be cut into bucket indices and Bloom filter bits.
+ */
+constexpr std::uint64_t hash_word(std::uint64_t value, std::uint64_t seed = 0) noexcept
+{
+	// hash_bytes() of the 8 bytes of value on a little-endian platform
+	return Hash_impl::finish(value >> 32 | value << 32, value,
+							 seed ^ Hash_impl::mix(seed ^ Hash_impl::secret[0], Hash_impl::secret[1]), 8);
+}
+
+/*!
+  @brief		hash size bytes
+ */
+inline std::uint64_t hash_bytes(const void *data, std::size_t size, std::uint64_t seed = 0) noexcept
+{
+	using namespace Hash_impl;
+	const unsigned char *p = static_cast<const unsigned char *>(data);
+	seed ^= mix(seed ^ secret[0], secret[1]);
+	std::uint64_t a, b;
+	if ( size <= 16 ) {
+		if ( size >= 4 ) {
+			const std::size_t middle{(size >> 3) << 2};
+			a = (read4(p) << 32) | read4(p + middle);
+			b = (read4(p + size - 4) << 32) | read4(p + size - 4 - middle);
+		}
+		else if ( size > 0 ) {
+			a = read3(p, size);
+			b = 0;
+		}
+		else {
+			a = b = 0;
+		}
+	}
+	else {
+		std::size_t rest{size};
+		if ( rest > 48 ) {
+			// three independent lanes
+			std::uint64_t seed1{seed}, seed2{seed};
+			do {
+				seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+				seed1 = mix(read8(p + 16) ^ secret[2], read8(p + 24) ^ seed1);
+				seed2 = mix(read8(p + 32) ^ secret[3], read8(p + 40) ^ seed2);
+				p += 48;
+				rest -= 48;
+			} while ( rest > 48 );
+			seed ^= seed1 ^ seed2;
+		}
+		for ( ; rest > 16; rest -= 16, p += 16 ) {
+			seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+		}
+		a = read8(p + rest - 16);
+		b = read8(p + rest - 8);
+	}
+	return finish(a, b, seed, size);
+}
+
+} // namespace aid
+
+
+#endif // aid_Hash_hpp
@@ -0,0 +1,221 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file InplaceCreator.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_InplaceCreator_hpp
+#define aid_InplaceCreator_hpp
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace aid {
+
+namespace InplaceCreator_impl {
+
+constexpr std::size_t default_capacity{4 * sizeof(void *)};
+
+enum class Operation
+{
+	move,		// move the callable of source to target, and destroy it in source
+	destroy,	// destroy the callable of source
+};
+
+//! whether Callable called with Args returns a Result, as for the constructor of std::function
+template<typename Callable, typename Result, typename... Args>
+class IsCallable
+{
+  private:
+	template<typename C>
+	static auto test(int)
+		-> std::integral_constant<bool,
+			std::is_void<Result>::value
+			|| std::is_convertible<decltype(std::declval<C &>()(std::declval<Args>()...)), Result>::value>;
+
+	template<typename C>
+	static std::false_type test(...);
+
+  public:
+	static constexpr bool value{decltype(test<Callable>(0))::value};
+};
+
+} // namespace InplaceCreator_impl
+
+template<typename Signature, std::size_t t_capacity = InplaceCreator_impl::default_capacity>
+class InplaceCreator;
+
+/*!
+  @brief		move-only callable stored in the object, for the ProductCreator of Factory
+  @details		Unlike std::function, a callable is never allocated: one which
+				does not fit in t_capacity bytes is a compile error. A call is
+				one indirect call to a function which calls the stored callable
+				inline, so a creator with context (a lambda which captures a
+				configuration, for example) costs about the same as a function
+				pointer. The callables which are trivially copyable, such as
+				function pointers and lambdas which capture pointers and
+				integers, are moved with memcpy.
+				@code
+				using Creator = InplaceCreator<std::unique_ptr<Product> (int)>;
+				Factory<std::unique_ptr<Product>, std::string, Creator> factory;
+				factory.register_creator("tenant", [config](int i) { return make_product(config, i); });
+				@endcode
+
+				The callable is called as non-const even by the const operator(),
+				as by std::function. An empty InplaceCreator throws
+				std::bad_function_call when it is called. ConcurrentFactory
+				copies its creators, so it needs a copyable ProductCreator.
+  @tparam		t_capacity	size of the storage of the callable
+ */
+template<typename Result, typename... Args, std::size_t t_capacity>
+class InplaceCreator<Result (Args...), t_capacity>
+{
+  private:
+	using Storage	= typename std::aligned_storage<t_capacity, alignof(std::max_align_t)>::type;
+	using Invoker	= Result (*)(Storage &storage, Args &&... args);
+	using Manager	= void (*)(InplaceCreator_impl::Operation operation, Storage &source, Storage *target);
+
+	template<typename Callable>
+	using EnableIfCallable = typename std::enable_if<
+		!std::is_same<typename std::decay<Callable>::type, InplaceCreator>::value
+		&& InplaceCreator_impl::IsCallable<typename std::decay<Callable>::type, Result, Args...>::value>::type;
+
+  private:
+	mutable Storage	m_storage;
+	Invoker			m_invoker;
+	Manager			m_manager;	// nullptr if the callable is trivially copyable
+
+  private:
+	static Result invoke_empty(Storage &, Args &&...) {
+		throw std::bad_function_call();
+	}
+
+	template<typename Callable>
+	static Result invoke(Storage &storage, Args &&... args) {
+		return (*reinterpret_cast<Callable *>(&storage))(std::forward<Args>(args)...);
+	}
+
+	template<typename Callable>
+	static void manage(InplaceCreator_impl::Operation operation, Storage &source, Storage *target) noexcept {
+		Callable &callable = *reinterpret_cast<Callable *>(&source);
+		if ( operation == InplaceCreator_impl::Operation::move ) {
+			::new(target) Callable(std::move(callable));
+		}
+		callable.~Callable();
+	}
+
+	template<typename Callable>
+	static constexpr bool is_null(const Callable &) noexcept {
+		return false;
+	}
+
+	template<typename FunctionResult, typename... FunctionArgs>
+	static constexpr bool is_null(FunctionResult (* const &function)(FunctionArgs...)) noexcept {
+		return function == nullptr;
+	}
+
+	//! take the callable of other, and leave other empty
+	void take(InplaceCreator &other) noexcept {
+		m_invoker = other.m_invoker;
+		m_manager = other.m_manager;
+		if ( m_manager != nullptr ) {
+			m_manager(InplaceCreator_impl::Operation::move, other.m_storage, &m_storage);
+		}
+		else {
+			std::memcpy(&m_storage, &other.m_storage, sizeof(m_storage));
+		}
+		other.m_invoker = &invoke_empty;
+		other.m_manager = nullptr;
+	}
+
+	void destroy() noexcept {
+		if ( m_manager != nullptr ) {
+			m_manager(InplaceCreator_impl::Operation::destroy, m_storage, nullptr);
+		}
+	}
+
+  public:
+	//! construct an empty InplaceCreator
+	InplaceCreator() noexcept
+		: m_invoker{&invoke_empty}, m_manager{nullptr}
+	{}
+
+	/*!
+	  @brief		store a copy of callable, or move it
+	  @details		A null function pointer makes an empty InplaceCreator.
+					The moves of InplaceCreator are noexcept, so if the move of
+					the callable throws (a copy of a const std::string which it
+					captures may), std::terminate() is called.
+	 */
+	template<typename Callable, typename = EnableIfCallable<Callable>>
+	InplaceCreator(Callable &&callable)
+		: m_invoker{&invoke_empty}, m_manager{nullptr}
+	{
+		using Target = typename std::decay<Callable>::type;
+		static_assert(sizeof(Target) <= t_capacity, "the callable is larger than t_capacity");
+		static_assert(alignof(Target) <= alignof(Storage), "the callable is over-aligned");
+
+		if ( is_null(callable) ) {
+			return;
+		}
+		::new(&m_storage) Target(std::forward<Callable>(callable));
+		m_invoker = &invoke<Target>;
+		if ( !std::is_trivially_copyable<Target>::value ) {
+			m_manager = &manage<Target>;
+		}
+	}
+
+	InplaceCreator(InplaceCreator &&other) noexcept {
+		take(other);
+	}
+
+	InplaceCreator &operator=(InplaceCreator &&other) noexcept {
+		if ( this != &other ) {
+			destroy();
+			take(other);
+		}
+		return *this;
+	}
+
+	InplaceCreator(const InplaceCreator &) = delete;
+	InplaceCreator &operator=(const InplaceCreator &) = delete;
+
+	~InplaceCreator() {
+		destroy();
+	}
+
+  public:
+	explicit operator bool() const noexcept {
+		return m_invoker != &invoke_empty;
+	}
+
+	/*!
+	  @exception	std::bad_function_call	*this is empty
+	  @exception	any		thrown by the callable
+	 */
+	Result operator()(Args... args) const {
+		return m_invoker(m_storage, std::forward<Args>(args)...);
+	}
+}; // class InplaceCreator
+
+} // namespace aid
+
+
+#endif // aid_InplaceCreator_hpp
@@ -0,0 +1,69 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file Isa.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_Isa_hpp
+#define aid_Isa_hpp
+
+
+namespace aid {
+
+/*!
+  @brief		instruction set variants of the kernels compiled into the library
+  @details		The variants are ordered; a CPU which supports a variant supports
+				all the preceding variants.
+ */
+enum class Isa: unsigned char
+{
+	scalar
+	, ssse3
+	, avx2
+	, avx512
+};
+
+/*!
+  @brief		get the best variant which the CPU (and the library build) supports
+ */
+Isa supported_isa() noexcept;
+
+/*!
+  @brief		get the variant which the kernels currently use
+  @details		It is resolved once, at the first call, to supported_isa().
+				The environment variable AID_ISA (scalar, ssse3, avx2 or avx512)
+				overrides the resolution; a variant better than supported_isa()
+				is lowered to supported_isa().
+ */
+Isa active_isa() noexcept;
+
+/*!
+  @brief		force the kernels to use a variant
+  @param[in]	isa		variant to use
+  @retval		true	isa is selected
+  @retval		false	isa is not supported; the active variant is unchanged
+ */
+bool select_isa(Isa isa) noexcept;
+
+/*!
+  @brief		get the name of a variant
+  @return		"scalar", "ssse3", "avx2" or "avx512"
+ */
+const char *isa_name(Isa isa) noexcept;
+
+} // namespace aid
+
+
+#endif // aid_Isa_hpp
@@ -0,0 +1,233 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file MappedEndianFile.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_MappedEndianFile_hpp
+#define aid_MappedEndianFile_hpp
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "aid/DynamicEndianConverter.hpp"
+#include "aid/NonCopyable.hpp"
+
+
+namespace aid {
+
+/*!
+  @brief		memory-mapped file of external endian values
+  @details		The values are converted window by window, either lazily into
+				a caller's buffer or in place in the mapping. The kernel gets
+				a madvise() hint for each window before it is touched.
+  @attention	POSIX only.
+ */
+class MappedEndianFile
+	: private NonCopyable
+{
+  public:
+	enum class Mode: unsigned char
+	{
+		read_only		//!< the values can be converted only into other buffers
+		, copy_on_write	//!< in-place conversions change the mapping, not the file
+		, read_write	//!< in-place conversions rewrite the file
+	};
+
+	enum class Advice: unsigned char
+	{
+		normal
+		, sequential
+		, random
+		, will_need
+		, dont_need
+	};
+
+	static constexpr std::size_t default_window_size{4 * 1024 * 1024};
+
+  private:
+	unsigned char			*m_data;
+	std::size_t				m_size;
+	Mode					m_mode;
+	DynamicEndianConverter	m_converter;
+	std::size_t				m_window_size;
+
+  public:
+	/*!
+	  @brief		map a file
+	  @param[in]	path			path of the file
+	  @param[in]	external_type	endian type of the values in the file
+	  @param[in]	mode			mapping mode
+	  @exception	std::system_error	the file cannot be opened or mapped
+	 */
+	MappedEndianFile(const std::string &path, EndianType external_type, Mode mode = Mode::read_only);
+
+	MappedEndianFile(MappedEndianFile &&other) noexcept;
+	MappedEndianFile &operator=(MappedEndianFile &&other) noexcept;
+
+	~MappedEndianFile();
+
+  public:
+	std::size_t size() const noexcept {
+		return m_size;
+	}
+
+	Mode mode() const noexcept {
+		return m_mode;
+	}
+
+	EndianType get_external_type() const noexcept {
+		return m_converter.get_external_type();
+	}
+
+	/*!
+	  @brief		get the mapped bytes
+	 */
+	const unsigned char *data() const noexcept {
+		return m_data;
+	}
+
+	/*!
+	  @brief		get the size of a conversion window
+	 */
+	std::size_t window_size() const noexcept {
+		return m_window_size;
+	}
+
+	/*!
+	  @brief		set the size of a conversion window
+	  @exception	std::length_error	window_size == 0
+	 */
+	void set_window_size(std::size_t window_size) {
+		if ( window_size == 0 ) throw std::length_error("window_size == 0");
+		m_window_size = window_size;
+	}
+
+	/*!
+	  @brief		give the kernel a hint of the access pattern of a range
+	  @details		The range is widened to page boundaries. Errors are ignored,
+					since a hint never changes the result.
+	 */
+	void advise(std::size_t offset, std::size_t length, Advice advice) const noexcept;
+
+	/*!
+	  @brief		write the modified pages back to the file
+	  @exception	std::system_error	msync() failed
+	 */
+	void sync();
+
+	/*!
+	  @brief		read a external endian value
+	  @param[in]	offset	byte offset of the value
+	  @exception	std::out_of_range	the value is out of the file
+	 */
+	template<typename Integer>
+	Integer get(std::size_t offset) const {
+		check_range(offset, 1, sizeof(Integer));
+		Integer native;
+		m_converter.from_external(m_data + offset, sizeof(native), native);
+		return native;
+	}
+
+	/*!
+	  @brief		convert external endian values into a buffer
+	  @param[in]	offset	byte offset of the first value
+	  @param[in]	count	number of the values
+	  @param[out]	native	pointer to the beginning of the native endian values
+	  @exception	std::out_of_range	the values are out of the file
+	 */
+	template<typename Integer>
+	void read_n(std::size_t offset, std::size_t count, Integer *native) const {
+		for_each_window<Integer>(offset, count,
+			[this, native](const unsigned char *external, std::size_t first, std::size_t n) {
+				m_converter.from_external_n(external, n, native + first);
+			});
+	}
+
+	/*!
+	  @brief		convert external endian values window by window and pass them to a function
+	  @param[in]	offset		byte offset of the first value
+	  @param[in]	count		number of the values
+	  @param[in]	function	called as function(const Integer *native, std::size_t n)
+							for each window; native is valid only during the call
+	  @exception	std::out_of_range	the values are out of the file
+	 */
+	template<typename Integer, typename Function>
+	void for_each_native(std::size_t offset, std::size_t count, Function function) const {
+		std::vector<Integer> native(values_per_window(sizeof(Integer)) < count
+									? values_per_window(sizeof(Integer)) : count);
+		for_each_window<Integer>(offset, count,
+			[this, &native, &function](const unsigned char *external, std::size_t, std::size_t n) {
+				m_converter.from_external_n(external, n, native.data());
+				function(static_cast<const Integer *>(native.data()), n);
+			});
+	}
+
+	/*!
+	  @brief		convert external endian values to native endian values in the mapping
+	  @param[in]	offset	byte offset of the first value
+	  @param[in]	count	number of the values
+	  @return		pointer to the native endian values
+	  @exception	std::logic_error		mode() == Mode::read_only
+	  @exception	std::out_of_range		the values are out of the file
+	  @exception	std::invalid_argument	offset is not aligned for Integer
+	  @attention	Converting a range twice restores the external endian values.
+	 */
+	template<typename Integer>
+	Integer *convert_in_place(std::size_t offset, std::size_t count) {
+		if ( m_mode == Mode::read_only ) throw std::logic_error("mode() == Mode::read_only");
+		if ( offset % alignof(Integer) != 0 ) throw std::invalid_argument("offset is not aligned");
+
+		for_each_window<Integer>(offset, count,
+			[this](const unsigned char *external, std::size_t, std::size_t n) {
+				unsigned char * const bytes = const_cast<unsigned char *>(external);
+				m_converter.from_external_n(bytes, n, reinterpret_cast<Integer *>(bytes));
+			});
+		return reinterpret_cast<Integer *>(m_data + offset);
+	}
+
+  private:
+	void check_range(std::size_t offset, std::size_t count, std::size_t size) const;
+
+	std::size_t values_per_window(std::size_t size) const noexcept {
+		return m_window_size < size ? 1 : m_window_size / size;
+	}
+
+	template<typename Integer, typename Function>
+	void for_each_window(std::size_t offset, std::size_t count, Function function) const {
+		check_range(offset, count, sizeof(Integer));
+		if ( count == 0 ) {
+			return;
+		}
+
+		const std::size_t per_window{values_per_window(sizeof(Integer))};
+		advise(offset, count * sizeof(Integer), Advice::sequential);
+		advise(offset, per_window * sizeof(Integer), Advice::will_need);
+		for ( std::size_t first{0}; first < count; first += per_window ) {
+			const std::size_t n{count - first < per_window ? count - first : per_window};
+			const std::size_t window{offset + first * sizeof(Integer)};
+			if ( first + n < count ) {
+				advise(window + n * sizeof(Integer), per_window * sizeof(Integer), Advice::will_need);
+			}
+			function(m_data + window, first, n);
+		}
+	}
+}; // class MappedEndianFile
+
+} // namespace aid
+
+
+#endif // aid_MappedEndianFile_hpp
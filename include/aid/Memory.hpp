@@ -20,6 +20,7 @@
 #define aid_Memory_hpp
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <utility>
 
@@ -53,6 +54,56 @@ class PrivateAllocator
 }; // class PrivateAllocator
 
 
+/*!
+  @brief		allocator which aligns the storage to t_alignment bytes
+  @details		The storage is over-allocated with ::operator new() and the
+				original pointer is kept just before the aligned block.
+ */
+template<class Object, std::size_t t_alignment>
+class AlignedAllocator
+{
+	static_assert(t_alignment >= alignof(void *) && (t_alignment & (t_alignment - 1)) == 0,
+				  "t_alignment is not a power of 2 at least alignof(void *)");
+
+  public:
+	using value_type		= Object;
+
+	template<class U>
+	struct rebind
+	{
+		using other = AlignedAllocator<U, t_alignment>;
+	};
+
+	AlignedAllocator() noexcept = default;
+
+	template<class U>
+	AlignedAllocator(const AlignedAllocator<U, t_alignment> &) noexcept
+	{}
+
+	Object *allocate(std::size_t n) {
+		void * const raw = ::operator new(n * sizeof(Object) + t_alignment + sizeof(void *));
+		const std::uintptr_t address{reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *)};
+		void ** const aligned = reinterpret_cast<void **>((address + t_alignment - 1) & ~(t_alignment - 1));
+		aligned[-1] = raw;
+		return reinterpret_cast<Object *>(aligned);
+	}
+
+	void deallocate(Object *p, std::size_t) noexcept {
+		::operator delete(reinterpret_cast<void **>(p)[-1]);
+	}
+
+	template<class U>
+	bool operator==(const AlignedAllocator<U, t_alignment> &) const noexcept {
+		return true;
+	}
+
+	template<class U>
+	bool operator!=(const AlignedAllocator<U, t_alignment> &) const noexcept {
+		return false;
+	}
+}; // class AlignedAllocator
+
+
 template<
 	class Object
 	, class Allocator = std::allocator<Object>
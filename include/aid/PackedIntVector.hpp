@@ -0,0 +1,384 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file PackedIntVector.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_PackedIntVector_hpp
+#define aid_PackedIntVector_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "aid/BitField.hpp"
+
+
+namespace aid {
+
+namespace PackedIntVector_impl {
+
+using word_type	= std::uint64_t;
+
+constexpr unsigned int word_bits{64};
+constexpr unsigned int max_width{32};
+constexpr std::size_t padding_words{1};	// lets get() and the vector kernels read past the last element
+
+//! the Section mask of an element at offset 0
+inline constexpr word_type mask(unsigned int width) noexcept
+{
+	return ~word_type{0} >> (word_bits - width);
+}
+
+/*!
+  @brief		element index of words
+  @details		The two words are funneled without a branch; the second one may be padding.
+ */
+inline std::uint32_t get(const word_type *words, unsigned int width, std::size_t index) noexcept
+{
+	const std::size_t bit{index * width};
+	const word_type * const word = words + bit / word_bits;
+	const unsigned int offset{static_cast<unsigned int>(bit % word_bits)};
+	return static_cast<std::uint32_t>(((word[0] >> offset) | ((word[1] << 1) << (word_bits - 1 - offset)))
+									  & mask(width));
+}
+
+/*!
+  @brief		set element index of words
+  @pre			value <= mask(width)
+ */
+inline void set(word_type *words, unsigned int width, std::size_t index, std::uint32_t value) noexcept
+{
+	const std::size_t bit{index * width};
+	word_type * const word = words + bit / word_bits;
+	const unsigned int offset{static_cast<unsigned int>(bit % word_bits)};
+	word[0] = (word[0] & ~(mask(width) << offset)) | (word_type{value} << offset);
+	// the upper part which spills into the next word, if any
+	const unsigned int spill{word_bits - 1 - offset};
+	word[1] = (word[1] & ~((mask(width) >> 1) >> spill)) | ((word_type{value} >> 1) >> spill);
+}
+
+/*!
+  @brief		values[i] = element (first + i) of words, for i in [0, count)
+  @details		The elements are gathered with AVX2/AVX-512 if available.
+ */
+void unpack_n(const word_type *words, unsigned int width, std::size_t first, std::size_t count,
+			  std::uint32_t *values) noexcept;
+
+//! whether unpack_n gathers the elements with vector instructions on the active Isa
+bool vector_unpack() noexcept;
+
+/*!
+  @brief		element (first + i) of words = values[i], for i in [0, count)
+  @details		Whole words are streamed out, so the cost is about a shift and an or per element.
+				The values are masked to width.
+ */
+void pack_n(word_type *words, unsigned int width, std::size_t first, const std::uint32_t *values,
+			std::size_t count) noexcept;
+
+/*!
+  @brief		64 elements of t_width bits, which fill exactly t_width words
+  @details		Unrolled at compile time: every shift and mask is a constant.
+ */
+template<unsigned int t_width, unsigned int t_index = 0, bool t_end = t_index == word_bits>
+struct Block
+{
+	static constexpr unsigned int bit{t_index * t_width};
+	static constexpr unsigned int word{bit / word_bits};
+	static constexpr unsigned int offset{bit % word_bits};
+	static constexpr bool spans{offset + t_width > word_bits};
+
+	static void unpack(const word_type *words, std::uint32_t *values) noexcept {
+		word_type value{words[word] >> offset};
+		if ( spans ) {
+			value |= words[word + 1] << ((word_bits - offset) % word_bits);
+		}
+		values[t_index] = static_cast<std::uint32_t>(value & BitField<0, t_width - 1>::template mask<word_type>());
+		Block<t_width, t_index + 1>::unpack(words, values);
+	}
+
+	// the first bits of each word are assigned, so the words need not be cleared
+	static void pack(const std::uint32_t *values, word_type *words) noexcept {
+		const word_type value{values[t_index] & BitField<0, t_width - 1>::template mask<word_type>()};
+		if ( offset == 0 ) {
+			words[word] = value;
+		}
+		else {
+			words[word] |= value << offset;
+		}
+		if ( spans ) {
+			words[word + 1] = value >> ((word_bits - offset) % word_bits);
+		}
+		Block<t_width, t_index + 1>::pack(values, words);
+	}
+};
+
+template<unsigned int t_width, unsigned int t_index>
+struct Block<t_width, t_index, true>
+{
+	static void unpack(const word_type *, std::uint32_t *) noexcept {}
+	static void pack(const std::uint32_t *, word_type *) noexcept {}
+};
+
+} // namespace PackedIntVector_impl
+
+/*!
+  @brief		array of t_width-bit unsigned integers stored back to back
+  @details		Each element is a Section of one or two words. With t_width != 0
+				the width is a compile-time constant and the bulk operations run
+				unrolled blocks of 64 elements; with t_width == 0
+				(DynamicPackedIntVector) the width is given at run time and
+				unpack() gathers the elements with AVX2/AVX-512.
+				The bits past the last element are always zero.
+  @tparam		t_width	bits per element (1 to 32), or 0 for a run-time width
+ */
+template<unsigned int t_width>
+class BasicPackedIntVector
+{
+	static_assert(t_width <= PackedIntVector_impl::max_width, "t_width > 32");
+
+  public:
+	using value_type	= std::uint32_t;
+	using size_type		= std::size_t;
+	using word_type		= PackedIntVector_impl::word_type;
+
+  private:
+	std::vector<word_type>	m_words;
+	size_type				m_size;
+	unsigned int			m_width;
+
+  private:
+	static constexpr size_type word_count(size_type size, unsigned int width) noexcept {
+		return (size * width + PackedIntVector_impl::word_bits - 1) / PackedIntVector_impl::word_bits
+			+ PackedIntVector_impl::padding_words;
+	}
+
+  public:
+	/*!
+	  @brief		size zeros of t_width bits
+	 */
+	template<unsigned int w = t_width, typename std::enable_if<w != 0, int>::type = 0>
+	explicit BasicPackedIntVector(size_type size = 0)
+		: m_words(word_count(size, t_width)), m_size{size}, m_width{t_width}
+	{}
+
+	/*!
+	  @brief		size zeros of width bits
+	  @exception	std::invalid_argument	width == 0 || width > 32
+	 */
+	template<unsigned int w = t_width, typename std::enable_if<w == 0, int>::type = 0>
+	explicit BasicPackedIntVector(unsigned int width, size_type size = 0)
+		: m_words{}, m_size{size}, m_width{width}
+	{
+		if ( width == 0 || width > PackedIntVector_impl::max_width ) {
+			throw std::invalid_argument("width == 0 || width > 32");
+		}
+		m_words.resize(word_count(size, width));
+	}
+
+  public:
+	size_type size() const noexcept {
+		return m_size;
+	}
+
+	bool empty() const noexcept {
+		return m_size == 0;
+	}
+
+	unsigned int width() const noexcept {
+		return t_width != 0 ? t_width : m_width;
+	}
+
+	//! the largest value of an element
+	value_type max_value() const noexcept {
+		return static_cast<value_type>(PackedIntVector_impl::mask(width()));
+	}
+
+	const word_type *data() const noexcept {
+		return m_words.data();
+	}
+
+	size_type word_size() const noexcept {
+		return m_words.size();
+	}
+
+	/*!
+	  @brief		change the size; the new elements are value
+	  @exception	std::overflow_error	value > max_value() (only without NDEBUG)
+	 */
+	void resize(size_type size, value_type value = 0) {
+		value = checked(value);
+		const size_type old_size{m_size};
+		if ( size < old_size ) {
+			// clear the bits of the dropped elements which share a word with the kept ones
+			const size_type bits{size * width()};
+			if ( bits % PackedIntVector_impl::word_bits != 0 ) {
+				m_words[bits / PackedIntVector_impl::word_bits] &= PackedIntVector_impl::mask(bits % PackedIntVector_impl::word_bits);
+			}
+			for ( size_type i{(bits + PackedIntVector_impl::word_bits - 1) / PackedIntVector_impl::word_bits};
+				  i < word_count(old_size, width()); ++i ) {
+				m_words[i] = 0;
+			}
+		}
+		m_words.resize(word_count(size, width()));
+		m_size = size;
+		if ( value != 0 ) {
+			for ( size_type i{old_size}; i < size; ++i ) {
+				PackedIntVector_impl::set(m_words.data(), width(), i, value);
+			}
+		}
+	}
+
+	void clear() noexcept {
+		m_words.assign(PackedIntVector_impl::padding_words, 0);
+		m_size = 0;
+	}
+
+	/*!
+	  @exception	std::overflow_error	value > max_value() (only without NDEBUG)
+	 */
+	void push_back(value_type value) {
+		value = checked(value);
+		resize(m_size + 1);
+		PackedIntVector_impl::set(m_words.data(), width(), m_size - 1, value);
+	}
+
+	value_type operator[](size_type index) const noexcept {
+		return PackedIntVector_impl::get(m_words.data(), width(), index);
+	}
+
+	/*!
+	  @exception	std::out_of_range	index >= size()
+	 */
+	value_type get(size_type index) const {
+		if ( index >= m_size ) throw std::out_of_range("index >= size()");
+		return (*this)[index];
+	}
+
+	/*!
+	  @exception	std::out_of_range	index >= size()
+	  @exception	std::overflow_error	value > max_value() (only without NDEBUG)
+	 */
+	BasicPackedIntVector &set(size_type index, value_type value) {
+		if ( index >= m_size ) throw std::out_of_range("index >= size()");
+		PackedIntVector_impl::set(m_words.data(), width(), index, checked(value));
+		return *this;
+	}
+
+	/*!
+	  @brief		values[i] = (*this)[first + i] for i in [0, count)
+	  @exception	std::out_of_range		first + count > size()
+	  @exception	std::invalid_argument	values == nullptr && count > 0
+	 */
+	void unpack(size_type first, size_type count, value_type *values) const {
+		check_range(first, count, values);
+		unpack(first, count, values, std::integral_constant<bool, t_width != 0>());
+	}
+
+	/*!
+	  @brief		(*this)[first + i] = values[i] for i in [0, count)
+	  @exception	std::out_of_range		first + count > size()
+	  @exception	std::invalid_argument	values == nullptr && count > 0
+	  @exception	std::overflow_error		values[i] > max_value() (only without NDEBUG)
+	 */
+	void pack(size_type first, const value_type *values, size_type count) {
+		check_range(first, count, values);
+#ifndef NDEBUG
+		for ( size_type i{0}; i < count; ++i ) {
+			checked(values[i]);
+		}
+#endif
+		pack(first, values, count, std::integral_constant<bool, t_width != 0>());
+	}
+
+	bool operator==(const BasicPackedIntVector &rhs) const noexcept {
+		return m_size == rhs.m_size && width() == rhs.width() && m_words == rhs.m_words;
+	}
+
+	bool operator!=(const BasicPackedIntVector &rhs) const noexcept {
+		return !(*this == rhs);
+	}
+
+  private:
+	value_type checked(value_type value) const {
+#ifdef NDEBUG
+		return value & max_value();
+#else
+		if ( value > max_value() ) throw std::overflow_error("value > max_value()");
+		return value;
+#endif
+	}
+
+	void check_range(size_type first, size_type count, const value_type *values) const {
+		if ( first > m_size || count > m_size - first ) throw std::out_of_range("first + count > size()");
+		if ( values == nullptr && count > 0 ) throw std::invalid_argument("values == nullptr");
+	}
+
+	// run-time width
+	void unpack(size_type first, size_type count, value_type *values, std::false_type) const noexcept {
+		PackedIntVector_impl::unpack_n(m_words.data(), width(), first, count, values);
+	}
+
+	void pack(size_type first, const value_type *values, size_type count, std::false_type) noexcept {
+		PackedIntVector_impl::pack_n(m_words.data(), width(), first, values, count);
+	}
+
+	// compile-time width: the elements up to a block boundary one by one, then whole blocks
+	// (a gather beats the unrolled blocks, so it is taken when the Isa has one)
+	void unpack(size_type first, size_type count, value_type *values, std::true_type) const noexcept {
+		using namespace PackedIntVector_impl;
+		if ( vector_unpack() ) {
+			unpack_n(m_words.data(), t_width, first, count, values);
+			return;
+		}
+		size_type i{0};
+		for ( ; i < count && (first + i) % word_bits != 0; ++i ) {
+			values[i] = (*this)[first + i];
+		}
+		for ( ; i + word_bits <= count; i += word_bits ) {
+			Block<t_width>::unpack(m_words.data() + (first + i) / word_bits * t_width, values + i);
+		}
+		for ( ; i < count; ++i ) {
+			values[i] = (*this)[first + i];
+		}
+	}
+
+	void pack(size_type first, const value_type *values, size_type count, std::true_type) noexcept {
+		using namespace PackedIntVector_impl;
+		size_type i{0};
+		for ( ; i < count && (first + i) % word_bits != 0; ++i ) {
+			PackedIntVector_impl::set(m_words.data(), t_width, first + i, values[i] & max_value());
+		}
+		for ( ; i + word_bits <= count; i += word_bits ) {
+			Block<t_width>::pack(values + i, m_words.data() + (first + i) / word_bits * t_width);
+		}
+		for ( ; i < count; ++i ) {
+			PackedIntVector_impl::set(m_words.data(), t_width, first + i, values[i] & max_value());
+		}
+	}
+}; // class BasicPackedIntVector
+
+//! elements of t_width bits, fixed at compile time
+template<unsigned int t_width>
+using PackedIntVector = BasicPackedIntVector<t_width>;
+
+//! elements of a width given at run time
+using DynamicPackedIntVector = BasicPackedIntVector<0>;
+
+} // namespace aid
+
+
+#endif // aid_PackedIntVector_hpp
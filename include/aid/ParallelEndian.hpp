@@ -0,0 +1,169 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file ParallelEndian.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_ParallelEndian_hpp
+#define aid_ParallelEndian_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "aid/DynamicEndianConverter.hpp"
+#include "aid/Endian.hpp"
+#include "aid/WorkerPool.hpp"
+
+
+namespace aid {
+
+/*!
+  @brief		options of a parallel conversion
+ */
+struct ParallelOptions
+{
+	//! buffers smaller than this (in bytes) are converted by the calling thread only
+	std::size_t	threshold;
+	//! bytes of a chunk given to a thread; rounded up to a multiple of page_size
+	std::size_t	chunk_size;
+	//! chunk boundaries are aligned to this (in bytes) in the native buffer
+	std::size_t	page_size;
+
+	constexpr ParallelOptions(std::size_t ithreshold = 1024 * 1024,
+							  std::size_t ichunk_size = 256 * 1024,
+							  std::size_t ipage_size = 4096) noexcept
+		: threshold{ithreshold}, chunk_size{ichunk_size}, page_size{ipage_size}
+	{}
+};
+
+namespace ParallelEndian_impl {
+
+/*!
+  @brief		split of an array into chunks whose boundaries are page aligned
+ */
+class Chunks
+{
+  private:
+	std::size_t	m_count;
+	std::size_t	m_head;
+	std::size_t	m_per_chunk;
+
+  public:
+	Chunks(const void *native, std::size_t count, std::size_t size, const ParallelOptions &options) noexcept
+		: m_count{count}, m_head{0}, m_per_chunk{0}
+	{
+		const std::size_t page{options.page_size == 0 ? 1 : options.page_size};
+		std::size_t bytes{(options.chunk_size + page - 1) / page * page};
+		if ( bytes < size ) bytes = size;
+		m_per_chunk = bytes / size;
+
+		const std::uintptr_t address{reinterpret_cast<std::uintptr_t>(native)};
+		if ( address % size == 0 ) {
+			m_head = (page - address % page) % page / size;
+			if ( m_head > count ) m_head = count;
+		}
+	}
+
+	std::size_t size() const noexcept {
+		const std::size_t rest{m_count - m_head};
+		return (m_head > 0 ? 1 : 0) + (rest + m_per_chunk - 1) / m_per_chunk;
+	}
+
+	std::size_t first(std::size_t index) const noexcept {
+		if ( m_head == 0 ) return index * m_per_chunk;
+		return index == 0 ? 0 : m_head + (index - 1) * m_per_chunk;
+	}
+
+	std::size_t count(std::size_t index) const noexcept {
+		const std::size_t begin{first(index)};
+		const std::size_t end{m_head > 0 && index == 0 ? m_head : begin + m_per_chunk};
+		return (end < m_count ? end : m_count) - begin;
+	}
+}; // class Chunks
+
+inline void check_arguments(const void *native, const void *external)
+{
+	if ( native == nullptr ) throw std::invalid_argument("native == nullptr");
+	if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
+}
+
+} // namespace ParallelEndian_impl
+
+/*!
+  @brief		convert native endian values to external endian values with a worker pool
+  @details		The result is the same as converter.to_external_n(native, count, external);
+				every chunk is written by exactly one thread.
+  @param[in]	pool		worker pool
+  @param[in]	converter	EndianConverter or DynamicEndianConverter
+  @param[in]	native		pointer to the beginning of the native endian values
+  @param[in]	count		number of the values
+  @param[out]	external	pointer to the beginning of the external endian values
+  @param[in]	options		options of the split
+  @exception	std::invalid_argument	native == nullptr && count > 0
+  @exception	std::invalid_argument	external == nullptr && count > 0
+  @exception	std::logic_error		the external endian type of converter is unknown
+ */
+template<class Converter, typename Integer>
+void parallel_to_external_n(WorkerPool &pool, const Converter &converter,
+							const Integer *native, std::size_t count, unsigned char *external,
+							const ParallelOptions &options = ParallelOptions())
+{
+	if ( count * sizeof(Integer) < options.threshold || pool.size() == 1 ) {
+		return converter.to_external_n(native, count, external);
+	}
+	ParallelEndian_impl::check_arguments(native, external);
+
+	const ParallelEndian_impl::Chunks chunks(native, count, sizeof(Integer), options);
+	pool.run(chunks.size(), [&](std::size_t index) {
+		const std::size_t first{chunks.first(index)};
+		converter.to_external_n(native + first, chunks.count(index), external + first * sizeof(Integer));
+	});
+}
+
+/*!
+  @brief		convert external endian values to native endian values with a worker pool
+  @details		The result is the same as converter.from_external_n(external, count, native);
+				every chunk is written by exactly one thread.
+  @param[in]	pool		worker pool
+  @param[in]	converter	EndianConverter or DynamicEndianConverter
+  @param[in]	external	pointer to the beginning of the external endian values
+  @param[in]	count		number of the values
+  @param[out]	native		pointer to the beginning of the native endian values
+  @param[in]	options		options of the split
+  @exception	std::invalid_argument	external == nullptr && count > 0
+  @exception	std::invalid_argument	native == nullptr && count > 0
+  @exception	std::logic_error		the external endian type of converter is unknown
+ */
+template<class Converter, typename Integer>
+void parallel_from_external_n(WorkerPool &pool, const Converter &converter,
+							  const unsigned char *external, std::size_t count, Integer *native,
+							  const ParallelOptions &options = ParallelOptions())
+{
+	if ( count * sizeof(Integer) < options.threshold || pool.size() == 1 ) {
+		return converter.from_external_n(external, count, native);
+	}
+	ParallelEndian_impl::check_arguments(native, external);
+
+	const ParallelEndian_impl::Chunks chunks(native, count, sizeof(Integer), options);
+	pool.run(chunks.size(), [&](std::size_t index) {
+		const std::size_t first{chunks.first(index)};
+		converter.from_external_n(external + first * sizeof(Integer), chunks.count(index), native + first);
+	});
+}
+
+} // namespace aid
+
+
+#endif // aid_ParallelEndian_hpp
@@ -0,0 +1,544 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file PooledFactory.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_PooledFactory_hpp
+#define aid_PooledFactory_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "aid/AtomicBitVector.hpp"
+#include "aid/Factory.hpp"
+#include "aid/Memory.hpp"
+#include "aid/NonCopyable.hpp"
+#include "aid/NonMovable.hpp"
+
+
+namespace aid {
+
+namespace PooledFactory_impl {
+
+constexpr std::size_t max_thread_count{64};		// threads with a cache of their own
+constexpr std::size_t no_thread_index{max_thread_count};
+constexpr std::size_t cache_capacity{16};		// products in the cache of a thread
+
+//! an index in [0, max_thread_count) owned by a thread from its first pooled call to its end
+class ThreadIndex
+	: private NonCopyable
+	, private NonMovable
+{
+  private:
+	std::size_t	m_index;
+
+  private:
+	static AtomicBitVector<std::uint64_t> &indices() noexcept {
+		static AtomicBitVector<std::uint64_t> s_indices;
+		return s_indices;
+	}
+
+  public:
+	ThreadIndex() noexcept
+		: m_index{indices().acquire_first_free()}
+	{
+		if ( m_index == AtomicBitVector<std::uint64_t>::npos ) {
+			m_index = no_thread_index;
+		}
+	}
+
+	~ThreadIndex() {
+		// the products released later in the thread exit (by other thread_locals) go to the overflow lists
+		const std::size_t index{m_index};
+		m_index = no_thread_index;
+		if ( index != no_thread_index ) {
+			indices().release(static_cast<AtomicBitVector<std::uint64_t>::offset_type>(index));
+		}
+	}
+
+	std::size_t get() const noexcept {
+		return m_index;
+	}
+}; // class ThreadIndex
+
+//! the index of the calling thread, or no_thread_index if max_thread_count threads have one or it is ending
+inline std::size_t thread_index() noexcept
+{
+	static thread_local const ThreadIndex s_index;
+	return s_index.get();
+}
+
+//! counts written by one thread and read by any
+inline void increment(std::atomic<std::uint64_t> &count) noexcept
+{
+	count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/*!
+  @brief		the products of an identifier which are not in use
+  @details		Each thread index has a cache of up to cache_capacity products,
+				which only the thread of the index touches, and so with no
+				lock. A full cache moves half of it to the overflow list, and
+				an empty one takes up to half of its capacity back from it,
+				under a mutex. A thread past max_thread_count uses the
+				overflow list only.
+
+				Once retired by its factory, the pool deletes the products
+				given back, and deletes itself with the last one. The products
+				in use are those taken (the hits and the misses) less those
+				given back, which each thread counts in its cache with no
+				shared write, so retire() counts them once and the later
+				releases count down from there.
+ */
+template<class AbstractProduct>
+class Pool
+	: private NonCopyable
+	, private NonMovable
+{
+  public:
+	using Creator	= std::function<std::unique_ptr<AbstractProduct> ()>;
+	using Reset		= std::function<void (AbstractProduct &)>;
+
+  private:
+	struct Cache
+	{
+		AbstractProduct				*products[cache_capacity];
+		std::size_t					size;
+		std::atomic<std::uint64_t>	parks;	// twice the products given back, plus one while one is given back
+		std::atomic<std::uint64_t>	hits;
+		std::atomic<std::uint64_t>	misses;
+
+		Cache() noexcept
+			: products{}, size{0}, parks{0}, hits{0}, misses{0}
+		{}
+	};
+
+	using CacheAllocator	= AlignedAllocator<Cache, 64>;	// a cache line of its own
+
+  private:
+	const Creator						m_creator;
+	const Reset							m_reset;
+	std::atomic<Cache *>				m_caches[max_thread_count];
+	std::mutex							m_mutex;
+	std::vector<AbstractProduct *>		m_overflow;
+	std::atomic<std::uint64_t>			m_hits;		// of the threads with no cache
+	std::atomic<std::uint64_t>			m_misses;
+	std::uint64_t						m_parks;	// of the threads with no cache, under m_mutex
+	std::atomic<bool>					m_retired;
+	std::atomic<std::uint64_t>			m_in_use;	// less the releases not counted by parks, modulo 2^64
+
+  private:
+	Cache &cache(std::size_t index) {
+		Cache *cache = m_caches[index].load(std::memory_order_relaxed);
+		if ( cache == nullptr ) {
+			CacheAllocator allocator;
+			cache = new(allocator.allocate(1)) Cache;
+			// (sequentially consistent, so that retire() finds it if park() does not see retire())
+			m_caches[index].store(cache);
+		}
+		return *cache;
+	}
+
+	void refill(Cache &cache) {
+		std::lock_guard<std::mutex> guard(m_mutex);
+		while ( cache.size < cache_capacity / 2 && !m_overflow.empty() ) {
+			cache.products[cache.size++] = m_overflow.back();
+			m_overflow.pop_back();
+		}
+	}
+
+	//! move the upper half of cache to the overflow list, or delete it if the list cannot grow
+	void spill(Cache &cache) noexcept {
+		AbstractProduct * const * const first = cache.products + cache_capacity / 2;
+		AbstractProduct * const * const last = cache.products + cache.size;
+		cache.size = cache_capacity / 2;
+		std::lock_guard<std::mutex> guard(m_mutex);
+		try {
+			m_overflow.insert(m_overflow.end(), first, last);
+		}
+		catch ( ... ) {
+			for ( auto product = first; product != last; ++product ) {
+				delete *product;
+			}
+		}
+	}
+
+	//! a product of the overflow list, or nullptr
+	AbstractProduct *pop_overflow() {
+		std::lock_guard<std::mutex> guard(m_mutex);
+		if ( m_overflow.empty() ) {
+			return nullptr;
+		}
+		AbstractProduct * const product = m_overflow.back();
+		m_overflow.pop_back();
+		return product;
+	}
+
+	void delete_overflow() noexcept {
+		for ( AbstractProduct *product : m_overflow ) {
+			delete product;
+		}
+		m_overflow.clear();
+	}
+
+	//! keep product for acquire() and count it in parks, or return false if the pool is retired
+	bool park(AbstractProduct *product) {
+		const std::size_t index{thread_index()};
+		if ( index == no_thread_index ) {
+			std::lock_guard<std::mutex> guard(m_mutex);
+			if ( m_retired.load(std::memory_order_relaxed) ) {
+				return false;
+			}
+			m_overflow.push_back(product);
+			++m_parks;
+			return true;
+		}
+
+		Cache &local = cache(index);
+		// (sequentially consistent, so that either retire() waits for the odd count or it is seen here)
+		const std::uint64_t parks{local.parks.fetch_add(1) + 1};
+		if ( m_retired.load() ) {
+			local.parks.store(parks - 1, std::memory_order_relaxed);
+			return false;
+		}
+		if ( local.size == cache_capacity ) {
+			spill(local);
+		}
+		local.products[local.size++] = product;
+		local.parks.store(parks + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! count down a product in use not counted by the parks, and delete the pool with the last one
+	void release() noexcept {
+		if ( m_in_use.fetch_sub(1, std::memory_order_acq_rel) == 1 ) {
+			delete this;
+		}
+	}
+
+  public:
+	Pool(Creator creator, Reset reset)
+		: m_creator{std::move(creator)}, m_reset{std::move(reset)}
+		, m_mutex{}, m_overflow{}, m_hits{0}, m_misses{0}, m_parks{0}, m_retired{false}, m_in_use{0}
+	{
+		for ( auto &cache : m_caches ) {
+			cache.store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	~Pool() {
+		for ( auto &cache : m_caches ) {
+			Cache * const p = cache.load(std::memory_order_acquire);
+			if ( p != nullptr ) {
+				for ( std::size_t i{0}; i < p->size; ++i ) {
+					delete p->products[i];
+				}
+				p->~Cache();
+				CacheAllocator().deallocate(p, 1);
+			}
+		}
+		delete_overflow();
+	}
+
+  public:
+	//! a product of the caches, or of the creator if they are empty
+	AbstractProduct *acquire() {
+		const std::size_t index{thread_index()};
+		if ( index != no_thread_index ) {
+			Cache &local = cache(index);
+			if ( local.size == 0 ) {
+				refill(local);
+			}
+			if ( local.size > 0 ) {
+				increment(local.hits);
+				return local.products[--local.size];
+			}
+			AbstractProduct * const product = m_creator().release();
+			if ( product != nullptr ) {
+				increment(local.misses);
+			}
+			return product;
+		}
+
+		AbstractProduct *product = pop_overflow();
+		if ( product != nullptr ) {
+			m_hits.fetch_add(1, std::memory_order_relaxed);
+			return product;
+		}
+		product = m_creator().release();
+		if ( product != nullptr ) {
+			m_misses.fetch_add(1, std::memory_order_relaxed);
+		}
+		return product;
+	}
+
+	//! reset product and keep it for acquire(), or delete it if the pool is retired
+	void recycle(AbstractProduct *product) noexcept {
+		if ( !m_retired.load(std::memory_order_acquire) ) {
+			if ( m_reset ) {
+				m_reset(*product);
+			}
+			try {
+				if ( park(product) ) {
+					return;
+				}
+			}
+			catch ( ... ) {
+			}
+		}
+		delete product;
+		release();
+	}
+
+	/*!
+	  @brief		delete the pooled products and those given back from now on
+	  @details		The pool and its caches are deleted now if no product is in
+					use, or else when the last one is released. create() must
+					not be called concurrently, but the release of the products may.
+	 */
+	void retire() noexcept {
+		// (sequentially consistent, as the caches and the parks of park())
+		m_retired.store(true);
+		std::uint64_t in_use{0};
+		for ( auto &cache : m_caches ) {
+			Cache * const p = cache.load();
+			if ( p != nullptr ) {
+				std::uint64_t parks;
+				while ( (parks = p->parks.load()) % 2 != 0 ) {
+					std::this_thread::yield();
+				}
+				for ( std::size_t i{0}; i < p->size; ++i ) {
+					delete p->products[i];
+				}
+				p->size = 0;
+				in_use += p->hits.load(std::memory_order_relaxed) + p->misses.load(std::memory_order_relaxed) - parks / 2;
+			}
+		}
+		{
+			std::lock_guard<std::mutex> guard(m_mutex);
+			delete_overflow();
+			in_use += m_hits.load(std::memory_order_relaxed) + m_misses.load(std::memory_order_relaxed) - m_parks;
+		}
+		if ( m_in_use.fetch_add(in_use, std::memory_order_acq_rel) + in_use == 0 ) {
+			delete this;
+		}
+	}
+
+	//! add the hits and the misses of all the threads
+	void count(std::uint64_t &hits, std::uint64_t &misses) const noexcept {
+		hits += m_hits.load(std::memory_order_relaxed);
+		misses += m_misses.load(std::memory_order_relaxed);
+		for ( const auto &cache : m_caches ) {
+			const Cache * const p = cache.load(std::memory_order_acquire);
+			if ( p != nullptr ) {
+				hits += p->hits.load(std::memory_order_relaxed);
+				misses += p->misses.load(std::memory_order_relaxed);
+			}
+		}
+	}
+}; // class Pool
+
+//! the deleter of the products of a PooledFactory, which gives them back to their pool
+template<class AbstractProduct>
+class Recycler
+{
+  private:
+	Pool<AbstractProduct>	*m_pool;
+
+  public:
+	Recycler() noexcept
+		: m_pool{nullptr}
+	{}
+
+	explicit Recycler(Pool<AbstractProduct> *pool) noexcept
+		: m_pool{pool}
+	{}
+
+	void operator()(AbstractProduct *product) const noexcept {
+		if ( m_pool != nullptr ) {
+			m_pool->recycle(product);
+		}
+		else {
+			delete product;
+		}
+	}
+}; // class Recycler
+
+//! the deleter of the pools of a PooledFactory, which retires them
+template<class AbstractProduct>
+struct Retirer
+{
+	void operator()(Pool<AbstractProduct> *pool) const noexcept {
+		pool->retire();
+	}
+};
+
+} // namespace PooledFactory_impl
+
+/*!
+  @brief		Factory which reuses the products released instead of deleting them
+  @details		The products are unique_ptrs whose deleter gives them back to
+				the pool of their identifier, after the reset hook, and create()
+				returns one of them before it calls the creator. A thread takes
+				and gives back the products of a small cache of its own with no
+				lock and no allocation, and the caches exchange products through
+				an overflow list under a mutex.
+
+				create() and the release of the products may be called from any
+				thread. The other member functions must not be called
+				concurrently with create(), as those of Factory. The pool of an
+				identifier is deleted when the identifier is unregistered and
+				its last product is released, so the products may outlive the
+				factory.
+  @tparam		AbstractProduct		the products are AbstractProducts allocated by new
+ */
+template<
+	class AbstractProduct
+	, typename Identifier
+	, template<typename, class> class FactoryErrorPolicy = DefaultFactoryError
+	, template<typename, typename> class FactoryLookupPolicy = MapFactoryLookup
+	>
+class PooledFactory
+	: public FactoryErrorPolicy<Identifier,
+								std::unique_ptr<AbstractProduct, PooledFactory_impl::Recycler<AbstractProduct>>>
+	, private NonCopyable
+	, private NonMovable
+{
+  private:
+	using Pool				= PooledFactory_impl::Pool<AbstractProduct>;
+	using IdToPoolMap		= FactoryLookupPolicy<Identifier, Pool *>;
+	using OwnedPool			= std::unique_ptr<Pool, PooledFactory_impl::Retirer<AbstractProduct>>;
+
+  public:
+	using abstract_product_ptr_type	= std::unique_ptr<AbstractProduct, PooledFactory_impl::Recycler<AbstractProduct>>;
+	using identifier_type			= Identifier;
+	using product_creator_type		= typename Pool::Creator;
+	using product_reset_type		= typename Pool::Reset;
+	using error_policy_type			= FactoryErrorPolicy<Identifier, abstract_product_ptr_type>;
+	using lookup_policy_type		= IdToPoolMap;
+
+	struct Stats
+	{
+		std::uint64_t	hits;		// create() calls which reused a product
+		std::uint64_t	misses;		// create() calls which called the creator
+	};
+
+  private:
+	IdToPoolMap				m_pools;
+	std::vector<OwnedPool>	m_owned;	// the pools of m_pools
+	Stats					m_retired_stats;	// the statistics of the unregistered identifiers
+
+  public:
+	PooledFactory()
+		: m_pools{}, m_owned{}, m_retired_stats{0, 0}
+	{}
+
+  public:
+	/*!
+	  @brief		register the creator of the products of id
+	  @param[in]	reset	called on a product when it is released, to be reused;
+							it must not throw
+	 */
+	bool register_creator(const identifier_type &id, product_creator_type creator,
+						  product_reset_type reset = product_reset_type()) {
+		if ( m_pools.find(id) != nullptr ) {
+			return false;
+		}
+		OwnedPool pool{new Pool(std::move(creator), std::move(reset))};
+		m_owned.reserve(m_owned.size() + 1);
+		m_pools.insert(id, pool.get());
+		m_owned.push_back(std::move(pool));
+		return true;
+	}
+
+	/*!
+	  @brief		unregister id
+	  @details		The pooled products of id are deleted, and so are the products
+					of id in use when they are released.
+	 */
+	bool unregister_creator(const identifier_type &id) {
+		Pool * const * const found = m_pools.find(id);
+		if ( found == nullptr ) {
+			return false;
+		}
+		Pool * const pool = *found;
+		m_pools.erase(id);
+		pool->count(m_retired_stats.hits, m_retired_stats.misses);
+		m_owned.erase(std::find_if(m_owned.begin(), m_owned.end(), [pool](const OwnedPool &owned) {
+			return owned.get() == pool;
+		}));
+		return true;
+	}
+
+	std::vector<identifier_type> registered_ids() const {
+		return m_pools.ids();
+	}
+
+	void clear_creator() {
+		for ( const auto &id : m_pools.ids() ) {
+			unregister_creator(id);
+		}
+	}
+
+	//! a product of id, reused if one is pooled
+	abstract_product_ptr_type create(const identifier_type &id) const {
+		Pool * const * const pool = m_pools.find(id);
+		if ( pool == nullptr ) {
+			return this->on_unknown_type(id);
+		}
+		return abstract_product_ptr_type((*pool)->acquire(), PooledFactory_impl::Recycler<AbstractProduct>(*pool));
+	}
+
+	/*!
+	  @brief		build a perfect hash of the registered identifiers (FrozenFactoryLookup only)
+	  @return		whether the lookups are frozen
+	 */
+	bool freeze() {
+		return m_pools.freeze();
+	}
+
+	//! the statistics of id, which are zero if id is not registered
+	Stats stats(const identifier_type &id) const {
+		Stats stats{0, 0};
+		Pool * const * const pool = m_pools.find(id);
+		if ( pool != nullptr ) {
+			(*pool)->count(stats.hits, stats.misses);
+		}
+		return stats;
+	}
+
+	//! the statistics of all the identifiers ever registered
+	Stats stats() const noexcept {
+		Stats stats = m_retired_stats;
+		for ( const auto &pool : m_owned ) {
+			pool->count(stats.hits, stats.misses);
+		}
+		return stats;
+	}
+}; // class PooledFactory
+
+} // namespace aid
+
+
+#endif // aid_PooledFactory_hpp
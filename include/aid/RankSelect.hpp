@@ -0,0 +1,190 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file RankSelect.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_RankSelect_hpp
+#define aid_RankSelect_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "aid/DynamicBitVector.hpp"
+
+#if		defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+
+namespace aid {
+
+namespace RankSelect_impl {
+
+constexpr std::size_t block_bits{512};			// a cache line of DynamicBitVector
+constexpr std::size_t superblock_bits{65536};	// the relative ranks fit in 16 bits
+constexpr std::size_t select_sample{16384};		// every select_sample-th set bit is sampled
+
+/*!
+  @brief		index of the rank-th (0-based) set bit of a word
+  @pre			rank < popcount(word)
+ */
+inline unsigned int select_in_word(std::uint64_t word, unsigned int rank) noexcept
+{
+#if		defined(__BMI2__)
+	return BitVector_impl::count_trailing_zeros(_pdep_u64(std::uint64_t{1} << rank, word));
+#else
+	for ( ; rank > 0; --rank ) {
+		word &= word - 1;
+	}
+	return BitVector_impl::count_trailing_zeros(word);
+#endif
+}
+
+} // namespace RankSelect_impl
+
+/*!
+  @brief		read-only rank/select index over a DynamicBitVector
+  @details		rank1() reads an absolute count per 65536 bits, a 16-bit
+				relative count per 512-bit block (a cache line) and at most
+				8 words of the block, so the index adds about 3.2% to the bits.
+				select1() starts from the block of a sampled set bit, binary
+				searches the blocks up to the next sample and finishes in the
+				word with pdep/tzcnt (BMI2) or a broadword loop.
+ */
+class RankSelect
+{
+  public:
+	using size_type	= DynamicBitVector::size_type;
+
+  private:
+	DynamicBitVector			m_bits;
+	std::vector<std::uint64_t>	m_superblocks;	// set bits before each superblock
+	std::vector<std::uint16_t>	m_blocks;		// set bits before each block in its superblock
+	std::vector<std::uint32_t>	m_samples;		// block of every select_sample-th set bit
+	size_type					m_count;
+
+  public:
+	RankSelect() noexcept
+		: m_bits{}, m_superblocks{}, m_blocks{}, m_samples{}, m_count{0}
+	{}
+
+	/*!
+	  @brief		build the index
+	  @param[in]	bits	bits to index; moved into the index
+	  @exception	std::length_error	bits.size() >= 2^41
+	 */
+	explicit RankSelect(DynamicBitVector bits);
+
+  public:
+	const DynamicBitVector &bits() const noexcept {
+		return m_bits;
+	}
+
+	size_type size() const noexcept {
+		return m_bits.size();
+	}
+
+	/*!
+	  @brief		number of the set bits
+	 */
+	size_type count() const noexcept {
+		return m_count;
+	}
+
+	/*!
+	  @brief		number of the set bits in [0, index)
+	  @exception	std::out_of_range	index > size()
+	 */
+	size_type rank1(size_type index) const {
+		if ( index > size() ) throw std::out_of_range("index > size()");
+		if ( index == size() ) return m_count;
+
+		const size_type block{index / RankSelect_impl::block_bits};
+		size_type rank{absolute_rank(block)};
+		const BitVector_impl::word_type * const words = m_bits.data();
+		const size_type word{index / BitVector_impl::word_bits};
+		for ( size_type i{block * BitVector_impl::line_words}; i < word; ++i ) {
+			rank += BitVector_impl::popcount(words[i]);
+		}
+		const unsigned int offset{static_cast<unsigned int>(index % BitVector_impl::word_bits)};
+		if ( offset != 0 ) {
+			rank += BitVector_impl::popcount(words[word] << (BitVector_impl::word_bits - offset));
+		}
+		return rank;
+	}
+
+	/*!
+	  @brief		number of the clear bits in [0, index)
+	  @exception	std::out_of_range	index > size()
+	 */
+	size_type rank0(size_type index) const {
+		return index - rank1(index);
+	}
+
+	/*!
+	  @brief		index of the rank-th (0-based) set bit
+	  @exception	std::out_of_range	rank >= count()
+	 */
+	size_type select1(size_type rank) const {
+		if ( rank >= m_count ) throw std::out_of_range("rank >= count()");
+
+		// the last block whose absolute rank is <= rank
+		const size_type sample{rank / RankSelect_impl::select_sample};
+		size_type low{m_samples[sample]};
+		size_type high{sample + 1 < m_samples.size() ? m_samples[sample + 1] : m_blocks.size() - 1};
+		while ( low < high ) {
+			const size_type middle{low + (high - low + 1) / 2};
+			if ( absolute_rank(middle) <= rank ) {
+				low = middle;
+			}
+			else {
+				high = middle - 1;
+			}
+		}
+
+		size_type rest{rank - absolute_rank(low)};
+		const BitVector_impl::word_type * const words = m_bits.data();
+		for ( size_type i{low * BitVector_impl::line_words}; ; ++i ) {
+			const unsigned int n{BitVector_impl::popcount(words[i])};
+			if ( rest < n ) {
+				return i * BitVector_impl::word_bits
+					+ RankSelect_impl::select_in_word(words[i], static_cast<unsigned int>(rest));
+			}
+			rest -= n;
+		}
+	}
+
+	/*!
+	  @brief		size of the index, excluding the bits
+	 */
+	size_type index_bytes() const noexcept {
+		return m_superblocks.size() * sizeof(m_superblocks[0])
+			+ m_blocks.size() * sizeof(m_blocks[0])
+			+ m_samples.size() * sizeof(m_samples[0]);
+	}
+
+  private:
+	size_type absolute_rank(size_type block) const noexcept {
+		constexpr size_type blocks_per_superblock{RankSelect_impl::superblock_bits / RankSelect_impl::block_bits};
+		return static_cast<size_type>(m_superblocks[block / blocks_per_superblock]) + m_blocks[block];
+	}
+}; // class RankSelect
+
+} // namespace aid
+
+
+#endif // aid_RankSelect_hpp
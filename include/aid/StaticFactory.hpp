@@ -0,0 +1,149 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file StaticFactory.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_StaticFactory_hpp
+#define aid_StaticFactory_hpp
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "aid/Factory.hpp"
+#include "aid/TypeList.hpp"
+
+
+namespace aid {
+
+namespace StaticFactory_impl {
+
+template<class AbstractProductPtr, class TProduct, typename... Args>
+AbstractProductPtr construct(Args &&... args)
+{
+	return AbstractProductPtr(new TProduct(std::forward<Args>(args)...));
+}
+
+//! the constructors of the products which take Args, in the order of the TypeList
+template<class AbstractProductPtr, typename TProducts, typename... Args>
+struct CreatorTable;
+
+template<class AbstractProductPtr, typename... TProducts, typename... Args>
+struct CreatorTable<AbstractProductPtr, TypeList<TProducts...>, Args...>
+{
+	using creator_type = AbstractProductPtr (*)(Args &&...);
+
+	static constexpr creator_type creators[sizeof...(TProducts)]{
+		&construct<AbstractProductPtr, TProducts, Args...>...
+	};
+};
+
+template<class AbstractProductPtr, typename... TProducts, typename... Args>
+constexpr typename CreatorTable<AbstractProductPtr, TypeList<TProducts...>, Args...>::creator_type
+CreatorTable<AbstractProductPtr, TypeList<TProducts...>, Args...>::creators[sizeof...(TProducts)];
+
+//! the index of TProduct in TProducts, or TProducts::size if it is not there
+template<typename TProduct, typename TProducts>
+struct IndexOf;
+
+template<typename TProduct>
+struct IndexOf<TProduct, TypeList<>>
+{
+	static constexpr std::size_t value{0};
+};
+
+template<typename TProduct, typename THead, typename... TTail>
+struct IndexOf<TProduct, TypeList<THead, TTail...>>
+{
+	static constexpr std::size_t value{std::is_same<TProduct, THead>::value
+									   ? 0 : 1 + IndexOf<TProduct, TypeList<TTail...>>::value};
+};
+
+} // namespace StaticFactory_impl
+
+template<
+	class AbstractProductPtr
+	, typename TProducts
+	, typename Identifier = std::size_t
+	, template<typename, class> class FactoryErrorPolicy = DefaultFactoryError
+	>
+class StaticFactory;
+
+/*!
+  @brief		Factory whose products are fixed at compile time
+  @details		The identifier of a product is its index in the TypeList, an
+				integer or an enumerator of the same value, and create() is a
+				bounds check and an indirect call through a constant table
+				of the constructors, with no registration and no lookup.
+				@code
+				enum class Shape { circle, square };
+				using ShapeFactory = StaticFactory<std::unique_ptr<Base>, TypeList<Circle, Square>, Shape>;
+				auto square = ShapeFactory().create(Shape::square, 2.0);
+				@endcode
+  @tparam		TProducts	TypeList of the products, each of which is
+							constructed by new and AbstractProductPtr
+ */
+template<
+	class AbstractProductPtr
+	, typename... TProducts
+	, typename Identifier
+	, template<typename, class> class FactoryErrorPolicy
+	>
+class StaticFactory<AbstractProductPtr, TypeList<TProducts...>, Identifier, FactoryErrorPolicy>
+	: public FactoryErrorPolicy<Identifier, AbstractProductPtr>
+{
+	static_assert(sizeof...(TProducts) > 0, "no product");
+
+  public:
+	using abstract_product_ptr_type	= AbstractProductPtr;
+	using identifier_type			= Identifier;
+	using products					= TypeList<TProducts...>;
+	using error_policy_type			= FactoryErrorPolicy<Identifier, AbstractProductPtr>;
+
+	static constexpr std::size_t size{sizeof...(TProducts)};
+
+  public:
+	//! get the identifier of TProduct
+	template<typename TProduct>
+	static constexpr identifier_type id() noexcept {
+		static_assert(StaticFactory_impl::IndexOf<TProduct, products>::value < size, "TProduct is not a product");
+		return static_cast<identifier_type>(StaticFactory_impl::IndexOf<TProduct, products>::value);
+	}
+
+	/*!
+	  @brief		construct the product of id with args
+	  @details		All the products must be constructible from args.
+	  @return		the product, or on_unknown_type(id) if id >= size
+	 */
+	template<typename... Args>
+	abstract_product_ptr_type create(const identifier_type &id, Args &&... args) const {
+		// (a negative id is converted to a large index)
+		const std::size_t index{static_cast<std::size_t>(id)};
+		if ( index >= size ) {
+			return this->on_unknown_type(id);
+		}
+		return StaticFactory_impl::CreatorTable<AbstractProductPtr, products, Args...>::creators[index](
+			std::forward<Args>(args)...);
+	}
+}; // class StaticFactory
+
+template<class AbstractProductPtr, typename... TProducts, typename Identifier,
+		 template<typename, class> class FactoryErrorPolicy>
+constexpr std::size_t StaticFactory<AbstractProductPtr, TypeList<TProducts...>, Identifier, FactoryErrorPolicy>::size;
+
+} // namespace aid
+
+
+#endif // aid_StaticFactory_hpp
@@ -0,0 +1,100 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file WorkerPool.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_WorkerPool_hpp
+#define aid_WorkerPool_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "aid/NonCopyable.hpp"
+#include "aid/NonMovable.hpp"
+
+
+namespace aid {
+
+/*!
+  @brief		fixed set of threads which run indexed tasks
+  @details		run() hands the task indices out to the workers and the calling
+				thread, and returns when all of them have finished.
+ */
+class WorkerPool
+	: private NonCopyable
+	, private NonMovable
+{
+  public:
+	using Task	= std::function<void (std::size_t index)>;
+
+  private:
+	std::vector<std::thread>	m_workers;
+	std::mutex					m_run_mutex;
+	std::mutex					m_mutex;
+	std::condition_variable		m_start;
+	std::condition_variable		m_finish;
+	const Task					*m_task;
+	std::size_t					m_task_count;
+	std::atomic<std::size_t>	m_next;
+	std::size_t					m_running;
+	unsigned long				m_generation;
+	std::exception_ptr			m_exception;
+	bool						m_stop;
+
+  public:
+	/*!
+	  @brief		start the workers
+	  @param[in]	threads		number of the threads which run tasks, including the
+								caller of run(); 0 means std::thread::hardware_concurrency()
+	 */
+	explicit WorkerPool(unsigned int threads = 0);
+
+	~WorkerPool();
+
+  public:
+	/*!
+	  @brief		get the process-wide pool of std::thread::hardware_concurrency() threads
+	 */
+	static WorkerPool &default_pool();
+
+	/*!
+	  @brief		get the number of the threads which run tasks, including the caller
+	 */
+	unsigned int size() const noexcept {
+		return static_cast<unsigned int>(m_workers.size() + 1);
+	}
+
+	/*!
+	  @brief		run task(0) ... task(count - 1) and wait for them
+	  @details		Calls from several threads are serialized.
+	  @exception	any		the first exception thrown by a task
+	 */
+	void run(std::size_t count, const Task &task);
+
+  private:
+	void work();
+	void drain();
+}; // class WorkerPool
+
+} // namespace aid
+
+
+#endif // aid_WorkerPool_hpp
@@ -0,0 +1,432 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file BitVectorBatch.cpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "aid/BitVectorBatch.hpp"
+#include "Isa_impl.hpp"
+
+
+namespace aid {
+
+namespace BitVectorBatch_impl {
+
+namespace {
+
+/*!
+  @brief		vector parts of get_n, select_n and set_n
+  @details		select and set kernels process whole words of selection (64 elements).
+  @return		number of the processed elements
+ */
+template<typename DataType>
+struct Kernels
+{
+	using Get = std::size_t (*)(const DataType *data, std::size_t count, DataType mask, unsigned int offset,
+								DataType *values);
+	using Select = std::size_t (*)(const DataType *data, std::size_t count, DataType mask, DataType bits,
+								   word_type *selection, std::size_t &selected);
+	using Set = std::size_t (*)(DataType *data, std::size_t count, DataType mask, DataType bits,
+								const word_type *selection);
+
+	Get		get;
+	Select	select;
+	Set		set;
+};
+
+template<typename DataType>
+std::size_t get_none(const DataType *, std::size_t, DataType, unsigned int, DataType *) noexcept
+{
+	return 0;
+}
+
+template<typename DataType>
+std::size_t select_none(const DataType *, std::size_t, DataType, DataType, word_type *, std::size_t &) noexcept
+{
+	return 0;
+}
+
+template<typename DataType>
+std::size_t set_none(DataType *, std::size_t, DataType, DataType, const word_type *) noexcept
+{
+	return 0;
+}
+
+template<typename DataType>
+constexpr Kernels<DataType> none() noexcept
+{
+	return {get_none<DataType>, select_none<DataType>, set_none<DataType>};
+}
+
+#if		defined(AID_ISA_X86)
+
+//! the lanes of DataType in a __m256i
+template<typename DataType>
+struct Avx2;
+
+template<>
+struct Avx2<std::uint32_t>
+{
+	static constexpr unsigned int lanes{8};
+
+	AID_TARGET("avx2")
+	static __m256i set1(std::uint32_t x) noexcept {
+		return _mm256_set1_epi32(static_cast<int>(x));
+	}
+
+	AID_TARGET("avx2")
+	static __m256i srl(__m256i x, __m128i count) noexcept {
+		return _mm256_srl_epi32(x, count);
+	}
+
+	//! bit i is lane i of x == lane i of y
+	AID_TARGET("avx2")
+	static unsigned int equal(__m256i x, __m256i y) noexcept {
+		return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, y))));
+	}
+
+	//! lane i is all ones if bit i of bits is set
+	AID_TARGET("avx2")
+	static __m256i expand(word_type bits) noexcept {
+		const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+		return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits)), lane_bits),
+								  lane_bits);
+	}
+};
+
+template<>
+struct Avx2<std::uint64_t>
+{
+	static constexpr unsigned int lanes{4};
+
+	AID_TARGET("avx2")
+	static __m256i set1(std::uint64_t x) noexcept {
+		return _mm256_set1_epi64x(static_cast<long long>(x));
+	}
+
+	AID_TARGET("avx2")
+	static __m256i srl(__m256i x, __m128i count) noexcept {
+		return _mm256_srl_epi64(x, count);
+	}
+
+	AID_TARGET("avx2")
+	static unsigned int equal(__m256i x, __m256i y) noexcept {
+		return static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x, y))));
+	}
+
+	AID_TARGET("avx2")
+	static __m256i expand(word_type bits) noexcept {
+		const __m256i lane_bits = _mm256_setr_epi64x(1, 2, 4, 8);
+		return _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_set1_epi64x(static_cast<long long>(bits)), lane_bits),
+								  lane_bits);
+	}
+};
+
+template<typename DataType>
+AID_TARGET("avx2")
+std::size_t get_avx2(const DataType *data, std::size_t count, DataType mask, unsigned int offset,
+					 DataType *values) noexcept
+{
+	using Lanes = Avx2<DataType>;
+	const __m256i section_mask = Lanes::set1(mask);
+	const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(offset));
+	std::size_t i{0};
+	for ( ; i + 2 * Lanes::lanes <= count; i += 2 * Lanes::lanes ) {
+		const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+		const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + Lanes::lanes));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(values + i),
+							Lanes::srl(_mm256_and_si256(x, section_mask), shift));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(values + i + Lanes::lanes),
+							Lanes::srl(_mm256_and_si256(y, section_mask), shift));
+	}
+	return i;
+}
+
+template<typename DataType>
+AID_TARGET("avx2,popcnt")
+std::size_t select_avx2(const DataType *data, std::size_t count, DataType mask, DataType bits,
+						word_type *selection, std::size_t &selected) noexcept
+{
+	using Lanes = Avx2<DataType>;
+	const __m256i section_mask = Lanes::set1(mask);
+	const __m256i section_bits = Lanes::set1(bits);
+	std::size_t i{0};
+	for ( ; i + word_bits <= count; i += word_bits ) {
+		word_type word{0};
+		for ( unsigned int k{0}; k < word_bits; k += Lanes::lanes ) {
+			const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + k));
+			word |= word_type{Lanes::equal(_mm256_and_si256(x, section_mask), section_bits)} << k;
+		}
+		selection[i / word_bits] = word;
+		selected += BitVector_impl::popcount(word);
+	}
+	return i;
+}
+
+// A word of selection with any bit set rewrites all its 64 elements, the unselected ones unchanged.
+template<typename DataType>
+AID_TARGET("avx2")
+std::size_t set_avx2(DataType *data, std::size_t count, DataType mask, DataType bits,
+					 const word_type *selection) noexcept
+{
+	using Lanes = Avx2<DataType>;
+	const __m256i section_mask = Lanes::set1(mask);
+	const __m256i section_bits = Lanes::set1(bits);
+	std::size_t i{0};
+	for ( ; i + word_bits <= count; i += word_bits ) {
+		const word_type word{selection[i / word_bits]};
+		if ( word == 0 ) {
+			continue;
+		}
+		for ( unsigned int k{0}; k < word_bits; k += Lanes::lanes ) {
+			__m256i * const p = reinterpret_cast<__m256i *>(data + i + k);
+			const __m256i x = _mm256_loadu_si256(p);
+			const __m256i y = _mm256_or_si256(_mm256_andnot_si256(section_mask, x), section_bits);
+			_mm256_storeu_si256(p, _mm256_blendv_epi8(x, y, Lanes::expand(word >> k)));
+		}
+	}
+	return i;
+}
+
+//! the lanes of DataType in a __m512i
+// (the masked forms are used; the plain ones start from _mm512_undefined, on which GCC warns falsely)
+template<typename DataType>
+struct Avx512;
+
+template<>
+struct Avx512<std::uint32_t>
+{
+	static constexpr unsigned int lanes{16};
+
+	AID_TARGET("avx512f")
+	static __m512i set1(std::uint32_t x) noexcept {
+		return _mm512_set1_epi32(static_cast<int>(x));
+	}
+
+	AID_TARGET("avx512f")
+	static __m512i srl(__m512i x, __m128i count) noexcept {
+		return _mm512_maskz_srl_epi32(0xFFFF, x, count);
+	}
+
+	AID_TARGET("avx512f")
+	static word_type equal(__m512i x, __m512i y) noexcept {
+		return _mm512_cmpeq_epi32_mask(x, y);
+	}
+
+	AID_TARGET("avx512f")
+	static void store(std::uint32_t *p, word_type selected, __m512i x) noexcept {
+		_mm512_mask_storeu_epi32(p, static_cast<__mmask16>(selected), x);
+	}
+};
+
+template<>
+struct Avx512<std::uint64_t>
+{
+	static constexpr unsigned int lanes{8};
+
+	AID_TARGET("avx512f")
+	static __m512i set1(std::uint64_t x) noexcept {
+		return _mm512_set1_epi64(static_cast<long long>(x));
+	}
+
+	AID_TARGET("avx512f")
+	static __m512i srl(__m512i x, __m128i count) noexcept {
+		return _mm512_maskz_srl_epi64(0xFF, x, count);
+	}
+
+	AID_TARGET("avx512f")
+	static word_type equal(__m512i x, __m512i y) noexcept {
+		return _mm512_cmpeq_epi64_mask(x, y);
+	}
+
+	AID_TARGET("avx512f")
+	static void store(std::uint64_t *p, word_type selected, __m512i x) noexcept {
+		_mm512_mask_storeu_epi64(p, static_cast<__mmask8>(selected), x);
+	}
+};
+
+template<typename DataType>
+AID_TARGET("avx512f")
+std::size_t get_avx512(const DataType *data, std::size_t count, DataType mask, unsigned int offset,
+					   DataType *values) noexcept
+{
+	using Lanes = Avx512<DataType>;
+	const __m512i section_mask = Lanes::set1(mask);
+	const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(offset));
+	std::size_t i{0};
+	for ( ; i + 2 * Lanes::lanes <= count; i += 2 * Lanes::lanes ) {
+		const __m512i x = _mm512_loadu_si512(data + i);
+		const __m512i y = _mm512_loadu_si512(data + i + Lanes::lanes);
+		_mm512_storeu_si512(values + i, Lanes::srl(_mm512_and_si512(x, section_mask), shift));
+		_mm512_storeu_si512(values + i + Lanes::lanes, Lanes::srl(_mm512_and_si512(y, section_mask), shift));
+	}
+	return i;
+}
+
+template<typename DataType>
+AID_TARGET("avx512f,popcnt")
+std::size_t select_avx512(const DataType *data, std::size_t count, DataType mask, DataType bits,
+						  word_type *selection, std::size_t &selected) noexcept
+{
+	using Lanes = Avx512<DataType>;
+	const __m512i section_mask = Lanes::set1(mask);
+	const __m512i section_bits = Lanes::set1(bits);
+	std::size_t i{0};
+	for ( ; i + word_bits <= count; i += word_bits ) {
+		word_type word{0};
+		for ( unsigned int k{0}; k < word_bits; k += Lanes::lanes ) {
+			const __m512i x = _mm512_loadu_si512(data + i + k);
+			word |= Lanes::equal(_mm512_and_si512(x, section_mask), section_bits) << k;
+		}
+		selection[i / word_bits] = word;
+		selected += BitVector_impl::popcount(word);
+	}
+	return i;
+}
+
+// Only the selected elements are stored.
+template<typename DataType>
+AID_TARGET("avx512f")
+std::size_t set_avx512(DataType *data, std::size_t count, DataType mask, DataType bits,
+					   const word_type *selection) noexcept
+{
+	using Lanes = Avx512<DataType>;
+	const __m512i section_mask = Lanes::set1(mask);
+	const __m512i section_bits = Lanes::set1(bits);
+	std::size_t i{0};
+	for ( ; i + word_bits <= count; i += word_bits ) {
+		const word_type word{selection[i / word_bits]};
+		if ( word == 0 ) {
+			continue;
+		}
+		for ( unsigned int k{0}; k < word_bits; k += Lanes::lanes ) {
+			const __m512i x = _mm512_loadu_si512(data + i + k);
+			const __m512i y = _mm512_ternarylogic_epi64(section_mask, x, section_bits, 0xAE);	// ~mask & x | bits
+			Lanes::store(data + i + k, word >> k, y);
+		}
+	}
+	return i;
+}
+
+template<typename DataType>
+constexpr Kernels<DataType> avx2() noexcept
+{
+	return {get_avx2<DataType>, select_avx2<DataType>, set_avx2<DataType>};
+}
+
+template<typename DataType>
+constexpr Kernels<DataType> avx512() noexcept
+{
+	return {get_avx512<DataType>, select_avx512<DataType>, set_avx512<DataType>};
+}
+
+// The scalar get loop is vectorized with SSE2 by the compiler, so SSSE3 has no kernels.
+const Kernels<std::uint32_t> kernels32[Isa_impl::variant_count]{
+	none<std::uint32_t>(), none<std::uint32_t>(), avx2<std::uint32_t>(), avx512<std::uint32_t>(),
+};
+
+const Kernels<std::uint64_t> kernels64[Isa_impl::variant_count]{
+	none<std::uint64_t>(), none<std::uint64_t>(), avx2<std::uint64_t>(), avx512<std::uint64_t>(),
+};
+
+#else	// AID_ISA_X86
+
+const Kernels<std::uint32_t> kernels32[Isa_impl::variant_count]{
+	none<std::uint32_t>(), none<std::uint32_t>(), none<std::uint32_t>(), none<std::uint32_t>(),
+};
+
+const Kernels<std::uint64_t> kernels64[Isa_impl::variant_count]{
+	none<std::uint64_t>(), none<std::uint64_t>(), none<std::uint64_t>(), none<std::uint64_t>(),
+};
+
+#endif	// AID_ISA_X86
+
+inline const Kernels<std::uint32_t> &active(const std::uint32_t *) noexcept
+{
+	return kernels32[Isa_impl::active_index()];
+}
+
+inline const Kernels<std::uint64_t> &active(const std::uint64_t *) noexcept
+{
+	return kernels64[Isa_impl::active_index()];
+}
+
+// the kernel, then the scalar loop from where it stopped
+template<typename DataType>
+void get_words(const DataType *data, std::size_t count, DataType mask, unsigned int offset,
+			   DataType *values) noexcept
+{
+	const std::size_t i{active(data).get(data, count, mask, offset, values)};
+	get_n<DataType>(data + i, count - i, mask, offset, values + i);
+}
+
+template<typename DataType>
+std::size_t select_words(const DataType *data, std::size_t count, DataType mask, DataType bits,
+						 word_type *selection) noexcept
+{
+	std::size_t selected{0};
+	const std::size_t i{active(data).select(data, count, mask, bits, selection, selected)};
+	return selected + select_n<DataType>(data + i, count - i, mask, bits, selection + i / word_bits);
+}
+
+template<typename DataType>
+void set_words(DataType *data, std::size_t count, DataType mask, DataType bits,
+			   const word_type *selection) noexcept
+{
+	const std::size_t i{active(static_cast<const DataType *>(data)).set(data, count, mask, bits, selection)};
+	set_n<DataType>(data + i, count - i, mask, bits, selection + i / word_bits);
+}
+
+} // unnamed namespace
+
+void get_n(const std::uint32_t *data, std::size_t count, std::uint32_t mask, unsigned int offset,
+		   std::uint32_t *values) noexcept
+{
+	get_words(data, count, mask, offset, values);
+}
+
+void get_n(const std::uint64_t *data, std::size_t count, std::uint64_t mask, unsigned int offset,
+		   std::uint64_t *values) noexcept
+{
+	get_words(data, count, mask, offset, values);
+}
+
+std::size_t select_n(const std::uint32_t *data, std::size_t count, std::uint32_t mask, std::uint32_t bits,
+					 word_type *selection) noexcept
+{
+	return select_words(data, count, mask, bits, selection);
+}
+
+std::size_t select_n(const std::uint64_t *data, std::size_t count, std::uint64_t mask, std::uint64_t bits,
+					 word_type *selection) noexcept
+{
+	return select_words(data, count, mask, bits, selection);
+}
+
+void set_n(std::uint32_t *data, std::size_t count, std::uint32_t mask, std::uint32_t bits,
+		   const word_type *selection) noexcept
+{
+	set_words(data, count, mask, bits, selection);
+}
+
+void set_n(std::uint64_t *data, std::size_t count, std::uint64_t mask, std::uint64_t bits,
+		   const word_type *selection) noexcept
+{
+	set_words(data, count, mask, bits, selection);
+}
+
+} // namespace BitVectorBatch_impl
+
+} // namespace aid
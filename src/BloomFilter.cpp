@@ -0,0 +1,162 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file BloomFilter.cpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "aid/BloomFilter.hpp"
+#include "Isa_impl.hpp"
+
+
+namespace aid {
+
+namespace BloomFilter_impl {
+
+namespace {
+
+/*!
+  @brief		vector parts of insert_n and contains_n
+  @details		contains kernels process whole words of result (64 hashes).
+  @return		number of the processed hashes
+ */
+using InsertKernel = std::size_t (*)(word_type *words, std::size_t block_count, const hash_type *hashes,
+									 std::size_t count);
+using ContainsKernel = std::size_t (*)(const word_type *words, std::size_t block_count, const hash_type *hashes,
+									   std::size_t count, word_type *result, std::size_t &found);
+
+// the blocks of the hashes this far ahead are prefetched, so that the cache misses overlap
+constexpr std::size_t prefetch_distance{16};
+
+std::size_t insert_none(word_type *, std::size_t, const hash_type *, std::size_t) noexcept
+{
+	return 0;
+}
+
+std::size_t contains_none(const word_type *, std::size_t, const hash_type *, std::size_t, word_type *,
+						  std::size_t &) noexcept
+{
+	return 0;
+}
+
+#if		defined(AID_ISA_X86)
+
+AID_TARGET("avx2")
+inline __m256i mask256(hash_type hash) noexcept
+{
+	const __m256i salts = _mm256_setr_epi32(static_cast<int>(salt[0]), static_cast<int>(salt[1]),
+											static_cast<int>(salt[2]), static_cast<int>(salt[3]),
+											static_cast<int>(salt[4]), static_cast<int>(salt[5]),
+											static_cast<int>(salt[6]), static_cast<int>(salt[7]));
+	const __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(hash)), salts), 27);
+	return _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+}
+
+// (the blocks are aligned: the words of a DynamicBitVector are aligned to a cache line)
+AID_TARGET("avx2")
+inline __m256i *block256(const word_type *words, std::size_t block_count, hash_type hash) noexcept
+{
+	return reinterpret_cast<__m256i *>(const_cast<word_type *>(words) + block(hash, block_count) * block_words);
+}
+
+AID_TARGET("avx2")
+std::size_t insert_avx2(word_type *words, std::size_t block_count, const hash_type *hashes,
+						std::size_t count) noexcept
+{
+	for ( std::size_t i{0}; i < count; ++i ) {
+		if ( i + prefetch_distance < count ) {
+			_mm_prefetch(reinterpret_cast<const char *>(block256(words, block_count, hashes[i + prefetch_distance])),
+						 _MM_HINT_T0);
+		}
+		__m256i * const p = block256(words, block_count, hashes[i]);
+		_mm256_store_si256(p, _mm256_or_si256(_mm256_load_si256(p), mask256(hashes[i])));
+	}
+	return count;
+}
+
+AID_TARGET("avx2,popcnt")
+std::size_t contains_avx2(const word_type *words, std::size_t block_count, const hash_type *hashes,
+						  std::size_t count, word_type *result, std::size_t &found) noexcept
+{
+	std::size_t i{0};
+	for ( ; i + word_bits <= count; i += word_bits ) {
+		word_type word{0};
+		for ( unsigned int k{0}; k < word_bits; ++k ) {
+			if ( i + k + prefetch_distance < count ) {
+				_mm_prefetch(reinterpret_cast<const char *>(block256(words, block_count,
+																	 hashes[i + k + prefetch_distance])),
+							 _MM_HINT_T0);
+			}
+			const hash_type hash{hashes[i + k]};
+			// testc: all the bits of the mask are in the block
+			const int all{_mm256_testc_si256(_mm256_load_si256(block256(words, block_count, hash)), mask256(hash))};
+			word |= word_type(static_cast<unsigned int>(all)) << k;
+		}
+		result[i / word_bits] = word;
+		found += BitVector_impl::popcount(word);
+	}
+	return i;
+}
+
+// A block is a 256-bit vector, so AVX-512 runs the AVX2 kernels, and SSSE3 the scalar loops.
+const InsertKernel insert_kernels[Isa_impl::variant_count]{
+	insert_none, insert_none, insert_avx2, insert_avx2,
+};
+
+const ContainsKernel contains_kernels[Isa_impl::variant_count]{
+	contains_none, contains_none, contains_avx2, contains_avx2,
+};
+
+#else	// AID_ISA_X86
+
+const InsertKernel insert_kernels[Isa_impl::variant_count]{
+	insert_none, insert_none, insert_none, insert_none,
+};
+
+const ContainsKernel contains_kernels[Isa_impl::variant_count]{
+	contains_none, contains_none, contains_none, contains_none,
+};
+
+#endif	// AID_ISA_X86
+
+} // unnamed namespace
+
+void insert_n(word_type *words, std::size_t block_count, const hash_type *hashes, std::size_t count) noexcept
+{
+	std::size_t i{insert_kernels[Isa_impl::active_index()](words, block_count, hashes, count)};
+	for ( ; i < count; ++i ) {
+		insert(words, block_count, hashes[i]);
+	}
+}
+
+std::size_t contains_n(const word_type *words, std::size_t block_count, const hash_type *hashes,
+					   std::size_t count, word_type *result) noexcept
+{
+	std::size_t found{0};
+	std::size_t i{contains_kernels[Isa_impl::active_index()](words, block_count, hashes, count, result, found)};
+	for ( ; i < count; i += word_bits ) {
+		const std::size_t n{count - i < word_bits ? count - i : word_bits};
+		word_type word{0};
+		for ( std::size_t k{0}; k < n; ++k ) {
+			word |= word_type{contains(words, block_count, hashes[i + k])} << k;
+		}
+		result[i / word_bits] = word;
+		found += BitVector_impl::popcount(word);
+	}
+	return found;
+}
+
+} // namespace BloomFilter_impl
+
+} // namespace aid
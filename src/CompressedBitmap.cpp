@@ -0,0 +1,750 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file CompressedBitmap.cpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "aid/CompressedBitmap.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+
+namespace aid {
+namespace {
+
+using namespace CompressedBitmap_impl;
+using BitVector_impl::word_type;
+using BitVector_impl::word_bits;
+using Words		= std::vector<word_type>;
+using Values	= std::vector<std::uint16_t>;
+
+const unsigned char magic[4]{'a', 'i', 'd', 'R'};
+
+// an array much smaller than the other is intersected by binary searches
+constexpr std::size_t gallop_ratio{64};
+
+/*!
+  @brief		merge intersection without data dependent branches
+  @return		number of the values written to out
+ */
+std::size_t intersect_arrays(const Values &x, const Values &y, std::uint16_t *out) noexcept
+{
+	std::size_t i{0}, j{0}, count{0};
+	while ( i < x.size() && j < y.size() ) {
+		const std::uint16_t a{x[i]};
+		const std::uint16_t b{y[j]};
+		out[count] = a;
+		count += a == b;
+		i += a <= b;
+		j += b <= a;
+	}
+	return count;
+}
+
+bool key_less(const Container &container, std::uint16_t key) noexcept
+{
+	return container.key < key;
+}
+
+word_type bit(unsigned int low) noexcept
+{
+	return word_type{1} << (low % word_bits);
+}
+
+//! set the bits [first, last]
+void set_range(word_type *words, unsigned int first, unsigned int last) noexcept
+{
+	const std::size_t first_word{first / word_bits};
+	const std::size_t last_word{last / word_bits};
+	const word_type first_mask{~word_type{0} << (first % word_bits)};
+	const word_type last_mask{~word_type{0} >> (word_bits - 1 - last % word_bits)};
+	if ( first_word == last_word ) {
+		words[first_word] |= first_mask & last_mask;
+		return;
+	}
+	words[first_word] |= first_mask;
+	for ( std::size_t i{first_word + 1}; i < last_word; ++i ) {
+		words[i] = ~word_type{0};
+	}
+	words[last_word] |= last_mask;
+}
+
+//! the first bit at or after position which is set in words ^ flip
+std::size_t find_bit(const Words &words, std::size_t position, word_type flip) noexcept
+{
+	std::size_t i{position / word_bits};
+	if ( i >= bitmap_words ) return chunk_bits;
+	word_type word{(words[i] ^ flip) & (~word_type{0} << (position % word_bits))};
+	while ( word == 0 ) {
+		if ( ++i == bitmap_words ) return chunk_bits;
+		word = words[i] ^ flip;
+	}
+	return i * word_bits + BitVector_impl::count_trailing_zeros(word);
+}
+
+template<typename Read>
+bool array_contains(Read read, std::size_t size, std::uint16_t low)
+{
+	std::size_t first{0};
+	for ( std::size_t last{size}; first < last; ) {
+		const std::size_t middle{first + (last - first) / 2};
+		if ( read(middle) < low ) {
+			first = middle + 1;
+		}
+		else {
+			last = middle;
+		}
+	}
+	return first < size && read(first) == low;
+}
+
+template<typename Read>
+bool run_contains(Read read, std::size_t size, std::uint16_t low)
+{
+	// the first run which starts after low
+	std::size_t first{0};
+	for ( std::size_t last{size / 2}; first < last; ) {
+		const std::size_t middle{first + (last - first) / 2};
+		if ( read(middle * 2) <= low ) {
+			first = middle + 1;
+		}
+		else {
+			last = middle;
+		}
+	}
+	return first > 0 && low - read(first * 2 - 2) <= read(first * 2 - 1);
+}
+
+bool container_contains(const Container &container, std::uint16_t low) noexcept
+{
+	const Values &values = container.values;
+	const auto read = [&values](std::size_t i) { return values[i]; };
+	switch ( container.kind ) {
+	case Kind::array:	return array_contains(read, values.size(), low);
+	case Kind::bitmap:	return (container.words[low / word_bits] & bit(low)) != 0;
+	case Kind::run:		return run_contains(read, values.size(), low);
+	}
+	return false;
+}
+
+Words to_words(const Container &container)
+{
+	if ( container.kind == Kind::bitmap ) {
+		return container.words;
+	}
+
+	Words words(bitmap_words);
+	if ( container.kind == Kind::array ) {
+		for ( std::uint16_t low : container.values ) {
+			words[low / word_bits] |= bit(low);
+		}
+	}
+	else {
+		for ( std::size_t i{0}; i < container.values.size(); i += 2 ) {
+			set_range(words.data(), container.values[i], container.values[i] + container.values[i + 1]);
+		}
+	}
+	return words;
+}
+
+//! to_words() which steals the words of a bitmap container
+Words take_words(Container &container)
+{
+	return container.kind == Kind::bitmap ? std::move(container.words) : to_words(container);
+}
+
+void assign_words(Container &container, Words words, std::uint32_t cardinality)
+{
+	container.cardinality = cardinality;
+	if ( cardinality > array_limit ) {
+		container.kind = Kind::bitmap;
+		container.words = std::move(words);
+		Values().swap(container.values);
+		return;
+	}
+
+	container.kind = Kind::array;
+	container.values.clear();
+	container.values.reserve(cardinality);
+	for ( std::size_t i{0}; i < bitmap_words; ++i ) {
+		for ( word_type word{words[i]}; word != 0; word &= word - 1 ) {
+			container.values.push_back(static_cast<std::uint16_t>(i * word_bits
+																  + BitVector_impl::count_trailing_zeros(word)));
+		}
+	}
+	Words().swap(container.words);
+}
+
+void assign_values(Container &container, Values values)
+{
+	if ( values.size() > array_limit ) {
+		Words words(bitmap_words);
+		for ( std::uint16_t low : values ) {
+			words[low / word_bits] |= bit(low);
+		}
+		assign_words(container, std::move(words), static_cast<std::uint32_t>(values.size()));
+		return;
+	}
+
+	container.kind = Kind::array;
+	container.cardinality = static_cast<std::uint32_t>(values.size());
+	container.values = std::move(values);
+	Words().swap(container.words);
+}
+
+void assign_count(Container &container, Words words)
+{
+	const std::size_t cardinality{BitVector_impl::count_n(words.data(), bitmap_words)};
+	assign_words(container, std::move(words), static_cast<std::uint32_t>(cardinality));
+}
+
+//! turn a run container back into an array or a bitmap before it is modified
+void expand(Container &container)
+{
+	if ( container.kind == Kind::run ) {
+		assign_words(container, to_words(container), container.cardinality);
+	}
+}
+
+void unite(Container &x, const Container &y)
+{
+	// arrays which may overflow go straight to a bitmap
+	if ( x.kind == Kind::array && y.kind == Kind::array && x.values.size() + y.values.size() <= array_limit ) {
+		Values values;
+		values.reserve(x.values.size() + y.values.size());
+		std::set_union(x.values.begin(), x.values.end(), y.values.begin(), y.values.end(),
+					   std::back_inserter(values));
+		assign_values(x, std::move(values));
+		return;
+	}
+
+	Words words{take_words(x)};
+	if ( y.kind == Kind::array ) {
+		for ( std::uint16_t low : y.values ) {
+			words[low / word_bits] |= bit(low);
+		}
+	}
+	else if ( y.kind == Kind::bitmap ) {
+		BitVector_impl::apply_n(words.data(), y.words.data(), bitmap_words, BitOp::or_);
+	}
+	else {
+		for ( std::size_t i{0}; i < y.values.size(); i += 2 ) {
+			set_range(words.data(), y.values[i], y.values[i] + y.values[i + 1]);
+		}
+	}
+	assign_count(x, std::move(words));
+}
+
+void intersect(Container &x, const Container &y)
+{
+	if ( x.kind == Kind::array || y.kind == Kind::array ) {
+		const bool both{x.kind == Kind::array && y.kind == Kind::array};
+		Values values;
+		if ( both && x.values.size() < y.values.size() * gallop_ratio
+			 && y.values.size() < x.values.size() * gallop_ratio ) {
+			values.resize(std::min(x.values.size(), y.values.size()));
+			values.resize(intersect_arrays(x.values, y.values, values.data()));
+		}
+		else {
+			// probe the other container with each value of the smaller array
+			const bool x_probes{x.kind == Kind::array && (!both || x.values.size() <= y.values.size())};
+			const Container &probes = x_probes ? x : y;
+			const Container &other = x_probes ? y : x;
+			values.resize(probes.values.size());
+			std::size_t count{0};
+			if ( other.kind == Kind::bitmap ) {
+				for ( std::uint16_t low : probes.values ) {
+					values[count] = low;
+					count += (other.words[low / word_bits] >> (low % word_bits)) & 1;
+				}
+			}
+			else {
+				for ( std::uint16_t low : probes.values ) {
+					if ( container_contains(other, low) ) values[count++] = low;
+				}
+			}
+			values.resize(count);
+		}
+		assign_values(x, std::move(values));
+		return;
+	}
+
+	Words words{take_words(x)};
+	Words other;
+	const word_type * const y_words = y.kind == Kind::bitmap ? y.words.data() : (other = to_words(y)).data();
+	BitVector_impl::apply_n(words.data(), y_words, bitmap_words, BitOp::and_);
+	assign_count(x, std::move(words));
+}
+
+void subtract(Container &x, const Container &y)
+{
+	if ( x.kind == Kind::array ) {
+		Values values;
+		values.reserve(x.values.size());
+		for ( std::uint16_t low : x.values ) {
+			if ( !container_contains(y, low) ) values.push_back(low);
+		}
+		assign_values(x, std::move(values));
+		return;
+	}
+
+	Words words{take_words(x)};
+	if ( y.kind == Kind::array ) {
+		for ( std::uint16_t low : y.values ) {
+			words[low / word_bits] &= ~bit(low);
+		}
+	}
+	else {
+		Words other;
+		const word_type * const y_words = y.kind == Kind::bitmap ? y.words.data() : (other = to_words(y)).data();
+		BitVector_impl::apply_n(words.data(), y_words, bitmap_words, BitOp::and_not);
+	}
+	assign_count(x, std::move(words));
+}
+
+std::size_t payload_bytes(const Container &container) noexcept
+{
+	return container.kind == Kind::bitmap
+		? bitmap_words * sizeof(word_type)
+		: container.values.size() * sizeof(std::uint16_t);
+}
+
+std::size_t count_runs(const Container &container) noexcept
+{
+	std::size_t runs{0};
+	if ( container.kind == Kind::array ) {
+		for ( std::size_t i{0}; i < container.values.size(); ++i ) {
+			if ( i == 0 || container.values[i] != container.values[i - 1] + 1 ) ++runs;
+		}
+		return runs;
+	}
+
+	// a run starts at a set bit whose lower neighbour is clear
+	word_type carry{0};
+	for ( word_type word : container.words ) {
+		runs += BitVector_impl::popcount(word & ~((word << 1) | carry));
+		carry = word >> (word_bits - 1);
+	}
+	return runs;
+}
+
+Values make_runs(const Container &container)
+{
+	Values runs;
+	if ( container.kind == Kind::array ) {
+		const Values &values = container.values;
+		for ( std::size_t first{0}; first < values.size(); ) {
+			std::size_t last{first};
+			while ( last + 1 < values.size() && values[last + 1] == values[last] + 1 ) ++last;
+			runs.push_back(values[first]);
+			runs.push_back(static_cast<std::uint16_t>(last - first));
+			first = last + 1;
+		}
+		return runs;
+	}
+
+	for ( std::size_t first{find_bit(container.words, 0, 0)}; first < chunk_bits; ) {
+		const std::size_t end{find_bit(container.words, first, ~word_type{0})};
+		runs.push_back(static_cast<std::uint16_t>(first));
+		runs.push_back(static_cast<std::uint16_t>(end - 1 - first));
+		first = find_bit(container.words, end, 0);
+	}
+	return runs;
+}
+
+} // unnamed namespace
+
+
+CompressedBitmap::CompressedBitmap(const CompressedBitmapView &view)
+	: m_containers{}
+{
+	m_containers.reserve(view.container_count());
+	for ( std::size_t i{0}; i < view.container_count(); ++i ) {
+		const CompressedBitmapView::Entry entry{view.read_entry(i)};
+		view.validate_payload(entry);
+		m_containers.push_back(Container{entry.key, entry.kind, entry.cardinality, {}, {}});
+		Container &container = m_containers.back();
+		if ( entry.kind == Kind::bitmap ) {
+			container.words.resize(bitmap_words);
+			Converter::from_external_n(view.m_data + entry.offset, bitmap_words, container.words.data());
+		}
+		else {
+			container.values.resize(entry.size);
+			Converter::from_external_n(view.m_data + entry.offset, entry.size, container.values.data());
+		}
+	}
+}
+
+CompressedBitmap::size_type CompressedBitmap::cardinality() const noexcept
+{
+	size_type cardinality{0};
+	for ( const Container &container : m_containers ) {
+		cardinality += container.cardinality;
+	}
+	return cardinality;
+}
+
+std::size_t CompressedBitmap::memory_bytes() const noexcept
+{
+	std::size_t bytes{m_containers.capacity() * sizeof(Container)};
+	for ( const Container &container : m_containers ) {
+		bytes += container.values.capacity() * sizeof(std::uint16_t) + container.words.capacity() * sizeof(word_type);
+	}
+	return bytes;
+}
+
+CompressedBitmap &CompressedBitmap::add(value_type value)
+{
+	const std::uint16_t key{static_cast<std::uint16_t>(value >> 16)};
+	const std::uint16_t low{static_cast<std::uint16_t>(value)};
+	auto found = std::lower_bound(m_containers.begin(), m_containers.end(), key, key_less);
+	if ( found == m_containers.end() || found->key != key ) {
+		found = m_containers.insert(found, Container{key, Kind::array, 0, {}, {}});
+	}
+
+	Container &container = *found;
+	expand(container);
+	if ( container.kind == Kind::array ) {
+		const auto position = std::lower_bound(container.values.begin(), container.values.end(), low);
+		if ( position != container.values.end() && *position == low ) {
+			return *this;
+		}
+		if ( container.values.size() < array_limit ) {
+			container.values.insert(position, low);
+			++container.cardinality;
+			return *this;
+		}
+		Words words{to_words(container)};
+		words[low / word_bits] |= bit(low);
+		assign_words(container, std::move(words), container.cardinality + 1);
+		return *this;
+	}
+
+	word_type &word = container.words[low / word_bits];
+	if ( (word & bit(low)) == 0 ) {
+		word |= bit(low);
+		++container.cardinality;
+	}
+	return *this;
+}
+
+CompressedBitmap &CompressedBitmap::remove(value_type value)
+{
+	const std::uint16_t key{static_cast<std::uint16_t>(value >> 16)};
+	const std::uint16_t low{static_cast<std::uint16_t>(value)};
+	const auto found = std::lower_bound(m_containers.begin(), m_containers.end(), key, key_less);
+	if ( found == m_containers.end() || found->key != key || !container_contains(*found, low) ) {
+		return *this;
+	}
+
+	Container &container = *found;
+	expand(container);
+	if ( container.kind == Kind::array ) {
+		container.values.erase(std::lower_bound(container.values.begin(), container.values.end(), low));
+		--container.cardinality;
+	}
+	else {
+		container.words[low / word_bits] &= ~bit(low);
+		if ( --container.cardinality <= array_limit ) {
+			assign_words(container, std::move(container.words), container.cardinality);
+		}
+	}
+	if ( container.cardinality == 0 ) {
+		m_containers.erase(found);
+	}
+	return *this;
+}
+
+bool CompressedBitmap::contains(value_type value) const noexcept
+{
+	const std::uint16_t key{static_cast<std::uint16_t>(value >> 16)};
+	const auto found = std::lower_bound(m_containers.begin(), m_containers.end(), key, key_less);
+	return found != m_containers.end() && found->key == key
+		&& container_contains(*found, static_cast<std::uint16_t>(value));
+}
+
+bool CompressedBitmap::run_optimize()
+{
+	bool has_runs{false};
+	for ( Container &container : m_containers ) {
+		if ( container.kind != Kind::run ) {
+			const std::size_t runs{count_runs(container)};
+			if ( runs * 2 * sizeof(std::uint16_t) >= payload_bytes(container) ) {
+				continue;
+			}
+			container.values = make_runs(container);
+			container.kind = Kind::run;
+			Words().swap(container.words);
+		}
+		has_runs = true;
+	}
+	return has_runs;
+}
+
+CompressedBitmap &CompressedBitmap::operator|=(const CompressedBitmap &rhs)
+{
+	if ( this == &rhs ) return *this;
+
+	std::vector<Container> result;
+	result.reserve(m_containers.size() + rhs.m_containers.size());
+	auto x = m_containers.begin();
+	auto y = rhs.m_containers.begin();
+	while ( x != m_containers.end() || y != rhs.m_containers.end() ) {
+		if ( y == rhs.m_containers.end() || (x != m_containers.end() && x->key < y->key) ) {
+			result.push_back(std::move(*x++));
+		}
+		else if ( x == m_containers.end() || y->key < x->key ) {
+			result.push_back(*y++);
+		}
+		else {
+			result.push_back(std::move(*x++));
+			unite(result.back(), *y++);
+		}
+	}
+	m_containers.swap(result);
+	return *this;
+}
+
+CompressedBitmap &CompressedBitmap::operator&=(const CompressedBitmap &rhs)
+{
+	if ( this == &rhs ) return *this;
+
+	std::vector<Container> result;
+	auto y = rhs.m_containers.begin();
+	for ( Container &x : m_containers ) {
+		y = std::lower_bound(y, rhs.m_containers.end(), x.key, key_less);
+		if ( y == rhs.m_containers.end() ) break;
+		if ( y->key != x.key ) continue;
+		intersect(x, *y);
+		if ( x.cardinality != 0 ) result.push_back(std::move(x));
+	}
+	m_containers.swap(result);
+	return *this;
+}
+
+CompressedBitmap &CompressedBitmap::operator-=(const CompressedBitmap &rhs)
+{
+	if ( this == &rhs ) {
+		clear();
+		return *this;
+	}
+
+	std::vector<Container> result;
+	result.reserve(m_containers.size());
+	auto y = rhs.m_containers.begin();
+	for ( Container &x : m_containers ) {
+		y = std::lower_bound(y, rhs.m_containers.end(), x.key, key_less);
+		if ( y != rhs.m_containers.end() && y->key == x.key ) {
+			subtract(x, *y);
+		}
+		if ( x.cardinality != 0 ) result.push_back(std::move(x));
+	}
+	m_containers.swap(result);
+	return *this;
+}
+
+std::size_t CompressedBitmap::serialized_size() const noexcept
+{
+	std::size_t size{header_bytes + m_containers.size() * entry_bytes};
+	for ( const Container &container : m_containers ) {
+		size += payload_bytes(container);
+	}
+	return size;
+}
+
+void CompressedBitmap::serialize(unsigned char *external) const
+{
+	if ( external == nullptr ) throw std::invalid_argument("external == nullptr");
+
+	std::memcpy(external, magic, sizeof(magic));
+	Converter::to_external<4>(static_cast<std::uint32_t>(m_containers.size()), external + sizeof(magic));
+
+	// the largest form is 65536 bitmaps, so the offsets fit in 32 bits
+	std::size_t offset{header_bytes + m_containers.size() * entry_bytes};
+	for ( std::size_t i{0}; i < m_containers.size(); ++i ) {
+		const Container &container = m_containers[i];
+		const bool bitmap{container.kind == Kind::bitmap};
+		const std::size_t size{bitmap ? bitmap_words : container.values.size()};
+
+		unsigned char * const entry = external + header_bytes + i * entry_bytes;
+		Converter::to_external<2>(container.key, entry);
+		entry[2] = static_cast<unsigned char>(container.kind);
+		entry[3] = 0;
+		Converter::to_external<4>(container.cardinality, entry + 4);
+		Converter::to_external<4>(static_cast<std::uint32_t>(offset), entry + 8);
+		Converter::to_external<4>(static_cast<std::uint32_t>(size), entry + 12);
+
+		if ( bitmap ) {
+			Converter::to_external_n(container.words.data(), size, external + offset);
+		}
+		else {
+			Converter::to_external_n(container.values.data(), size, external + offset);
+		}
+		offset += payload_bytes(container);
+	}
+}
+
+bool CompressedBitmap::operator==(const CompressedBitmap &rhs) const
+{
+	if ( m_containers.size() != rhs.m_containers.size() ) {
+		return false;
+	}
+	for ( std::size_t i{0}; i < m_containers.size(); ++i ) {
+		const Container &x = m_containers[i];
+		const Container &y = rhs.m_containers[i];
+		if ( x.key != y.key || x.cardinality != y.cardinality ) {
+			return false;
+		}
+		if ( x.kind == y.kind ? x.values != y.values || x.words != y.words : to_words(x) != to_words(y) ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+CompressedBitmapView::CompressedBitmapView(const void *external, std::size_t size)
+	: m_data{static_cast<const unsigned char *>(external)}, m_container_count{0}, m_cardinality{0}
+{
+	if ( m_data == nullptr || size < header_bytes || std::memcmp(m_data, magic, sizeof(magic)) != 0 ) {
+		throw std::invalid_argument("not a CompressedBitmap");
+	}
+	std::uint32_t count;
+	Converter::from_external<4>(m_data + sizeof(magic), count);
+	if ( count > chunk_bits || size < header_bytes + count * entry_bytes ) {
+		throw std::invalid_argument("truncated CompressedBitmap entries");
+	}
+
+	for ( std::size_t i{0}; i < count; ++i ) {
+		const Entry entry{read_entry(i)};
+		if ( i > 0 && entry.key <= read_entry(i - 1).key ) {
+			throw std::invalid_argument("unsorted CompressedBitmap keys");
+		}
+		if ( entry.cardinality == 0 || entry.cardinality > chunk_bits ) {
+			throw std::invalid_argument("bad CompressedBitmap cardinality");
+		}
+
+		std::size_t bytes;
+		switch ( entry.kind ) {
+		case Kind::array:
+			if ( entry.size != entry.cardinality ) throw std::invalid_argument("bad CompressedBitmap array");
+			bytes = entry.size * sizeof(std::uint16_t);
+			break;
+		case Kind::bitmap:
+			if ( entry.size != bitmap_words ) throw std::invalid_argument("bad CompressedBitmap bitmap");
+			bytes = entry.size * sizeof(word_type);
+			break;
+		case Kind::run:
+			if ( entry.size == 0 || entry.size % 2 != 0 ) throw std::invalid_argument("bad CompressedBitmap runs");
+			bytes = entry.size * sizeof(std::uint16_t);
+			break;
+		default:
+			throw std::invalid_argument("unknown CompressedBitmap container");
+		}
+		if ( entry.offset > size || bytes > size - entry.offset ) {
+			throw std::invalid_argument("truncated CompressedBitmap payload");
+		}
+		m_cardinality += entry.cardinality;
+	}
+	m_container_count = count;
+}
+
+void CompressedBitmapView::validate_payload(const Entry &entry) const
+{
+	// (not in the constructor of the view, whose queries are safe without it, so that a view reads only the entries)
+	const unsigned char * const payload = m_data + entry.offset;
+	switch ( entry.kind ) {
+	case Kind::array:
+		for ( std::size_t i{1}; i < entry.size; ++i ) {
+			if ( read16(payload, i - 1) >= read16(payload, i) ) {
+				throw std::invalid_argument("unsorted CompressedBitmap array");
+			}
+		}
+		break;
+	case Kind::bitmap: {
+		std::size_t cardinality{0};
+		for ( std::size_t i{0}; i < bitmap_words; ++i ) {
+			cardinality += BitVector_impl::popcount(read64(payload, i));
+		}
+		if ( cardinality != entry.cardinality ) throw std::invalid_argument("bad CompressedBitmap bitmap");
+		break;
+	}
+	case Kind::run: {
+		// (start, length - 1) pairs, ascending and neither overlapping nor adjacent
+		std::size_t cardinality{0};
+		std::size_t next{0};	// the least start of the next run
+		for ( std::size_t i{0}; i < entry.size; i += 2 ) {
+			const std::size_t start{read16(payload, i)};
+			const std::size_t last{start + read16(payload, i + 1)};
+			if ( start < next || last >= chunk_bits ) throw std::invalid_argument("bad CompressedBitmap runs");
+			cardinality += last - start + 1;
+			next = last + 2;
+		}
+		if ( cardinality != entry.cardinality ) throw std::invalid_argument("bad CompressedBitmap runs");
+		break;
+	}
+	}
+}
+
+bool CompressedBitmapView::contains(value_type value) const noexcept
+{
+	const std::uint16_t key{static_cast<std::uint16_t>(value >> 16)};
+	const std::uint16_t low{static_cast<std::uint16_t>(value)};
+
+	std::size_t first{0};
+	for ( std::size_t last{m_container_count}; first < last; ) {
+		const std::size_t middle{first + (last - first) / 2};
+		if ( read16(m_data + header_bytes + middle * entry_bytes, 0) < key ) {
+			first = middle + 1;
+		}
+		else {
+			last = middle;
+		}
+	}
+	if ( first == m_container_count ) {
+		return false;
+	}
+	const Entry entry{read_entry(first)};
+	if ( entry.key != key ) {
+		return false;
+	}
+
+	const unsigned char * const payload = m_data + entry.offset;
+	const auto read = [payload](std::size_t i) { return read16(payload, i); };
+	switch ( entry.kind ) {
+	case Kind::array:	return array_contains(read, entry.size, low);
+	case Kind::bitmap:	return (read64(payload, low / word_bits) & bit(low)) != 0;
+	case Kind::run:		return run_contains(read, entry.size, low);
+	}
+	return false;
+}
+
+CompressedBitmapView::Entry CompressedBitmapView::read_entry(std::size_t index) const noexcept
+{
+	const unsigned char * const entry = m_data + header_bytes + index * entry_bytes;
+	Entry result;
+	Converter::from_external<2>(entry, result.key);
+	result.kind = static_cast<Kind>(entry[2]);
+	Converter::from_external<4>(entry + 4, result.cardinality);
+	Converter::from_external<4>(entry + 8, result.offset);
+	Converter::from_external<4>(entry + 12, result.size);
+	return result;
+}
+
+} // namespace aid
@@ -0,0 +1,496 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file DynamicBitVector.cpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "aid/DynamicBitVector.hpp"
+#include "Isa_impl.hpp"
+
+
+namespace aid {
+
+namespace BitVector_impl {
+
+namespace {
+
+constexpr unsigned int op_count{static_cast<unsigned int>(BitOp::and_not) + 1};
+
+/*!
+  @brief		vector parts of the bulk operations
+  @return		number of the processed words
+ */
+using ApplyKernel = std::size_t (*)(word_type *dst, const word_type *src, std::size_t count);
+using FusedKernel = std::size_t (*)(word_type *dst, const word_type *a, const word_type *b, std::size_t count);
+using FlipKernel = std::size_t (*)(word_type *dst, std::size_t count);
+using CountKernel = std::size_t (*)(const word_type *src, std::size_t count, std::size_t &bits);
+using CountOpKernel = std::size_t (*)(const word_type *a, const word_type *b, std::size_t count,
+									  std::size_t &bits);
+
+std::size_t apply_none(word_type *, const word_type *, std::size_t) noexcept
+{
+	return 0;
+}
+
+std::size_t fused_none(word_type *, const word_type *, const word_type *, std::size_t) noexcept
+{
+	return 0;
+}
+
+std::size_t flip_none(word_type *, std::size_t) noexcept
+{
+	return 0;
+}
+
+std::size_t count_none(const word_type *, std::size_t, std::size_t &) noexcept
+{
+	return 0;
+}
+
+std::size_t count_op_none(const word_type *, const word_type *, std::size_t, std::size_t &) noexcept
+{
+	return 0;
+}
+
+// a row of kernels for each BitOp, and a table of rows for each outer BitOp
+#define aid_BitVector_OP_ROW(d_kernel) \
+	{ d_kernel<BitOp::and_>, d_kernel<BitOp::or_>, d_kernel<BitOp::xor_>, d_kernel<BitOp::and_not> }
+#define aid_BitVector_FUSED_ROW(d_kernel, d_outer) \
+	{ d_kernel<d_outer, BitOp::and_>, d_kernel<d_outer, BitOp::or_>, \
+	  d_kernel<d_outer, BitOp::xor_>, d_kernel<d_outer, BitOp::and_not> }
+#define aid_BitVector_FUSED_TABLE(d_kernel) \
+	{ aid_BitVector_FUSED_ROW(d_kernel, BitOp::and_), aid_BitVector_FUSED_ROW(d_kernel, BitOp::or_), \
+	  aid_BitVector_FUSED_ROW(d_kernel, BitOp::xor_), aid_BitVector_FUSED_ROW(d_kernel, BitOp::and_not) }
+#define aid_BitVector_NONE_ROW(d_kernel) \
+	{ d_kernel, d_kernel, d_kernel, d_kernel }
+
+#if		defined(AID_ISA_X86)
+
+/*!
+  @brief		nibble lookup table of pshufb popcount
+ */
+#define aid_BitVector_NIBBLE_COUNTS \
+	0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+
+AID_TARGET("ssse3")
+inline __m128i popcount128(__m128i v) noexcept
+{
+	const __m128i lookup = _mm_setr_epi8(aid_BitVector_NIBBLE_COUNTS);
+	const __m128i low_mask = _mm_set1_epi8(0x0F);
+	const __m128i lo = _mm_shuffle_epi8(lookup, _mm_and_si128(v, low_mask));
+	const __m128i hi = _mm_shuffle_epi8(lookup, _mm_and_si128(_mm_srli_epi16(v, 4), low_mask));
+	return _mm_sad_epu8(_mm_add_epi8(lo, hi), _mm_setzero_si128());
+}
+
+AID_TARGET("ssse3")
+inline std::size_t sum128(__m128i v) noexcept
+{
+	std::uint64_t halves[2];
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(halves), v);
+	return static_cast<std::size_t>(halves[0] + halves[1]);
+}
+
+template<BitOp t_op>
+AID_TARGET("ssse3")
+inline __m128i apply128(__m128i x, __m128i y) noexcept
+{
+	switch ( t_op ) {
+	case BitOp::and_:		return _mm_and_si128(x, y);
+	case BitOp::or_:		return _mm_or_si128(x, y);
+	case BitOp::xor_:		return _mm_xor_si128(x, y);
+	case BitOp::and_not:	return _mm_andnot_si128(y, x);
+	}
+	return x;
+}
+
+AID_TARGET("ssse3")
+std::size_t count_ssse3(const word_type *src, std::size_t count, std::size_t &bits) noexcept
+{
+	__m128i sum = _mm_setzero_si128();
+	std::size_t i{0};
+	for ( ; i + 2 <= count; i += 2 ) {
+		sum = _mm_add_epi64(sum, popcount128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))));
+	}
+	bits += sum128(sum);
+	return i;
+}
+
+template<BitOp t_op>
+AID_TARGET("ssse3")
+std::size_t count_op_ssse3(const word_type *a, const word_type *b, std::size_t count, std::size_t &bits) noexcept
+{
+	__m128i sum = _mm_setzero_si128();
+	std::size_t i{0};
+	for ( ; i + 2 <= count; i += 2 ) {
+		const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+		const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+		sum = _mm_add_epi64(sum, popcount128(apply128<t_op>(x, y)));
+	}
+	bits += sum128(sum);
+	return i;
+}
+
+AID_TARGET("avx2")
+inline __m256i popcount256(__m256i v) noexcept
+{
+	const __m256i lookup = _mm256_setr_epi8(aid_BitVector_NIBBLE_COUNTS, aid_BitVector_NIBBLE_COUNTS);
+	const __m256i low_mask = _mm256_set1_epi8(0x0F);
+	const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+	const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+	return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+AID_TARGET("avx2")
+inline std::size_t sum256(__m256i v) noexcept
+{
+	return sum128(_mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+
+template<BitOp t_op>
+AID_TARGET("avx2")
+inline __m256i apply256(__m256i x, __m256i y) noexcept
+{
+	switch ( t_op ) {
+	case BitOp::and_:		return _mm256_and_si256(x, y);
+	case BitOp::or_:		return _mm256_or_si256(x, y);
+	case BitOp::xor_:		return _mm256_xor_si256(x, y);
+	case BitOp::and_not:	return _mm256_andnot_si256(y, x);
+	}
+	return x;
+}
+
+AID_TARGET("avx2")
+inline __m256i load256(const word_type *src) noexcept
+{
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+}
+
+AID_TARGET("avx2")
+inline void store256(word_type *dst, __m256i v) noexcept
+{
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), v);
+}
+
+template<BitOp t_op>
+AID_TARGET("avx2")
+std::size_t apply_avx2(word_type *dst, const word_type *src, std::size_t count) noexcept
+{
+	std::size_t i{0};
+	for ( ; i + 8 <= count; i += 8 ) {
+		store256(dst + i, apply256<t_op>(load256(dst + i), load256(src + i)));
+		store256(dst + i + 4, apply256<t_op>(load256(dst + i + 4), load256(src + i + 4)));
+	}
+	return i;
+}
+
+template<BitOp t_outer, BitOp t_inner>
+AID_TARGET("avx2")
+std::size_t fused_avx2(word_type *dst, const word_type *a, const word_type *b, std::size_t count) noexcept
+{
+	std::size_t i{0};
+	for ( ; i + 8 <= count; i += 8 ) {
+		store256(dst + i, apply256<t_outer>(load256(dst + i), apply256<t_inner>(load256(a + i), load256(b + i))));
+		store256(dst + i + 4, apply256<t_outer>(load256(dst + i + 4),
+												apply256<t_inner>(load256(a + i + 4), load256(b + i + 4))));
+	}
+	return i;
+}
+
+AID_TARGET("avx2")
+std::size_t flip_avx2(word_type *dst, std::size_t count) noexcept
+{
+	const __m256i ones = _mm256_set1_epi8(-1);
+	std::size_t i{0};
+	for ( ; i + 4 <= count; i += 4 ) {
+		store256(dst + i, _mm256_xor_si256(load256(dst + i), ones));
+	}
+	return i;
+}
+
+AID_TARGET("avx2")
+std::size_t count_avx2(const word_type *src, std::size_t count, std::size_t &bits) noexcept
+{
+	__m256i sum = _mm256_setzero_si256();
+	std::size_t i{0};
+	for ( ; i + 8 <= count; i += 8 ) {
+		sum = _mm256_add_epi64(sum, popcount256(load256(src + i)));
+		sum = _mm256_add_epi64(sum, popcount256(load256(src + i + 4)));
+	}
+	bits += sum256(sum);
+	return i;
+}
+
+template<BitOp t_op>
+AID_TARGET("avx2")
+std::size_t count_op_avx2(const word_type *a, const word_type *b, std::size_t count, std::size_t &bits) noexcept
+{
+	__m256i sum = _mm256_setzero_si256();
+	std::size_t i{0};
+	for ( ; i + 8 <= count; i += 8 ) {
+		sum = _mm256_add_epi64(sum, popcount256(apply256<t_op>(load256(a + i), load256(b + i))));
+		sum = _mm256_add_epi64(sum, popcount256(apply256<t_op>(load256(a + i + 4), load256(b + i + 4))));
+	}
+	bits += sum256(sum);
+	return i;
+}
+
+AID_TARGET("avx512f,avx512bw")
+inline __m512i popcount512(__m512i v) noexcept
+{
+	const __m512i lookup = _mm512_set_epi64(0x0403030203020201, 0x0302020102010100,
+											0x0403030203020201, 0x0302020102010100,
+											0x0403030203020201, 0x0302020102010100,
+											0x0403030203020201, 0x0302020102010100);
+	const __m512i low_mask = _mm512_set1_epi8(0x0F);
+	const __m512i lo = _mm512_shuffle_epi8(lookup, _mm512_and_si512(v, low_mask));
+	const __m512i hi = _mm512_shuffle_epi8(lookup, _mm512_and_si512(_mm512_srli_epi16(v, 4), low_mask));
+	return _mm512_sad_epu8(_mm512_add_epi8(lo, hi), _mm512_setzero_si512());
+}
+
+AID_TARGET("avx512f,avx512bw")
+inline std::size_t sum512(__m512i v) noexcept
+{
+	std::uint64_t lanes[8];
+	_mm512_storeu_si512(lanes, v);
+	return static_cast<std::size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]
+									+ lanes[4] + lanes[5] + lanes[6] + lanes[7]);
+}
+
+// (the _mm512_undefined-based intrinsics are avoided; GCC warns on them falsely)
+template<BitOp t_op>
+AID_TARGET("avx512f,avx512bw")
+inline __m512i apply512(__m512i x, __m512i y) noexcept
+{
+	switch ( t_op ) {
+	case BitOp::and_:		return _mm512_and_si512(x, y);
+	case BitOp::or_:		return _mm512_or_si512(x, y);
+	case BitOp::xor_:		return _mm512_xor_si512(x, y);
+	case BitOp::and_not:	return _mm512_ternarylogic_epi64(x, y, y, 0x30);
+	}
+	return x;
+}
+
+/*!
+  @brief		vpternlog immediate of x outer (y inner z)
+ */
+template<BitOp t_outer, BitOp t_inner>
+struct TernaryLogic
+{
+	static constexpr unsigned int truth(BitOp op, unsigned int x, unsigned int y) noexcept {
+		return op == BitOp::and_ ? x & y
+			: op == BitOp::or_ ? x | y
+			: op == BitOp::xor_ ? x ^ y
+			: x & ~y & 1;
+	}
+
+	static constexpr unsigned int bit(unsigned int i) noexcept {
+		return truth(t_outer, (i >> 2) & 1, truth(t_inner, (i >> 1) & 1, i & 1)) << i;
+	}
+
+	static constexpr int value = static_cast<int>(bit(0) | bit(1) | bit(2) | bit(3)
+												  | bit(4) | bit(5) | bit(6) | bit(7));
+};
+
+template<BitOp t_op>
+AID_TARGET("avx512f,avx512bw")
+std::size_t apply_avx512(word_type *dst, const word_type *src, std::size_t count) noexcept
+{
+	std::size_t i{0};
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm512_storeu_si512(dst + i, apply512<t_op>(_mm512_loadu_si512(dst + i), _mm512_loadu_si512(src + i)));
+	}
+	return i;
+}
+
+template<BitOp t_outer, BitOp t_inner>
+AID_TARGET("avx512f,avx512bw")
+std::size_t fused_avx512(word_type *dst, const word_type *a, const word_type *b, std::size_t count) noexcept
+{
+	constexpr int logic{TernaryLogic<t_outer, t_inner>::value};
+	std::size_t i{0};
+	for ( ; i + 8 <= count; i += 8 ) {
+		const __m512i x = _mm512_ternarylogic_epi64(_mm512_loadu_si512(dst + i), _mm512_loadu_si512(a + i),
+													_mm512_loadu_si512(b + i), logic);
+		_mm512_storeu_si512(dst + i, x);
+	}
+	return i;
+}
+
+AID_TARGET("avx512f,avx512bw")
+std::size_t flip_avx512(word_type *dst, std::size_t count) noexcept
+{
+	std::size_t i{0};
+	for ( ; i + 8 <= count; i += 8 ) {
+		const __m512i x = _mm512_loadu_si512(dst + i);
+		_mm512_storeu_si512(dst + i, _mm512_ternarylogic_epi64(x, x, x, 0x55));
+	}
+	return i;
+}
+
+AID_TARGET("avx512f,avx512bw")
+std::size_t count_avx512(const word_type *src, std::size_t count, std::size_t &bits) noexcept
+{
+	__m512i sum = _mm512_setzero_si512();
+	std::size_t i{0};
+	for ( ; i + 8 <= count; i += 8 ) {
+		sum = _mm512_add_epi64(sum, popcount512(_mm512_loadu_si512(src + i)));
+	}
+	bits += sum512(sum);
+	return i;
+}
+
+template<BitOp t_op>
+AID_TARGET("avx512f,avx512bw")
+std::size_t count_op_avx512(const word_type *a, const word_type *b, std::size_t count, std::size_t &bits) noexcept
+{
+	__m512i sum = _mm512_setzero_si512();
+	std::size_t i{0};
+	for ( ; i + 8 <= count; i += 8 ) {
+		const __m512i x = apply512<t_op>(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+		sum = _mm512_add_epi64(sum, popcount512(x));
+	}
+	bits += sum512(sum);
+	return i;
+}
+
+#undef aid_BitVector_NIBBLE_COUNTS
+
+// The scalar loops are vectorized with SSE2 by the compiler, so only popcount has an SSSE3 kernel.
+const ApplyKernel apply_kernels[Isa_impl::variant_count][op_count]{
+	aid_BitVector_NONE_ROW(apply_none),
+	aid_BitVector_NONE_ROW(apply_none),
+	aid_BitVector_OP_ROW(apply_avx2),
+	aid_BitVector_OP_ROW(apply_avx512),
+};
+
+const FusedKernel fused_kernels[Isa_impl::variant_count][op_count][op_count]{
+	{ aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none),
+	  aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none) },
+	{ aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none),
+	  aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none) },
+	aid_BitVector_FUSED_TABLE(fused_avx2),
+	aid_BitVector_FUSED_TABLE(fused_avx512),
+};
+
+const FlipKernel flip_kernels[Isa_impl::variant_count]{
+	flip_none, flip_none, flip_avx2, flip_avx512,
+};
+
+const CountKernel count_kernels[Isa_impl::variant_count]{
+	count_none, count_ssse3, count_avx2, count_avx512,
+};
+
+const CountOpKernel count_op_kernels[Isa_impl::variant_count][op_count]{
+	aid_BitVector_NONE_ROW(count_op_none),
+	aid_BitVector_OP_ROW(count_op_ssse3),
+	aid_BitVector_OP_ROW(count_op_avx2),
+	aid_BitVector_OP_ROW(count_op_avx512),
+};
+
+#else	// AID_ISA_X86
+
+const ApplyKernel apply_kernels[Isa_impl::variant_count][op_count]{
+	aid_BitVector_NONE_ROW(apply_none), aid_BitVector_NONE_ROW(apply_none),
+	aid_BitVector_NONE_ROW(apply_none), aid_BitVector_NONE_ROW(apply_none),
+};
+
+const FusedKernel fused_kernels[Isa_impl::variant_count][op_count][op_count]{
+	{ aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none),
+	  aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none) },
+	{ aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none),
+	  aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none) },
+	{ aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none),
+	  aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none) },
+	{ aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none),
+	  aid_BitVector_NONE_ROW(fused_none), aid_BitVector_NONE_ROW(fused_none) },
+};
+
+const FlipKernel flip_kernels[Isa_impl::variant_count]{
+	flip_none, flip_none, flip_none, flip_none,
+};
+
+const CountKernel count_kernels[Isa_impl::variant_count]{
+	count_none, count_none, count_none, count_none,
+};
+
+const CountOpKernel count_op_kernels[Isa_impl::variant_count][op_count]{
+	aid_BitVector_NONE_ROW(count_op_none), aid_BitVector_NONE_ROW(count_op_none),
+	aid_BitVector_NONE_ROW(count_op_none), aid_BitVector_NONE_ROW(count_op_none),
+};
+
+#endif	// AID_ISA_X86
+
+#undef aid_BitVector_OP_ROW
+#undef aid_BitVector_FUSED_ROW
+#undef aid_BitVector_FUSED_TABLE
+#undef aid_BitVector_NONE_ROW
+
+inline unsigned int index(BitOp op) noexcept
+{
+	return static_cast<unsigned int>(op);
+}
+
+} // unnamed namespace
+
+void apply_n(word_type *dst, const word_type *src, std::size_t count, BitOp op) noexcept
+{
+	const std::size_t done = apply_kernels[Isa_impl::active_index()][index(op)](dst, src, count);
+	for ( std::size_t i{done}; i < count; ++i ) {
+		dst[i] = apply(op, dst[i], src[i]);
+	}
+}
+
+void apply_n(word_type *dst, const word_type *a, const word_type *b, std::size_t count,
+			 BitOp outer, BitOp inner) noexcept
+{
+	const std::size_t done = fused_kernels[Isa_impl::active_index()][index(outer)][index(inner)](dst, a, b, count);
+	for ( std::size_t i{done}; i < count; ++i ) {
+		dst[i] = apply(outer, dst[i], apply(inner, a[i], b[i]));
+	}
+}
+
+void flip_n(word_type *dst, std::size_t count) noexcept
+{
+	const std::size_t done = flip_kernels[Isa_impl::active_index()](dst, count);
+	for ( std::size_t i{done}; i < count; ++i ) {
+		dst[i] = ~dst[i];
+	}
+}
+
+std::size_t count_n(const word_type *src, std::size_t count) noexcept
+{
+	std::size_t bits{0};
+	const std::size_t done = count_kernels[Isa_impl::active_index()](src, count, bits);
+	for ( std::size_t i{done}; i < count; ++i ) {
+		bits += popcount(src[i]);
+	}
+	return bits;
+}
+
+std::size_t count_n(const word_type *a, const word_type *b, std::size_t count, BitOp op) noexcept
+{
+	std::size_t bits{0};
+	const std::size_t done = count_op_kernels[Isa_impl::active_index()][index(op)](a, b, count, bits);
+	for ( std::size_t i{done}; i < count; ++i ) {
+		bits += popcount(apply(op, a[i], b[i]));
+	}
+	return bits;
+}
+
+} // namespace BitVector_impl
+
+constexpr DynamicBitVector::size_type DynamicBitVector::npos;
+
+} // namespace aid
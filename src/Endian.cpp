@@ -17,9 +17,390 @@
    limitations under the License.
 */
 #include "aid/Endian.hpp"
+#include "Isa_impl.hpp"
+
+#if		!defined(AID_ISA_X86) && (defined(__SSSE3__) || defined(__AVX2__))
+#include <immintrin.h>
+#endif
+
 
 namespace aid {
 
+namespace Endian_impl {
+
+namespace {
+
+/*!
+  @brief		vector part of byte_swap_n()
+  @return		number of the processed elements
+ */
+using ByteSwapKernel = std::size_t (*)(const unsigned char *src, unsigned char *dst,
+									   std::size_t count, std::size_t width);
+
+template<typename UInteger>
+void byte_swap_scalar(const unsigned char *src, unsigned char *dst, std::size_t count) noexcept
+{
+	for ( std::size_t i{0}; i < count; ++i ) {
+		UInteger value;
+		std::memcpy(&value, src + i * sizeof(value), sizeof(value));
+		value = byte_swap(value);
+		std::memcpy(dst + i * sizeof(value), &value, sizeof(value));
+	}
+}
+
+void byte_swap_scalar16(const unsigned char *src, unsigned char *dst, std::size_t count) noexcept
+{
+	for ( std::size_t i{0}; i < count; ++i ) {
+		std::uint64_t halves[2];
+		std::memcpy(halves, src + i * 16, sizeof(halves));
+		const std::uint64_t swapped[2]{byte_swap(halves[1]), byte_swap(halves[0])};
+		std::memcpy(dst + i * 16, swapped, sizeof(swapped));
+	}
+}
+
+/*!
+  @brief		pshufb control which reverses each width-byte lane
+ */
+template<std::size_t t_size>
+struct ReverseControl
+{
+	alignas(64) unsigned char bytes[t_size];
+
+	explicit ReverseControl(std::size_t width) noexcept {
+		for ( std::size_t i{0}; i < t_size; ++i ) {
+			bytes[i] = static_cast<unsigned char>(i - i % width + (width - 1 - i % width));
+		}
+	}
+};
+
+#if		defined(AID_ISA_X86)
+
+std::size_t byte_swap_none(const unsigned char *, unsigned char *, std::size_t, std::size_t) noexcept
+{
+	return 0;
+}
+
+AID_TARGET("ssse3")
+std::size_t byte_swap_ssse3(const unsigned char *src, unsigned char *dst,
+							std::size_t count, std::size_t width) noexcept
+{
+	const std::size_t bytes{count * width};
+	const ReverseControl<16> table(width);
+	const __m128i control = _mm_load_si128(reinterpret_cast<const __m128i *>(table.bytes));
+
+	std::size_t done{0};
+	for ( ; done + 16 <= bytes; done += 16 ) {
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + done));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + done), _mm_shuffle_epi8(a, control));
+	}
+	return done / width;
+}
+
+AID_TARGET("avx2")
+std::size_t byte_swap_avx2(const unsigned char *src, unsigned char *dst,
+						   std::size_t count, std::size_t width) noexcept
+{
+	const std::size_t bytes{count * width};
+	const ReverseControl<32> table(width);
+	const __m256i control = _mm256_load_si256(reinterpret_cast<const __m256i *>(table.bytes));
+
+	std::size_t done{0};
+	for ( ; done + 64 <= bytes; done += 64 ) {
+		const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + done));
+		const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + done + 32));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + done), _mm256_shuffle_epi8(a, control));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + done + 32), _mm256_shuffle_epi8(b, control));
+	}
+	for ( ; done + 16 <= bytes; done += 16 ) {
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + done));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + done),
+						 _mm_shuffle_epi8(a, _mm256_castsi256_si128(control)));
+	}
+	return done / width;
+}
+
+AID_TARGET("avx512f,avx512bw")
+std::size_t byte_swap_avx512(const unsigned char *src, unsigned char *dst,
+							 std::size_t count, std::size_t width) noexcept
+{
+	const std::size_t bytes{count * width};
+	const ReverseControl<64> table(width);
+	const __m512i control = _mm512_load_si512(table.bytes);
+
+	std::size_t done{0};
+	for ( ; done + 128 <= bytes; done += 128 ) {
+		const __m512i a = _mm512_loadu_si512(src + done);
+		const __m512i b = _mm512_loadu_si512(src + done + 64);
+		_mm512_storeu_si512(dst + done, _mm512_shuffle_epi8(a, control));
+		_mm512_storeu_si512(dst + done + 64, _mm512_shuffle_epi8(b, control));
+	}
+	if ( done < bytes ) {
+		// the tail in whole elements with a masked load/store
+		const std::size_t rest{bytes - done < 64 ? (bytes - done) / width * width : 64};
+		const __mmask64 mask{rest == 64 ? ~__mmask64{0} : (__mmask64{1} << rest) - 1};
+		const __m512i a = _mm512_maskz_loadu_epi8(mask, src + done);
+		_mm512_mask_storeu_epi8(dst + done, mask, _mm512_shuffle_epi8(a, control));
+		done += rest;
+	}
+	return done / width;
+}
+
+const ByteSwapKernel byte_swap_kernels[Isa_impl::variant_count]{
+	byte_swap_none, byte_swap_ssse3, byte_swap_avx2, byte_swap_avx512,
+};
+
+#else	// AID_ISA_X86
+
+/*!
+  @brief		the widest vectors enabled at compile time
+ */
+std::size_t byte_swap_vector(const unsigned char *src, unsigned char *dst,
+							 std::size_t count, std::size_t width) noexcept
+{
+	const std::size_t bytes{count * width};
+	std::size_t done{0};
+
+#if		defined(__AVX2__)
+	{
+		const ReverseControl<32> table(width);
+		const __m256i control = _mm256_load_si256(reinterpret_cast<const __m256i *>(table.bytes));
+		for ( ; done + 32 <= bytes; done += 32 ) {
+			const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + done));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + done), _mm256_shuffle_epi8(a, control));
+		}
+	}
+#endif
+#if		defined(__SSSE3__)
+	{
+		const ReverseControl<16> table(width);
+		const __m128i control = _mm_load_si128(reinterpret_cast<const __m128i *>(table.bytes));
+		for ( ; done + 16 <= bytes; done += 16 ) {
+			const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + done));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + done), _mm_shuffle_epi8(a, control));
+		}
+	}
+#endif
+	static_cast<void>(src);
+	static_cast<void>(dst);
+	static_cast<void>(bytes);
+	return done / width;
+}
+
+const ByteSwapKernel byte_swap_kernels[Isa_impl::variant_count]{
+	byte_swap_vector, byte_swap_vector, byte_swap_vector, byte_swap_vector,
+};
+
+#endif	// AID_ISA_X86
+
+/*!
+  @brief		vector part of unpack24_n() and unpack48_n()
+  @return		number of the processed elements
+ */
+using UnpackKernel = std::size_t (*)(const unsigned char *external, std::size_t count, void *native,
+									 bool big, bool sign);
+
+std::size_t unpack_none(const unsigned char *, std::size_t, void *, bool, bool) noexcept
+{
+	return 0;
+}
+
+#if		defined(AID_ISA_X86)
+
+/*!
+  @brief		pshufb control which moves t_size-byte values to the upper bytes of
+				t_width-byte lanes, in the order of the native (little) endian
+ */
+template<std::size_t t_size, std::size_t t_width>
+struct UnpackControl
+{
+	alignas(16) unsigned char bytes[16];
+
+	explicit UnpackControl(bool big) noexcept {
+		for ( std::size_t lane{0}; lane < 16 / t_width; ++lane ) {
+			for ( std::size_t i{0}; i < t_width - t_size; ++i ) {
+				bytes[lane * t_width + i] = 0x80;
+			}
+			for ( std::size_t i{0}; i < t_size; ++i ) {
+				const std::size_t source{big ? t_size - 1 - i : i};
+				bytes[lane * t_width + t_width - t_size + i] = static_cast<unsigned char>(lane * t_size + source);
+			}
+		}
+	}
+};
+
+AID_TARGET("ssse3")
+std::size_t unpack24_ssse3(const unsigned char *external, std::size_t count, void *native,
+						   bool big, bool sign) noexcept
+{
+	const UnpackControl<3, 4> table(big);
+	const __m128i control = _mm_load_si128(reinterpret_cast<const __m128i *>(table.bytes));
+	unsigned char * const out = static_cast<unsigned char *>(native);
+
+	std::size_t i{0};
+	for ( ; 3 * i + 16 <= 3 * count; i += 4 ) {
+		const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(external + 3 * i)), control);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4 * i), sign ? _mm_srai_epi32(a, 8) : _mm_srli_epi32(a, 8));
+	}
+	return i;
+}
+
+AID_TARGET("avx2")
+std::size_t unpack24_avx2(const unsigned char *external, std::size_t count, void *native,
+						  bool big, bool sign) noexcept
+{
+	const UnpackControl<3, 4> table(big);
+	const __m256i control = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(table.bytes)));
+	unsigned char * const out = static_cast<unsigned char *>(native);
+
+	std::size_t i{0};
+	for ( ; 3 * i + 28 <= 3 * count; i += 8 ) {
+		const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(external + 3 * i));
+		const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(external + 3 * i + 12));
+		const __m256i a = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), control);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 4 * i), sign ? _mm256_srai_epi32(a, 8) : _mm256_srli_epi32(a, 8));
+	}
+	return i + unpack24_ssse3(external + 3 * i, count - i, out + 4 * i, big, sign);
+}
+
+AID_TARGET("ssse3")
+std::size_t unpack48_ssse3(const unsigned char *external, std::size_t count, void *native,
+						   bool big, bool sign) noexcept
+{
+	const UnpackControl<6, 8> table(big);
+	const __m128i control = _mm_load_si128(reinterpret_cast<const __m128i *>(table.bytes));
+	const __m128i m = _mm_set1_epi64x(sign ? std::int64_t{1} << 47 : 0);
+	unsigned char * const out = static_cast<unsigned char *>(native);
+
+	std::size_t i{0};
+	for ( ; 6 * i + 16 <= 6 * count; i += 2 ) {
+		__m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(external + 6 * i)), control);
+		a = _mm_sub_epi64(_mm_xor_si128(_mm_srli_epi64(a, 16), m), m);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8 * i), a);
+	}
+	return i;
+}
+
+AID_TARGET("avx2")
+std::size_t unpack48_avx2(const unsigned char *external, std::size_t count, void *native,
+						  bool big, bool sign) noexcept
+{
+	const UnpackControl<6, 8> table(big);
+	const __m256i control = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(table.bytes)));
+	const __m256i m = _mm256_set1_epi64x(sign ? std::int64_t{1} << 47 : 0);
+	unsigned char * const out = static_cast<unsigned char *>(native);
+
+	std::size_t i{0};
+	for ( ; 6 * i + 28 <= 6 * count; i += 4 ) {
+		const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(external + 6 * i));
+		const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(external + 6 * i + 12));
+		__m256i a = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), control);
+		a = _mm256_sub_epi64(_mm256_xor_si256(_mm256_srli_epi64(a, 16), m), m);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 8 * i), a);
+	}
+	return i + unpack48_ssse3(external + 6 * i, count - i, out + 8 * i, big, sign);
+}
+
+// AVX-512 has no wider 3/6-byte gather than two AVX2 lanes, so it shares the AVX2 kernels.
+const UnpackKernel unpack24_kernels[Isa_impl::variant_count]{
+	unpack_none, unpack24_ssse3, unpack24_avx2, unpack24_avx2,
+};
+
+const UnpackKernel unpack48_kernels[Isa_impl::variant_count]{
+	unpack_none, unpack48_ssse3, unpack48_avx2, unpack48_avx2,
+};
+
+#else	// AID_ISA_X86
+
+const UnpackKernel unpack24_kernels[Isa_impl::variant_count]{
+	unpack_none, unpack_none, unpack_none, unpack_none,
+};
+
+const UnpackKernel unpack48_kernels[Isa_impl::variant_count]{
+	unpack_none, unpack_none, unpack_none, unpack_none,
+};
+
+#endif	// AID_ISA_X86
+
+template<EndianType t_external_type, std::size_t t_size, typename UInteger>
+void unpack_scalar(const unsigned char *external, std::size_t count, UInteger *native, bool sign) noexcept
+{
+	using Signed = typename std::make_signed<UInteger>::type;
+	using Converter = FixedSizeConverter<t_external_type, t_size>;
+
+	for ( std::size_t i{0}; i < count; ++i ) {
+		if ( sign ) {
+			Converter::from_external(external + i * t_size, reinterpret_cast<Signed &>(native[i]));
+		}
+		else {
+			Converter::from_external(external + i * t_size, native[i]);
+		}
+	}
+}
+
+template<std::size_t t_size, typename UInteger>
+void unpack_n(const UnpackKernel (&kernels)[Isa_impl::variant_count],
+			  const unsigned char *external, std::size_t count, UInteger *native,
+			  EndianType external_type, bool sign) noexcept
+{
+	const bool big{external_type == EndianType::big};
+	const std::size_t done = kernels[Isa_impl::active_index()](external, count, native, big, sign);
+	external += done * t_size;
+	native += done;
+	count -= done;
+
+	if ( big ) {
+		unpack_scalar<EndianType::big, t_size>(external, count, native, sign);
+	}
+	else {
+		unpack_scalar<EndianType::little, t_size>(external, count, native, sign);
+	}
+}
+
+} // unnamed namespace
+
+void byte_swap_n(const void *src, void *dst, std::size_t count, std::size_t width) noexcept
+{
+	const unsigned char *usrc = static_cast<const unsigned char *>(src);
+	unsigned char *udst = static_cast<unsigned char *>(dst);
+
+	if ( width == 1 ) {
+		if ( usrc != udst ) {
+			std::memcpy(udst, usrc, count);
+		}
+		return;
+	}
+
+	const std::size_t done = byte_swap_kernels[Isa_impl::active_index()](usrc, udst, count, width);
+	usrc += done * width;
+	udst += done * width;
+	count -= done;
+
+	switch ( width ) {
+	case 2:
+		return byte_swap_scalar<std::uint16_t>(usrc, udst, count);
+	case 4:
+		return byte_swap_scalar<std::uint32_t>(usrc, udst, count);
+	case 8:
+		return byte_swap_scalar<std::uint64_t>(usrc, udst, count);
+	case 16:
+		return byte_swap_scalar16(usrc, udst, count);
+	}
+}
+
+void unpack24_n(const unsigned char *external, std::size_t count, std::uint32_t *native,
+				EndianType external_type, bool sign) noexcept
+{
+	unpack_n<3>(unpack24_kernels, external, count, native, external_type, sign);
+}
+
+void unpack48_n(const unsigned char *external, std::size_t count, std::uint64_t *native,
+				EndianType external_type, bool sign) noexcept
+{
+	unpack_n<6>(unpack48_kernels, external, count, native, external_type, sign);
+}
+
+} // namespace Endian_impl
+
 aid_DEFINE_EndianConverter(, EndianType::little);
 aid_DEFINE_EndianConverter(, EndianType::big);
 
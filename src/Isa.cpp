@@ -0,0 +1,103 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file Isa.cpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "Isa_impl.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace aid {
+
+namespace {
+
+Isa detect_isa() noexcept
+{
+#if		defined(AID_ISA_X86)
+	__builtin_cpu_init();
+	if ( __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") ) {
+		return Isa::avx512;
+	}
+	if ( __builtin_cpu_supports("avx2") ) {
+		return Isa::avx2;
+	}
+	if ( __builtin_cpu_supports("ssse3") ) {
+		return Isa::ssse3;
+	}
+#endif
+	return Isa::scalar;
+}
+
+Isa initial_isa() noexcept
+{
+	const Isa supported = supported_isa();
+	const char * const name = std::getenv("AID_ISA");
+	if ( name == nullptr ) {
+		return supported;
+	}
+
+	for ( unsigned int i{0}; i < Isa_impl::variant_count; ++i ) {
+		const Isa isa = static_cast<Isa>(i);
+		if ( std::strcmp(name, isa_name(isa)) == 0 ) {
+			return isa < supported ? isa : supported;
+		}
+	}
+	return supported;
+}
+
+std::atomic<Isa> &active() noexcept
+{
+	static std::atomic<Isa> s_active{initial_isa()};
+	return s_active;
+}
+
+} // unnamed namespace
+
+Isa supported_isa() noexcept
+{
+	static const Isa s_supported{detect_isa()};
+	return s_supported;
+}
+
+Isa active_isa() noexcept
+{
+	return active().load(std::memory_order_relaxed);
+}
+
+bool select_isa(Isa isa) noexcept
+{
+	if ( isa > supported_isa() ) {
+		return false;
+	}
+	active().store(isa, std::memory_order_relaxed);
+	return true;
+}
+
+const char *isa_name(Isa isa) noexcept
+{
+	switch ( isa ) {
+	case Isa::scalar:	return "scalar";
+	case Isa::ssse3:	return "ssse3";
+	case Isa::avx2:		return "avx2";
+	case Isa::avx512:	return "avx512";
+	}
+	return "unknown";
+}
+
+} // namespace aid
@@ -0,0 +1,53 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file Isa_impl.hpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef aid_Isa_impl_hpp
+#define aid_Isa_impl_hpp
+
+#include "aid/Isa.hpp"
+
+// AID_ISA_X86: the kernels are compiled in all the variants and dispatched at run time.
+// AID_TARGET(d_isa): attribute which enables an instruction set for a function.
+#if		defined(AID_ISA_DISPATCH) && defined(__GNUC__) \
+		&& (defined(__x86_64__) || defined(__i386__))
+#define AID_ISA_X86	1
+#define AID_TARGET(d_isa)	__attribute__((target(d_isa)))
+#include <immintrin.h>
+#endif
+
+
+namespace aid {
+
+namespace Isa_impl {
+
+constexpr unsigned int variant_count{static_cast<unsigned int>(Isa::avx512) + 1};
+
+/*!
+  @brief		index of the active variant in a kernel table
+ */
+inline unsigned int active_index() noexcept
+{
+	return static_cast<unsigned int>(active_isa());
+}
+
+} // namespace Isa_impl
+
+} // namespace aid
+
+
+#endif // aid_Isa_impl_hpp
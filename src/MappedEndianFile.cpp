@@ -0,0 +1,146 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file MappedEndianFile.cpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "aid/MappedEndianFile.hpp"
+
+#include <cerrno>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace aid {
+
+namespace {
+
+[[noreturn]] void throw_system_error(const char *what)
+{
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+int to_posix(MappedEndianFile::Advice advice) noexcept
+{
+	switch ( advice ) {
+	case MappedEndianFile::Advice::sequential:	return MADV_SEQUENTIAL;
+	case MappedEndianFile::Advice::random:		return MADV_RANDOM;
+	case MappedEndianFile::Advice::will_need:	return MADV_WILLNEED;
+	case MappedEndianFile::Advice::dont_need:	return MADV_DONTNEED;
+	default:									return MADV_NORMAL;
+	}
+}
+
+} // unnamed namespace
+
+constexpr std::size_t MappedEndianFile::default_window_size;
+
+MappedEndianFile::MappedEndianFile(const std::string &path, EndianType external_type, Mode mode)
+	: m_data{nullptr}, m_size{0}, m_mode{mode}
+	, m_converter{external_type}, m_window_size{default_window_size}
+{
+	const int fd = ::open(path.c_str(), mode == Mode::read_write ? O_RDWR : O_RDONLY);
+	if ( fd < 0 ) {
+		throw_system_error("open");
+	}
+
+	struct stat status;
+	if ( ::fstat(fd, &status) != 0 ) {
+		const int error = errno;
+		::close(fd);
+		errno = error;
+		throw_system_error("fstat");
+	}
+
+	m_size = static_cast<std::size_t>(status.st_size);
+	if ( m_size > 0 ) {
+		const int protection = mode == Mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+		const int flags = mode == Mode::read_write ? MAP_SHARED : MAP_PRIVATE;
+		void * const data = ::mmap(nullptr, m_size, protection, flags, fd, 0);
+		if ( data == MAP_FAILED ) {
+			const int error = errno;
+			::close(fd);
+			errno = error;
+			throw_system_error("mmap");
+		}
+		m_data = static_cast<unsigned char *>(data);
+	}
+	::close(fd);
+}
+
+MappedEndianFile::MappedEndianFile(MappedEndianFile &&other) noexcept
+	: m_data{other.m_data}, m_size{other.m_size}, m_mode{other.m_mode}
+	, m_converter{other.m_converter}, m_window_size{other.m_window_size}
+{
+	other.m_data = nullptr;
+	other.m_size = 0;
+}
+
+MappedEndianFile &MappedEndianFile::operator=(MappedEndianFile &&other) noexcept
+{
+	if ( this != &other ) {
+		if ( m_data != nullptr ) {
+			::munmap(m_data, m_size);
+		}
+		m_data = other.m_data;
+		m_size = other.m_size;
+		m_mode = other.m_mode;
+		m_converter = other.m_converter;
+		m_window_size = other.m_window_size;
+		other.m_data = nullptr;
+		other.m_size = 0;
+	}
+	return *this;
+}
+
+MappedEndianFile::~MappedEndianFile()
+{
+	if ( m_data != nullptr ) {
+		::munmap(m_data, m_size);
+	}
+}
+
+void MappedEndianFile::advise(std::size_t offset, std::size_t length, Advice advice) const noexcept
+{
+	if ( m_data == nullptr || offset >= m_size ) {
+		return;
+	}
+	if ( length > m_size - offset ) {
+		length = m_size - offset;
+	}
+
+	const std::size_t page_size{static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))};
+	const std::size_t first{offset / page_size * page_size};
+	::madvise(m_data + first, length + (offset - first), to_posix(advice));
+}
+
+void MappedEndianFile::sync()
+{
+	if ( m_data != nullptr && m_mode == Mode::read_write && ::msync(m_data, m_size, MS_SYNC) != 0 ) {
+		throw_system_error("msync");
+	}
+}
+
+void MappedEndianFile::check_range(std::size_t offset, std::size_t count, std::size_t size) const
+{
+	if ( offset > m_size || count > (m_size - offset) / size ) {
+		throw std::out_of_range("out of the file");
+	}
+}
+
+} // namespace aid
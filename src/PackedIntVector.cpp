@@ -0,0 +1,192 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file PackedIntVector.cpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "aid/PackedIntVector.hpp"
+#include "Isa_impl.hpp"
+
+
+namespace aid {
+
+namespace PackedIntVector_impl {
+
+namespace {
+
+/*!
+  @brief		vector part of unpack_n
+  @details		bytes is the first byte of a group of 8 elements; 8 elements of
+				width bits are width bytes, so every group starts on a byte.
+				Widths up to 25 fit in a 32-bit lane after the byte offset,
+				wider ones are gathered in 64-bit lanes.
+  @return		number of the unpacked elements
+ */
+using UnpackKernel = std::size_t (*)(const unsigned char *bytes, unsigned int width, std::size_t count,
+									 std::uint32_t *values);
+
+constexpr unsigned int narrow_width{25};
+
+std::size_t unpack_none(const unsigned char *, unsigned int, std::size_t, std::uint32_t *) noexcept
+{
+	return 0;
+}
+
+#if		defined(AID_ISA_X86)
+
+AID_TARGET("avx2")
+std::size_t unpack_avx2(const unsigned char *bytes, unsigned int width, std::size_t count,
+						std::uint32_t *values) noexcept
+{
+	const __m256i bits = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+											_mm256_set1_epi32(static_cast<int>(width)));
+	const __m256i offsets = _mm256_srli_epi32(bits, 3);
+	const __m256i shifts = _mm256_and_si256(bits, _mm256_set1_epi32(7));
+	const __m256i value_mask = _mm256_set1_epi32(static_cast<int>(mask(width)));
+	std::size_t i{0};
+	if ( width <= narrow_width ) {
+		for ( ; i + 8 <= count; i += 8, bytes += width ) {
+			const __m256i x = _mm256_i32gather_epi32(reinterpret_cast<const int *>(bytes), offsets, 1);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(values + i),
+								_mm256_and_si256(_mm256_srlv_epi32(x, shifts), value_mask));
+		}
+	}
+	else {
+		const __m128i lo_offsets = _mm256_castsi256_si128(offsets);
+		const __m128i hi_offsets = _mm256_extracti128_si256(offsets, 1);
+		const __m256i lo_shifts = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(shifts));
+		const __m256i hi_shifts = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(shifts, 1));
+		const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+		for ( ; i + 8 <= count; i += 8, bytes += width ) {
+			const long long *base = reinterpret_cast<const long long *>(bytes);
+			const __m256i lo = _mm256_srlv_epi64(_mm256_i32gather_epi64(base, lo_offsets, 1), lo_shifts);
+			const __m256i hi = _mm256_srlv_epi64(_mm256_i32gather_epi64(base, hi_offsets, 1), hi_shifts);
+			const __m256i x = _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(lo, even),
+														_mm256_permutevar8x32_epi32(hi, even), 0x20);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(values + i), _mm256_and_si256(x, value_mask));
+		}
+	}
+	return i;
+}
+
+// (the masked forms are used; the plain ones start from _mm512_undefined, on which GCC warns falsely)
+AID_TARGET("avx512f")
+std::size_t unpack_avx512(const unsigned char *bytes, unsigned int width, std::size_t count,
+						  std::uint32_t *values) noexcept
+{
+	std::size_t i{0};
+	if ( width <= narrow_width ) {
+		const __m512i bits = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+																   8, 9, 10, 11, 12, 13, 14, 15),
+												_mm512_set1_epi32(static_cast<int>(width)));
+		const __m512i offsets = _mm512_maskz_srli_epi32(0xFFFF, bits, 3);
+		const __m512i shifts = _mm512_and_si512(bits, _mm512_set1_epi32(7));
+		const __m512i value_mask = _mm512_set1_epi32(static_cast<int>(mask(width)));
+		for ( ; i + 16 <= count; i += 16, bytes += 2 * width ) {
+			const __m512i x = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, offsets, bytes, 1);
+			_mm512_storeu_si512(values + i, _mm512_and_si512(_mm512_maskz_srlv_epi32(0xFFFF, x, shifts),
+															 value_mask));
+		}
+	}
+	else {
+		const __m256i lo_bits = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+												   _mm256_set1_epi32(static_cast<int>(width)));
+		const __m256i hi_bits = _mm256_add_epi32(lo_bits, _mm256_set1_epi32(static_cast<int>(8 * width)));
+		const __m256i lo_offsets = _mm256_srli_epi32(lo_bits, 3);
+		const __m256i hi_offsets = _mm256_srli_epi32(hi_bits, 3);
+		const __m256i seven = _mm256_set1_epi32(7);
+		const __m512i lo_shifts = _mm512_maskz_cvtepu32_epi64(0xFF, _mm256_and_si256(lo_bits, seven));
+		const __m512i hi_shifts = _mm512_maskz_cvtepu32_epi64(0xFF, _mm256_and_si256(hi_bits, seven));
+		const __m512i value_mask = _mm512_set1_epi64(static_cast<long long>(mask(width)));
+		for ( ; i + 16 <= count; i += 16, bytes += 2 * width ) {
+			const __m512i lo = _mm512_mask_i32gather_epi64(_mm512_setzero_si512(), 0xFF, lo_offsets, bytes, 1);
+			const __m512i hi = _mm512_mask_i32gather_epi64(_mm512_setzero_si512(), 0xFF, hi_offsets, bytes, 1);
+			const __m512i x = _mm512_and_si512(_mm512_maskz_srlv_epi64(0xFF, lo, lo_shifts), value_mask);
+			const __m512i y = _mm512_and_si512(_mm512_maskz_srlv_epi64(0xFF, hi, hi_shifts), value_mask);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(values + i), _mm512_maskz_cvtepi64_epi32(0xFF, x));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(values + i + 8), _mm512_maskz_cvtepi64_epi32(0xFF, y));
+		}
+	}
+	return i;
+}
+
+// A gather needs AVX2, so SSSE3 runs the scalar loop.
+const UnpackKernel unpack_kernels[Isa_impl::variant_count]{
+	unpack_none, unpack_none, unpack_avx2, unpack_avx512,
+};
+
+#else	// AID_ISA_X86
+
+const UnpackKernel unpack_kernels[Isa_impl::variant_count]{
+	unpack_none, unpack_none, unpack_none, unpack_none,
+};
+
+#endif	// AID_ISA_X86
+
+} // unnamed namespace
+
+void unpack_n(const word_type *words, unsigned int width, std::size_t first, std::size_t count,
+			  std::uint32_t *values) noexcept
+{
+	std::size_t i{0};
+	for ( ; i < count && (first + i) % 8 != 0; ++i ) {
+		values[i] = get(words, width, first + i);
+	}
+	const unsigned char * const bytes = reinterpret_cast<const unsigned char *>(words) + (first + i) / 8 * width;
+	i += unpack_kernels[Isa_impl::active_index()](bytes, width, count - i, values + i);
+	for ( ; i < count; ++i ) {
+		values[i] = get(words, width, first + i);
+	}
+}
+
+bool vector_unpack() noexcept
+{
+	return unpack_kernels[Isa_impl::active_index()] != unpack_none;
+}
+
+void pack_n(word_type *words, unsigned int width, std::size_t first, const std::uint32_t *values,
+			std::size_t count) noexcept
+{
+	const word_type value_mask{mask(width)};
+	std::size_t i{0};
+	for ( ; i < count && (first + i) % word_bits != 0; ++i ) {
+		set(words, width, first + i, static_cast<std::uint32_t>(values[i] & value_mask));
+	}
+
+	// 64 elements fill exactly width words, which are assigned whole
+	word_type *word = words + (first + i) / word_bits * width;
+	for ( ; i + word_bits <= count; i += word_bits ) {
+		word_type bits{0};
+		unsigned int fill{0};
+		for ( unsigned int k{0}; k < word_bits; ++k ) {
+			const word_type value{values[i + k] & value_mask};
+			bits |= value << fill;
+			fill += width;
+			if ( fill >= word_bits ) {
+				*word++ = bits;
+				fill -= word_bits;
+				bits = value >> (width - fill);
+			}
+		}
+	}
+
+	for ( ; i < count; ++i ) {
+		set(words, width, first + i, static_cast<std::uint32_t>(values[i] & value_mask));
+	}
+}
+
+} // namespace PackedIntVector_impl
+
+} // namespace aid
@@ -0,0 +1,63 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file RankSelect.cpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "aid/RankSelect.hpp"
+
+#include <limits>
+#include <utility>
+
+
+namespace aid {
+
+RankSelect::RankSelect(DynamicBitVector bits)
+	: m_bits{std::move(bits)}, m_superblocks{}, m_blocks{}, m_samples{}, m_count{0}
+{
+	using namespace RankSelect_impl;
+	constexpr size_type blocks_per_superblock{superblock_bits / block_bits};
+
+	// DynamicBitVector pads the words to whole blocks; one more block keeps absolute_rank(block_count) valid
+	const size_type block_count{m_bits.word_size() / BitVector_impl::line_words};
+	if ( block_count >= std::numeric_limits<std::uint32_t>::max() ) {
+		throw std::length_error("bits.size() >= 2^41");
+	}
+	m_blocks.reserve(block_count + 1);
+	m_superblocks.reserve(block_count / blocks_per_superblock + 1);
+
+	const BitVector_impl::word_type * const words = m_bits.data();
+	size_type next_sample{0};
+	for ( size_type block{0}; block <= block_count; ++block ) {
+		if ( block % blocks_per_superblock == 0 ) {
+			m_superblocks.push_back(m_count);
+		}
+		m_blocks.push_back(static_cast<std::uint16_t>(m_count - m_superblocks.back()));
+		if ( block == block_count ) {
+			break;
+		}
+
+		size_type block_count_bits{0};
+		for ( size_type i{0}; i < BitVector_impl::line_words; ++i ) {
+			block_count_bits += BitVector_impl::popcount(words[block * BitVector_impl::line_words + i]);
+		}
+		for ( ; next_sample < m_count + block_count_bits; next_sample += select_sample ) {
+			m_samples.push_back(static_cast<std::uint32_t>(block));
+		}
+		m_count += block_count_bits;
+	}
+}
+
+} // namespace aid
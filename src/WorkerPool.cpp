@@ -0,0 +1,134 @@
+// -*- tab-width: 4 -*-
+/*!
+   @file WorkerPool.cpp
+
+   Copyright 2015 pegacorn
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "aid/WorkerPool.hpp"
+
+
+namespace aid {
+
+WorkerPool::WorkerPool(unsigned int threads)
+	: m_task{nullptr}, m_task_count{0}, m_next{0}, m_running{0}
+	, m_generation{0}, m_stop{false}
+{
+	if ( threads == 0 ) {
+		threads = std::thread::hardware_concurrency();
+	}
+	for ( unsigned int i{1}; i < threads; ++i ) {
+		m_workers.emplace_back(&WorkerPool::work, this);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_start.notify_all();
+	for ( auto &worker : m_workers ) {
+		worker.join();
+	}
+}
+
+WorkerPool &WorkerPool::default_pool()
+{
+	static WorkerPool s_pool;
+	return s_pool;
+}
+
+void WorkerPool::run(std::size_t count, const Task &task)
+{
+	if ( count == 0 ) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> run_lock(m_run_mutex);
+	if ( m_workers.empty() || count == 1 ) {
+		for ( std::size_t i{0}; i < count; ++i ) {
+			task(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_task = &task;
+		m_task_count = count;
+		m_next.store(0, std::memory_order_relaxed);
+		m_running = m_workers.size();
+		m_exception = nullptr;
+		++m_generation;
+	}
+	m_start.notify_all();
+
+	drain();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_finish.wait(lock, [this] { return m_running == 0; });
+	m_task = nullptr;
+	if ( m_exception ) {
+		std::rethrow_exception(m_exception);
+	}
+}
+
+void WorkerPool::work()
+{
+	unsigned long generation{0};
+	for ( ; ; ) {
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_start.wait(lock, [this, generation] { return m_stop || m_generation != generation; });
+			if ( m_stop ) {
+				return;
+			}
+			generation = m_generation;
+		}
+
+		drain();
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			last = --m_running == 0;
+		}
+		if ( last ) {
+			m_finish.notify_one();
+		}
+	}
+}
+
+void WorkerPool::drain()
+{
+	for ( ; ; ) {
+		const std::size_t index{m_next.fetch_add(1, std::memory_order_relaxed)};
+		if ( index >= m_task_count ) {
+			return;
+		}
+		try {
+			(*m_task)(index);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if ( !m_exception ) {
+				m_exception = std::current_exception();
+			}
+		}
+	}
+}
+
+} // namespace aid
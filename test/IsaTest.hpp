@@ -0,0 +1,24 @@
+// -*- tab-width: 4 -*-
+#ifndef aid_test_IsaTest_hpp
+#define aid_test_IsaTest_hpp
+
+#include <boost/test/unit_test.hpp>
+
+#include "aid/Isa.hpp"
+
+
+//! call function with each supported instruction set selected, then restore the active one
+template<typename Function>
+void for_each_isa(Function function)
+{
+	const aid::Isa active = aid::active_isa();
+	for ( auto isa : {aid::Isa::scalar, aid::Isa::ssse3, aid::Isa::avx2, aid::Isa::avx512} ) {
+		if ( !aid::select_isa(isa) ) continue;
+		BOOST_TEST_CHECKPOINT("isa " << aid::isa_name(isa));
+		function();
+	}
+	aid::select_isa(active);
+}
+
+
+#endif // aid_test_IsaTest_hpp
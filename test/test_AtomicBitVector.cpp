@@ -0,0 +1,141 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE AtomicBitVector
+#include <boost/mpl/list.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "aid/AtomicBitVector.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using test_type_list = boost::mpl::list<uint8_t, uint16_t, uint32_t, uint64_t>;
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(set_1, test_type, test_type_list)
+{
+	using ABVec = aid::AtomicBitVector<test_type>;
+	constexpr unsigned int bits = sizeof(test_type) * CHAR_BIT;
+
+	ABVec abvec;
+	BOOST_CHECK(abvec.is_lock_free());
+	BOOST_CHECK_EQUAL(0u, abvec.get());
+
+	const auto low = ABVec::create_section(0, 2);
+	const auto high = ABVec::create_section(bits / 2, bits - 1);
+	abvec.set(low, 5);
+	abvec.set(high, 1);
+	BOOST_CHECK_EQUAL(5u, abvec.get(low));
+	BOOST_CHECK_EQUAL(1u, abvec.get(high));
+	BOOST_CHECK_EQUAL(5u, abvec.load().get(low));
+
+	BOOST_CHECK_EQUAL(5u, abvec.exchange(low, 2, memory_order_acq_rel));
+	BOOST_CHECK_EQUAL(2u, abvec.get(low, memory_order_acquire));
+	BOOST_CHECK_EQUAL(1u, abvec.get(high));
+
+	test_type expected = 3;
+	BOOST_CHECK(!abvec.compare_exchange(low, expected, 7));
+	BOOST_CHECK_EQUAL(2u, expected);
+	BOOST_CHECK(abvec.compare_exchange(low, expected, 7, memory_order_release));
+	BOOST_CHECK_EQUAL(7u, abvec.get(low));
+
+	BOOST_CHECK_EQUAL(7u, abvec.fetch_and(low, 4));
+	BOOST_CHECK_EQUAL(4u, abvec.get(low));
+	BOOST_CHECK_EQUAL(4u, abvec.fetch_or(low, 1, memory_order_relaxed));
+	BOOST_CHECK_EQUAL(5u, abvec.get(low));
+	BOOST_CHECK_EQUAL(1u, abvec.get(high));
+
+	abvec.store(aid::BitVector<test_type>(0));
+	BOOST_CHECK_EQUAL(0u, abvec.get());
+
+#ifndef NDEBUG
+	BOOST_CHECK_THROW(abvec.set(low, 8), overflow_error);
+	BOOST_CHECK_THROW(abvec.fetch_or(low, 8), overflow_error);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(acquire_first_free_1, test_type, test_type_list)
+{
+	using ABVec = aid::AtomicBitVector<test_type>;
+	constexpr unsigned int bits = sizeof(test_type) * CHAR_BIT;
+
+	ABVec abvec;
+	for ( unsigned int i = 0; i < bits; ++i ) {
+		BOOST_CHECK_EQUAL(i, abvec.acquire_first_free());
+	}
+	BOOST_CHECK_EQUAL(ABVec::npos, abvec.acquire_first_free());
+
+	abvec.release(3);
+	abvec.release(1);
+	BOOST_CHECK_EQUAL(1u, abvec.acquire_first_free());
+	BOOST_CHECK_EQUAL(3u, abvec.acquire_first_free());
+	BOOST_CHECK_THROW(abvec.release(bits), out_of_range);
+
+	// only the bits of the section are handed out
+	ABVec sectioned(test_type{0x01});
+	const auto section = ABVec::create_section(0, 1);
+	BOOST_CHECK_EQUAL(1u, sectioned.acquire_first_free(section));
+	BOOST_CHECK_EQUAL(ABVec::npos, sectioned.acquire_first_free(section));
+	BOOST_CHECK_EQUAL(2u, sectioned.acquire_first_free());
+}
+
+BOOST_AUTO_TEST_CASE(set_concurrent_1)
+{
+	using ABVec = aid::AtomicBitVector<uint64_t>;
+	constexpr unsigned int threads = 8;
+	constexpr unsigned int rounds = 20000;
+
+	// each thread counts in its own 8-bit section of the same word
+	ABVec abvec;
+	vector<thread> workers;
+	for ( unsigned int t = 0; t < threads; ++t ) {
+		workers.emplace_back([&abvec, t] {
+			const auto section = ABVec::create_section(t * 8, t * 8 + 7);
+			for ( unsigned int i = 1; i <= rounds; ++i ) {
+				abvec.set(section, i & 0xFF, memory_order_relaxed);
+			}
+		});
+	}
+	for ( auto &worker : workers ) {
+		worker.join();
+	}
+	for ( unsigned int t = 0; t < threads; ++t ) {
+		BOOST_CHECK_EQUAL(rounds & 0xFF, abvec.get(ABVec::create_section(t * 8, t * 8 + 7)));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(acquire_first_free_concurrent_1)
+{
+	using ABVec = aid::AtomicBitVector<uint64_t>;
+	constexpr unsigned int threads = 16;
+	constexpr unsigned int rounds = 20000;
+
+	// a slot is never owned by two threads at once
+	ABVec slots;
+	atomic<unsigned int> owners[64];
+	for ( auto &owner : owners ) owner = 0;
+	atomic<bool> shared{false};
+	vector<thread> workers;
+	for ( unsigned int t = 0; t < threads; ++t ) {
+		workers.emplace_back([&] {
+			for ( unsigned int i = 0; i < rounds; ++i ) {
+				const auto slot = slots.acquire_first_free();
+				if ( slot == ABVec::npos ) continue;
+				if ( owners[slot].fetch_add(1) != 0 ) shared = true;
+				owners[slot].fetch_sub(1);
+				slots.release(slot);
+			}
+		});
+	}
+	for ( auto &worker : workers ) {
+		worker.join();
+	}
+	BOOST_CHECK(!shared);
+	BOOST_CHECK_EQUAL(0u, slots.get());
+}
@@ -0,0 +1,153 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE BitField
+#include <boost/test/unit_test.hpp>
+
+#include "aid/BitField.hpp"
+#include "aid/BitVector.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+using aid::BitField;
+using aid::TypeList;
+
+
+namespace {
+
+// an IPv4-like first word: version, header length, type of service, total length
+using Version		= BitField<28, 31>;
+using HeaderLength	= BitField<24, 27>;
+using Service		= BitField<16, 23>;
+using TotalLength	= BitField<0, 15>;
+using Header		= aid::BitLayout<uint32_t, TypeList<Version, HeaderLength, Service, TotalLength>>;
+
+// the same word is folded at compile time
+static_assert(Header::pack(4, 5, 0, 84) == 0x45000054u, "pack");
+static_assert(Header::get<HeaderLength>(0x45000054u) == 5u, "get");
+static_assert(Header::set<Service>(0x45000054u, 0x10) == 0x45100054u, "set");
+static_assert(Header::mask == 0xFFFFFFFFu, "mask");
+
+static_assert(aid::BitField_impl::LayoutMask<uint8_t, TypeList<BitField<0, 3>, BitField<3, 4>>>::overlaps,
+			  "overlapping fields");
+static_assert(!aid::BitField_impl::LayoutMask<uint8_t, TypeList<BitField<0, 3>, BitField<5>>>::overlaps,
+			  "disjoint fields");
+
+} // unnamed namespace
+
+
+BOOST_AUTO_TEST_CASE(mask_1)
+{
+	BOOST_CHECK_EQUAL(0x0001u, (BitField<0>::mask<uint8_t>()));
+	BOOST_CHECK_EQUAL(0x0006u, (BitField<1, 2>::mask<uint16_t>()));
+	BOOST_CHECK_EQUAL(0x80u, (BitField<7>::mask<uint8_t>()));
+	BOOST_CHECK_EQUAL(0xFFFFFFFFFFFFFFFFu, (BitField<0, 63>::mask<uint64_t>()));
+	BOOST_CHECK_EQUAL(0xFFFFFFFF00000000u, (BitField<32, 63>::mask<uint64_t>()));
+	BOOST_CHECK_EQUAL(4u, (BitField<28, 31>::width));
+
+	// create_section() agrees with BitField
+	using BVec = aid::BitVector<uint64_t>;
+	for ( unsigned int first = 0; first < 64; first += 7 ) {
+		for ( unsigned int last = first; last < 64; last += 5 ) {
+			const uint64_t mask = (last == 63 ? ~uint64_t{0} : (uint64_t{1} << (last + 1)) - 1) & ~((uint64_t{1} << first) - 1);
+			BOOST_CHECK_EQUAL(mask, BVec::create_section(first, last).mask);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(bit_vector_1)
+{
+	aid::BitVector<uint32_t> bvec;
+	bvec.set<Version>(4);
+	bvec.set<HeaderLength>(5);
+	bvec.set<TotalLength>(84);
+	BOOST_CHECK_EQUAL(0x45000054u, bvec.get());
+	BOOST_CHECK_EQUAL(4u, bvec.get<Version>());
+	BOOST_CHECK_EQUAL(0u, bvec.get<Service>());
+	BOOST_CHECK_EQUAL(bvec.get(aid::BitVector<uint32_t>::create_section(24, 27)), bvec.get<HeaderLength>());
+
+	bvec.set<TotalLength>(0xFFFF);
+	BOOST_CHECK_EQUAL(0x4500FFFFu, bvec.get());
+
+	constexpr aid::BitVector<uint32_t> constant{0x45000054u};
+	static_assert(constant.get<Version>() == 4u, "get");
+
+#ifndef NDEBUG
+	BOOST_CHECK_THROW(bvec.set<Version>(16), overflow_error);
+	BOOST_CHECK_EQUAL(0x4500FFFFu, bvec.get());
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(pack_1)
+{
+	const uint32_t word = Header::pack(6, 15, 0xB8, 1500);
+	BOOST_CHECK_EQUAL(6u, Header::get<Version>(word));
+	BOOST_CHECK_EQUAL(15u, Header::get<HeaderLength>(word));
+	BOOST_CHECK_EQUAL(0xB8u, Header::get<Service>(word));
+	BOOST_CHECK_EQUAL(1500u, Header::get<TotalLength>(word));
+
+	uint8_t version = 0, length = 0, service = 0;
+	uint16_t total = 0;
+	Header::unpack(word, version, length, service, total);
+	BOOST_CHECK_EQUAL(6, version);
+	BOOST_CHECK_EQUAL(15, length);
+	BOOST_CHECK_EQUAL(0xB8, service);
+	BOOST_CHECK_EQUAL(1500, total);
+
+	// bits outside the fields are left alone
+	using Sparse = aid::BitLayout<uint16_t, TypeList<BitField<0, 2>, BitField<8>>>;
+	BOOST_CHECK_EQUAL(0x0107u, Sparse::mask);
+	BOOST_CHECK_EQUAL(0xF0F5u, (Sparse::set<BitField<0, 2>>(0xF0F0, 5)));
+	BOOST_CHECK_EQUAL(0x0103u, Sparse::pack(3, 1));
+
+#ifndef NDEBUG
+	BOOST_CHECK_THROW(Header::pack(16, 0, 0, 0), overflow_error);
+	BOOST_CHECK_THROW(Header::set<Version>(0, 16), overflow_error);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(extract_1)
+{
+	// a control word of fields out of order, with gaps between them
+	using Opcode	= BitField<26, 31>;
+	using Target	= BitField<21, 25>;
+	using Source	= BitField<16, 20>;
+	using Flags		= BitField<12, 14>;
+	using Offset	= BitField<0, 9>;
+	using Control	= aid::BitLayout<uint32_t, TypeList<Offset, Opcode, Flags, Target, Source>>;
+	BOOST_CHECK_EQUAL(29u, Control::width);
+	BOOST_CHECK_EQUAL(0u, Control::offset<Offset>());
+	BOOST_CHECK_EQUAL(10u, Control::offset<Flags>());
+	BOOST_CHECK_EQUAL(23u, Control::offset<Opcode>());
+	BOOST_CHECK_EQUAL(2u, Control::rank<Source>());
+	BOOST_CHECK_EQUAL(5u, Control::width_at(3));
+
+	const uint32_t word = Control::pack(0x155, 0x2A, 5, 0x11, 0x0E) | 0x0C00u;
+	const uint32_t bits = Control::extract(word);
+	BOOST_CHECK_EQUAL(0x155u, bits & 0x3FF);
+	BOOST_CHECK_EQUAL(5u, (bits >> Control::offset<Flags>()) & 0x7);
+	BOOST_CHECK_EQUAL(0x0Eu, (bits >> Control::offset<Source>()) & 0x1F);
+	BOOST_CHECK_EQUAL(0x11u, (bits >> Control::offset<Target>()) & 0x1F);
+	BOOST_CHECK_EQUAL(0x2Au, bits >> Control::offset<Opcode>());
+	BOOST_CHECK_EQUAL(word & Control::mask, Control::deposit(bits));
+	BOOST_CHECK_EQUAL(Control::mask, Control::deposit(~0u));
+
+	// a byte per field, the lowest field first
+	using Bytes = aid::BitLayout<uint64_t, TypeList<BitField<0, 9>, BitField<16, 18>, BitField<24, 28>,
+												   BitField<32, 36>, BitField<40, 45>>>;
+	const uint64_t lanes = Control::transcode<Bytes>(word);
+	BOOST_CHECK_EQUAL(0x2A110E050155u, lanes);
+	BOOST_CHECK_EQUAL(word & Control::mask, Bytes::transcode<Control>(lanes));
+
+	aid::BitVector<uint32_t> bvec{word};
+	BOOST_CHECK_EQUAL(bits, bvec.extract<Control>());
+	bvec.deposit<Control>(0);
+	BOOST_CHECK_EQUAL(0x0C00u, bvec.get());
+	bvec.deposit<Control>(bits);
+	BOOST_CHECK_EQUAL(word, bvec.get());
+
+	using Nibbles = aid::BitLayout<uint8_t, TypeList<BitField<6, 7>, BitField<0, 1>>>;
+	BOOST_CHECK_EQUAL(0x0Du, Nibbles::extract(0xC1));
+	BOOST_CHECK_EQUAL(0xC1u, Nibbles::deposit(0x0D));
+}
@@ -0,0 +1,212 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE BitStream
+#include <boost/mpl/list.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "aid/BitStream.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+using aid::BitOrder;
+
+using msb_first = integral_constant<BitOrder, BitOrder::msb_first>;
+using lsb_first = integral_constant<BitOrder, BitOrder::lsb_first>;
+using test_order_list = boost::mpl::list<msb_first, lsb_first>;
+
+
+BOOST_AUTO_TEST_CASE(reader_msb_first_1)
+{
+	// 101 | 000011110000 | 1 | 00111 (ue 6) | 1 (ue 0) | 011 (se -1)
+	const unsigned char bytes[]{0xA1, 0xE1, 0x3D, 0x80};
+	aid::BitReader<> reader(bytes, sizeof(bytes));
+
+	BOOST_CHECK_EQUAL(5u, reader.read(3));
+	BOOST_CHECK_EQUAL(0x0F0u, reader.peek(12));
+	BOOST_CHECK_EQUAL(0x0F0u, reader.read(12));
+	BOOST_CHECK(reader.read_bit());
+	BOOST_CHECK_EQUAL(16u, reader.position());
+	BOOST_CHECK_EQUAL(6u, reader.read_ue());
+	BOOST_CHECK_EQUAL(0u, reader.read_ue());
+	BOOST_CHECK_EQUAL(-1, reader.read_se());
+	BOOST_CHECK_EQUAL(25u, reader.position());
+	BOOST_CHECK_EQUAL(7u, reader.available());
+
+	reader.align();
+	BOOST_CHECK(reader.eof());
+	BOOST_CHECK_THROW(reader.read(1), out_of_range);
+	BOOST_CHECK_EQUAL(0u, reader.read(0));
+}
+
+BOOST_AUTO_TEST_CASE(reader_lsb_first_1)
+{
+	// the fields from bit 0 of each byte: 5 (3 bits), 0x1F4 (9 bits), 0xABC (12 bits)
+	const unsigned char bytes[]{0xA5, 0xCF, 0xAB};
+	aid::BitReader<BitOrder::lsb_first> reader(bytes, sizeof(bytes));
+
+	BOOST_CHECK_EQUAL(5u, reader.read(3));
+	BOOST_CHECK_EQUAL(0x1F4u, reader.read(9));
+	BOOST_CHECK_EQUAL(0xABCu, reader.read(12));
+	BOOST_CHECK(reader.eof());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(round_trip_1, test_order, test_order_list)
+{
+	constexpr BitOrder order = test_order::value;
+
+	// random fields of every width, across all the byte boundaries
+	mt19937_64 engine(5);
+	vector<unsigned int> widths;
+	vector<uint64_t> values;
+	size_t bits = 0;
+	for ( size_t i = 0; i < 2000; ++i ) {
+		const unsigned int width = static_cast<unsigned int>(engine() % 65);
+		widths.push_back(width);
+		values.push_back(width == 64 ? engine() : engine() & ((uint64_t{1} << width) - 1));
+		bits += width;
+	}
+
+	vector<unsigned char> bytes((bits + 7) / 8, 0xFF);
+	{
+		aid::BitWriter<order> writer(bytes.data(), bytes.size());
+		for ( size_t i = 0; i < values.size(); ++i ) {
+			writer.write(values[i], widths[i]);
+		}
+		BOOST_CHECK_EQUAL(bits, writer.position());
+		BOOST_CHECK_EQUAL(bytes.size(), writer.size());
+		BOOST_CHECK_THROW(writer.write(0, 8), out_of_range);
+	}
+
+	aid::BitReader<order> reader(bytes.data(), bytes.size());
+	for ( size_t i = 0; i < values.size(); ++i ) {
+		if ( reader.read(widths[i]) != values[i] ) {
+			BOOST_ERROR("field " << i << " of " << widths[i] << " bits");
+			break;
+		}
+	}
+	BOOST_CHECK_EQUAL(bits, reader.position());
+	BOOST_CHECK_EQUAL(0u, reader.read((8 - bits % 8) % 8));
+	BOOST_CHECK(reader.eof());
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(exp_golomb_1, test_order, test_order_list)
+{
+	constexpr BitOrder order = test_order::value;
+	const vector<uint64_t> unsigned_values{0, 1, 2, 6, 7, 255, 65535, (1u << 28) - 1, (1u << 29) - 1, 1u << 31, ~uint64_t{0} - 1};
+	const vector<int64_t> signed_values{0, 1, -1, 2, -2, 1000, -1000, INT64_MAX, INT64_MIN + 1};
+
+	vector<unsigned char> bytes(256);
+	{
+		aid::BitWriter<order> writer(bytes.data(), bytes.size());
+		for ( auto value : unsigned_values ) {
+			writer.write_ue(value);
+		}
+		for ( auto value : signed_values ) {
+			writer.write_se(value);
+		}
+		writer.write_unary(100);
+		writer.write_bit(true);
+		BOOST_CHECK_THROW(writer.write_ue(~uint64_t{0}), overflow_error);
+		BOOST_CHECK_THROW(writer.write_se(INT64_MIN), overflow_error);
+	}
+
+	aid::BitReader<order> reader(bytes.data(), bytes.size());
+	for ( auto value : unsigned_values ) {
+		BOOST_CHECK_EQUAL(value, reader.read_ue());
+	}
+	for ( auto value : signed_values ) {
+		BOOST_CHECK_EQUAL(value, reader.read_se());
+	}
+	BOOST_CHECK_EQUAL(100u, reader.read_unary());
+	BOOST_CHECK(reader.read_bit());
+
+	// the padding has no one
+	BOOST_CHECK_THROW(reader.read_unary(), out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(writer_1)
+{
+	unsigned char bytes[4]{0xFF, 0xFF, 0xFF, 0xFF};
+	{
+		aid::BitWriter<> writer(bytes, sizeof(bytes));
+		writer.write(5, 3).write(0x0F0, 12).write_bit(true);
+		writer.write_ue(6).write_ue(0).write_se(-1);
+		BOOST_CHECK_EQUAL(25u, writer.position());
+		BOOST_CHECK_EQUAL(7u, writer.available());
+
+		// flush() pads the last byte, and the next field overwrites the padding
+		writer.flush();
+		BOOST_CHECK_EQUAL(0x80, bytes[3]);
+		writer.write(3, 2);
+		writer.flush();
+		BOOST_CHECK_EQUAL(0xE0, bytes[3]);
+		BOOST_CHECK_THROW(writer.write(0, 6), out_of_range);
+		BOOST_CHECK_EQUAL(27u, writer.position());
+
+#ifndef NDEBUG
+		BOOST_CHECK_THROW(writer.write(4, 2), overflow_error);
+#endif
+		BOOST_CHECK_THROW(writer.write(0, 65), invalid_argument);
+	}
+	const unsigned char expected[]{0xA1, 0xE1, 0x3D, 0xE0};
+	BOOST_CHECK_EQUAL_COLLECTIONS(expected, expected + 4, bytes, bytes + 4);
+
+	unsigned char lsb[3]{};
+	{
+		aid::BitWriter<BitOrder::lsb_first> writer(lsb, sizeof(lsb));
+		writer.write(5, 3).write(0x1F4, 9).write(0xABC, 12);
+	}
+	const unsigned char lsb_expected[]{0xA5, 0xCF, 0xAB};
+	BOOST_CHECK_EQUAL_COLLECTIONS(lsb_expected, lsb_expected + 3, lsb, lsb + 3);
+}
+
+// the bytes past size() are kept
+BOOST_AUTO_TEST_CASE_TEMPLATE(writer_2, test_order, test_order_list)
+{
+	constexpr BitOrder order = test_order::value;
+	for ( unsigned int bits = 1; bits <= 64; ++bits ) {
+		vector<unsigned char> bytes(32, 0x5A);
+		size_t size;
+		{
+			aid::BitWriter<order> writer(bytes.data(), bytes.size());
+			for ( int i = 0; i < 3; ++i ) {
+				writer.write(0, bits);
+			}
+			writer.flush();
+			size = writer.size();
+		}
+		BOOST_TEST_CHECKPOINT("bits " << bits);
+		BOOST_CHECK(all_of(bytes.begin(), bytes.begin() + size, [](unsigned char byte) { return byte == 0; }));
+		BOOST_CHECK(all_of(bytes.begin() + size, bytes.end(), [](unsigned char byte) { return byte == 0x5A; }));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(skip_1)
+{
+	vector<unsigned char> bytes(64);
+	for ( size_t i = 0; i < bytes.size(); ++i ) {
+		bytes[i] = static_cast<unsigned char>(i);
+	}
+	aid::BitReader<> reader(bytes.data(), bytes.size());
+	BOOST_CHECK_EQUAL(0u, reader.read(4));
+	reader.skip(4 + 8 * 9);
+	BOOST_CHECK_EQUAL(10u, reader.read(8));
+	reader.skip(3).align();
+	BOOST_CHECK_EQUAL(12u, reader.read(8));
+	reader.skip(8 * 50);
+	BOOST_CHECK_EQUAL(0x3F, reader.read(8));
+	BOOST_CHECK_THROW(reader.skip(1), out_of_range);
+
+	BOOST_CHECK_THROW(aid::BitReader<>(nullptr, 1), invalid_argument);
+	aid::BitReader<> empty(nullptr, 0);
+	BOOST_CHECK(empty.eof());
+	BOOST_CHECK_THROW(empty.peek(57), invalid_argument);
+}
@@ -0,0 +1,139 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE BitVectorBatch
+#include <boost/mpl/list.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "aid/BitVectorBatch.hpp"
+#include "IsaTest.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using aid::BitVector;
+using aid::DynamicBitVector;
+
+using test_types = boost::mpl::list<uint8_t, uint16_t, uint32_t, uint64_t>;
+
+
+namespace {
+
+const size_t test_sizes[]{0, 1, 15, 63, 64, 65, 200, 1000};
+
+// the section of bits 3 to 5 takes few values, so every value is selected often
+template<typename DataType>
+vector<BitVector<DataType>> make_vectors(size_t size)
+{
+	mt19937_64 engine(size);
+	vector<BitVector<DataType>> bvecs;
+	for ( size_t i = 0; i < size; ++i ) {
+		bvecs.emplace_back(static_cast<DataType>(engine()));
+	}
+	return bvecs;
+}
+
+template<typename DataType>
+vector<typename BitVector<DataType>::Section> make_sections()
+{
+	using BVec = BitVector<DataType>;
+	constexpr unsigned int bits = sizeof(DataType) * CHAR_BIT;
+	return {BVec::create_section(0), BVec::create_section(3, 5), BVec::create_section(bits / 2, bits - 1),
+			BVec::create_section(0, bits - 1)};
+}
+
+} // unnamed namespace
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(get_sections_1, DataType, test_types)
+{
+	for_each_isa([] {
+		for ( size_t size : test_sizes ) {
+			const auto bvecs = make_vectors<DataType>(size);
+			for ( const auto &section : make_sections<DataType>() ) {
+				vector<DataType> values(size + 1, 0x5A);
+				aid::get_sections(bvecs.data(), size, section, values.data());
+				for ( size_t i = 0; i < size; ++i ) {
+					BOOST_REQUIRE_EQUAL(bvecs[i].get(section), values[i]);
+				}
+				BOOST_CHECK_EQUAL(0x5A, values[size]);
+			}
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(select_sections_1, DataType, test_types)
+{
+	for_each_isa([] {
+		for ( size_t size : test_sizes ) {
+			const auto bvecs = make_vectors<DataType>(size);
+			for ( const auto &section : make_sections<DataType>() ) {
+				for ( DataType value : {DataType{0}, DataType{1}, DataType{5}} ) {
+					DynamicBitVector selection(3, true);
+					const size_t selected = aid::select_sections(bvecs.data(), size, section, value, selection);
+					BOOST_REQUIRE_EQUAL(size, selection.size());
+					size_t expected_selected = 0;
+					for ( size_t i = 0; i < size; ++i ) {
+						const bool expected = bvecs[i].get(section) == value;
+						BOOST_REQUIRE_EQUAL(expected, selection[i]);
+						expected_selected += expected;
+					}
+					BOOST_CHECK_EQUAL(expected_selected, selected);
+					BOOST_CHECK_EQUAL(selected, selection.count());
+				}
+			}
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(set_sections_1, DataType, test_types)
+{
+	using BVec = BitVector<DataType>;
+	for_each_isa([] {
+		for ( size_t size : test_sizes ) {
+			const auto original = make_vectors<DataType>(size);
+			const auto section = BVec::create_section(3, 5);
+			DynamicBitVector selection;
+			aid::select_sections(original.data(), size, section, DataType{2}, selection);
+
+			// the selected elements are set, the others are left alone
+			auto bvecs = original;
+			aid::set_sections(bvecs.data(), size, BVec::create_section(0, 1), DataType{3}, selection);
+			for ( size_t i = 0; i < size; ++i ) {
+				BVec expected = original[i];
+				if ( selection[i] ) {
+					expected.set(BVec::create_section(0, 1), 3);
+				}
+				BOOST_REQUIRE(expected == bvecs[i]);
+			}
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(exception_1)
+{
+	using BVec = BitVector<uint32_t>;
+	const auto section = BVec::create_section(4, 7);
+	vector<BVec> bvecs(10, BVec(0xF0));
+	uint32_t values[10];
+	DynamicBitVector selection;
+
+	// a value which does not fit selects nothing
+	BOOST_CHECK_EQUAL(10u, aid::select_sections(bvecs.data(), 10, section, 15u, selection));
+	BOOST_CHECK_EQUAL(0u, aid::select_sections(bvecs.data(), 10, section, 31u, selection));
+	BOOST_CHECK(selection.none());
+
+	BOOST_CHECK_THROW(aid::get_sections<uint32_t>(nullptr, 1, section, values), invalid_argument);
+	BOOST_CHECK_THROW(aid::get_sections<uint32_t>(bvecs.data(), 1, section, nullptr), invalid_argument);
+	BOOST_CHECK_THROW(aid::select_sections<uint32_t>(nullptr, 1, section, 0, selection), invalid_argument);
+	BOOST_CHECK_THROW(aid::set_sections(bvecs.data(), 9, section, 0u, selection), invalid_argument);
+	aid::get_sections<uint32_t>(nullptr, 0, section, nullptr);
+
+#ifndef NDEBUG
+	BOOST_CHECK_THROW(aid::set_sections(bvecs.data(), 10, section, 16u, selection), overflow_error);
+#endif
+}
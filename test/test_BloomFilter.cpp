@@ -0,0 +1,118 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE BloomFilter
+#include <boost/test/unit_test.hpp>
+
+#include "aid/BloomFilter.hpp"
+#include "aid/Hash.hpp"
+#include "IsaTest.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using aid::BloomFilter;
+using aid::DynamicBitVector;
+
+
+namespace {
+
+vector<uint64_t> make_hashes(uint64_t first, size_t count)
+{
+	vector<uint64_t> hashes;
+	for ( uint64_t key = first; key < first + count; ++key ) {
+		hashes.push_back(aid::hash_word(key));
+	}
+	return hashes;
+}
+
+// the rate of the absent keys which are found, with bits_per_key
+double false_positive_rate(size_t bits_per_key)
+{
+	const size_t count = 20000;
+	BloomFilter filter(count * bits_per_key);
+	const vector<uint64_t> inserted = make_hashes(0, count);
+	filter.insert(inserted.data(), inserted.size());
+	const vector<uint64_t> absent = make_hashes(count, 10 * count);
+	DynamicBitVector result;
+	return static_cast<double>(filter.contains(absent.data(), absent.size(), result)) / absent.size();
+}
+
+} // unnamed namespace
+
+
+BOOST_AUTO_TEST_CASE(insert_1)
+{
+	BloomFilter filter(1000);
+	BOOST_CHECK_EQUAL(1024u, filter.size());
+	BOOST_CHECK(filter.bits().none());
+
+	for ( uint64_t key = 0; key < 50; ++key ) {
+		filter.insert(aid::hash_word(key));
+	}
+	for ( uint64_t key = 0; key < 50; ++key ) {
+		BOOST_CHECK(filter.contains(aid::hash_word(key)));
+	}
+	// a key sets at most 8 bits
+	BOOST_CHECK(filter.bits().count() <= 50 * 8);
+
+	filter.clear();
+	BOOST_CHECK(filter.bits().none());
+	BOOST_CHECK(!filter.contains(aid::hash_word(0)));
+}
+
+BOOST_AUTO_TEST_CASE(bulk_1)
+{
+	for_each_isa([] {
+		for ( size_t count : {size_t{0}, size_t{1}, size_t{63}, size_t{64}, size_t{100}, size_t{5000}} ) {
+			const vector<uint64_t> hashes = make_hashes(0, count);
+			BloomFilter bulk(count * 10);
+			bulk.insert(hashes.data(), hashes.size());
+			BloomFilter single(count * 10);
+			for ( uint64_t hash : hashes ) {
+				single.insert(hash);
+			}
+			BOOST_CHECK(bulk == single);
+
+			// the inserted keys are all found, and the bulk test agrees with the single one
+			const vector<uint64_t> queries = make_hashes(count / 2, count);
+			DynamicBitVector result(7, true);
+			const size_t found = bulk.contains(queries.data(), queries.size(), result);
+			BOOST_REQUIRE_EQUAL(count, result.size());
+			BOOST_CHECK_EQUAL(found, result.count());
+			for ( size_t i = 0; i < count; ++i ) {
+				BOOST_REQUIRE_EQUAL(single.contains(queries[i]), result[i]);
+				if ( i < count - count / 2 ) {
+					BOOST_REQUIRE(result[i]);
+				}
+			}
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(false_positive_1)
+{
+	BOOST_CHECK_LT(false_positive_rate(10), 0.015);
+	BOOST_CHECK_LT(false_positive_rate(16), 0.002);
+}
+
+BOOST_AUTO_TEST_CASE(merge_1)
+{
+	const vector<uint64_t> hashes = make_hashes(0, 200);
+	BloomFilter all(4096), first(4096), second(4096);
+	all.insert(hashes.data(), hashes.size());
+	first.insert(hashes.data(), 100);
+	second.insert(hashes.data() + 100, 100);
+	BOOST_CHECK(first != all);
+	first |= second;
+	BOOST_CHECK(first == all);
+
+	BloomFilter other(8192);
+	BOOST_CHECK_THROW(first |= other, invalid_argument);
+	DynamicBitVector result;
+	BOOST_CHECK_THROW(first.insert(nullptr, 1), invalid_argument);
+	BOOST_CHECK_THROW(first.contains(nullptr, 1, result), invalid_argument);
+	BOOST_CHECK_EQUAL(256u, BloomFilter(0).size());
+}
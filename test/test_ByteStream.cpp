@@ -0,0 +1,161 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ByteStream
+#include <boost/test/unit_test.hpp>
+
+#include "aid/ByteStream.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+
+namespace {
+
+aid::ByteSource make_memory_source(const vector<unsigned char> &bytes, size_t step)
+{
+	size_t offset = 0;
+	return [&bytes, offset, step](unsigned char *buffer, size_t size) mutable -> size_t {
+		size_t n = bytes.size() - offset;
+		if ( n > size ) n = size;
+		if ( n > step ) n = step;
+		memcpy(buffer, bytes.data() + offset, n);
+		offset += n;
+		return n;
+	};
+}
+
+} // unnamed namespace
+
+
+BOOST_AUTO_TEST_CASE(reader_memory_1)
+{
+	const unsigned char bytes[]{0x12,0x34, 0x89,0xAB,0xCD,0xEF, 0xFF,0xFE, 0x01,0x02,0x03};
+	aid::ByteReader<aid::EndianType::big> reader(bytes, sizeof(bytes));
+
+	uint16_t a;
+	uint32_t b;
+	int16_t c;
+	reader.read(a).read(b).read(c);
+	BOOST_CHECK_EQUAL(0x1234u, a);
+	BOOST_CHECK_EQUAL(0x89ABCDEFu, b);
+	BOOST_CHECK_EQUAL(-2, c);
+	BOOST_CHECK_EQUAL(8u, reader.position());
+
+	BOOST_CHECK_EQUAL(0x010203u, reader.read<uint32_t>(3));
+	BOOST_CHECK(reader.eof());
+	BOOST_CHECK_THROW(reader.read<uint8_t>(), out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(reader_unchecked_1)
+{
+	const unsigned char bytes[]{0x01,0x02,0x03,0x04, 0x05,0x06};
+	aid::ByteReader<aid::EndianType::little> reader(bytes, sizeof(bytes));
+
+	BOOST_REQUIRE(reader.ensure(6));
+	uint32_t a;
+	uint16_t b;
+	reader.read_unchecked(a).read_unchecked(b);
+	BOOST_CHECK_EQUAL(0x04030201u, a);
+	BOOST_CHECK_EQUAL(0x0605u, b);
+	BOOST_CHECK(!reader.ensure(1));
+}
+
+BOOST_AUTO_TEST_CASE(reader_source_1)
+{
+	vector<unsigned char> bytes;
+	for ( unsigned int i = 0; i < 1000; ++i ) {
+		bytes.push_back(static_cast<unsigned char>(i >> 8));
+		bytes.push_back(static_cast<unsigned char>(i));
+	}
+
+	for ( size_t buffer_size : {1u, 3u, 16u, 4096u} ) {
+		aid::ByteReader<aid::EndianType::big> reader(make_memory_source(bytes, 7), buffer_size);
+		for ( unsigned int i = 0; i < 500; ++i ) {
+			BOOST_REQUIRE_EQUAL(i, reader.read<uint16_t>());
+		}
+
+		vector<uint16_t> values(500);
+		reader.read_n(values.data(), values.size());
+		for ( unsigned int i = 0; i < 500; ++i ) {
+			BOOST_REQUIRE_EQUAL(500 + i, values[i]);
+		}
+		BOOST_CHECK_EQUAL(bytes.size(), reader.position());
+		BOOST_CHECK(reader.eof());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(reader_file_1)
+{
+	FILE *file = tmpfile();
+	BOOST_REQUIRE(file);
+	const unsigned char bytes[]{0xCA,0xFE,0xBA,0xBE, 0x00,0x10};
+	fwrite(bytes, 1, sizeof(bytes), file);
+	rewind(file);
+
+	aid::ByteReader<aid::EndianType::big> reader(aid::make_file_source(file));
+	BOOST_CHECK_EQUAL(0xCAFEBABEu, reader.read<uint32_t>());
+	reader.skip(1);
+	BOOST_CHECK_EQUAL(0x10u, reader.read<uint8_t>());
+	BOOST_CHECK(reader.eof());
+	fclose(file);
+}
+
+BOOST_AUTO_TEST_CASE(writer_memory_1)
+{
+	unsigned char bytes[8];
+	aid::ByteWriter<aid::EndianType::big> writer(bytes, sizeof(bytes));
+	writer.write(uint16_t{0x1234}).write(uint32_t{0x89ABCDEF}).write(int16_t{-2});
+	BOOST_CHECK_EQUAL(8u, writer.position());
+	BOOST_CHECK_THROW(writer.write(uint8_t{0}), out_of_range);
+
+	const unsigned char expected[]{0x12,0x34, 0x89,0xAB,0xCD,0xEF, 0xFF,0xFE};
+	BOOST_CHECK(memcmp(expected, bytes, sizeof(bytes)) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(writer_sink_1)
+{
+	vector<unsigned char> bytes;
+	{
+		aid::ByteWriter<aid::EndianType::little> writer(aid::make_vector_sink(bytes), 5);
+		for ( uint32_t i = 0; i < 100; ++i ) {
+			writer.write(i);
+		}
+		vector<uint16_t> values(100, 0xABCD);
+		writer.write_n(values.data(), values.size());
+		writer.write(uint32_t{0x00ABCDEF}, 3);
+	}
+	BOOST_REQUIRE_EQUAL(100 * 4 + 100 * 2 + 3u, bytes.size());
+
+	aid::ByteReader<aid::EndianType::little> reader(bytes.data(), bytes.size());
+	for ( uint32_t i = 0; i < 100; ++i ) {
+		BOOST_REQUIRE_EQUAL(i, reader.read<uint32_t>());
+	}
+	for ( int i = 0; i < 100; ++i ) {
+		BOOST_REQUIRE_EQUAL(0xABCDu, reader.read<uint16_t>());
+	}
+	BOOST_CHECK_EQUAL(0x00ABCDEFu, reader.read<uint32_t>(3));
+}
+
+BOOST_AUTO_TEST_CASE(dynamic_1)
+{
+	for ( auto type : {aid::EndianType::little, aid::EndianType::big} ) {
+		vector<unsigned char> bytes;
+		{
+			aid::DynamicByteWriter writer(aid::make_vector_sink(bytes), 16, type);
+			writer.write(uint32_t{0x01020304}).write(int64_t{-5});
+		}
+		BOOST_CHECK_EQUAL(type == aid::EndianType::big ? 0x01 : 0x04, bytes[0]);
+
+		aid::DynamicByteReader reader(bytes.data(), bytes.size(), type);
+		BOOST_CHECK_EQUAL(0x01020304u, reader.read<uint32_t>());
+		BOOST_CHECK_EQUAL(-5, reader.read<int64_t>());
+	}
+
+	const unsigned char bytes[1]{};
+	BOOST_CHECK_THROW(aid::DynamicByteReader(bytes, sizeof(bytes), aid::EndianType::unknown), logic_error);
+}
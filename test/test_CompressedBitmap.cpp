@@ -0,0 +1,285 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CompressedBitmap
+#include <boost/test/unit_test.hpp>
+
+#include "aid/CompressedBitmap.hpp"
+#include "IsaTest.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using aid::CompressedBitmap;
+using aid::CompressedBitmapView;
+
+
+namespace {
+
+// sparse chunks, dense chunks and long runs
+vector<uint32_t> make_values(unsigned int seed)
+{
+	mt19937 engine(seed);
+	vector<uint32_t> values;
+	for ( uint32_t i = 0; i < 3000; ++i ) {
+		values.push_back(engine() % (1u << 20));
+	}
+	for ( uint32_t i = 0; i < 20000; ++i ) {
+		values.push_back((5u << 16) | (engine() & 0xFFFF));
+	}
+	const uint32_t first = (9u << 16) + engine() % 1000;
+	for ( uint32_t i = 0; i < 70000; ++i ) {
+		values.push_back(first + i);
+	}
+	values.push_back(0xFFFFFFFF);
+	sort(values.begin(), values.end());
+	values.erase(unique(values.begin(), values.end()), values.end());
+	return values;
+}
+
+CompressedBitmap make_bitmap(const vector<uint32_t> &values)
+{
+	CompressedBitmap bitmap;
+	for ( uint32_t value : values ) {
+		bitmap.add(value);
+	}
+	return bitmap;
+}
+
+template<typename Bitmap>
+vector<uint32_t> values_of(const Bitmap &bitmap)
+{
+	vector<uint32_t> values;
+	bitmap.for_each([&values](uint32_t value) { values.push_back(value); });
+	return values;
+}
+
+template<typename Bitmap>
+void check_equal(const vector<uint32_t> &expected, const Bitmap &actual)
+{
+	BOOST_REQUIRE_EQUAL(expected.size(), actual.cardinality());
+	const vector<uint32_t> values = values_of(actual);
+	BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), values.begin(), values.end());
+}
+
+} // unnamed namespace
+
+
+BOOST_AUTO_TEST_CASE(add_1)
+{
+	CompressedBitmap empty;
+	BOOST_CHECK(empty.empty());
+	BOOST_CHECK_EQUAL(0u, empty.cardinality());
+	BOOST_CHECK(!empty.contains(0));
+
+	const vector<uint32_t> values = make_values(1);
+	CompressedBitmap bitmap = make_bitmap(values);
+	check_equal(values, bitmap);
+	for ( uint32_t value : values ) {
+		BOOST_REQUIRE(bitmap.contains(value));
+	}
+	BOOST_CHECK(!bitmap.contains(0xFFFFFFFE));
+
+	// adding again changes nothing
+	bitmap.add(values.front()).add(values.back());
+	BOOST_CHECK_EQUAL(values.size(), bitmap.cardinality());
+}
+
+BOOST_AUTO_TEST_CASE(remove_1)
+{
+	vector<uint32_t> values = make_values(2);
+	CompressedBitmap bitmap = make_bitmap(values);
+
+	// every other value goes, so the dense chunks turn into arrays
+	vector<uint32_t> kept;
+	for ( size_t i = 0; i < values.size(); ++i ) {
+		if ( i % 2 == 0 ) {
+			bitmap.remove(values[i]);
+		}
+		else {
+			kept.push_back(values[i]);
+		}
+	}
+	bitmap.remove(values[0]);
+	check_equal(kept, bitmap);
+
+	for ( uint32_t value : kept ) {
+		bitmap.remove(value);
+	}
+	BOOST_CHECK(bitmap.empty());
+}
+
+BOOST_AUTO_TEST_CASE(set_operations_1)
+{
+	for_each_isa([] {
+		const vector<uint32_t> x = make_values(3);
+		const vector<uint32_t> y = make_values(4);
+		vector<uint32_t> expected;
+
+		for ( bool runs : {false, true} ) {
+			CompressedBitmap bx = make_bitmap(x);
+			CompressedBitmap by = make_bitmap(y);
+			if ( runs ) {
+				BOOST_CHECK(bx.run_optimize());
+				BOOST_CHECK(by.run_optimize());
+			}
+
+			expected.clear();
+			set_union(x.begin(), x.end(), y.begin(), y.end(), back_inserter(expected));
+			check_equal(expected, bx | by);
+
+			expected.clear();
+			set_intersection(x.begin(), x.end(), y.begin(), y.end(), back_inserter(expected));
+			check_equal(expected, bx & by);
+
+			expected.clear();
+			set_difference(x.begin(), x.end(), y.begin(), y.end(), back_inserter(expected));
+			check_equal(expected, bx - by);
+
+			check_equal(x, bx | bx);
+			check_equal(x, bx & bx);
+			BOOST_CHECK((bx - bx).empty());
+			BOOST_CHECK(bx == make_bitmap(x));
+			BOOST_CHECK(bx != by);
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(run_optimize_1)
+{
+	const vector<uint32_t> values = make_values(5);
+	CompressedBitmap bitmap = make_bitmap(values);
+	const size_t bytes = bitmap.serialized_size();
+
+	BOOST_CHECK(bitmap.run_optimize());
+	BOOST_CHECK_LT(bitmap.serialized_size(), bytes);
+	check_equal(values, bitmap);
+	for ( uint32_t value : values ) {
+		BOOST_REQUIRE(bitmap.contains(value));
+	}
+
+	// a modified run container is expanded
+	bitmap.remove(values.back()).remove(values[values.size() / 2]).add(values[values.size() / 2]);
+	check_equal(vector<uint32_t>(values.begin(), values.end() - 1), bitmap);
+
+	CompressedBitmap sparse;
+	sparse.add(1).add(3);
+	BOOST_CHECK(!sparse.run_optimize());
+}
+
+BOOST_AUTO_TEST_CASE(serialize_1)
+{
+	for ( bool runs : {false, true} ) {
+		const vector<uint32_t> values = make_values(6);
+		CompressedBitmap bitmap = make_bitmap(values);
+		if ( runs ) bitmap.run_optimize();
+
+		const vector<unsigned char> external = bitmap.serialize();
+		BOOST_REQUIRE_EQUAL(bitmap.serialized_size(), external.size());
+		BOOST_CHECK_EQUAL('a', external[0]);
+
+		const CompressedBitmapView view(external.data(), external.size());
+		BOOST_CHECK_EQUAL(bitmap.container_count(), view.container_count());
+		check_equal(values, view);
+		for ( uint32_t value : values ) {
+			BOOST_REQUIRE(view.contains(value));
+		}
+		for ( uint32_t value = 0; value < (1u << 20); value += 7 ) {
+			BOOST_REQUIRE_EQUAL(bitmap.contains(value), view.contains(value));
+		}
+
+		BOOST_CHECK(CompressedBitmap(view) == bitmap);
+	}
+
+	const vector<unsigned char> empty = CompressedBitmap().serialize();
+	BOOST_CHECK_EQUAL(8u, empty.size());
+	BOOST_CHECK(CompressedBitmapView(empty.data(), empty.size()).empty());
+	BOOST_CHECK(CompressedBitmap(CompressedBitmapView()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(serialize_e1)
+{
+	CompressedBitmap bitmap;
+	bitmap.add(1).add(70000);
+	vector<unsigned char> external = bitmap.serialize();
+
+	BOOST_CHECK_THROW(bitmap.serialize(nullptr), invalid_argument);
+	BOOST_CHECK_THROW(CompressedBitmapView(nullptr, 0), invalid_argument);
+	BOOST_CHECK_THROW(CompressedBitmapView(external.data(), 7), invalid_argument);
+	BOOST_CHECK_THROW(CompressedBitmapView(external.data(), 8 + 16), invalid_argument);
+	BOOST_CHECK_THROW(CompressedBitmapView(external.data(), external.size() - 1), invalid_argument);
+
+	vector<unsigned char> broken = external;
+	broken[0] = 'x';
+	BOOST_CHECK_THROW(CompressedBitmapView(broken.data(), broken.size()), invalid_argument);
+	broken = external;
+	broken[8 + 2] = 7;		// the kind of the first container
+	BOOST_CHECK_THROW(CompressedBitmapView(broken.data(), broken.size()), invalid_argument);
+	broken = external;
+	broken[8 + 16] = 0;		// the key of the second container
+	BOOST_CHECK_THROW(CompressedBitmapView(broken.data(), broken.size()), invalid_argument);
+
+	// a view does not read the payloads, but a CompressedBitmap checks them, as it trusts its containers
+	const auto payload = [](vector<unsigned char> &data) {
+		return data.data() + (data[8 + 8] | data[8 + 9] << 8 | data[8 + 10] << 16 | data[8 + 11] << 24);
+	};
+	const auto deserialize = [](const vector<unsigned char> &data) {
+		const CompressedBitmapView view(data.data(), data.size());
+		return CompressedBitmap(view);
+	};
+	CompressedBitmap array;
+	array.add(3).add(5);
+	external = array.serialize();
+	broken = external;
+	payload(broken)[0] = 5;		// (5, 5)
+	BOOST_CHECK_NO_THROW(CompressedBitmapView(broken.data(), broken.size()));
+	BOOST_CHECK_THROW(deserialize(broken), invalid_argument);
+
+	CompressedBitmap words;
+	for ( uint32_t value = 0; value < 10000; value += 2 ) {
+		words.add(value);
+	}
+	external = words.serialize();
+	BOOST_CHECK(deserialize(external) == words);
+	broken = external;
+	payload(broken)[0] = 0xFF;	// 4 more values than the cardinality
+	BOOST_CHECK_NO_THROW(CompressedBitmapView(broken.data(), broken.size()));
+	BOOST_CHECK_THROW(deserialize(broken), invalid_argument);
+
+	CompressedBitmap runs;
+	for ( uint32_t value = 10; value <= 200; ++value ) {
+		runs.add(value);
+	}
+	runs.add(300);
+	BOOST_REQUIRE(runs.run_optimize());
+	external = runs.serialize();
+	BOOST_CHECK(deserialize(external) == runs);
+	broken = external;
+	fill_n(payload(broken), 4, 0xFF);	// the run (0xFFFF, 0xFFFF)
+	BOOST_CHECK_NO_THROW(CompressedBitmapView(broken.data(), broken.size()));
+	BOOST_CHECK_THROW(deserialize(broken), invalid_argument);
+	broken = external;
+	payload(broken)[4] = 201;	// the second run (300) is adjacent to the first
+	payload(broken)[5] = 0;
+	BOOST_CHECK_THROW(deserialize(broken), invalid_argument);
+	broken = external;
+	payload(broken)[2] = 191;	// one more value than the cardinality
+	BOOST_CHECK_THROW(deserialize(broken), invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(sparse_1)
+{
+	// 1M ids at 0.5% density
+	mt19937 engine(7);
+	CompressedBitmap bitmap;
+	for ( size_t i = 0; i < 1000000; ++i ) {
+		bitmap.add(static_cast<uint32_t>(engine() % 200000000));
+	}
+	BOOST_CHECK_LT(bitmap.memory_bytes(), 200000000 / 8 / 5);
+	BOOST_CHECK_LT(bitmap.serialized_size(), 200000000 / 8 / 5);
+}
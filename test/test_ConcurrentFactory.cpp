@@ -0,0 +1,171 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ConcurrentFactory
+#include <boost/mpl/list.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "aid/ConcurrentFactory.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+using namespace std;
+
+
+struct MyAbstractProduct
+{
+	int i;
+	double d;
+	MyAbstractProduct(int i, double d): i{i}, d{d} {}
+	virtual ~MyAbstractProduct() = default;
+};
+
+using MyAbstractProductPtr = unique_ptr<MyAbstractProduct>;
+
+struct MyProductA: MyAbstractProduct
+{
+	MyProductA(int i, double d): MyAbstractProduct(i, d) {}
+};
+
+MyAbstractProductPtr create_a(int i, double d) {
+	return MyAbstractProductPtr(new MyProductA(i, d));
+}
+
+struct MyProductB: MyAbstractProduct
+{
+	MyProductB(int i, double d): MyAbstractProduct(i, d) {}
+};
+
+using MyProductCreator = function<MyAbstractProductPtr(int, double)>;
+using MyFactory = aid::ConcurrentFactory<MyAbstractProductPtr, string, MyProductCreator>;
+using MyHashFactory = aid::ConcurrentFactory<MyAbstractProductPtr, string, MyProductCreator,
+											 aid::DefaultFactoryError, aid::HashFactoryLookup>;
+using MyFrozenFactory = aid::ConcurrentFactory<MyAbstractProductPtr, string, MyProductCreator,
+											   aid::DefaultFactoryError, aid::FrozenFactoryLookup>;
+using MyFactories = boost::mpl::list<MyFactory, MyHashFactory, MyFrozenFactory>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(register_1, Factory, MyFactories)
+{
+	Factory factory;
+	BOOST_CHECK(factory.registered_ids().empty());
+	BOOST_CHECK(factory.register_creator("MyProductA", create_a));
+	BOOST_CHECK(!factory.register_creator("MyProductA", create_a));
+	BOOST_CHECK(factory.register_creator("MyProductB",
+		[](int i, double d) {
+			 return MyAbstractProductPtr(new MyProductB(i, d));
+		}));
+
+	auto ids = factory.registered_ids();
+	sort(ids.begin(), ids.end());
+	BOOST_CHECK(ids == (vector<string>{"MyProductA", "MyProductB"}));
+
+	auto product_a = factory.create("MyProductA", 2, 3.4);
+	BOOST_CHECK(typeid(*product_a) == typeid(MyProductA));
+	BOOST_CHECK_EQUAL(product_a->i, 2);
+	BOOST_CHECK(typeid(*factory.create("MyProductB", 3, 4.5)) == typeid(MyProductB));
+	BOOST_CHECK_THROW(factory.create("MyProductC", 3, 4.5), typename Factory::error_policy_type::Exception);
+
+	BOOST_CHECK(factory.unregister_creator("MyProductA"));
+	BOOST_CHECK(!factory.unregister_creator("MyProductA"));
+	BOOST_CHECK_THROW(factory.create("MyProductA", 2, 3.4), typename Factory::error_policy_type::Exception);
+
+	factory.clear_creator();
+	BOOST_CHECK(factory.registered_ids().empty());
+	BOOST_CHECK_THROW(factory.create("MyProductB", 3, 4.5), typename Factory::error_policy_type::Exception);
+}
+
+BOOST_AUTO_TEST_CASE(freeze_1)
+{
+	MyFrozenFactory factory;
+	BOOST_CHECK(!factory.freeze());
+	factory.register_creator("MyProductA", create_a);
+	factory.register_creator("MyProductB",
+		[](int i, double d) {
+			 return MyAbstractProductPtr(new MyProductB(i, d));
+		});
+	BOOST_CHECK(factory.freeze());
+	BOOST_CHECK(typeid(*factory.create("MyProductA", 2, 3.4)) == typeid(MyProductA));
+	BOOST_CHECK(typeid(*factory.create("MyProductB", 3, 4.5)) == typeid(MyProductB));
+	BOOST_CHECK_THROW(factory.create("MyProductC", 3, 4.5), MyFrozenFactory::error_policy_type::Exception);
+}
+
+// an update returns after the snapshots which it replaces are deleted
+BOOST_AUTO_TEST_CASE(retire_1)
+{
+	using IntFactory = aid::ConcurrentFactory<int, int, function<int()>>;
+	IntFactory factory;
+	const auto token = make_shared<int>(1);
+	factory.register_creator(1, [token]() { return *token; });
+	BOOST_CHECK_EQUAL(factory.create(1), 1);
+	BOOST_CHECK_EQUAL(token.use_count(), 2);
+
+	factory.register_creator(2, []() { return 2; });
+	BOOST_CHECK_EQUAL(token.use_count(), 2);
+
+	factory.unregister_creator(1);
+	BOOST_CHECK_EQUAL(token.use_count(), 1);
+	BOOST_CHECK_EQUAL(factory.create(2), 2);
+}
+
+// readers create while a writer registers and unregisters
+BOOST_AUTO_TEST_CASE(concurrent_1)
+{
+	using IntFactory = aid::ConcurrentFactory<int, int, function<int()>, aid::DefaultFactoryError,
+											  aid::HashFactoryLookup>;
+	constexpr int stable_count = 64;
+	constexpr int changing_first = 1000;
+	constexpr int changing_count = 16;
+
+	IntFactory factory;
+	for ( int id = 0; id < stable_count; ++id ) {
+		factory.register_creator(id, [id]() { return id; });
+	}
+
+	constexpr unsigned int reader_count = 8;
+	atomic<unsigned int> running{reader_count};
+	atomic<unsigned long> errors{0};
+	atomic<unsigned long> found{0};
+	vector<thread> readers;
+	for ( unsigned int t = 0; t < reader_count; ++t ) {
+		readers.emplace_back([&, t]() {
+			for ( unsigned long n = t; n < t + 200000; ++n ) {
+				const int stable = static_cast<int>(n % stable_count);
+				if ( factory.create(stable) != stable ) ++errors;
+
+				const int changing = changing_first + static_cast<int>(n % changing_count);
+				try {
+					if ( factory.create(changing) != changing ) ++errors;
+					++found;
+				}
+				catch ( const IntFactory::error_policy_type::Exception & ) {
+				}
+			}
+			--running;
+		});
+	}
+
+	// (the readers may run one at a time, so the writer runs as long as they do)
+	unsigned int rounds = 0;
+	for ( ; running.load() > 0; ++rounds ) {
+		for ( int id = changing_first; id < changing_first + changing_count; ++id ) {
+			BOOST_REQUIRE(factory.register_creator(id, [id]() { return id; }));
+		}
+		for ( int id = changing_first; id < changing_first + changing_count; ++id ) {
+			BOOST_REQUIRE(factory.unregister_creator(id));
+		}
+	}
+	for ( auto &reader : readers ) {
+		reader.join();
+	}
+
+	BOOST_CHECK_EQUAL(errors.load(), 0u);
+	BOOST_CHECK_EQUAL(factory.registered_ids().size(), stable_count);
+	BOOST_TEST_MESSAGE(rounds << " rounds; found the changing ids " << found.load() << " times");
+}
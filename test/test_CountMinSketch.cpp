@@ -0,0 +1,83 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE CountMinSketch
+#include <boost/test/unit_test.hpp>
+
+#include "aid/CountMinSketch.hpp"
+#include "aid/Hash.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+using aid::CountMinSketch;
+
+
+BOOST_AUTO_TEST_CASE(construct_e1)
+{
+	BOOST_CHECK_THROW(CountMinSketch(0, 4), invalid_argument);
+	BOOST_CHECK_THROW(CountMinSketch(100, 0), invalid_argument);
+	BOOST_CHECK_THROW(CountMinSketch(100, 17), invalid_argument);
+	BOOST_CHECK_THROW(CountMinSketch((size_t{1} << 32) + 1, 1), length_error);
+}
+
+BOOST_AUTO_TEST_CASE(add_1)
+{
+	CountMinSketch sketch(64, 4);
+	BOOST_CHECK_EQUAL(64u, sketch.width());
+	BOOST_CHECK_EQUAL(4u, sketch.depth());
+	BOOST_CHECK_EQUAL(0u, sketch.estimate(aid::hash_word(1)));
+
+	sketch.add(aid::hash_word(1));
+	sketch.add(aid::hash_word(1));
+	sketch.add(aid::hash_word(2), 5);
+	BOOST_CHECK_EQUAL(7u, sketch.total());
+	BOOST_CHECK(sketch.estimate(aid::hash_word(1)) >= 2);
+	BOOST_CHECK(sketch.estimate(aid::hash_word(2)) >= 5);
+	BOOST_CHECK(sketch.estimate(aid::hash_word(1)) + sketch.estimate(aid::hash_word(2)) <= 2 * 7);
+
+	sketch.clear();
+	BOOST_CHECK_EQUAL(0u, sketch.total());
+	BOOST_CHECK_EQUAL(0u, sketch.estimate(aid::hash_word(2)));
+}
+
+// the estimates are never less than the counts, and rarely more than e / width of the total above
+BOOST_AUTO_TEST_CASE(estimate_1)
+{
+	const size_t width = 2719;
+	const uint64_t key_count = 20000;
+	CountMinSketch sketch(width, 5);
+	for ( uint64_t key = 0; key < key_count; ++key ) {
+		// a few heavy keys among many light ones
+		sketch.add(aid::hash_word(key), key % 1000 == 0 ? 1000 : 1);
+	}
+
+	const uint64_t bound = sketch.total() / 1000;
+	size_t over = 0;
+	for ( uint64_t key = 0; key < key_count; ++key ) {
+		const uint64_t count = key % 1000 == 0 ? 1000 : 1;
+		const uint64_t estimate = sketch.estimate(aid::hash_word(key));
+		BOOST_REQUIRE(estimate >= count);
+		if ( estimate - count > bound ) ++over;
+	}
+	// at most exp(-5) = 0.7% of the keys
+	BOOST_CHECK(over < key_count * 7 / 1000);
+}
+
+BOOST_AUTO_TEST_CASE(merge_1)
+{
+	CountMinSketch all(256, 4), even(256, 4), odd(256, 4);
+	for ( uint64_t key = 0; key < 1000; ++key ) {
+		all.add(aid::hash_word(key), key);
+		(key % 2 == 0 ? even : odd).add(aid::hash_word(key), key);
+	}
+	BOOST_CHECK(even != all);
+	even += odd;
+	BOOST_CHECK(even == all);
+	BOOST_CHECK_EQUAL(all.total(), even.total());
+
+	CountMinSketch narrow(128, 4), shallow(256, 3);
+	BOOST_CHECK_THROW(all += narrow, invalid_argument);
+	BOOST_CHECK_THROW(all += shallow, invalid_argument);
+}
@@ -0,0 +1,245 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE DynamicBitVector
+#include <boost/test/unit_test.hpp>
+
+#include "aid/DynamicBitVector.hpp"
+#include "IsaTest.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using aid::BitOp;
+using aid::DynamicBitVector;
+
+
+namespace {
+
+const size_t test_sizes[]{0, 1, 63, 64, 65, 511, 512, 513, 1000, 4099};
+const BitOp test_ops[]{BitOp::and_, BitOp::or_, BitOp::xor_, BitOp::and_not};
+
+vector<bool> make_bools(size_t size, unsigned int seed)
+{
+	mt19937 engine(seed);
+	vector<bool> bools(size);
+	for ( size_t i = 0; i < size; ++i ) {
+		bools[i] = engine() % 3 == 0;
+	}
+	return bools;
+}
+
+DynamicBitVector make_bvec(const vector<bool> &bools)
+{
+	DynamicBitVector bvec(bools.size());
+	for ( size_t i = 0; i < bools.size(); ++i ) {
+		bvec.set(i, bools[i]);
+	}
+	return bvec;
+}
+
+bool apply(BitOp op, bool x, bool y)
+{
+	switch ( op ) {
+	case BitOp::and_:		return x && y;
+	case BitOp::or_:		return x || y;
+	case BitOp::xor_:		return x != y;
+	case BitOp::and_not:	return x && !y;
+	}
+	return x;
+}
+
+void check_equal(const vector<bool> &expected, const DynamicBitVector &actual)
+{
+	BOOST_REQUIRE_EQUAL(expected.size(), actual.size());
+	size_t count = 0;
+	for ( size_t i = 0; i < expected.size(); ++i ) {
+		BOOST_CHECK_EQUAL(expected[i], actual[i]);
+		count += expected[i] ? 1 : 0;
+	}
+	BOOST_CHECK_EQUAL(count, actual.count());
+}
+
+} // unnamed namespace
+
+
+BOOST_AUTO_TEST_CASE(construct_1)
+{
+	DynamicBitVector empty;
+	BOOST_CHECK(empty.empty());
+	BOOST_CHECK_EQUAL(0u, empty.count());
+	BOOST_CHECK(empty.none());
+	BOOST_CHECK(empty.all());
+
+	for ( size_t size : test_sizes ) {
+		DynamicBitVector zeros(size);
+		BOOST_CHECK_EQUAL(size, zeros.size());
+		BOOST_CHECK_EQUAL(0u, zeros.count());
+		BOOST_CHECK_EQUAL(0u, zeros.word_size() % 8);
+		BOOST_CHECK_EQUAL(0u, reinterpret_cast<uintptr_t>(zeros.data()) % 64);
+
+		DynamicBitVector ones(size, true);
+		BOOST_CHECK_EQUAL(size, ones.count());
+		BOOST_CHECK(ones.all());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(set_1)
+{
+	DynamicBitVector bvec(130);
+	bvec.set(0).set(64).set(129);
+	BOOST_CHECK(bvec.test(0));
+	BOOST_CHECK(!bvec.test(1));
+	BOOST_CHECK(bvec.test(64));
+	BOOST_CHECK(bvec.test(129));
+	BOOST_CHECK_EQUAL(3u, bvec.count());
+
+	bvec.reset(64);
+	BOOST_CHECK(!bvec.test(64));
+	bvec.flip(64).flip(0);
+	BOOST_CHECK(bvec.test(64));
+	BOOST_CHECK(!bvec.test(0));
+	bvec.set(1, false);
+	BOOST_CHECK(!bvec.test(1));
+
+	BOOST_CHECK_THROW(bvec.test(130), out_of_range);
+	BOOST_CHECK_THROW(bvec.set(130), out_of_range);
+	BOOST_CHECK_THROW(bvec.reset(130), out_of_range);
+	BOOST_CHECK_THROW(bvec.flip(130), out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(resize_1)
+{
+	DynamicBitVector bvec(70, true);
+	bvec.resize(100, false);
+	BOOST_CHECK_EQUAL(70u, bvec.count());
+	BOOST_CHECK(!bvec.test(70));
+
+	bvec.resize(200, true);
+	BOOST_CHECK_EQUAL(170u, bvec.count());
+	BOOST_CHECK(!bvec.test(99));
+	BOOST_CHECK(bvec.test(100));
+	BOOST_CHECK(bvec.test(199));
+
+	// the dropped bits do not come back
+	bvec.resize(65);
+	BOOST_CHECK_EQUAL(65u, bvec.count());
+	bvec.resize(200);
+	BOOST_CHECK_EQUAL(65u, bvec.count());
+
+	bvec.clear();
+	BOOST_CHECK(bvec.empty());
+}
+
+BOOST_AUTO_TEST_CASE(flip_1)
+{
+	for_each_isa([] {
+		for ( size_t size : test_sizes ) {
+			vector<bool> bools = make_bools(size, 1);
+			DynamicBitVector bvec = make_bvec(bools);
+
+			const DynamicBitVector inverted = ~bvec;
+			bools.flip();
+			check_equal(bools, inverted);
+
+			bvec.flip();
+			BOOST_CHECK(inverted == bvec);
+			bvec.reset();
+			BOOST_CHECK_EQUAL(0u, bvec.count());
+			bvec.set();
+			BOOST_CHECK_EQUAL(size, bvec.count());
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(apply_1)
+{
+	for_each_isa([] {
+		for ( size_t size : test_sizes ) {
+			const vector<bool> x = make_bools(size, 1);
+			const vector<bool> y = make_bools(size, 2);
+			for ( BitOp op : test_ops ) {
+				vector<bool> expected(size);
+				size_t count = 0;
+				for ( size_t i = 0; i < size; ++i ) {
+					expected[i] = apply(op, x[i], y[i]);
+					count += expected[i] ? 1 : 0;
+				}
+
+				DynamicBitVector bvec = make_bvec(x);
+				BOOST_CHECK_EQUAL(count, bvec.count(op, make_bvec(y)));
+				bvec.apply(op, make_bvec(y));
+				check_equal(expected, bvec);
+			}
+
+			BOOST_CHECK(((make_bvec(x) & make_bvec(y)) ^ make_bvec(x)) == (make_bvec(x) & ~make_bvec(y)));
+			BOOST_CHECK((make_bvec(x) | make_bvec(y)) == ~(~make_bvec(x) & ~make_bvec(y)));
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(fused_1)
+{
+	for_each_isa([] {
+		for ( size_t size : test_sizes ) {
+			const vector<bool> x = make_bools(size, 1);
+			const vector<bool> y = make_bools(size, 2);
+			const vector<bool> z = make_bools(size, 3);
+			for ( BitOp outer : test_ops ) {
+				for ( BitOp inner : test_ops ) {
+					vector<bool> expected(size);
+					for ( size_t i = 0; i < size; ++i ) {
+						expected[i] = apply(outer, x[i], apply(inner, y[i], z[i]));
+					}
+
+					DynamicBitVector bvec = make_bvec(x);
+					bvec.apply(outer, make_bvec(y), inner, make_bvec(z));
+					check_equal(expected, bvec);
+				}
+			}
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(apply_e1)
+{
+	DynamicBitVector a(10), b(11);
+	BOOST_CHECK_THROW(a &= b, invalid_argument);
+	BOOST_CHECK_THROW(a.count(BitOp::and_, b), invalid_argument);
+	BOOST_CHECK_THROW(a.apply(BitOp::and_, a, BitOp::or_, b), invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(find_1)
+{
+	for ( size_t size : test_sizes ) {
+		const vector<bool> bools = make_bools(size, 4);
+		const DynamicBitVector bvec = make_bvec(bools);
+
+		vector<size_t> expected;
+		for ( size_t i = 0; i < size; ++i ) {
+			if ( bools[i] ) expected.push_back(i);
+		}
+
+		vector<size_t> found;
+		for ( size_t i = bvec.find_first(); i != DynamicBitVector::npos; i = bvec.find_next(i) ) {
+			found.push_back(i);
+		}
+		BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), found.begin(), found.end());
+
+		vector<size_t> visited;
+		bvec.for_each_set([&visited](size_t i) { visited.push_back(i); });
+		BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), visited.begin(), visited.end());
+
+		BOOST_CHECK_EQUAL(!expected.empty(), bvec.any());
+	}
+
+	DynamicBitVector bvec(200);
+	BOOST_CHECK_EQUAL(DynamicBitVector::npos, bvec.find_first());
+	bvec.set(199);
+	BOOST_CHECK_EQUAL(199u, bvec.find_first());
+	BOOST_CHECK_EQUAL(199u, bvec.find_next(63));
+	BOOST_CHECK_EQUAL(DynamicBitVector::npos, bvec.find_next(199));
+}
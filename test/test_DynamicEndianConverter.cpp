@@ -0,0 +1,113 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE DynamicEndianConverter
+#include <boost/mpl/list.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "aid/DynamicEndianConverter.hpp"
+
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#define CHECK_EQUAL_COLLECTIONS(x, y) BOOST_CHECK_EQUAL_COLLECTIONS(begin(x), end(x), begin(y), end(y))
+
+
+using namespace std;
+using test_type_list = boost::mpl::list<
+	unsigned short,			short
+	, unsigned int,			int
+	, unsigned long long,	long long
+	>;
+
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(resolve_1, test_type, test_type_list)
+{
+	for ( auto type : {aid::EndianType::little, aid::EndianType::big} ) {
+		const aid::DynamicEndianConverter converter{type};
+
+		for ( size_t size = 1; size <= sizeof(test_type); ++size ) {
+			const auto resolved = converter.resolve<test_type>(size);
+			BOOST_CHECK_EQUAL(size, resolved.size());
+
+			const test_type native = static_cast<test_type>(-0x1234);
+			unsigned char expected[sizeof(test_type)];
+			unsigned char external[sizeof(test_type)];
+			converter.to_external(native, expected, size);
+			resolved.to_external(native, external);
+			BOOST_CHECK(memcmp(expected, external, size) == 0);
+
+			test_type expected_native;
+			converter.from_external(external, size, expected_native);
+			BOOST_CHECK_EQUAL(expected_native, resolved.from_external(external));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(resolve_n_1, test_type, test_type_list)
+{
+	for ( auto type : {aid::EndianType::little, aid::EndianType::big} ) {
+		const aid::DynamicEndianConverter converter{type};
+
+		for ( size_t size = 1; size <= sizeof(test_type); ++size ) {
+			const auto resolved = converter.resolve<test_type>(size);
+
+			vector<test_type> native(37);
+			for ( size_t i = 0; i < native.size(); ++i ) {
+				native[i] = static_cast<test_type>(i * 0x0305 + 1);
+			}
+			vector<unsigned char> external(native.size() * size);
+			resolved.to_external_n(native.data(), native.size(), external.data());
+
+			for ( size_t i = 0; i < native.size(); ++i ) {
+				test_type value;
+				converter.from_external(&external[i * size], size, value);
+				BOOST_CHECK_EQUAL(resolved.from_external(&external[i * size]), value);
+			}
+
+			vector<test_type> back(native.size());
+			resolved.from_external_n(external.data(), back.size(), back.data());
+			for ( size_t i = 0; i < back.size(); ++i ) {
+				BOOST_CHECK_EQUAL(resolved.from_external(&external[i * size]), back[i]);
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(resolve_e1, test_type, test_type_list)
+{
+	aid::DynamicEndianConverter converter;
+	BOOST_CHECK_THROW(converter.resolve<test_type>(), logic_error);
+
+	converter.set_external_type(aid::EndianType::big);
+	BOOST_CHECK_THROW(converter.resolve<test_type>(0), length_error);
+	BOOST_CHECK_THROW(converter.resolve<test_type>(sizeof(test_type) + 1), invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(bulk_1, test_type, test_type_list)
+{
+	const unsigned char big[]{0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0x0A,0x0B,0x0C,0x0D,0x0E,0x0F,0x10};
+	constexpr size_t count{sizeof(big) / sizeof(test_type)};
+
+	const aid::DynamicEndianConverter big_converter{aid::EndianType::big};
+	test_type native[count];
+	big_converter.from_external_n(big, count, native);
+	for ( size_t i = 0; i < count; ++i ) {
+		test_type expected;
+		big_converter.from_external(big + i * sizeof(test_type), sizeof(test_type), expected);
+		BOOST_CHECK_EQUAL(expected, native[i]);
+	}
+
+	const aid::DynamicEndianConverter little_converter{aid::EndianType::little};
+	unsigned char little[sizeof(big)];
+	little_converter.to_external_n(native, count, little);
+	for ( size_t i = 0; i < sizeof(big); ++i ) {
+		BOOST_CHECK_EQUAL(big[i], little[i - i % sizeof(test_type) + sizeof(test_type) - 1 - i % sizeof(test_type)]);
+	}
+
+	aid::DynamicEndianConverter unknown;
+	BOOST_CHECK_THROW(unknown.from_external_n(big, count, native), logic_error);
+	BOOST_CHECK_THROW(unknown.to_external_n(native, count, little), logic_error);
+}
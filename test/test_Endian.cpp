@@ -6,6 +6,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include "aid/Endian.hpp"
+#include "aid/Isa.hpp"
+#include "IsaTest.hpp"
 
 #include <climits>
 #include <cstring>
@@ -13,6 +15,7 @@
 #include <iterator>
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 #define CHECK_EQUAL_COLLECTIONS(x, y) BOOST_CHECK_EQUAL_COLLECTIONS(begin(x), end(x), begin(y), end(y))
 
@@ -276,3 +279,344 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(little_to_native_e1, test_type, test_type_list)
 		BOOST_CHECK_NO_THROW(converter::from_external(little, sizeof(little), integer));
 	}
 }
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(native_to_big_n_1, test_type, test_type_list)
+{
+	using converter = aid::EndianConverter<aid::EndianType::big>;
+	using UInteger = typename make_unsigned<test_type>::type;
+
+	for ( size_t count : {0u, 1u, 3u, 15u, 16u, 17u, 63u, 64u, 65u, 200u} ) {
+		vector<test_type> native(count);
+		for ( size_t i = 0; i < count; ++i ) {
+			native[i] = static_cast<test_type>(static_cast<UInteger>(0xF1E2D3C4B5A69788ull + i * 0x0102030405060708ull));
+		}
+
+		vector<unsigned char> big(count * sizeof(test_type));
+		converter::to_external_n(native.data(), count, big.data());
+
+		vector<unsigned char> expected(count * sizeof(test_type));
+		for ( size_t i = 0; i < count; ++i ) {
+			converter::to_external(native[i], &expected[i * sizeof(test_type)], sizeof(test_type));
+		}
+		CHECK_EQUAL_COLLECTIONS(expected, big);
+	}
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(big_to_native_n_1, test_type, test_type_list)
+{
+	using converter = aid::EndianConverter<aid::EndianType::big>;
+
+	for ( size_t count : {0u, 1u, 3u, 15u, 16u, 17u, 63u, 64u, 65u, 200u} ) {
+		vector<unsigned char> big(count * sizeof(test_type));
+		for ( size_t i = 0; i < big.size(); ++i ) {
+			big[i] = static_cast<unsigned char>(0xFE - i * 7);
+		}
+
+		vector<test_type> native(count);
+		converter::from_external_n(big.data(), count, native.data());
+
+		vector<test_type> expected(count);
+		for ( size_t i = 0; i < count; ++i ) {
+			converter::from_external(&big[i * sizeof(test_type)], sizeof(test_type), expected[i]);
+		}
+		CHECK_EQUAL_COLLECTIONS(expected, native);
+
+		// in place
+		converter::from_external_n(big.data(), count, reinterpret_cast<test_type *>(big.data()));
+		BOOST_CHECK(memcmp(expected.data(), big.data(), big.size()) == 0);
+	}
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(little_n_1, test_type, test_type_list)
+{
+	using converter = aid::EndianConverter<aid::EndianType::little>;
+
+	const test_type native[]{1, 2, 3, 4, 5};
+	unsigned char little[sizeof(native)];
+	converter::to_external_n(native, 5, little);
+
+	test_type back[5];
+	converter::from_external_n(little, 5, back);
+	CHECK_EQUAL_COLLECTIONS(native, back);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(big_n_e1, test_type, test_type_list)
+{
+	using converter = aid::EndianConverter<aid::EndianType::big>;
+
+	test_type native[2]{};
+	unsigned char big[sizeof(native)];
+	BOOST_CHECK_THROW(converter::to_external_n((const test_type *)nullptr, 2, big), invalid_argument);
+	BOOST_CHECK_THROW(converter::to_external_n(native, 2, (unsigned char *)nullptr), invalid_argument);
+	BOOST_CHECK_THROW(converter::from_external_n((const unsigned char *)nullptr, 2, native), invalid_argument);
+	BOOST_CHECK_THROW(converter::from_external_n(big, 2, (test_type *)nullptr), invalid_argument);
+	BOOST_CHECK_NO_THROW(converter::to_external_n((const test_type *)nullptr, 0, (unsigned char *)nullptr));
+	BOOST_CHECK_NO_THROW(converter::from_external_n((const unsigned char *)nullptr, 0, (test_type *)nullptr));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(big_n_isa_1, test_type, test_type_list)
+{
+	using converter = aid::EndianConverter<aid::EndianType::big>;
+
+	constexpr size_t count{131};
+	vector<unsigned char> big(count * sizeof(test_type));
+	for ( size_t i = 0; i < big.size(); ++i ) {
+		big[i] = static_cast<unsigned char>(i * 13 + 5);
+	}
+
+	vector<test_type> expected(count);
+	for ( size_t i = 0; i < count; ++i ) {
+		converter::from_external(&big[i * sizeof(test_type)], sizeof(test_type), expected[i]);
+	}
+
+	for_each_isa([&] {
+		BOOST_CHECK(aid::active_isa() <= aid::supported_isa());
+
+		vector<test_type> native(count);
+		converter::from_external_n(big.data(), count, native.data());
+		CHECK_EQUAL_COLLECTIONS(expected, native);
+	});
+	BOOST_CHECK(aid::supported_isa() == aid::Isa::avx512 || !aid::select_isa(aid::Isa::avx512));
+}
+
+BOOST_AUTO_TEST_CASE(endian_integer_1)
+{
+	struct Header
+	{
+		aid::big_uint16_t		type;
+		aid::big_int24_t		delta;
+		aid::little_uint32_t	length;
+		aid::big_uint48_t		address;
+		aid::little_int64_t		timestamp;
+	};
+	static_assert(is_trivially_copyable<Header>::value, "Header is not trivially copyable");
+	static_assert(alignof(Header) == 1, "alignof(Header) != 1");
+	static_assert(sizeof(Header) == 2 + 3 + 4 + 6 + 8, "Header is padded");
+
+	const unsigned char bytes[]{
+		0x12,0x34
+		, 0xFF,0xFF,0xFE
+		, 0x78,0x56,0x34,0x12
+		, 0x00,0x1B,0x21,0x3C,0x4D,0x5E
+		, 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF
+	};
+	unsigned char buffer[1 + sizeof(bytes)];
+	memcpy(buffer + 1, bytes, sizeof(bytes));
+
+	Header *header = reinterpret_cast<Header *>(buffer + 1);
+	BOOST_CHECK_EQUAL(0x1234u, header->type.get());
+	BOOST_CHECK_EQUAL(-2, header->delta.get());
+	BOOST_CHECK_EQUAL(0x12345678u, header->length);
+	BOOST_CHECK_EQUAL(0x001B213C4D5Eull, header->address.get());
+	BOOST_CHECK_EQUAL(-1, header->timestamp.get());
+
+	header->type = 0xABCD;
+	header->delta = -3;
+	header->length.set(0x01020304u);
+	const unsigned char expected[]{0xAB,0xCD, 0xFF,0xFF,0xFD, 0x04,0x03,0x02,0x01};
+	BOOST_CHECK(memcmp(expected, buffer + 1, sizeof(expected)) == 0);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(fixed_size_1, test_type, test_type_list)
+{
+	using big_converter = aid::EndianConverter<aid::EndianType::big>;
+	using little_converter = aid::EndianConverter<aid::EndianType::little>;
+
+	const unsigned char bytes[]{0xFE,0xDC,0xBA,0x98,0x76,0x54,0x32,0x10};
+	test_type expected;
+	test_type native;
+
+	big_converter::from_external(bytes, 1, expected);
+	big_converter::from_external<1>(bytes, native);
+	BOOST_CHECK_EQUAL(expected, native);
+	little_converter::from_external(bytes, 1, expected);
+	little_converter::from_external<1>(bytes, native);
+	BOOST_CHECK_EQUAL(expected, native);
+
+	unsigned char external[8];
+	big_converter::to_external<1>(native, external);
+	BOOST_CHECK_EQUAL(bytes[0], external[0]);
+	BOOST_CHECK_THROW(big_converter::from_external<1>((const unsigned char *)nullptr, native), invalid_argument);
+	BOOST_CHECK_THROW(big_converter::to_external<1>(native, (unsigned char *)nullptr), invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(fixed_size_2)
+{
+	using big_converter = aid::EndianConverter<aid::EndianType::big>;
+	using little_converter = aid::EndianConverter<aid::EndianType::little>;
+
+	const unsigned char ubytes[]{0xFE,0xDC,0xBA,0x98,0x76,0x54,0x32,0x10};
+	const unsigned char *bytes = ubytes;
+
+	int32_t i24;
+	big_converter::from_external<3>(bytes, i24);
+	BOOST_CHECK_EQUAL(static_cast<int32_t>(0xFFFEDCBA), i24);
+	uint32_t u24;
+	little_converter::from_external<3>(bytes, u24);
+	BOOST_CHECK_EQUAL(0x00BADCFEu, u24);
+
+	int64_t i40;
+	little_converter::from_external<5>(bytes, i40);
+	BOOST_CHECK_EQUAL(0x7698BADCFEll, i40);
+	int64_t i48;
+	big_converter::from_external<6>(bytes, i48);
+	BOOST_CHECK_EQUAL(static_cast<int64_t>(0xFFFFFEDCBA987654ull), i48);
+	uint64_t u56;
+	big_converter::from_external<7>(bytes, u56);
+	BOOST_CHECK_EQUAL(0x00FEDCBA98765432ull, u56);
+
+	for ( size_t size = 1; size <= 8; ++size ) {
+		int64_t expected;
+		big_converter::from_external(bytes, size, expected);
+		int64_t native = 0;
+		switch ( size ) {
+		case 1: big_converter::from_external<1>(bytes, native); break;
+		case 2: big_converter::from_external<2>(bytes, native); break;
+		case 3: big_converter::from_external<3>(bytes, native); break;
+		case 4: big_converter::from_external<4>(bytes, native); break;
+		case 5: big_converter::from_external<5>(bytes, native); break;
+		case 6: big_converter::from_external<6>(bytes, native); break;
+		case 7: big_converter::from_external<7>(bytes, native); break;
+		case 8: big_converter::from_external<8>(bytes, native); break;
+		}
+		BOOST_CHECK_EQUAL(expected, native);
+	}
+
+	unsigned char external[6];
+	big_converter::to_external<6>(i48, external);
+	BOOST_CHECK(memcmp(bytes, external, 6) == 0);
+	little_converter::to_external<3>(u24, external);
+	BOOST_CHECK(memcmp(bytes, external, 3) == 0);
+}
+
+template<size_t t_size, typename Integer, aid::EndianType t_type>
+void check_packed_n()
+{
+	using converter = aid::EndianConverter<t_type>;
+
+	for ( size_t count : {0u, 1u, 2u, 5u, 8u, 9u, 31u, 100u} ) {
+		vector<unsigned char> packed(count * t_size);
+		for ( size_t i = 0; i < packed.size(); ++i ) {
+			packed[i] = static_cast<unsigned char>(i * 37 + 11);
+		}
+
+		vector<Integer> native(count);
+		converter::template from_external_n<t_size>(packed.data(), count, native.data());
+		for ( size_t i = 0; i < count; ++i ) {
+			Integer expected;
+			converter::from_external(&packed[i * t_size], t_size, expected);
+			BOOST_REQUIRE_EQUAL(expected, native[i]);
+		}
+
+		vector<unsigned char> back(packed.size());
+		converter::template to_external_n<t_size>(native.data(), count, back.data());
+		BOOST_CHECK(packed == back);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(packed_n_1)
+{
+	for_each_isa([] {
+		check_packed_n<3, uint32_t, aid::EndianType::big>();
+		check_packed_n<3, int32_t, aid::EndianType::big>();
+		check_packed_n<3, uint32_t, aid::EndianType::little>();
+		check_packed_n<3, int32_t, aid::EndianType::little>();
+		check_packed_n<6, uint64_t, aid::EndianType::big>();
+		check_packed_n<6, int64_t, aid::EndianType::big>();
+		check_packed_n<6, uint64_t, aid::EndianType::little>();
+		check_packed_n<6, int64_t, aid::EndianType::little>();
+		check_packed_n<5, int64_t, aid::EndianType::big>();
+		check_packed_n<3, long long, aid::EndianType::big>();
+	});
+}
+
+BOOST_AUTO_TEST_CASE(floating_point_1)
+{
+	using big_converter = aid::EndianConverter<aid::EndianType::big>;
+	using little_converter = aid::EndianConverter<aid::EndianType::little>;
+
+	{
+		const unsigned char big[]{0x40,0x49,0x0F,0xDB};
+		float native;
+		big_converter::from_external(big, native);
+		BOOST_CHECK_EQUAL(3.14159274f, native);
+
+		unsigned char external[4];
+		big_converter::to_external(native, external);
+		CHECK_EQUAL_COLLECTIONS(big, external);
+	}
+	{
+		const unsigned char little[]{0x18,0x2D,0x44,0x54,0xFB,0x21,0x09,0xC0};
+		double native;
+		little_converter::from_external(little, native);
+		BOOST_CHECK_EQUAL(-3.141592653589793, native);
+
+		unsigned char external[8];
+		little_converter::to_external(native, external);
+		CHECK_EQUAL_COLLECTIONS(little, external);
+	}
+
+	unsigned char external[8];
+	double native = 0;
+	BOOST_CHECK_THROW(big_converter::to_external(native, external, 4), invalid_argument);
+	BOOST_CHECK_THROW(big_converter::from_external(external, 4, native), invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(floating_point_n_1)
+{
+	using converter = aid::EndianConverter<aid::EndianType::big>;
+
+	vector<double> native(77);
+	for ( size_t i = 0; i < native.size(); ++i ) {
+		native[i] = 1.0 / (i + 1) - 0.5;
+	}
+	vector<unsigned char> big(native.size() * sizeof(double));
+	converter::to_external_n(native.data(), native.size(), big.data());
+
+	double first;
+	converter::from_external(big.data(), sizeof(first), first);
+	BOOST_CHECK_EQUAL(native[0], first);
+
+	vector<double> back(native.size());
+	converter::from_external_n(big.data(), back.size(), back.data());
+	BOOST_CHECK(memcmp(native.data(), back.data(), native.size() * sizeof(double)) == 0);
+}
+
+#if		defined(AID_HAS_INT128)
+BOOST_AUTO_TEST_CASE(int128_1)
+{
+	using converter = aid::EndianConverter<aid::EndianType::big>;
+
+	unsigned char big[16];
+	for ( size_t i = 0; i < sizeof(big); ++i ) {
+		big[i] = static_cast<unsigned char>(0xF0 + i);
+	}
+
+	aid::uint128_t unative;
+	converter::from_external(big, unative);
+	BOOST_CHECK(static_cast<uint64_t>(unative >> 64) == 0xF0F1F2F3F4F5F6F7ull);
+	BOOST_CHECK(static_cast<uint64_t>(unative) == 0xF8F9FAFBFCFDFEFFull);
+
+	aid::int128_t snative;
+	converter::from_external(big, 3, snative);
+	BOOST_CHECK(snative == -(aid::int128_t{0x1000000} - 0xF0F1F2));
+
+	unsigned char external[16];
+	converter::to_external(unative, external);
+	CHECK_EQUAL_COLLECTIONS(big, external);
+
+	for_each_isa([] {
+		vector<unsigned char> bigs(16 * 37);
+		for ( size_t i = 0; i < bigs.size(); ++i ) {
+			bigs[i] = static_cast<unsigned char>(i * 3);
+		}
+		vector<aid::uint128_t> natives(37);
+		converter::from_external_n(bigs.data(), natives.size(), natives.data());
+		for ( size_t i = 0; i < natives.size(); ++i ) {
+			aid::uint128_t expected;
+			converter::from_external(&bigs[i * 16], 16, expected);
+			BOOST_REQUIRE(expected == natives[i]);
+		}
+	});
+}
+#endif
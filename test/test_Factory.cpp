@@ -1,11 +1,14 @@
 // -*- tab-width: 4 -*-
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE Factory
+#include <boost/mpl/list.hpp>
 #include <boost/test/test_case_template.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include "aid/Factory.hpp"
+#include "aid/InplaceCreator.hpp"
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <string>
@@ -126,3 +129,185 @@ BOOST_AUTO_TEST_CASE(registered_ids_1)
 	factory.clear_creator();
 	BOOST_CHECK(factory.registered_ids().empty());
 }
+
+using MyHashFactory = aid::Factory<MyAbstractProductPtr, std::string, MyProductCreator,
+								   aid::DefaultFactoryError, aid::HashFactoryLookup>;
+using MyFrozenFactory = aid::Factory<MyAbstractProductPtr, std::string, MyProductCreator,
+									 aid::DefaultFactoryError, aid::FrozenFactoryLookup>;
+using MyFactories = boost::mpl::list<MyFactory, MyHashFactory, MyFrozenFactory>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(lookup_1, Factory, MyFactories)
+{
+	Factory factory;
+	BOOST_CHECK(factory.register_creator("MyProductA", create_a));
+	BOOST_CHECK(!factory.register_creator("MyProductA", create_a));
+	BOOST_CHECK(factory.register_creator("MyProductB",
+		[](int i, double d) {
+			 return MyAbstractProductPtr(new MyProductB(i, d));
+		}));
+
+	auto product_a = factory.create("MyProductA", 2, 3.4);
+	BOOST_CHECK(typeid(*product_a) == typeid(MyProductA));
+	BOOST_CHECK_EQUAL(product_a->i, 2);
+	auto product_b = factory.create("MyProductB", 3, 4.5);
+	BOOST_CHECK(typeid(*product_b) == typeid(MyProductB));
+	BOOST_CHECK_THROW(factory.create("MyProductC", 3, 4.5), typename Factory::error_policy_type::Exception);
+
+	auto ids = factory.registered_ids();
+	sort(ids.begin(), ids.end());
+	BOOST_CHECK(ids == (vector<string>{"MyProductA", "MyProductB"}));
+
+	BOOST_CHECK(factory.unregister_creator("MyProductA"));
+	BOOST_CHECK(!factory.unregister_creator("MyProductA"));
+	BOOST_CHECK_THROW(factory.create("MyProductA", 2, 3.4), typename Factory::error_policy_type::Exception);
+	BOOST_CHECK_NO_THROW(factory.create("MyProductB", 3, 4.5));
+
+	factory.clear_creator();
+	BOOST_CHECK(factory.registered_ids().empty());
+	BOOST_CHECK_THROW(factory.create("MyProductB", 3, 4.5), typename Factory::error_policy_type::Exception);
+}
+
+using IntFactory = aid::Factory<int, int, function<int()>, aid::DefaultFactoryError, aid::HashFactoryLookup>;
+using FrozenIntFactory = aid::Factory<int, int, function<int()>, aid::DefaultFactoryError,
+									  aid::FrozenFactoryLookup>;
+using IntFactories = boost::mpl::list<IntFactory, FrozenIntFactory>;
+
+// the creator of id returns id
+template<class Factory>
+void register_ids(Factory &factory, int first, int last)
+{
+	for ( int id = first; id < last; ++id ) {
+		BOOST_REQUIRE(factory.register_creator(id, [id]() { return id; }));
+	}
+}
+
+template<class Factory>
+void check_ids(const Factory &factory, int first, int last, int count)
+{
+	for ( int id = first; id < last; ++id ) {
+		BOOST_REQUIRE_EQUAL(factory.create(id), id);
+	}
+	BOOST_CHECK_THROW(factory.create(last), typename Factory::error_policy_type::Exception);
+	BOOST_CHECK_EQUAL(factory.registered_ids().size(), count);
+}
+
+// many identifiers grow the table, and erasing every other one shifts the probe sequences back
+BOOST_AUTO_TEST_CASE_TEMPLATE(lookup_2, Factory, IntFactories)
+{
+	Factory factory;
+	register_ids(factory, 0, 1000);
+	check_ids(factory, 0, 1000, 1000);
+
+	for ( int id = 0; id < 1000; id += 2 ) {
+		BOOST_REQUIRE(factory.unregister_creator(id));
+	}
+	for ( int id = 0; id < 1000; ++id ) {
+		if ( id % 2 == 0 ) {
+			BOOST_REQUIRE_THROW(factory.create(id), typename Factory::error_policy_type::Exception);
+		}
+		else {
+			BOOST_REQUIRE_EQUAL(factory.create(id), id);
+		}
+	}
+	BOOST_CHECK_EQUAL(factory.registered_ids().size(), 500);
+
+	register_ids(factory, 1000, 1500);
+	for ( int id = 1; id < 1000; id += 2 ) {
+		BOOST_REQUIRE_EQUAL(factory.create(id), id);
+	}
+	check_ids(factory, 1000, 1500, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(freeze_1)
+{
+	FrozenIntFactory factory;
+	BOOST_CHECK(!factory.freeze());
+
+	register_ids(factory, 0, 1000);
+	BOOST_CHECK(factory.freeze());
+	check_ids(factory, 0, 1000, 1000);
+	BOOST_CHECK_THROW(factory.create(-1), FrozenIntFactory::error_policy_type::Exception);
+
+	// a change thaws the lookups, which work as a hash table until the next freeze()
+	BOOST_CHECK(factory.unregister_creator(500));
+	BOOST_CHECK_THROW(factory.create(500), FrozenIntFactory::error_policy_type::Exception);
+	BOOST_CHECK(!factory.register_creator(499, []() { return 0; }));
+	BOOST_CHECK(factory.register_creator(500, []() { return 500; }));
+	BOOST_CHECK(factory.register_creator(1000, []() { return 1000; }));
+	check_ids(factory, 0, 1001, 1001);
+
+	BOOST_CHECK(factory.freeze());
+	check_ids(factory, 0, 1001, 1001);
+
+	factory.clear_creator();
+	BOOST_CHECK_THROW(factory.create(0), FrozenIntFactory::error_policy_type::Exception);
+	BOOST_CHECK(!factory.freeze());
+}
+
+BOOST_AUTO_TEST_CASE(freeze_2)
+{
+	MyFrozenFactory factory;
+	for ( int i = 0; i < 300; ++i ) {
+		factory.register_creator("MyProduct" + to_string(i), create_a);
+	}
+	BOOST_CHECK(factory.freeze());
+	for ( int i = 0; i < 300; ++i ) {
+		BOOST_REQUIRE(factory.create("MyProduct" + to_string(i), i, 0.5)->i == i);
+	}
+	BOOST_CHECK_THROW(factory.create("MyProduct300", 0, 0.5), MyFrozenFactory::error_policy_type::Exception);
+	BOOST_CHECK_THROW(factory.create("", 0, 0.5), MyFrozenFactory::error_policy_type::Exception);
+}
+
+using MyInplaceCreator = aid::InplaceCreator<MyAbstractProductPtr (int, double)>;
+template<template<typename, typename> class FactoryLookupPolicy>
+using MyInplaceFactory = aid::Factory<MyAbstractProductPtr, std::string, MyInplaceCreator,
+									  aid::DefaultFactoryError, FactoryLookupPolicy>;
+using MyInplaceFactories = boost::mpl::list<MyInplaceFactory<aid::MapFactoryLookup>,
+											MyInplaceFactory<aid::HashFactoryLookup>,
+											MyInplaceFactory<aid::FrozenFactoryLookup>>;
+
+// move-only creators with context are moved into the lookups, and around when they grow
+BOOST_AUTO_TEST_CASE_TEMPLATE(inplace_creator_1, Factory, MyInplaceFactories)
+{
+	Factory factory;
+	for ( int n = 0; n < 100; ++n ) {
+		unique_ptr<int> scale{new int(n)};
+		struct Scaled
+		{
+			unique_ptr<int> scale;
+			MyAbstractProductPtr operator()(int i, double d) const {
+				return MyAbstractProductPtr(new MyProductA(i * *scale, d));
+			}
+		};
+		BOOST_REQUIRE(factory.register_creator("MyProduct" + to_string(n), Scaled{std::move(scale)}));
+	}
+	BOOST_CHECK(factory.register_creator("MyProductB",
+		[](int i, double d) {
+			 return MyAbstractProductPtr(new MyProductB(i, d));
+		}));
+	BOOST_CHECK(factory.register_creator("create_a", create_a));
+	BOOST_CHECK(factory.unregister_creator("MyProduct50"));
+
+	for ( int n = 0; n < 100; ++n ) {
+		if ( n == 50 ) {
+			BOOST_CHECK_THROW(factory.create("MyProduct50", 3, 4.5), typename Factory::error_policy_type::Exception);
+		}
+		else {
+			BOOST_REQUIRE_EQUAL(factory.create("MyProduct" + to_string(n), 3, 4.5)->i, 3 * n);
+		}
+	}
+	BOOST_CHECK(typeid(*factory.create("MyProductB", 3, 4.5)) == typeid(MyProductB));
+	BOOST_CHECK(typeid(*factory.create("create_a", 3, 4.5)) == typeid(MyProductA));
+	BOOST_CHECK_EQUAL(factory.registered_ids().size(), 101u);
+}
+
+BOOST_AUTO_TEST_CASE(inplace_creator_2)
+{
+	MyInplaceFactory<aid::FrozenFactoryLookup> factory;
+	const string tenant{"tenant"};
+	factory.register_creator(tenant, [tenant](int i, double d) {
+		return MyAbstractProductPtr(new MyProductA(static_cast<int>(tenant.size()) + i, d));
+	});
+	BOOST_CHECK(factory.freeze());
+	BOOST_CHECK_EQUAL(factory.create(tenant, 1, 0.5)->i, 7);
+}
@@ -0,0 +1,83 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Hash
+#include <boost/test/unit_test.hpp>
+
+#include "aid/BitVector.hpp"
+#include "aid/Hash.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+
+// usable in constant expressions
+static_assert(aid::hash_word(1) != aid::hash_word(2), "hash_word() is not constexpr");
+static_assert(hash<aid::BitVector<uint32_t>>{}(aid::BitVector<uint32_t>{1}) == aid::hash_word(1),
+			  "std::hash<BitVector> is not constexpr");
+
+BOOST_AUTO_TEST_CASE(hash_bytes_1)
+{
+	// the test vectors of wyhash final version 4 (the seed is the index)
+	const char * const messages[]{"", "a", "abc", "message digest", "abcdefghijklmnopqrstuvwxyz"};
+	const uint64_t expected[]{
+		0x93228a4de0eec5a2u, 0xc5bac3db178713c4u, 0xa97f2f7b1d9b3314u, 0x786d1f1df3801df4u, 0xdca5a8138ad37c87u,
+	};
+	for ( size_t i = 0; i < 5; ++i ) {
+		BOOST_CHECK_EQUAL(expected[i], aid::hash_bytes(messages[i], strlen(messages[i]), i));
+	}
+
+	// every size takes every byte
+	const string text(200, 'x');
+	for ( size_t size = 1; size < text.size(); ++size ) {
+		string other = text.substr(0, size);
+		other[size / 3] = 'y';
+		BOOST_CHECK_NE(aid::hash_bytes(text.data(), size), aid::hash_bytes(other.data(), size));
+		BOOST_CHECK_NE(aid::hash_bytes(text.data(), size), aid::hash_bytes(text.data(), size + 1));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(hash_word_1)
+{
+	for ( uint64_t value : {uint64_t{0}, uint64_t{1}, uint64_t{0x0123456789ABCDEF}, ~uint64_t{0}} ) {
+		BOOST_CHECK_EQUAL(aid::hash_bytes(&value, sizeof(value), 7), aid::hash_word(value, 7));
+	}
+
+	// flipping an input bit flips about half of the output bits
+	const size_t samples = 1000;
+	vector<size_t> flips(64 * 64, 0);
+	for ( uint64_t value = 0; value < samples; ++value ) {
+		const uint64_t hash = aid::hash_word(value * 0x9E3779B97F4A7C15u);
+		for ( unsigned int in = 0; in < 64; ++in ) {
+			const uint64_t changed = hash ^ aid::hash_word((value * 0x9E3779B97F4A7C15u) ^ (uint64_t{1} << in));
+			for ( unsigned int out = 0; out < 64; ++out ) {
+				flips[in * 64 + out] += (changed >> out) & 1;
+			}
+		}
+	}
+	for ( size_t count : flips ) {
+		BOOST_CHECK(count > samples * 4 / 10 && count < samples * 6 / 10);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(bit_vector_1)
+{
+	// consecutive packed keys fill the low bits of the buckets evenly
+	using BVec = aid::BitVector<uint32_t>;
+	const size_t buckets = 64;
+	vector<size_t> counts(buckets, 0);
+	for ( uint32_t i = 0; i < 64 * 1000; ++i ) {
+		++counts[hash<BVec>{}(BVec{i << 8}) % buckets];
+	}
+	for ( size_t count : counts ) {
+		BOOST_CHECK(count > 900 && count < 1100);
+	}
+
+	unordered_set<BVec> set{BVec{1}, BVec{2}, BVec{1}};
+	BOOST_CHECK_EQUAL(2u, set.size());
+}
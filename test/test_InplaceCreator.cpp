@@ -0,0 +1,139 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE InplaceCreator
+#include <boost/test/unit_test.hpp>
+
+#include "aid/InplaceCreator.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+using namespace std;
+
+
+using IntCreator = aid::InplaceCreator<int (int)>;
+
+static_assert(!is_copy_constructible<IntCreator>::value, "copyable");
+static_assert(is_nothrow_move_constructible<IntCreator>::value, "move may throw");
+// only the callables of the signature are stored
+static_assert(!is_constructible<IntCreator, int>::value, "constructible from a non-callable");
+static_assert(!is_constructible<IntCreator, int (*)(int, int)>::value, "constructible from another signature");
+static_assert(!is_constructible<IntCreator, string (*)(int)>::value, "constructible from another result");
+static_assert(is_constructible<IntCreator, long (*)(short)>::value, "not constructible from a convertible signature");
+static_assert(is_constructible<aid::InplaceCreator<void (int)>, int (*)(int)>::value, "the result is not discarded");
+static_assert(!is_convertible<int, aid::InplaceCreator<int ()>>::value, "convertible from a non-callable");
+
+int twice(int i) {
+	return i * 2;
+}
+
+// counts the live copies of a capture
+struct Counted
+{
+	static int live;
+	int value;
+	explicit Counted(int value): value{value} { ++live; }
+	Counted(const Counted &other): value{other.value} { ++live; }
+	Counted(Counted &&other) noexcept: value{other.value} { ++live; }
+	~Counted() { --live; }
+};
+
+int Counted::live = 0;
+
+BOOST_AUTO_TEST_CASE(empty_1)
+{
+	const IntCreator empty;
+	BOOST_CHECK(!empty);
+	BOOST_CHECK_THROW(empty(1), bad_function_call);
+
+	const IntCreator null{static_cast<int (*)(int)>(nullptr)};
+	BOOST_CHECK(!null);
+	BOOST_CHECK_THROW(null(1), bad_function_call);
+}
+
+BOOST_AUTO_TEST_CASE(call_1)
+{
+	const IntCreator function{twice};
+	BOOST_CHECK(function);
+	BOOST_CHECK_EQUAL(function(3), 6);
+
+	const IntCreator pointer{&twice};
+	BOOST_CHECK_EQUAL(pointer(4), 8);
+
+	const int offset = 10;
+	const IntCreator lambda{[offset](int i) { return i + offset; }};
+	BOOST_CHECK_EQUAL(lambda(1), 11);
+
+	// the callable is not const
+	int calls = 0;
+	const IntCreator counter{[calls](int i) mutable { return i + ++calls; }};
+	BOOST_CHECK_EQUAL(counter(0), 1);
+	BOOST_CHECK_EQUAL(counter(0), 2);
+}
+
+// the arguments are forwarded with their references
+BOOST_AUTO_TEST_CASE(call_2)
+{
+	const aid::InplaceCreator<string (string &, unique_ptr<string> &&)> append{
+		[](string &s, unique_ptr<string> &&p) {
+			s += *p;
+			const unique_ptr<string> taken{std::move(p)};
+			return s;
+		}};
+	string s{"ab"};
+	unique_ptr<string> p{new string("cd")};
+	BOOST_CHECK_EQUAL(append(s, std::move(p)), "abcd");
+	BOOST_CHECK_EQUAL(s, "abcd");
+	BOOST_CHECK(!p);
+}
+
+BOOST_AUTO_TEST_CASE(move_1)
+{
+	{
+		const string prefix{"a long prefix which std::string allocates: "};
+		IntCreator size{[prefix](int i) { return static_cast<int>(prefix.size()) + i; }};
+		IntCreator moved{std::move(size)};
+		BOOST_CHECK(!size);
+		BOOST_CHECK_EQUAL(moved(1), static_cast<int>(prefix.size()) + 1);
+
+		size = std::move(moved);
+		BOOST_CHECK(!moved);
+		BOOST_CHECK_EQUAL(size(2), static_cast<int>(prefix.size()) + 2);
+
+		size = std::move(size);
+		BOOST_CHECK_EQUAL(size(2), static_cast<int>(prefix.size()) + 2);
+	}
+	{
+		IntCreator first{[](int i) { return i; }};
+		{
+			const Counted counted{5};
+			IntCreator second{[counted](int i) { return counted.value + i; }};
+			BOOST_CHECK_EQUAL(Counted::live, 2);
+			first = std::move(second);
+			BOOST_CHECK_EQUAL(Counted::live, 2);
+		}
+		BOOST_CHECK_EQUAL(Counted::live, 1);
+		BOOST_CHECK_EQUAL(first(1), 6);
+		first = IntCreator{twice};
+		BOOST_CHECK_EQUAL(Counted::live, 0);
+		BOOST_CHECK_EQUAL(first(1), 2);
+	}
+}
+
+// a move-only capture
+BOOST_AUTO_TEST_CASE(move_2)
+{
+	struct Owner
+	{
+		unique_ptr<int> value;
+		int operator()(int i) const { return *value + i; }
+	};
+	Owner owner{unique_ptr<int>(new int(7))};
+	IntCreator creator{std::move(owner)};
+	BOOST_CHECK(!owner.value);
+	const IntCreator moved{std::move(creator)};
+	BOOST_CHECK_EQUAL(moved(1), 8);
+}
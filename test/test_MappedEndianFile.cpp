@@ -0,0 +1,105 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE MappedEndianFile
+#include <boost/test/unit_test.hpp>
+
+#include "aid/MappedEndianFile.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <unistd.h>
+
+using namespace std;
+
+
+struct Fixture
+{
+	string path;
+
+	Fixture() {
+		char name[] = "/tmp/aid_MappedEndianFileXXXXXX";
+		const int fd = mkstemp(name);
+		path = name;
+
+		vector<unsigned char> bytes;
+		for ( uint32_t i = 0; i < 10000; ++i ) {
+			bytes.push_back(static_cast<unsigned char>(i >> 24));
+			bytes.push_back(static_cast<unsigned char>(i >> 16));
+			bytes.push_back(static_cast<unsigned char>(i >> 8));
+			bytes.push_back(static_cast<unsigned char>(i));
+		}
+		const ssize_t written = write(fd, bytes.data(), bytes.size());
+		BOOST_REQUIRE_EQUAL(static_cast<ssize_t>(bytes.size()), written);
+		close(fd);
+	}
+
+	~Fixture() {
+		remove(path.c_str());
+	}
+};
+
+BOOST_FIXTURE_TEST_SUITE(normal, Fixture)
+
+BOOST_AUTO_TEST_CASE(read_1)
+{
+	aid::MappedEndianFile file(path, aid::EndianType::big);
+	BOOST_CHECK_EQUAL(40000u, file.size());
+	BOOST_CHECK_EQUAL(1234u, file.get<uint32_t>(1234 * 4));
+
+	file.set_window_size(100);
+	vector<uint32_t> native(9000);
+	file.read_n(4000, native.size(), native.data());
+	for ( uint32_t i = 0; i < native.size(); ++i ) {
+		BOOST_REQUIRE_EQUAL(1000 + i, native[i]);
+	}
+
+	uint32_t expected = 0;
+	file.for_each_native<uint32_t>(0, 10000, [&expected](const uint32_t *values, size_t n) {
+		for ( size_t i = 0; i < n; ++i ) {
+			BOOST_REQUIRE_EQUAL(expected++, values[i]);
+		}
+	});
+	BOOST_CHECK_EQUAL(10000u, expected);
+}
+
+BOOST_AUTO_TEST_CASE(read_e1)
+{
+	aid::MappedEndianFile file(path, aid::EndianType::big);
+	BOOST_CHECK_THROW(file.get<uint32_t>(39997), out_of_range);
+	BOOST_CHECK_THROW(file.read_n<uint32_t>(4, 10000, nullptr), out_of_range);
+	BOOST_CHECK_THROW(file.convert_in_place<uint32_t>(0, 1), logic_error);
+	BOOST_CHECK_THROW(aid::MappedEndianFile(path + ".none", aid::EndianType::big), system_error);
+}
+
+BOOST_AUTO_TEST_CASE(copy_on_write_1)
+{
+	{
+		aid::MappedEndianFile file(path, aid::EndianType::big, aid::MappedEndianFile::Mode::copy_on_write);
+		file.set_window_size(4096);
+		const uint32_t *native = file.convert_in_place<uint32_t>(0, 10000);
+		for ( uint32_t i = 0; i < 10000; ++i ) {
+			BOOST_REQUIRE_EQUAL(i, native[i]);
+		}
+	}
+
+	aid::MappedEndianFile file(path, aid::EndianType::big);
+	BOOST_CHECK_EQUAL(9999u, file.get<uint32_t>(9999 * 4));
+}
+
+BOOST_AUTO_TEST_CASE(read_write_1)
+{
+	{
+		aid::MappedEndianFile file(path, aid::EndianType::big, aid::MappedEndianFile::Mode::read_write);
+		file.convert_in_place<uint32_t>(0, 10000);
+		file.sync();
+	}
+
+	aid::MappedEndianFile file(path, aid::EndianType::little);
+	BOOST_CHECK_EQUAL(9999u, file.get<uint32_t>(9999 * 4));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,180 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PackedIntVector
+#include <boost/test/unit_test.hpp>
+
+#include "IsaTest.hpp"
+#include "aid/PackedIntVector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using aid::DynamicPackedIntVector;
+using aid::PackedIntVector;
+
+
+namespace {
+
+vector<uint32_t> make_values(unsigned int width, size_t size)
+{
+	mt19937 engine(width);
+	uniform_int_distribution<uint32_t> distribution(0, static_cast<uint32_t>(aid::PackedIntVector_impl::mask(width)));
+	vector<uint32_t> values(size);
+	for ( auto &value : values ) {
+		value = distribution(engine);
+	}
+	return values;
+}
+
+// pack and unpack ranges which start and end off the blocks, against get and set
+template<typename PackedInts>
+void check_bulk(PackedInts &pvec)
+{
+	const size_t size = pvec.size();
+	const vector<uint32_t> values = make_values(pvec.width(), size);
+	for ( size_t first : {size_t{0}, size_t{1}, size_t{7}, size_t{64}, size_t{67}} ) {
+		const size_t count = size - first - first % 5;
+		pvec.resize(0);
+		pvec.resize(size);
+		pvec.pack(first, values.data(), count);
+		for ( size_t i = 0; i < size; ++i ) {
+			const uint32_t expected = i >= first && i < first + count ? values[i - first] : 0;
+			if ( pvec[i] != expected ) {
+				BOOST_ERROR("width " << pvec.width() << " first " << first << " index " << i);
+				return;
+			}
+		}
+
+		vector<uint32_t> unpacked(count + 1, 0xDEADBEEF);
+		pvec.unpack(first, count, unpacked.data());
+		BOOST_CHECK_EQUAL_COLLECTIONS(values.begin(), values.begin() + count, unpacked.begin(), unpacked.end() - 1);
+		BOOST_CHECK_EQUAL(0xDEADBEEF, unpacked.back());
+	}
+}
+
+template<unsigned int t_width>
+void check_fixed()
+{
+	PackedIntVector<t_width> pvec(1000);
+	BOOST_CHECK_EQUAL(t_width, pvec.width());
+	check_bulk(pvec);
+
+	// the same bits as with the width given at run time
+	DynamicPackedIntVector dvec(t_width, pvec.size());
+	vector<uint32_t> values(pvec.size());
+	pvec.unpack(0, values.size(), values.data());
+	dvec.pack(0, values.data(), values.size());
+	BOOST_CHECK_EQUAL_COLLECTIONS(pvec.data(), pvec.data() + pvec.word_size(),
+								  dvec.data(), dvec.data() + dvec.word_size());
+}
+
+} // unnamed namespace
+
+
+BOOST_AUTO_TEST_CASE(set_1)
+{
+	for ( unsigned int width = 1; width <= 32; ++width ) {
+		const vector<uint32_t> values = make_values(width, 300);
+		DynamicPackedIntVector pvec(width);
+		for ( auto value : values ) {
+			pvec.push_back(value);
+		}
+		BOOST_REQUIRE_EQUAL(values.size(), pvec.size());
+		for ( size_t i = 0; i < values.size(); ++i ) {
+			BOOST_REQUIRE_EQUAL(values[i], pvec.get(i));
+		}
+
+		// overwriting an element leaves its neighbours alone
+		pvec.set(100, pvec.max_value());
+		BOOST_CHECK_EQUAL(values[99], pvec[99]);
+		BOOST_CHECK_EQUAL(pvec.max_value(), pvec[100]);
+		BOOST_CHECK_EQUAL(values[101], pvec[101]);
+		pvec.set(100, 0);
+		BOOST_CHECK_EQUAL(values[99], pvec[99]);
+		BOOST_CHECK_EQUAL(values[101], pvec[101]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(resize_1)
+{
+	PackedIntVector<5> pvec;
+	BOOST_CHECK(pvec.empty());
+	BOOST_CHECK_EQUAL(31u, pvec.max_value());
+
+	pvec.resize(40, 31);
+	BOOST_CHECK_EQUAL(40u, pvec.size());
+	BOOST_CHECK_EQUAL(31u, pvec[39]);
+
+	// the dropped elements come back as zeros
+	pvec.resize(13);
+	pvec.resize(40);
+	BOOST_CHECK_EQUAL(31u, pvec[12]);
+	BOOST_CHECK_EQUAL(0u, pvec[13]);
+	BOOST_CHECK_EQUAL(0u, pvec[39]);
+
+	PackedIntVector<5> other(13);
+	other.resize(40);
+	BOOST_CHECK(pvec != other);
+	for ( size_t i = 0; i < 13; ++i ) {
+		other.set(i, 31);
+	}
+	BOOST_CHECK(pvec == other);
+
+	pvec.clear();
+	BOOST_CHECK(pvec.empty());
+	BOOST_CHECK_EQUAL(1u, pvec.word_size());
+}
+
+BOOST_AUTO_TEST_CASE(bulk_1)
+{
+	for_each_isa([] {
+		for ( unsigned int width = 1; width <= 32; ++width ) {
+			DynamicPackedIntVector pvec(width, 1000);
+			check_bulk(pvec);
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(fixed_width_1)
+{
+	for_each_isa([] {
+		check_fixed<1>();
+		check_fixed<3>();
+		check_fixed<8>();
+		check_fixed<13>();
+		check_fixed<25>();
+		check_fixed<26>();
+		check_fixed<31>();
+		check_fixed<32>();
+	});
+}
+
+BOOST_AUTO_TEST_CASE(exception_1)
+{
+	BOOST_CHECK_THROW(DynamicPackedIntVector(0), invalid_argument);
+	BOOST_CHECK_THROW(DynamicPackedIntVector(33), invalid_argument);
+
+	DynamicPackedIntVector pvec(4, 10);
+	uint32_t values[11] = {};
+	BOOST_CHECK_THROW(pvec.get(10), out_of_range);
+	BOOST_CHECK_THROW(pvec.set(10, 0), out_of_range);
+	BOOST_CHECK_THROW(pvec.unpack(5, 6, values), out_of_range);
+	BOOST_CHECK_THROW(pvec.pack(11, values, 0), out_of_range);
+	BOOST_CHECK_THROW(pvec.unpack(0, 1, nullptr), invalid_argument);
+	pvec.unpack(10, 0, nullptr);
+
+#ifndef NDEBUG
+	BOOST_CHECK_THROW(pvec.set(0, 16), overflow_error);
+	BOOST_CHECK_THROW(pvec.push_back(16), overflow_error);
+	values[3] = 16;
+	BOOST_CHECK_THROW(pvec.pack(0, values, 4), overflow_error);
+	BOOST_CHECK_EQUAL(10u, pvec.size());
+#else
+	pvec.set(0, 17);
+	BOOST_CHECK_EQUAL(1u, pvec[0]);
+#endif
+}
@@ -0,0 +1,66 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE ParallelEndian
+#include <boost/mpl/list.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "aid/ParallelEndian.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using test_type_list = boost::mpl::list<uint16_t, int32_t, uint64_t>;
+
+
+BOOST_AUTO_TEST_CASE(worker_pool_1)
+{
+	for ( unsigned int threads : {1u, 2u, 5u} ) {
+		aid::WorkerPool pool(threads);
+		BOOST_CHECK_EQUAL(threads, pool.size());
+
+		for ( size_t count : {0u, 1u, 7u, 1000u} ) {
+			vector<atomic<int>> done(count);
+			for ( auto &d : done ) d = 0;
+			pool.run(count, [&done](size_t index) { ++done[index]; });
+			for ( auto &d : done ) BOOST_REQUIRE_EQUAL(1, d.load());
+		}
+
+		BOOST_CHECK_THROW(pool.run(10, [](size_t index) {
+				if ( index == 3 ) throw runtime_error("task");
+			}), runtime_error);
+	}
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(from_external_1, test_type, test_type_list)
+{
+	constexpr size_t count{100003};
+	vector<unsigned char> big(count * sizeof(test_type) + 1);
+	for ( size_t i = 0; i < big.size(); ++i ) {
+		big[i] = static_cast<unsigned char>(i * 31 + 7);
+	}
+
+	const aid::EndianConverter<aid::EndianType::big> converter{};
+	vector<test_type> expected(count);
+	converter.from_external_n(big.data() + 1, count, expected.data());
+
+	aid::WorkerPool pool(4);
+	const aid::ParallelOptions options(0, 1000, 256);
+	vector<test_type> native(count + 1);
+	for ( size_t offset : {0u, 1u} ) {
+		aid::parallel_from_external_n(pool, converter, big.data() + 1, count, native.data() + offset, options);
+		BOOST_CHECK(equal(expected.begin(), expected.end(), native.begin() + offset));
+	}
+
+	const aid::DynamicEndianConverter dynamic{aid::EndianType::big};
+	vector<unsigned char> back(count * sizeof(test_type));
+	aid::parallel_to_external_n(pool, dynamic, expected.data(), count, back.data(), options);
+	BOOST_CHECK(equal(back.begin(), back.end(), big.begin() + 1));
+
+	const aid::DynamicEndianConverter unknown;
+	BOOST_CHECK_THROW(aid::parallel_to_external_n(pool, unknown, expected.data(), count, back.data(), options),
+					  logic_error);
+}
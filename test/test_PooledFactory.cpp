@@ -0,0 +1,274 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE PooledFactory
+#include <boost/test/unit_test.hpp>
+
+#include "aid/PooledFactory.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+using namespace std;
+
+
+atomic<int> live_products{0};
+
+struct MyAbstractProduct
+{
+	int i;
+	MyAbstractProduct(): i{0} { ++live_products; }
+	virtual ~MyAbstractProduct() { --live_products; }
+};
+
+struct MyProductA: MyAbstractProduct {};
+
+struct MyProductB: MyAbstractProduct {};
+
+unique_ptr<MyAbstractProduct> create_a() {
+	return unique_ptr<MyAbstractProduct>(new MyProductA);
+}
+
+unique_ptr<MyAbstractProduct> create_b() {
+	return unique_ptr<MyAbstractProduct>(new MyProductB);
+}
+
+using MyFactory = aid::PooledFactory<MyAbstractProduct, string>;
+
+BOOST_AUTO_TEST_CASE(register_1)
+{
+	{
+		MyFactory factory;
+		BOOST_CHECK(factory.register_creator("MyProductA", create_a));
+		BOOST_CHECK(!factory.register_creator("MyProductA", create_b));
+		BOOST_CHECK(factory.register_creator("MyProductB", create_b));
+
+		auto ids = factory.registered_ids();
+		BOOST_CHECK(ids == (vector<string>{"MyProductA", "MyProductB"}));
+
+		auto product_a = factory.create("MyProductA");
+		BOOST_CHECK(typeid(*product_a) == typeid(MyProductA));
+		auto product_b = factory.create("MyProductB");
+		BOOST_CHECK(typeid(*product_b) == typeid(MyProductB));
+		BOOST_CHECK_THROW(factory.create("MyProductC"), MyFactory::error_policy_type::Exception);
+
+		BOOST_CHECK(factory.unregister_creator("MyProductA"));
+		BOOST_CHECK(!factory.unregister_creator("MyProductA"));
+		BOOST_CHECK_THROW(factory.create("MyProductA"), MyFactory::error_policy_type::Exception);
+
+		factory.clear_creator();
+		BOOST_CHECK(factory.registered_ids().empty());
+	}
+	BOOST_CHECK_EQUAL(live_products.load(), 0);
+}
+
+// a released product is reset and returned by the next create()
+BOOST_AUTO_TEST_CASE(reuse_1)
+{
+	{
+		MyFactory factory;
+		factory.register_creator("MyProductA", create_a, [](MyAbstractProduct &product) { product.i = 0; });
+		factory.register_creator("MyProductB", create_b);
+
+		auto product = factory.create("MyProductA");
+		product->i = 5;
+		const MyAbstractProduct * const address = product.get();
+		product.reset();
+		BOOST_CHECK_EQUAL(live_products.load(), 1);
+
+		product = factory.create("MyProductA");
+		BOOST_CHECK_EQUAL(product.get(), address);
+		BOOST_CHECK_EQUAL(product->i, 0);
+		BOOST_CHECK(typeid(*factory.create("MyProductB")) == typeid(MyProductB));
+
+		BOOST_CHECK_EQUAL(factory.stats("MyProductA").hits, 1u);
+		BOOST_CHECK_EQUAL(factory.stats("MyProductA").misses, 1u);
+		BOOST_CHECK_EQUAL(factory.stats("MyProductC").misses, 0u);
+		BOOST_CHECK_EQUAL(factory.stats().hits, 1u);
+		BOOST_CHECK_EQUAL(factory.stats().misses, 2u);
+	}
+	BOOST_CHECK_EQUAL(live_products.load(), 0);
+}
+
+// more products than a thread caches go through the overflow list
+BOOST_AUTO_TEST_CASE(reuse_2)
+{
+	constexpr size_t count = 100;
+	MyFactory factory;
+	factory.register_creator("MyProductA", create_a);
+
+	for ( int round = 0; round < 3; ++round ) {
+		vector<MyFactory::abstract_product_ptr_type> products;
+		for ( size_t i = 0; i < count; ++i ) {
+			products.push_back(factory.create("MyProductA"));
+		}
+		BOOST_CHECK_EQUAL(live_products.load(), static_cast<int>(count));
+	}
+	BOOST_CHECK_EQUAL(factory.stats().misses, count);
+	BOOST_CHECK_EQUAL(factory.stats().hits, 2 * count);
+}
+
+// the products of an unregistered identifier are deleted when they are released
+BOOST_AUTO_TEST_CASE(unregister_1)
+{
+	MyFactory factory;
+	factory.register_creator("MyProductA", create_a);
+	factory.create("MyProductA");
+	auto product = factory.create("MyProductA");
+	BOOST_CHECK_EQUAL(live_products.load(), 1);
+
+	factory.unregister_creator("MyProductA");
+	product.reset();
+	BOOST_CHECK_EQUAL(live_products.load(), 0);
+
+	factory.register_creator("MyProductA", create_a);
+	BOOST_CHECK_EQUAL(factory.stats("MyProductA").misses, 0u);
+	factory.create("MyProductA");
+	BOOST_CHECK_EQUAL(factory.stats("MyProductA").misses, 1u);
+}
+
+// the pool of an unregistered identifier is deleted with its last product
+BOOST_AUTO_TEST_CASE(unregister_2)
+{
+	MyFactory factory;
+	const auto context = make_shared<int>(0);
+	const auto create_with_context = [context]() { return create_a(); };
+	for ( int round = 0; round < 3; ++round ) {
+		factory.register_creator("MyProductA", create_with_context);
+		auto pooled = factory.create("MyProductA");
+		auto product = factory.create("MyProductA");
+		pooled.reset();
+		BOOST_CHECK_EQUAL(live_products.load(), 2);
+		BOOST_CHECK_EQUAL(context.use_count(), 3);
+
+		factory.unregister_creator("MyProductA");
+		BOOST_CHECK_EQUAL(live_products.load(), 1);
+		BOOST_CHECK_EQUAL(context.use_count(), 3);
+		product.reset();
+		BOOST_CHECK_EQUAL(live_products.load(), 0);
+		BOOST_CHECK_EQUAL(context.use_count(), 2);
+	}
+
+	// a product may outlive the factory
+	MyFactory::abstract_product_ptr_type product;
+	{
+		MyFactory other;
+		other.register_creator("MyProductA", create_with_context);
+		product = other.create("MyProductA");
+	}
+	BOOST_CHECK_EQUAL(context.use_count(), 3);
+	product.reset();
+	BOOST_CHECK_EQUAL(context.use_count(), 2);
+	BOOST_CHECK_EQUAL(factory.stats().misses, 6u);
+}
+
+// the products released at the end of a thread, after its index is given back, go to the overflow list
+BOOST_AUTO_TEST_CASE(thread_exit_1)
+{
+	struct Holder
+	{
+		MyFactory::abstract_product_ptr_type product;
+	};
+
+	MyFactory factory;
+	factory.register_creator("MyProductA", create_a);
+	factory.create("MyProductA");
+	thread([&factory]() {
+		// (constructed before the index of the thread, so destroyed after it)
+		static thread_local Holder holder;
+		holder.product = factory.create("MyProductA");
+	}).join();
+	BOOST_CHECK_EQUAL(live_products.load(), 2);
+
+	const auto first = factory.create("MyProductA");
+	const auto second = factory.create("MyProductA");
+	BOOST_CHECK_EQUAL(factory.stats().hits, 2u);
+	BOOST_CHECK_EQUAL(factory.stats().misses, 2u);
+}
+
+// more threads than caches create and release, and pass products to each other
+BOOST_AUTO_TEST_CASE(concurrent_1)
+{
+	constexpr unsigned int thread_count = aid::PooledFactory_impl::max_thread_count + 8;
+	constexpr unsigned long creates_per_thread = 2000;
+	{
+		MyFactory factory;
+		factory.register_creator("MyProductA", create_a);
+		factory.register_creator("MyProductB", create_b);
+
+		atomic<unsigned int> started{0};
+		atomic<unsigned long> errors{0};
+		vector<MyFactory::abstract_product_ptr_type> passed(thread_count);
+		vector<thread> threads;
+		for ( unsigned int t = 0; t < thread_count; ++t ) {
+			threads.emplace_back([&, t]() {
+				// all the threads live at once, so that some of them have no cache
+				++started;
+				while ( started.load() < thread_count ) {
+					this_thread::yield();
+				}
+				vector<MyFactory::abstract_product_ptr_type> held;
+				for ( unsigned long n = 0; n < creates_per_thread; ++n ) {
+					const bool a = (n + t) % 3 != 0;
+					auto product = factory.create(a ? "MyProductA" : "MyProductB");
+					if ( (typeid(*product) == typeid(MyProductA)) != a ) ++errors;
+					held.push_back(std::move(product));
+					if ( held.size() > n % 24 ) {
+						held.clear();
+					}
+				}
+				passed[t] = factory.create("MyProductA");
+			});
+		}
+		for ( auto &thread : threads ) {
+			thread.join();
+		}
+		passed.clear();
+
+		BOOST_CHECK_EQUAL(errors.load(), 0u);
+		const auto stats = factory.stats();
+		BOOST_CHECK_EQUAL(stats.hits + stats.misses, thread_count * (creates_per_thread + 1));
+		BOOST_TEST_MESSAGE(stats.hits << " hits, " << stats.misses << " misses");
+	}
+	BOOST_CHECK_EQUAL(live_products.load(), 0);
+}
+
+// the products are released while their identifier is unregistered
+BOOST_AUTO_TEST_CASE(concurrent_2)
+{
+	constexpr unsigned int thread_count = 8;
+	constexpr size_t products_per_thread = 3 * aid::PooledFactory_impl::cache_capacity;
+	for ( int round = 0; round < 20; ++round ) {
+		MyFactory factory;
+		factory.register_creator("MyProductA", create_a);
+		vector<vector<MyFactory::abstract_product_ptr_type>> products(thread_count);
+		for ( auto &held : products ) {
+			for ( size_t i = 0; i < products_per_thread; ++i ) {
+				held.push_back(factory.create("MyProductA"));
+			}
+		}
+
+		atomic<bool> start{false};
+		vector<thread> threads;
+		for ( unsigned int t = 0; t < thread_count; ++t ) {
+			threads.emplace_back([&, t]() {
+				while ( !start.load() ) {
+					this_thread::yield();
+				}
+				for ( auto &product : products[t] ) {
+					product.reset();
+				}
+			});
+		}
+		start = true;
+		factory.unregister_creator("MyProductA");
+		for ( auto &thread : threads ) {
+			thread.join();
+		}
+		BOOST_CHECK_EQUAL(live_products.load(), 0);
+	}
+}
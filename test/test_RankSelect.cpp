@@ -0,0 +1,95 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE RankSelect
+#include <boost/test/unit_test.hpp>
+
+#include "aid/RankSelect.hpp"
+
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using aid::DynamicBitVector;
+using aid::RankSelect;
+
+
+namespace {
+
+// one bit in every `one_in` on average
+DynamicBitVector make_bits(size_t size, unsigned int one_in)
+{
+	mt19937 engine(static_cast<unsigned int>(size + one_in));
+	DynamicBitVector bits(size);
+	for ( size_t i = 0; i < size; ++i ) {
+		if ( engine() % one_in == 0 ) bits.set(i);
+	}
+	return bits;
+}
+
+void check_rank_select(const DynamicBitVector &bits)
+{
+	const RankSelect index(bits);
+	BOOST_REQUIRE_EQUAL(bits.size(), index.size());
+	BOOST_REQUIRE_EQUAL(bits.count(), index.count());
+
+	size_t rank = 0;
+	for ( size_t i = 0; i < bits.size(); ++i ) {
+		BOOST_REQUIRE_EQUAL(rank, index.rank1(i));
+		BOOST_REQUIRE_EQUAL(i - rank, index.rank0(i));
+		if ( bits[i] ) {
+			BOOST_REQUIRE_EQUAL(i, index.select1(rank));
+			++rank;
+		}
+	}
+	BOOST_CHECK_EQUAL(rank, index.rank1(bits.size()));
+
+	BOOST_CHECK_THROW(index.rank1(bits.size() + 1), out_of_range);
+	BOOST_CHECK_THROW(index.select1(index.count()), out_of_range);
+}
+
+} // unnamed namespace
+
+
+BOOST_AUTO_TEST_CASE(empty_1)
+{
+	check_rank_select(DynamicBitVector());
+
+	const RankSelect index;
+	BOOST_CHECK_EQUAL(0u, index.size());
+	BOOST_CHECK_EQUAL(0u, index.rank1(0));
+}
+
+BOOST_AUTO_TEST_CASE(uniform_1)
+{
+	for ( size_t size : {1, 64, 511, 512, 513, 65536, 65537, 200000} ) {
+		check_rank_select(DynamicBitVector(size));
+		check_rank_select(DynamicBitVector(size, true));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(random_1)
+{
+	for ( unsigned int one_in : {2, 7, 100, 5000} ) {
+		for ( size_t size : {1000, 65536 * 3 + 100, 1000000} ) {
+			check_rank_select(make_bits(size, one_in));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(select_in_word_1)
+{
+	const uint64_t word = 0x8000000100010011u;
+	const unsigned int expected[]{0, 4, 16, 32, 63};
+	for ( unsigned int rank = 0; rank < 5; ++rank ) {
+		BOOST_CHECK_EQUAL(expected[rank], aid::RankSelect_impl::select_in_word(word, rank));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(overhead_1)
+{
+	const RankSelect index(make_bits(100 * 1000 * 1000, 2));
+	const double overhead = double(index.index_bytes()) / (index.size() / 8);
+	BOOST_CHECK_LT(overhead, 0.035);
+}
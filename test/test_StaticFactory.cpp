@@ -0,0 +1,135 @@
+// -*- tab-width: 4 -*-
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE StaticFactory
+#include <boost/test/unit_test.hpp>
+
+#include "aid/StaticFactory.hpp"
+
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <utility>
+
+using namespace std;
+
+
+struct MyAbstractProduct
+{
+	int i;
+	double d;
+	MyAbstractProduct(int i, double d): i{i}, d{d} {}
+	virtual ~MyAbstractProduct() = default;
+};
+
+using MyAbstractProductPtr = unique_ptr<MyAbstractProduct>;
+
+struct MyProductA: MyAbstractProduct
+{
+	MyProductA(int i, double d): MyAbstractProduct(i, d) {}
+};
+
+struct MyProductB: MyAbstractProduct
+{
+	MyProductB(int i, double d): MyAbstractProduct(i, d) {}
+};
+
+struct MyProductC: MyAbstractProduct
+{
+	MyProductC(int i, double d): MyAbstractProduct(i * 2, d) {}
+};
+
+using MyProducts = aid::TypeList<MyProductA, MyProductB, MyProductC>;
+using MyFactory = aid::StaticFactory<MyAbstractProductPtr, MyProducts>;
+
+static_assert(MyFactory::size == 3, "size");
+static_assert(MyFactory::id<MyProductA>() == 0, "id of MyProductA");
+static_assert(MyFactory::id<MyProductC>() == 2, "id of MyProductC");
+
+BOOST_AUTO_TEST_CASE(create_1)
+{
+	const MyFactory factory;
+
+	int i = 2;
+	const double d = 3.4;
+	auto product_a = factory.create(0, i, d);
+	BOOST_CHECK(typeid(*product_a) == typeid(MyProductA));
+	BOOST_CHECK_EQUAL(product_a->i, 2);
+	BOOST_CHECK_EQUAL(product_a->d, 3.4);
+
+	auto product_b = factory.create(MyFactory::id<MyProductB>(), 3, 4.5);
+	BOOST_CHECK(typeid(*product_b) == typeid(MyProductB));
+	BOOST_CHECK_EQUAL(product_b->i, 3);
+
+	auto product_c = factory.create(2, 3, 4.5);
+	BOOST_CHECK(typeid(*product_c) == typeid(MyProductC));
+	BOOST_CHECK_EQUAL(product_c->i, 6);
+}
+
+BOOST_AUTO_TEST_CASE(create_e1)
+{
+	const MyFactory factory;
+	BOOST_CHECK_NO_THROW(factory.create(2, 3, 4.5));
+	BOOST_CHECK_THROW(factory.create(3, 3, 4.5), MyFactory::error_policy_type::Exception);
+	BOOST_CHECK_THROW(factory.create(static_cast<size_t>(-1), 3, 4.5), MyFactory::error_policy_type::Exception);
+}
+
+enum class Shape { circle, square, triangle };
+
+struct MyShape
+{
+	virtual ~MyShape() = default;
+	virtual string name() const = 0;
+};
+
+struct Circle: MyShape
+{
+	string name() const { return "circle"; }
+};
+
+struct Square: MyShape
+{
+	string name() const { return "square"; }
+};
+
+template<typename Identifier, class AbstractProductPtr>
+class NullFactoryError
+{
+  protected:
+	static AbstractProductPtr on_unknown_type(Identifier) {
+		return nullptr;
+	}
+
+  protected:
+	~NullFactoryError() = default;
+};
+
+// the identifiers are enumerators, and the products are shared
+BOOST_AUTO_TEST_CASE(create_2)
+{
+	using ShapeFactory = aid::StaticFactory<shared_ptr<MyShape>, aid::TypeList<Circle, Square>, Shape, NullFactoryError>;
+	static_assert(ShapeFactory::id<Square>() == Shape::square, "id of Square");
+
+	const ShapeFactory factory;
+	BOOST_CHECK_EQUAL(factory.create(Shape::circle)->name(), "circle");
+	BOOST_CHECK_EQUAL(factory.create(Shape::square)->name(), "square");
+	BOOST_CHECK(!factory.create(Shape::triangle));
+}
+
+struct MyOwner
+{
+	unique_ptr<string> name;
+	explicit MyOwner(unique_ptr<string> &&name): name{std::move(name)} {}
+	virtual ~MyOwner() = default;
+};
+
+// the arguments are forwarded, so that they may be moved
+BOOST_AUTO_TEST_CASE(create_3)
+{
+	using OwnerFactory = aid::StaticFactory<unique_ptr<MyOwner>, aid::TypeList<MyOwner>, int>;
+	const OwnerFactory factory;
+	unique_ptr<string> name{new string("owner")};
+	auto owner = factory.create(0, std::move(name));
+	BOOST_CHECK(!name);
+	BOOST_CHECK_EQUAL(*owner->name, "owner");
+	BOOST_CHECK_THROW(factory.create(-1, unique_ptr<string>{}), OwnerFactory::error_policy_type::Exception);
+}